@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+    CrossingEquivalence.cpp
+    Created: 19 Oct 2026 12:21:05am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "CrossingEquivalence.h"
+#include "ZeroCrossingDetector.h"
+
+namespace
+{
+    const int numSignals = 40;
+    const int signalLength = 1 << 14;
+    const int maxBlockSize = 1024;
+    /** the scanners are compared on this many random ranges of each signal */
+    const int numRangesPerSignal = 50;
+    const int maxNumCrossings = 512;
+    
+    enum SignalType
+    {
+        noise = 0,
+        steps,  // a few levels, many of them exactly zero or minus zero
+        tone,   // a sine at a random frequency with a little noise
+        numSignalTypes
+    };
+    
+    void makeSignal(Random& random, float* samples, int numSamples)
+    {
+        const SignalType type = (SignalType) random.nextInt(numSignalTypes);
+        const double increment = MathConstants<double>::twoPi * (0.001 + 0.3 * random.nextDouble());
+        const float levels[] = { -1.0f, -0.0f, 0.0f, 1.0f, -1.0e-38f, 1.0e-38f };
+        for (int i = 0; i < numSamples; i++)
+        {
+            switch (type)
+            {
+                case steps:
+                    samples[i] = levels[random.nextInt(numElementsInArray(levels))];
+                    break;
+                case tone:
+                    samples[i] = (float) sin(increment * i) + 0.01f * (random.nextFloat() - 0.5f);
+                    break;
+                case noise:
+                default:
+                    samples[i] = 2.0f * random.nextFloat() - 1.0f;
+                    break;
+            }
+        }
+    }
+    
+    /** both scanners on random ranges of a signal */
+    void compareScanners(Random& random, const float* samples, CrossingEquivalence::Result& result)
+    {
+        int vectorised[maxNumCrossings];
+        int reference[maxNumCrossings];
+        for (int n = 0; n < numRangesPerSignal; n++)
+        {
+            const int begin = 1 + random.nextInt(signalLength - 1);
+            const int end = begin + random.nextInt(signalLength - begin + 1);
+            const int maxNumIndices = 1 + random.nextInt(maxNumCrossings);
+            
+            const int numVectorised = ZeroCrossingDetector::findCrossingsVectorised(samples, begin, end, vectorised, maxNumIndices);
+            const int numReference = ZeroCrossingDetector::findCrossingsScalar(samples, begin, end, reference, maxNumIndices);
+            
+            bool same = numVectorised == numReference;
+            for (int i = 0; same && i < numReference; i++)
+                same = vectorised[i] == reference[i];
+            
+            result.numCases++;
+            result.numCrossings += numReference;
+            if (!same)
+                result.numMismatches++;
+        }
+    }
+    
+    /** a vectorised and a scalar detector on the same signal, split into blocks of random sizes */
+    void compareDetectors(Random& random, const float* samples, ZeroCrossingDetector::Interpolation interpolation,
+                          float hysteresis, CrossingEquivalence::Result& result)
+    {
+        ZeroCrossingDetector vectorised(interpolation);
+        ZeroCrossingDetector reference(interpolation);
+        reference.setVectorised(false);
+        vectorised.setHysteresis(hysteresis);
+        reference.setHysteresis(hysteresis);
+        
+        double vectorisedPositions[maxNumCrossings];
+        double referencePositions[maxNumCrossings];
+        bool same = true;
+        int position = 0;
+        while (position < signalLength)
+        {
+            const int blockSize = jmin(signalLength - position, 1 + random.nextInt(maxBlockSize));
+            const int maxNumPositions = 1 + random.nextInt(maxNumCrossings);
+            const int numVectorised = vectorised.process(samples + position, blockSize, vectorisedPositions, maxNumPositions);
+            const int numReference = reference.process(samples + position, blockSize, referencePositions, maxNumPositions);
+            position += blockSize;
+            
+            same = same && numVectorised == numReference;
+            for (int i = 0; same && i < numReference; i++)
+                same = vectorisedPositions[i] == referencePositions[i];
+            result.numCrossings += numReference;
+        }
+        
+        result.numCases++;
+        if (!same)
+            result.numMismatches++;
+    }
+}
+
+var CrossingEquivalence::toVar(const Result& result)
+{
+    DynamicObject::Ptr object = new DynamicObject();
+    object->setProperty("check", result.check);
+    object->setProperty("numCases", result.numCases);
+    object->setProperty("numCrossings", result.numCrossings);
+    object->setProperty("numMismatches", result.numMismatches);
+    return var(object.get());
+}
+
+var CrossingEquivalence::run(std::ostream& out, bool& passed)
+{
+    Array<Result> results;
+    
+    Result scanners;
+    scanners.check = "scan";
+    results.add(scanners);
+    const ZeroCrossingDetector::Interpolation interpolations[] = {
+        ZeroCrossingDetector::linear, ZeroCrossingDetector::cubic,
+        ZeroCrossingDetector::sinc, ZeroCrossingDetector::oversampledSinc
+    };
+    const String names[] = { "linear", "cubic", "sinc", "64x sinc" };
+    for (int i = 0; i < numElementsInArray(interpolations); i++)
+    {
+        for (int withHysteresis = 0; withHysteresis < 2; withHysteresis++)
+        {
+            Result detector;
+            detector.check = "detector, " + names[i] + (withHysteresis ? ", hysteresis" : "");
+            results.add(detector);
+        }
+    }
+    for (auto& r : results)
+    {
+        r.numCases = 0;
+        r.numCrossings = 0;
+        r.numMismatches = 0;
+    }
+    
+    // the same signals and splits every time, so that a failure can be reproduced
+    Random random(1);
+    HeapBlock<float> samples((size_t) signalLength);
+    for (int n = 0; n < numSignals; n++)
+    {
+        makeSignal(random, samples, signalLength);
+        compareScanners(random, samples, results.getReference(0));
+        for (int i = 1; i < results.size(); i++)
+        {
+            const bool withHysteresis = (i - 1) % 2 == 1;
+            compareDetectors(random, samples, interpolations[(i - 1) / 2], withHysteresis ? 0.1f : 0.0f,
+                             results.getReference(i));
+        }
+    }
+    
+    out << "Vectorised vs. scalar zero crossings, " << numSignals << " random signals of "
+        << signalLength << " samples" << std::endl;
+    out << String("check").paddedRight(' ', 32) << String("cases").paddedLeft(' ', 8)
+        << String("crossings").paddedLeft(' ', 12) << String("mismatches").paddedLeft(' ', 12) << std::endl;
+    
+    Array<var> vars;
+    for (const auto& r : results)
+    {
+        out << r.check.paddedRight(' ', 32) << String(r.numCases).paddedLeft(' ', 8)
+            << String(r.numCrossings).paddedLeft(' ', 12) << String(r.numMismatches).paddedLeft(' ', 12)
+            << (r.numMismatches > 0 ? "  FAILED" : "") << std::endl;
+        passed = passed && r.numMismatches == 0;
+        vars.add(toVar(r));
+    }
+    out << std::endl;
+    return vars;
+}
@@ -0,0 +1,43 @@
+/*
+  ==============================================================================
+
+    CrossingEquivalence.h
+    Created: 19 Oct 2026 12:21:05am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef CROSSINGEQUIVALENCE_H_INCLUDED
+#define CROSSINGEQUIVALENCE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <iostream>
+
+/** Checks that the vectorised scan of the ZeroCrossingDetector finds exactly the same
+    crossings as the sample by sample reference implementation, in the build that is
+    actually shipped. Random signals (noise, steps through exact zeros, tones) are
+    scanned over random ranges, and fed through a vectorised and a scalar detector in
+    blocks of random sizes, with every interpolation and with and without hysteresis.
+    The positions must be the same to the last bit.
+ */
+class CrossingEquivalence
+{
+public:
+    struct Result
+    {
+        String check;
+        int numCases;       // ranges or signals that were compared
+        int64 numCrossings; // found by the reference implementation
+        int numMismatches;  // cases where the two differ
+    };
+    
+    /** runs all checks, prints a table and returns the results as an array of JSON objects.
+     passed is set to false if any of them found a difference. */
+    static var run(std::ostream& out, bool& passed);
+    
+    static var toVar(const Result& result);
+};
+
+
+#endif  // CROSSINGEQUIVALENCE_H_INCLUDED
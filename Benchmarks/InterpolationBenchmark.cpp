@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    InterpolationBenchmark.cpp
+    Created: 18 Oct 2026 12:58:33am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "InterpolationBenchmark.h"
+
+namespace
+{
+    /** the number of periods measured per signal */
+    const int numPeriods = 2000;
+    /** the detector gets the signal in blocks of this size, like from an audio callback */
+    const int blockSize = 256;
+    /** the signal is run through the detector this often to get a stable timing */
+    const int numTimingRuns = 5;
+    
+    const int averagingLengths[InterpolationBenchmark::numAveragingLengths] = { 1, 20, 50, 400 };
+}
+
+int InterpolationBenchmark::getAveragingLength(int index)
+{
+    return averagingLengths[index];
+}
+
+String InterpolationBenchmark::getName(ZeroCrossingDetector::Interpolation interpolation)
+{
+    switch (interpolation)
+    {
+        case ZeroCrossingDetector::cubic:
+            return "cubic";
+        case ZeroCrossingDetector::sinc:
+            return "sinc";
+        case ZeroCrossingDetector::oversampledSinc:
+            return "64x sinc";
+        case ZeroCrossingDetector::linear:
+        default:
+            return "linear";
+    }
+}
+
+InterpolationBenchmark::Result InterpolationBenchmark::measure(ZeroCrossingDetector::Interpolation interpolation,
+                                                               TestSignal::Waveform waveform,
+                                                               double frequency, double sampleRate)
+{
+    Result result;
+    result.interpolation = interpolation;
+    result.waveform = waveform;
+    result.frequency = frequency;
+    result.sampleRate = sampleRate;
+    
+    TestSignal signal(waveform, frequency, sampleRate);
+    const double periodLength = signal.getPeriodLength();
+    const int numSamples = (int) std::ceil((numPeriods + 2) * periodLength);
+    HeapBlock<float> samples((size_t) numSamples);
+    signal.render(samples, numSamples);
+    
+    // at most one crossing per two samples
+    HeapBlock<double> crossings((size_t) (numSamples / 2 + 1));
+    int numCrossings = 0;
+    double bestTime = 0;
+    for (int run = 0; run < numTimingRuns; run++)
+    {
+        ZeroCrossingDetector detector(interpolation);
+        numCrossings = 0;
+        const double start = Time::getMillisecondCounterHiRes();
+        for (int blockStart = 0; blockStart < numSamples; blockStart += blockSize)
+        {
+            const int numInBlock = jmin(blockSize, numSamples - blockStart);
+            numCrossings += detector.process(samples + blockStart, numInBlock, crossings + numCrossings,
+                                             numSamples / 2 + 1 - numCrossings);
+        }
+        const double time = Time::getMillisecondCounterHiRes() - start;
+        if (run == 0 || time < bestTime)
+            bestTime = time;
+    }
+    result.nanosecondsPerSample = bestTime * 1.0e6 / numSamples;
+    
+    // the first crossing may be the start of the signal
+    for (int a = 0; a < numAveragingLengths; a++)
+    {
+        const int length = averagingLengths[a];
+        double sumOfSquares = 0;
+        int count = 0;
+        for (int i = 1; i + length < numCrossings; i++)
+        {
+            const double averagePeriod = (crossings[i + length] - crossings[i]) / length;
+            const double cents = 1200.0 * log2(averagePeriod / periodLength);
+            sumOfSquares += cents * cents;
+            count++;
+        }
+        result.errorInCents[a] = count > 0 ? sqrt(sumOfSquares / count) : 0.0;
+    }
+    return result;
+}
+
+var InterpolationBenchmark::toVar(const Result& result)
+{
+    DynamicObject::Ptr object = new DynamicObject();
+    object->setProperty("interpolation", getName(result.interpolation));
+    object->setProperty("waveform", TestSignal::getName(result.waveform));
+    object->setProperty("frequency", result.frequency);
+    object->setProperty("sampleRate", result.sampleRate);
+    
+    Array<var> errors;
+    for (int a = 0; a < numAveragingLengths; a++)
+    {
+        DynamicObject::Ptr error = new DynamicObject();
+        error->setProperty("numPeriods", averagingLengths[a]);
+        error->setProperty("cents", result.errorInCents[a]);
+        errors.add(var(error.get()));
+    }
+    object->setProperty("errors", errors);
+    object->setProperty("nanosecondsPerSample", result.nanosecondsPerSample);
+    return var(object.get());
+}
+
+var InterpolationBenchmark::run(std::ostream& out)
+{
+    Array<var> results;
+    
+    const double sampleRate = 48000.0;
+    const TestSignal::Waveform waveforms[] = { TestSignal::sine, TestSignal::triangle, TestSignal::saw };
+    // A2 ... A8, detuned so that the period isn't a whole number of samples
+    const double frequencies[] = { 110.3, 440.3, 1760.3, 3520.3, 7040.3 };
+    
+    out << "Zero crossing interpolation, " << sampleRate << " Hz, RMS error in cents" << std::endl;
+    out << String("interpolation").paddedRight(' ', 15) << String("waveform").paddedRight(' ', 10)
+        << String("Hz").paddedLeft(' ', 8);
+    for (int a = 0; a < numAveragingLengths; a++)
+        out << String(averagingLengths[a]).paddedLeft(' ', 11);
+    out << String("ns/sample").paddedLeft(' ', 11) << std::endl;
+    
+    for (const auto waveform : waveforms)
+    {
+        for (const auto frequency : frequencies)
+        {
+            for (int i = ZeroCrossingDetector::linear; i <= ZeroCrossingDetector::oversampledSinc; i++)
+            {
+                const Result r = measure((ZeroCrossingDetector::Interpolation) i, waveform, frequency, sampleRate);
+                out << getName(r.interpolation).paddedRight(' ', 15) << TestSignal::getName(waveform).paddedRight(' ', 10)
+                    << String(frequency, 1).paddedLeft(' ', 8);
+                for (int a = 0; a < numAveragingLengths; a++)
+                    out << String(r.errorInCents[a], 5).paddedLeft(' ', 11);
+                out << String(r.nanosecondsPerSample, 2).paddedLeft(' ', 11) << std::endl;
+                results.add(toVar(r));
+            }
+        }
+    }
+    out << std::endl;
+    return results;
+}
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    InterpolationBenchmark.h
+    Created: 18 Oct 2026 12:58:33am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef INTERPOLATIONBENCHMARK_H_INCLUDED
+#define INTERPOLATIONBENCHMARK_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ZeroCrossingDetector.h"
+#include "TestSignal.h"
+#include <iostream>
+
+/** Compares the crossing interpolations of the ZeroCrossingDetector: how far the
+    period lengths are off on band limited test signals (single periods and the
+    averages over as many periods as the tuner's resolutions) and what each one
+    costs per sample.
+ */
+class InterpolationBenchmark
+{
+public:
+    struct Result
+    {
+        ZeroCrossingDetector::Interpolation interpolation;
+        TestSignal::Waveform waveform;
+        double frequency;
+        double sampleRate;
+        
+        /** RMS error of the average period length over 1, 20, 50 and 400 periods in cents */
+        double errorInCents[4];
+        double nanosecondsPerSample;
+    };
+    
+    static const int numAveragingLengths = 4;
+    static int getAveragingLength(int index);
+    
+    /** measures one interpolation on one signal */
+    static Result measure(ZeroCrossingDetector::Interpolation interpolation, TestSignal::Waveform waveform,
+                          double frequency, double sampleRate);
+    
+    /** measures all interpolations on a set of waveforms and notes, prints a table
+     and returns the results as an array of JSON objects */
+    static var run(std::ostream& out);
+    
+    static var toVar(const Result& result);
+    
+    static String getName(ZeroCrossingDetector::Interpolation interpolation);
+};
+
+
+#endif  // INTERPOLATIONBENCHMARK_H_INCLUDED
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    KernelBenchmark.cpp
+    Created: 18 Oct 2026 2:52:40am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "KernelBenchmark.h"
+#include "FrequencyEstimator.h"
+#include "RunningStatistics.h"
+#include "SettleDetector.h"
+#include "TestSignal.h"
+
+namespace
+{
+    const double sampleRate = 48000.0;
+    const double frequency = 324.7;
+    /** seconds of audio run through each estimator */
+    const double estimatorSeconds = 10.0;
+    const int blockSize = 256;
+    /** values added to the statistics and the settle detector */
+    const int numValues = 1000000;
+    
+    KernelBenchmark::Result makeResult(const String& kernel, const String& unit, int64 ticks, int64 numOperations)
+    {
+        KernelBenchmark::Result result;
+        result.kernel = kernel;
+        result.unit = unit;
+        const double seconds = Time::highResolutionTicksToSeconds(ticks);
+        result.nanosecondsPerOperation = seconds * 1.0e9 / (double) numOperations;
+        result.operationsPerSecond = seconds > 0 ? (double) numOperations / seconds : 0.0;
+        return result;
+    }
+    
+    KernelBenchmark::Result timeEstimator(FrequencyEstimator::Type type, SignalConditioner::Mode conditioning,
+                                          const float* samples, int numSamples)
+    {
+        std::unique_ptr<FrequencyEstimator> estimator = FrequencyEstimator::create(type);
+        estimator->setConditioning(conditioning);
+        estimator->reset(sampleRate, sampleRate / frequency);
+        HeapBlock<FrequencyEstimator::Period> periods((size_t) (blockSize / 2));
+        
+        const int64 start = Time::getHighResolutionTicks();
+        for (int blockStart = 0; blockStart + blockSize <= numSamples; blockStart += blockSize)
+            estimator->process(samples + blockStart, blockSize, periods, blockSize / 2);
+        const int64 ticks = Time::getHighResolutionTicks() - start;
+        
+        String name = FrequencyEstimator::getName(type);
+        if (conditioning != SignalConditioner::off)
+            name << ", " << SignalConditioner::getName(conditioning);
+        return makeResult(name, "sample", ticks, numSamples);
+    }
+    
+    KernelBenchmark::Result timeRunningStatistics(const double* values)
+    {
+        RunningStatistics statistics;
+        const int64 start = Time::getHighResolutionTicks();
+        for (int i = 0; i < numValues; i++)
+            statistics.add(values[i]);
+        const int64 ticks = Time::getHighResolutionTicks() - start;
+        
+        // keep the compiler from dropping the loop
+        if (statistics.getStandardErrorOfMean() < 0)
+            std::cout << std::endl;
+        return makeResult("RunningStatistics", "value", ticks, numValues);
+    }
+    
+    KernelBenchmark::Result timeSettleDetector(const double* values)
+    {
+        // the periods keep rising slowly, so the detector never settles and always fits its window
+        SettleDetector detector;
+        detector.reset(sampleRate, 0, 0, 0);
+        double position = 0;
+        const int64 start = Time::getHighResolutionTicks();
+        for (int i = 0; i < numValues; i++)
+        {
+            const double periodLength = values[i] * (1.0 + 1.0e-4 * i / numValues);
+            position += periodLength;
+            detector.addPeriod(position, periodLength);
+        }
+        const int64 ticks = Time::getHighResolutionTicks() - start;
+        return makeResult("SettleDetector", "period", ticks, numValues);
+    }
+}
+
+var KernelBenchmark::toVar(const Result& result)
+{
+    DynamicObject::Ptr object = new DynamicObject();
+    object->setProperty("kernel", result.kernel);
+    object->setProperty("unit", result.unit);
+    object->setProperty("nanosecondsPerOperation", result.nanosecondsPerOperation);
+    object->setProperty("operationsPerSecond", result.operationsPerSecond);
+    return var(object.get());
+}
+
+var KernelBenchmark::run(std::ostream& out)
+{
+    Array<Result> results;
+    
+    TestSignal signal(TestSignal::saw, frequency, sampleRate);
+    const int numSamples = (int) (estimatorSeconds * sampleRate);
+    HeapBlock<float> samples((size_t) numSamples);
+    signal.render(samples, numSamples);
+    for (int type = 0; type < FrequencyEstimator::numTypes; type++)
+        results.add(timeEstimator((FrequencyEstimator::Type) type, SignalConditioner::off, samples, numSamples));
+    
+    // what the input filters add to the zero crossings
+    results.add(timeEstimator(FrequencyEstimator::zeroCrossings, SignalConditioner::dcBlocker, samples, numSamples));
+    results.add(timeEstimator(FrequencyEstimator::zeroCrossings, SignalConditioner::bandPass, samples, numSamples));
+    
+    // period lengths with 0.2 cents of jitter
+    Random random(1);
+    HeapBlock<double> values((size_t) numValues);
+    for (int i = 0; i < numValues; i++)
+        values[i] = sampleRate / frequency * (1.0 + 1.0e-4 * (random.nextDouble() - 0.5));
+    results.add(timeRunningStatistics(values));
+    results.add(timeSettleDetector(values));
+    
+    out << "Kernels, " << sampleRate << " Hz, blocks of " << blockSize << std::endl;
+    out << String("kernel").paddedRight(' ', 26) << String("ns/op").paddedLeft(' ', 10)
+        << String("Mops/s").paddedLeft(' ', 10) << "  per" << std::endl;
+    
+    Array<var> vars;
+    for (const auto& r : results)
+    {
+        out << r.kernel.paddedRight(' ', 26) << String(r.nanosecondsPerOperation, 2).paddedLeft(' ', 10)
+            << String(r.operationsPerSecond / 1.0e6, 2).paddedLeft(' ', 10) << "  " << r.unit << std::endl;
+        vars.add(toVar(r));
+    }
+    out << std::endl;
+    return vars;
+}
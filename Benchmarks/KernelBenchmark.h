@@ -0,0 +1,39 @@
+/*
+  ==============================================================================
+
+    KernelBenchmark.h
+    Created: 18 Oct 2026 2:52:40am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef KERNELBENCHMARK_H_INCLUDED
+#define KERNELBENCHMARK_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <iostream>
+
+/** Times the building blocks of a measurement on their own: the frequency
+    estimators on a clean saw, the settle detector and the running statistics
+    that every period goes through.
+ */
+class KernelBenchmark
+{
+public:
+    struct Result
+    {
+        String kernel;
+        String unit;                    // what one operation is, e.g. "sample" or "period"
+        double nanosecondsPerOperation;
+        double operationsPerSecond;
+    };
+    
+    /** times all kernels, prints a table and returns the results as an array of JSON objects */
+    static var run(std::ostream& out);
+    
+    static var toVar(const Result& result);
+};
+
+
+#endif  // KERNELBENCHMARK_H_INCLUDED
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026 12:36:52am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "CrossingEquivalence.h"
+#include "InterpolationBenchmark.h"
+#include "KernelBenchmark.h"
+#include "MeasurementBenchmark.h"
+#include "ReplayRecordings.h"
+#include "SimulationBenchmark.h"
+
+/** Runs the benchmarks and prints their results as tables.
+
+    VCOTunerBenchmark [--json <file>] [--suite <name>[,<name>...]]
+    
+    --json   also writes all results to a JSON file, to keep track of regressions
+    --suite  only runs these suites: interpolation, kernels, equivalence, signals,
+             sampleRates, blockSizes, interference, conditioning, channels, simulation
+    
+    Exits with 1 if the vectorised zero crossings differ from the reference (see
+    CrossingEquivalence) or if the simulated sweeps don't measure the offsets of
+    their oscillators (see SimulationBenchmark).
+    
+    Instead of the benchmarks, it can test a sweep of the app over recordings:
+    
+    --write-recordings <folder>  writes the ReplayRecordings for `VCOTuner --headless --replay <folder>`
+    --check-replay <file>        checks the CSV output of that sweep, exits with 1 if it is off
+ */
+int main (int argc, char* argv[])
+{
+    // the tuner needs a message manager, even if it never gets to run a message loop
+    ScopedJuceInitialiser_GUI juceInitialiser;
+    
+    ArgumentList args(argc, argv);
+    if (args.containsOption("--write-recordings"))
+    {
+        const String error = ReplayRecordings::write(args.getFileForOption("--write-recordings"), std::cout);
+        if (error.isNotEmpty())
+            std::cerr << error << std::endl;
+        return error.isEmpty() ? 0 : 1;
+    }
+    if (args.containsOption("--check-replay"))
+        return ReplayRecordings::check(args.getFileForOption("--check-replay"), std::cout) ? 0 : 1;
+    
+    StringArray suites;
+    suites.add("interpolation");
+    suites.add("kernels");
+    suites.add("equivalence");
+    suites.addArray(MeasurementBenchmark::getSuiteNames());
+    suites.add("simulation");
+    if (args.containsOption("--suite"))
+    {
+        const StringArray selected = StringArray::fromTokens(args.getValueForOption("--suite"), ",", "");
+        for (int i = suites.size(); --i >= 0;)
+        {
+            if (!selected.contains(suites[i]))
+                suites.remove(i);
+        }
+    }
+    
+    DynamicObject::Ptr report = new DynamicObject();
+    report->setProperty("date", Time::getCurrentTime().toISO8601(true));
+    report->setProperty("cpu", SystemStats::getCpuModel());
+    report->setProperty("numCpus", SystemStats::getNumCpus());
+    report->setProperty("operatingSystem", SystemStats::getOperatingSystemName());
+   #if JUCE_DEBUG
+    report->setProperty("debugBuild", true);
+   #else
+    report->setProperty("debugBuild", false);
+   #endif
+    
+    bool passed = true;
+    Array<var> measurements;
+    for (const auto& suite : suites)
+    {
+        if (suite == "interpolation")
+            report->setProperty("interpolation", InterpolationBenchmark::run(std::cout));
+        else if (suite == "kernels")
+            report->setProperty("kernels", KernelBenchmark::run(std::cout));
+        else if (suite == "equivalence")
+            report->setProperty("equivalence", CrossingEquivalence::run(std::cout, passed));
+        else if (suite == "simulation")
+            report->setProperty("simulation", SimulationBenchmark::run(std::cout, passed));
+        else
+            measurements.addArray(*MeasurementBenchmark::runSuite(suite, std::cout).getArray());
+    }
+    if (!measurements.isEmpty())
+        report->setProperty("measurements", measurements);
+    
+    if (args.containsOption("--json"))
+    {
+        const File file = args.getFileForOption("--json");
+        if (!file.replaceWithText(JSON::toString(var(report.get()))))
+        {
+            std::cerr << "Can't write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,293 @@
+/*
+  ==============================================================================
+
+    MeasurementBenchmark.cpp
+    Created: 18 Oct 2026 2:14:26am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MeasurementBenchmark.h"
+
+namespace
+{
+    /** the periods measured per note */
+    const int resolution = 50;
+    /** a measurement that isn't done after this much audio counts as failed */
+    const double maxMeasurementSeconds = 30.0;
+    
+    /** the tuner talks to the oscillator through this - the test signals don't listen */
+    class NullMidiSink: public VCOTuner::MidiSink
+    {
+    public:
+        void sendMessageNow(const MidiMessage& /*message*/) override {}
+    };
+    
+    MeasurementBenchmark::Setup withWaveform(MeasurementBenchmark::Setup setup, TestSignal::Waveform waveform, double frequency)
+    {
+        setup.waveform = waveform;
+        setup.frequency = frequency;
+        return setup;
+    }
+    
+    MeasurementBenchmark::Setup withInterference(MeasurementBenchmark::Setup setup, TestSignal::Interference interference, double snr)
+    {
+        setup.interference = interference;
+        setup.signalToNoiseRatio = snr;
+        return setup;
+    }
+    
+    MeasurementBenchmark::Setup withConditioning(MeasurementBenchmark::Setup setup, SignalConditioner::Mode conditioning)
+    {
+        setup.conditioning = conditioning;
+        return setup;
+    }
+    
+    bool isZeroCrossingEstimator(FrequencyEstimator::Type estimator)
+    {
+        return estimator == FrequencyEstimator::zeroCrossings || estimator == FrequencyEstimator::zeroCrossingsCubic
+            || estimator == FrequencyEstimator::zeroCrossingsSinc || estimator == FrequencyEstimator::zeroCrossingsOversampledSinc;
+    }
+    
+    /** the setups of a suite, for one estimator */
+    Array<MeasurementBenchmark::Setup> getSetups(const String& suiteName, FrequencyEstimator::Type estimator)
+    {
+        MeasurementBenchmark::Setup defaultSetup;
+        defaultSetup.estimator = estimator;
+        
+        Array<MeasurementBenchmark::Setup> setups;
+        if (suiteName == "signals")
+        {
+            // 20 Hz ... 10 kHz, detuned so that the period isn't a whole number of samples
+            const TestSignal::Waveform waveforms[] = { TestSignal::sine, TestSignal::saw, TestSignal::square, TestSignal::pulse };
+            const double frequencies[] = { 20.3, 81.1, 324.7, 1298.3, 5191.4, 10007.7 };
+            for (const auto waveform : waveforms)
+                for (const auto frequency : frequencies)
+                    setups.add(withWaveform(defaultSetup, waveform, frequency));
+        }
+        else if (suiteName == "sampleRates")
+        {
+            const double sampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+            for (const auto sampleRate : sampleRates)
+            {
+                MeasurementBenchmark::Setup setup = defaultSetup;
+                setup.sampleRate = sampleRate;
+                setups.add(setup);
+            }
+        }
+        else if (suiteName == "blockSizes")
+        {
+            for (int blockSize = 16; blockSize <= 4096; blockSize *= 2)
+            {
+                MeasurementBenchmark::Setup setup = defaultSetup;
+                setup.blockSize = blockSize;
+                setups.add(setup);
+            }
+        }
+        else if (suiteName == "interference")
+        {
+            const TestSignal::Interference interferences[] = { TestSignal::whiteNoise, TestSignal::hum };
+            const double signalToNoiseRatios[] = { 60.0, 40.0, 20.0, 10.0 };
+            for (const auto interference : interferences)
+                for (const auto snr : signalToNoiseRatios)
+                    setups.add(withInterference(defaultSetup, interference, snr));
+        }
+        else if (suiteName == "conditioning" && isZeroCrossingEstimator(estimator))
+        {
+            // the same signals with each input filter
+            Array<MeasurementBenchmark::Setup> signals;
+            const double signalToNoiseRatios[] = { 20.0, 10.0, 0.0 };
+            for (const auto snr : signalToNoiseRatios)
+                signals.add(withInterference(defaultSetup, TestSignal::whiteNoise, snr));
+            for (const auto snr : signalToNoiseRatios)
+                signals.add(withInterference(defaultSetup, TestSignal::hum, snr));
+            signals.add(withInterference(withWaveform(defaultSetup, TestSignal::pulse, 324.7), TestSignal::dcOffset, 0.0));
+            
+            for (int mode = 0; mode < SignalConditioner::numModes; mode++)
+                for (const auto& setup : signals)
+                    setups.add(withConditioning(setup, (SignalConditioner::Mode) mode));
+        }
+        else if (suiteName == "channels")
+        {
+            for (int numChannels = 1; numChannels <= 8; numChannels *= 2)
+            {
+                MeasurementBenchmark::Setup setup = defaultSetup;
+                setup.numChannels = numChannels;
+                setups.add(setup);
+            }
+        }
+        return setups;
+    }
+}
+
+MeasurementBenchmark::Setup::Setup()
+    : estimator(FrequencyEstimator::zeroCrossings),
+      conditioning(SignalConditioner::off),
+      waveform(TestSignal::saw),
+      frequency(324.7),
+      sampleRate(48000.0),
+      blockSize(256),
+      numChannels(1),
+      interference(TestSignal::noInterference),
+      signalToNoiseRatio(0)
+{
+}
+
+MeasurementBenchmark::Result MeasurementBenchmark::measure(const Setup& setup)
+{
+    Result result;
+    result.setup = setup;
+    result.succeeded = false;
+    result.errorInCents = 0;
+    
+    AudioDeviceManager deviceManager;
+    VCOTuner tuner(&deviceManager);
+    NullMidiSink midiSink;
+    
+    Array<VCOTuner::LaneSetup> lanes;
+    OwnedArray<TestSignal> signals;
+    for (int i = 0; i < setup.numChannels; i++)
+    {
+        VCOTuner::LaneSetup lane;
+        lane.inputChannel = i;
+        lane.midiChannel = i + 1;
+        lanes.add(lane);
+        
+        TestSignal* signal = signals.add(new TestSignal(setup.waveform, setup.frequency, setup.sampleRate));
+        if (setup.interference != TestSignal::noInterference)
+            signal->setInterference(setup.interference, setup.signalToNoiseRatio, i + 1);
+    }
+    tuner.setLanes(lanes);
+    tuner.setEstimator(setup.estimator);
+    tuner.setConditioning(setup.conditioning);
+    tuner.setResolution(resolution);
+    tuner.setTargetConfidenceInterval(0);
+    tuner.prepareToPlay(setup.sampleRate);
+    tuner.setMidiSink(&midiSink);
+    tuner.setUsesVirtualClock(true);
+    
+    AudioBuffer<float> buffer(setup.numChannels, setup.blockSize);
+    const double blockTimeMs = 1000.0 * setup.blockSize / setup.sampleRate;
+    const int maxNumBlocks = (int) (maxMeasurementSeconds * setup.sampleRate / setup.blockSize);
+    int64 callbackTicks = 0;
+    int64 maxCallbackTicks = 0;
+    int64 analysisTicks = 0;
+    int numBlocks = 0;
+    
+    tuner.startSingleMeasurement(roundToInt(69.0 + 12.0 * log2(setup.frequency / 440.0)));
+    while (tuner.isRunning() && numBlocks < maxNumBlocks)
+    {
+        for (int i = 0; i < setup.numChannels; i++)
+            signals[i]->render(buffer.getWritePointer(i), setup.blockSize);
+        
+        const int64 start = Time::getHighResolutionTicks();
+        tuner.audioDeviceIOCallback(buffer.getArrayOfReadPointers(), setup.numChannels, nullptr, 0, setup.blockSize);
+        const int64 callbackEnd = Time::getHighResolutionTicks();
+        tuner.advanceClock(blockTimeMs);
+        const int64 analysisEnd = Time::getHighResolutionTicks();
+        
+        callbackTicks += callbackEnd - start;
+        maxCallbackTicks = jmax(maxCallbackTicks, callbackEnd - start);
+        analysisTicks += analysisEnd - callbackEnd;
+        numBlocks++;
+    }
+    
+    if (tuner.hasFinished() && tuner.getSingleMeasurementResult() > 0)
+    {
+        result.succeeded = true;
+        result.errorInCents = 1200.0 * log2(tuner.getSingleMeasurementResult() / setup.frequency);
+    }
+    else if (tuner.isRunning())
+        result.error = "no result after " + String(maxMeasurementSeconds) + " s";
+    else
+        result.error = tuner.getLastErrors().joinIntoString(" ");
+    
+    tuner.stop();
+    tuner.setUsesVirtualClock(false);
+    tuner.setMidiSink(nullptr);
+    
+    const double nanosecondsPerBlock = 1.0e9 / jmax(1, numBlocks);
+    result.measurementSeconds = numBlocks * setup.blockSize / setup.sampleRate;
+    result.callbackNanoseconds = Time::highResolutionTicksToSeconds(callbackTicks) * nanosecondsPerBlock;
+    result.maxCallbackNanoseconds = Time::highResolutionTicksToSeconds(maxCallbackTicks) * 1.0e9;
+    result.analysisNanoseconds = Time::highResolutionTicksToSeconds(analysisTicks) * nanosecondsPerBlock;
+    
+    const double seconds = Time::highResolutionTicksToSeconds(callbackTicks + analysisTicks);
+    result.samplesPerSecond = seconds > 0 ? (double) numBlocks * setup.blockSize / seconds : 0.0;
+    return result;
+}
+
+StringArray MeasurementBenchmark::getSuiteNames()
+{
+    return StringArray("signals", "sampleRates", "blockSizes", "interference", "conditioning", "channels");
+}
+
+var MeasurementBenchmark::toVar(const Result& result)
+{
+    DynamicObject::Ptr object = new DynamicObject();
+    object->setProperty("suite", result.suite);
+    object->setProperty("estimator", FrequencyEstimator::getName(result.setup.estimator));
+    object->setProperty("conditioning", SignalConditioner::getName(result.setup.conditioning));
+    object->setProperty("waveform", TestSignal::getName(result.setup.waveform));
+    object->setProperty("frequency", result.setup.frequency);
+    object->setProperty("sampleRate", result.setup.sampleRate);
+    object->setProperty("blockSize", result.setup.blockSize);
+    object->setProperty("numChannels", result.setup.numChannels);
+    object->setProperty("interference", TestSignal::getName(result.setup.interference));
+    if (result.setup.interference != TestSignal::noInterference)
+        object->setProperty("signalToNoiseRatio", result.setup.signalToNoiseRatio);
+    
+    object->setProperty("succeeded", result.succeeded);
+    if (result.succeeded)
+        object->setProperty("errorInCents", result.errorInCents);
+    else
+        object->setProperty("error", result.error);
+    object->setProperty("measurementSeconds", result.measurementSeconds);
+    object->setProperty("callbackNanoseconds", result.callbackNanoseconds);
+    object->setProperty("maxCallbackNanoseconds", result.maxCallbackNanoseconds);
+    object->setProperty("analysisNanoseconds", result.analysisNanoseconds);
+    object->setProperty("samplesPerSecond", result.samplesPerSecond);
+    return var(object.get());
+}
+
+var MeasurementBenchmark::runSuite(const String& suiteName, std::ostream& out)
+{
+    out << "Measurement, suite \"" << suiteName << "\" (" << resolution << " periods per note)" << std::endl;
+    out << String("estimator").paddedRight(' ', 26) << String("filter").paddedRight(' ', 12) << String("waveform").paddedRight(' ', 10)
+        << String("Hz").paddedLeft(' ', 9) << String("rate").paddedLeft(' ', 8) << String("block").paddedLeft(' ', 6)
+        << String("ch").paddedLeft(' ', 4) << String("noise").paddedLeft(' ', 11)
+        << String("cents").paddedLeft(' ', 12) << String("audio s").paddedLeft(' ', 9)
+        << String("ns/cb").paddedLeft(' ', 9) << String("max ns/cb").paddedLeft(' ', 11)
+        << String("ns/analysis").paddedLeft(' ', 12) << String("Msamples/s").paddedLeft(' ', 12) << std::endl;
+    
+    Array<var> results;
+    for (int type = 0; type < FrequencyEstimator::numTypes; type++)
+    {
+        const Array<Setup> setups = getSetups(suiteName, (FrequencyEstimator::Type) type);
+        for (const auto& setup : setups)
+        {
+            Result r = measure(setup);
+            r.suite = suiteName;
+            results.add(toVar(r));
+            
+            const String noise = setup.interference == TestSignal::noInterference
+                               ? String("-")
+                               : TestSignal::getName(setup.interference) + " " + String(roundToInt(setup.signalToNoiseRatio)) + "dB";
+            out << FrequencyEstimator::getName(setup.estimator).paddedRight(' ', 26)
+                << SignalConditioner::getName(setup.conditioning).paddedRight(' ', 12)
+                << TestSignal::getName(setup.waveform).paddedRight(' ', 10)
+                << String(setup.frequency, 1).paddedLeft(' ', 9) << String(roundToInt(setup.sampleRate)).paddedLeft(' ', 8)
+                << String(setup.blockSize).paddedLeft(' ', 6) << String(setup.numChannels).paddedLeft(' ', 4)
+                << noise.paddedLeft(' ', 11)
+                << (r.succeeded ? String(r.errorInCents, 4) : String("failed")).paddedLeft(' ', 12)
+                << String(r.measurementSeconds, 3).paddedLeft(' ', 9)
+                << String(r.callbackNanoseconds, 0).paddedLeft(' ', 9) << String(r.maxCallbackNanoseconds, 0).paddedLeft(' ', 11)
+                << String(r.analysisNanoseconds, 0).paddedLeft(' ', 12) << String(r.samplesPerSecond / 1.0e6, 2).paddedLeft(' ', 12)
+                << std::endl;
+        }
+    }
+    out << std::endl;
+    return results;
+}
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    MeasurementBenchmark.h
+    Created: 18 Oct 2026 2:14:26am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef MEASUREMENTBENCHMARK_H_INCLUDED
+#define MEASUREMENTBENCHMARK_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "VCOTuner.h"
+#include "TestSignal.h"
+#include <iostream>
+
+/** Runs single note measurements of the VCOTuner on test signals, the whole way from
+    the audio callback through the frequency estimator to the result. The tuner runs
+    on a virtual clock, so the analysis happens in between the callbacks and both
+    can be timed separately.
+    
+    Each suite varies one property of the default setup (a saw at 324.7 Hz, 48 kHz,
+    blocks of 256 samples, a single input, no noise, no input filter) for each of the
+    estimators. The conditioning suite only runs the zero crossings, which are the
+    only ones that use the input filter.
+ */
+class MeasurementBenchmark
+{
+public:
+    struct Setup
+    {
+        Setup();
+        
+        FrequencyEstimator::Type estimator;
+        SignalConditioner::Mode conditioning;
+        TestSignal::Waveform waveform;
+        double frequency;
+        double sampleRate;
+        int blockSize;
+        int numChannels; // all channels get the same signal, with different noise
+        TestSignal::Interference interference;
+        double signalToNoiseRatio; // in dB
+    };
+    
+    struct Result
+    {
+        Setup setup;
+        String suite;
+        
+        bool succeeded;
+        String error;               // why the measurement failed
+        double errorInCents;        // measured vs. exact frequency
+        double measurementSeconds;  // of audio until the result was there
+        
+        double callbackNanoseconds;     // average time spent in audioDeviceIOCallback()
+        double maxCallbackNanoseconds;  // the slowest callback
+        double analysisNanoseconds;     // average analysis time per block
+        double samplesPerSecond;        // samples per channel and second of callback and analysis time
+    };
+    
+    /** measures a single note */
+    static Result measure(const Setup& setup);
+    
+    /** the names of the suites, in the order they are run */
+    static StringArray getSuiteNames();
+    
+    /** runs a suite for all estimators, prints a table and returns the results as an array of JSON objects */
+    static var runSuite(const String& suiteName, std::ostream& out);
+    
+    static var toVar(const Result& result);
+};
+
+
+#endif  // MEASUREMENTBENCHMARK_H_INCLUDED
@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    ReplayRecordings.cpp
+    Created: 18 Oct 2026 11:52:14pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ReplayRecordings.h"
+#include "TestSignal.h"
+
+namespace
+{
+    const int lowestNote = 24;
+    const int highestNote = 96;
+    const double sampleRate = 48000.0;
+    const int bitsPerSample = 24;
+    /** the length of each recording. The frequencies are rounded to a whole number of periods in it. */
+    const double recordingSeconds = 3.0;
+    
+    /** the imperfections of the recorded oscillator, relative to note 60 */
+    const double scaleErrorInCentsPerOctave = 8.0;
+    const double offsetInCents = 3.0;
+    
+    /** a measured frequency may be this far from the recorded one */
+    const double toleranceInCents = 0.5;
+}
+
+double ReplayRecordings::getFrequency(int midiNote)
+{
+    const double cents = 100.0 * (midiNote - 69) + scaleErrorInCentsPerOctave * (midiNote - 60) / 12.0 + offsetInCents;
+    const double frequency = 440.0 * pow(2.0, cents / 1200.0);
+    return jmax(1.0, (double) roundToInt(frequency * recordingSeconds)) / recordingSeconds;
+}
+
+String ReplayRecordings::write(const File& folder, std::ostream& out)
+{
+    const Result result = folder.createDirectory();
+    if (result.failed())
+        return result.getErrorMessage();
+    
+    WavAudioFormat wav;
+    const int numSamples = roundToInt(recordingSeconds * sampleRate);
+    HeapBlock<float> samples(numSamples);
+    for (int note = lowestNote; note <= highestNote; note++)
+    {
+        TestSignal signal(TestSignal::saw, getFrequency(note), sampleRate);
+        signal.render(samples, numSamples);
+        
+        const File file = folder.getChildFile(String(note) + ".wav");
+        file.deleteFile();
+        std::unique_ptr<OutputStream> stream(new FileOutputStream(file));
+        std::unique_ptr<AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, 1,
+                                                                      bitsPerSample, {}, 0));
+        if (writer == nullptr)
+            return "Can't write " + file.getFullPathName();
+        stream.release(); // the writer owns it now
+        
+        const float* channels[] = { samples.get() };
+        if (!writer->writeFromFloatArrays(channels, 1, numSamples))
+            return "Can't write " + file.getFullPathName();
+    }
+    
+    out << "Wrote notes " << lowestNote << " to " << highestNote << " to "
+        << folder.getFullPathName() << std::endl;
+    return {};
+}
+
+bool ReplayRecordings::check(const File& csvFile, std::ostream& out)
+{
+    StringArray lines;
+    csvFile.readLines(lines);
+    lines.removeEmptyStrings();
+    if (lines.isEmpty())
+    {
+        out << "No results in " << csvFile.getFullPathName() << std::endl;
+        return false;
+    }
+    
+    const StringArray header = StringArray::fromTokens(lines[0], ",", "\"");
+    const int pitchColumn = header.indexOf("midiPitch");
+    const int frequencyColumn = header.indexOf("frequency");
+    if (pitchColumn < 0 || frequencyColumn < 0)
+    {
+        out << csvFile.getFullPathName() << " isn't the CSV output of a headless sweep" << std::endl;
+        return false;
+    }
+    
+    out << "Replayed sweep" << std::endl
+        << String("note").paddedRight(' ', 6) << String("recorded Hz").paddedLeft(' ', 14)
+        << String("measured Hz").paddedLeft(' ', 14) << String("error cents").paddedLeft(' ', 14) << std::endl;
+    
+    int numChecked = 0;
+    int numFailed = 0;
+    for (int i = 1; i < lines.size(); i++)
+    {
+        const StringArray fields = StringArray::fromTokens(lines[i], ",", "\"");
+        const int note = fields[pitchColumn].getIntValue();
+        const double measured = fields[frequencyColumn].getDoubleValue();
+        const double recorded = getFrequency(note);
+        const double error = measured > 0 ? 1200.0 * log2(measured / recorded) : 0;
+        const bool failed = note < lowestNote || note > highestNote || measured <= 0
+                            || std::abs(error) > toleranceInCents;
+        
+        out << String(note).paddedRight(' ', 6) << String(recorded, 4).paddedLeft(' ', 14)
+            << String(measured, 4).paddedLeft(' ', 14) << String(error, 4).paddedLeft(' ', 14)
+            << (failed ? "  FAILED" : "") << std::endl;
+        numChecked++;
+        if (failed)
+            numFailed++;
+    }
+    
+    out << numChecked << " notes, " << numFailed << " off by more than " << toleranceInCents << " cents" << std::endl;
+    return numChecked > 0 && numFailed == 0;
+}
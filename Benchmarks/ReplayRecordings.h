@@ -0,0 +1,38 @@
+/*
+  ==============================================================================
+
+    ReplayRecordings.h
+    Created: 18 Oct 2026 11:52:14pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef REPLAYRECORDINGS_H_INCLUDED
+#define REPLAYRECORDINGS_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include <iostream>
+
+/** Recordings of an oscillator with a known scale error, for `VCOTuner --headless --replay`.
+    The output of a sweep over them can be checked against the frequencies they were
+    made with, which tests the whole app from the audio device to the results.
+    
+    Each recording holds a whole number of periods, so that it loops without a jump.
+ */
+class ReplayRecordings
+{
+public:
+    /** writes one WAV file per note ("60.wav") into the folder. Returns an error message. */
+    static String write(const File& folder, std::ostream& out);
+    
+    /** the exact frequency that a note was recorded at */
+    static double getFrequency(int midiNote);
+    
+    /** compares the frequencies of the headless sweep's CSV output with those of the
+     recordings and prints a table. Returns false if a note is off or none were measured. */
+    static bool check(const File& csvFile, std::ostream& out);
+};
+
+
+#endif  // REPLAYRECORDINGS_H_INCLUDED
@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    SimulationBenchmark.cpp
+    Created: 18 Oct 2026 11:58:36pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SimulationBenchmark.h"
+
+namespace
+{
+    const double sampleRate = 48000.0;
+    const int blockSize = 256;
+    const int lowestNote = 24;
+    const int highestNote = 96;
+    const int noteIncrement = 6;
+    /** a sweep that takes longer than this in virtual time has got stuck */
+    const double maxSweepSeconds = 600.0;
+    
+    /** a measured offset may be this far from the settled one */
+    const double toleranceInCents = 0.5;
+    
+    class ResultCollector: public VCOTuner::Listener
+    {
+    public:
+        void newMeasurementReady(const VCOTuner::measurement_t& m) override
+        {
+            measurements.add(m);
+        }
+        
+        Array<VCOTuner::measurement_t> measurements;
+    };
+}
+
+Array<SimulationBenchmark::Scenario> SimulationBenchmark::getScenarios()
+{
+    Array<Scenario> scenarios;
+    
+    Scenario ideal;
+    ideal.name = "ideal";
+    scenarios.add(ideal);
+    
+    Scenario scale;
+    scale.name = "scale error";
+    scale.parameters.scaleError = 12.0;
+    scale.parameters.offset = -7.0;
+    scenarios.add(scale);
+    
+    Scenario bow;
+    bow.name = "bow";
+    bow.parameters.expConverterBow = 3.0;
+    scenarios.add(bow);
+    
+    Scenario slew;
+    slew.name = "slew";
+    slew.parameters.latencyMs = 5.0;
+    slew.parameters.slewTimeMs = 30.0;
+    scenarios.add(slew);
+    
+    Scenario jitter;
+    jitter.name = "jitter";
+    jitter.parameters.jitter = 0.3;
+    jitter.parameters.seed = 3;
+    scenarios.add(jitter);
+    
+    // 12 bits over 10 V are steps of about 3 cents
+    Scenario dac;
+    dac.name = "DAC";
+    dac.parameters.dacBits = 12;
+    scenarios.add(dac);
+    
+    Scenario all;
+    all.name = "all";
+    all.parameters.scaleError = 12.0;
+    all.parameters.offset = -7.0;
+    all.parameters.expConverterBow = 3.0;
+    all.parameters.latencyMs = 5.0;
+    all.parameters.slewTimeMs = 30.0;
+    all.parameters.jitter = 0.3;
+    all.parameters.dacBits = 12;
+    all.parameters.seed = 7;
+    scenarios.add(all);
+    
+    return scenarios;
+}
+
+SimulationBenchmark::Result SimulationBenchmark::sweep(const Scenario& scenario)
+{
+    Result result;
+    result.scenario = scenario;
+    
+    AudioDeviceManager deviceManager;
+    VCOTuner tuner(&deviceManager);
+    ResultCollector collector;
+    tuner.addListener(&collector);
+    tuner.setNumMeasurementRange(lowestNote, noteIncrement, highestNote);
+    
+    SimulatedVCO vco(scenario.parameters);
+    const int64 start = Time::getHighResolutionTicks();
+    {
+        VCOSimulation simulation(tuner, vco, sampleRate, blockSize);
+        tuner.start();
+        result.finished = simulation.runUntilFinished(maxSweepSeconds);
+        result.sweepSeconds = simulation.getElapsedSeconds();
+    }
+    result.wallSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+    tuner.removeListener(&collector);
+    
+    const StringArray errors = tuner.getLastErrors();
+    if (!result.finished)
+        result.error = errors.isEmpty() ? "didn't finish" : errors[errors.size() - 1];
+    
+    // the offsets are relative to the reference note, in the middle of the range
+    const int referenceNote = tuner.getReferencePitch();
+    const double referenceFrequency = vco.getSettledFrequency(referenceNote);
+    result.numNotes = collector.measurements.size();
+    result.maxErrorInCents = 0;
+    double sumOfSquares = 0;
+    for (const auto& m : collector.measurements)
+    {
+        const double expectedOffset = 1200.0 * log2(vco.getSettledFrequency(m.midiPitch) / referenceFrequency)
+                                    - 100.0 * (m.midiPitch - referenceNote);
+        const double error = 100.0 * m.pitchOffset - expectedOffset;
+        result.maxErrorInCents = jmax(result.maxErrorInCents, std::abs(error));
+        sumOfSquares += error * error;
+    }
+    result.rmsErrorInCents = result.numNotes > 0 ? sqrt(sumOfSquares / result.numNotes) : 0.0;
+    
+    const int expectedNumNotes = (highestNote - lowestNote) / noteIncrement + 1;
+    result.passed = result.finished && result.numNotes == expectedNumNotes
+                    && result.maxErrorInCents <= toleranceInCents;
+    return result;
+}
+
+var SimulationBenchmark::toVar(const Result& result)
+{
+    const SimulatedVCO::Parameters& p = result.scenario.parameters;
+    DynamicObject::Ptr object = new DynamicObject();
+    object->setProperty("scenario", result.scenario.name);
+    object->setProperty("scaleError", p.scaleError);
+    object->setProperty("offset", p.offset);
+    object->setProperty("expConverterBow", p.expConverterBow);
+    object->setProperty("latencyMs", p.latencyMs);
+    object->setProperty("slewTimeMs", p.slewTimeMs);
+    object->setProperty("jitter", p.jitter);
+    object->setProperty("dacBits", p.dacBits);
+    object->setProperty("seed", p.seed);
+    object->setProperty("finished", result.finished);
+    if (result.error.isNotEmpty())
+        object->setProperty("error", result.error);
+    object->setProperty("numNotes", result.numNotes);
+    object->setProperty("maxErrorInCents", result.maxErrorInCents);
+    object->setProperty("rmsErrorInCents", result.rmsErrorInCents);
+    object->setProperty("sweepSeconds", result.sweepSeconds);
+    object->setProperty("wallSeconds", result.wallSeconds);
+    object->setProperty("passed", result.passed);
+    return var(object.get());
+}
+
+var SimulationBenchmark::run(std::ostream& out, bool& passed)
+{
+    out << "Simulated sweeps, notes " << lowestNote << " to " << highestNote << " every " << noteIncrement
+        << ", " << sampleRate << " Hz, blocks of " << blockSize << std::endl;
+    out << String("scenario").paddedRight(' ', 14) << String("notes").paddedLeft(' ', 7)
+        << String("max cents").paddedLeft(' ', 11) << String("rms cents").paddedLeft(' ', 11)
+        << String("sweep s").paddedLeft(' ', 9) << String("run s").paddedLeft(' ', 8) << std::endl;
+    
+    Array<var> vars;
+    for (const auto& scenario : getScenarios())
+    {
+        const Result r = sweep(scenario);
+        out << r.scenario.name.paddedRight(' ', 14) << String(r.numNotes).paddedLeft(' ', 7)
+            << String(r.maxErrorInCents, 3).paddedLeft(' ', 11) << String(r.rmsErrorInCents, 3).paddedLeft(' ', 11)
+            << String(r.sweepSeconds, 1).paddedLeft(' ', 9) << String(r.wallSeconds, 2).paddedLeft(' ', 8);
+        if (!r.passed)
+            out << "  FAILED " << (r.error.isNotEmpty() ? r.error : "more than " + String(toleranceInCents) + " cents off");
+        out << std::endl;
+        
+        passed = passed && r.passed;
+        vars.add(toVar(r));
+    }
+    out << std::endl;
+    return vars;
+}
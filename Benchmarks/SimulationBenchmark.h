@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    SimulationBenchmark.h
+    Created: 18 Oct 2026 11:58:36pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef SIMULATIONBENCHMARK_H_INCLUDED
+#define SIMULATIONBENCHMARK_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SimulatedVCO.h"
+#include <iostream>
+
+/** Runs whole sweeps of the VCOTuner against SimulatedVCOs with the typical
+    imperfections of an oscillator and its MIDI-CV interface: scale error, bow of the
+    exponential converter, slew and latency of the CV, pitch jitter and the steps of
+    the DAC. Each measured offset is compared with the one that the model settles at,
+    see SimulatedVCO::getSettledFrequency(). Unlike the other suites, this one can fail.
+ */
+class SimulationBenchmark
+{
+public:
+    struct Scenario
+    {
+        String name;
+        SimulatedVCO::Parameters parameters;
+    };
+    
+    struct Result
+    {
+        Scenario scenario;
+        
+        bool finished;              // the sweep ran to the end without errors
+        String error;               // of the tuner, if it didn't
+        int numNotes;               // that were measured
+        double maxErrorInCents;     // measured vs. settled offset, of the worst note
+        double rmsErrorInCents;     // over all notes
+        double sweepSeconds;        // of virtual time
+        double wallSeconds;         // that the sweep took to run
+        bool passed;
+    };
+    
+    /** the scenarios, in the order they are run */
+    static Array<Scenario> getScenarios();
+    
+    /** sweeps a single scenario */
+    static Result sweep(const Scenario& scenario);
+    
+    /** sweeps all scenarios, prints a table and returns the results as an array of JSON
+     objects. passed is set to false if a sweep didn't finish or an offset was off. */
+    static var run(std::ostream& out, bool& passed);
+    
+    static var toVar(const Result& result);
+};
+
+
+#endif  // SIMULATIONBENCHMARK_H_INCLUDED
@@ -0,0 +1,152 @@
+/*
+  ==============================================================================
+
+    TestSignal.cpp
+    Created: 18 Oct 2026 12:41:07am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TestSignal.h"
+
+namespace
+{
+    /** harmonics above this fraction of the sample rate are left out */
+    const double maxHarmonicFrequency = 0.45;
+    /** low notes get no more harmonics than this, so that rendering stays fast */
+    const int maxNumHarmonics = 64;
+    const double pulseWidth = 0.25;
+    const double humFrequency = 50.0;
+}
+
+String TestSignal::getName(Waveform waveform)
+{
+    switch (waveform)
+    {
+        case triangle:
+            return "triangle";
+        case saw:
+            return "saw";
+        case square:
+            return "square";
+        case pulse:
+            return "pulse";
+        case sine:
+        default:
+            return "sine";
+    }
+}
+
+String TestSignal::getName(Interference interference)
+{
+    switch (interference)
+    {
+        case whiteNoise:
+            return "noise";
+        case hum:
+            return "hum";
+        case dcOffset:
+            return "offset";
+        case noInterference:
+        default:
+            return "none";
+    }
+}
+
+TestSignal::TestSignal(Waveform waveform, double f, double sr, float amplitude)
+    : frequency(f),
+      sampleRate(sr),
+      interference(noInterference),
+      interferenceLevel(0),
+      position(0)
+{
+    const double pi = MathConstants<double>::pi;
+    const int numHarmonics = jlimit(1, maxNumHarmonics, (int) (maxHarmonicFrequency * sampleRate / frequency));
+    for (int k = 1; k <= numHarmonics; k++)
+    {
+        double sineAmplitude = 0;
+        double cosineAmplitude = 0;
+        switch (waveform)
+        {
+            case sine:
+                sineAmplitude = k == 1 ? 1.0 : 0.0;
+                break;
+            case triangle:
+                if (k % 2 == 1)
+                    sineAmplitude = (((k - 1) / 2) % 2 == 0 ? 1.0 : -1.0) * 8.0 / (pi * pi * k * k);
+                break;
+            case saw:
+                sineAmplitude = (k % 2 == 1 ? 1.0 : -1.0) * 2.0 / (pi * k);
+                break;
+            case square:
+                if (k % 2 == 1)
+                    sineAmplitude = 4.0 / (pi * k);
+                break;
+            case pulse:
+            {
+                // the rising edge at phase 0
+                const double a = 2.0 / (pi * k) * sin(pi * k * pulseWidth);
+                sineAmplitude = a * sin(pi * k * pulseWidth);
+                cosineAmplitude = a * cos(pi * k * pulseWidth);
+                break;
+            }
+        }
+        
+        // Lanczos sigma factors: the truncated series would ring across the whole period
+        const double x = pi * k / (numHarmonics + 1);
+        const double sigma = sin(x) / x;
+        sineAmplitudes.add(amplitude * sigma * sineAmplitude);
+        cosineAmplitudes.add(amplitude * sigma * cosineAmplitude);
+    }
+    
+    double sumOfSquares = 0;
+    for (int k = 0; k < numHarmonics; k++)
+        sumOfSquares += 0.5 * (sineAmplitudes[k] * sineAmplitudes[k] + cosineAmplitudes[k] * cosineAmplitudes[k]);
+    rmsLevel = sqrt(sumOfSquares);
+}
+
+void TestSignal::setInterference(Interference newInterference, double signalToNoiseRatioInDecibels, int64 seed)
+{
+    interference = newInterference;
+    interferenceLevel = rmsLevel / Decibels::decibelsToGain(signalToNoiseRatioInDecibels, -1000.0);
+    random.setSeed(seed);
+}
+
+void TestSignal::render(float* samples, int numSamples)
+{
+    const double twoPi = MathConstants<double>::twoPi;
+    for (int i = 0; i < numSamples; i++)
+    {
+        // the phase is calculated from the sample position, so it doesn't drift
+        const double cycles = (double) (position + i) * frequency / sampleRate;
+        const double phase = twoPi * (cycles - std::floor(cycles));
+        double sum = 0;
+        for (int k = 0; k < sineAmplitudes.size(); k++)
+        {
+            const double harmonicPhase = (k + 1) * phase;
+            sum += sineAmplitudes.getUnchecked(k) * sin(harmonicPhase);
+            if (cosineAmplitudes.getUnchecked(k) != 0)
+                sum += cosineAmplitudes.getUnchecked(k) * cos(harmonicPhase);
+        }
+        
+        if (interference == whiteNoise)
+        {
+            // gaussian (Box-Muller)
+            const double u1 = jmax(1e-12, random.nextDouble());
+            const double u2 = random.nextDouble();
+            sum += interferenceLevel * sqrt(-2.0 * log(u1)) * cos(twoPi * u2);
+        }
+        else if (interference == hum)
+        {
+            sum += interferenceLevel * MathConstants<double>::sqrt2 * sin(twoPi * humFrequency * (double) (position + i) / sampleRate);
+        }
+        else if (interference == dcOffset)
+        {
+            sum += interferenceLevel;
+        }
+        samples[i] = (float) sum;
+    }
+    position += numSamples;
+}
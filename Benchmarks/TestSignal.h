@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    TestSignal.h
+    Created: 18 Oct 2026 12:41:07am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef TESTSIGNAL_H_INCLUDED
+#define TESTSIGNAL_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** A band limited oscillator with an exactly known frequency, built from its
+    harmonics. The rising zero crossing of the fundamental is at phase 0, so
+    every waveform crosses zero once per period. The harmonics are faded out
+    towards the top, so there is no ringing around the edges.
+ */
+class TestSignal
+{
+public:
+    enum Waveform
+    {
+        sine = 0,
+        triangle,
+        saw,
+        square,
+        pulse // 25% duty cycle, without its DC offset
+    };
+    static const int numWaveforms = 5;
+    
+    enum Interference
+    {
+        noInterference = 0,
+        whiteNoise,
+        hum, // 50 Hz mains hum
+        dcOffset // a constant offset, e.g. of an oscillator that isn't AC coupled
+    };
+    
+    static String getName(Waveform waveform);
+    static String getName(Interference interference);
+    
+    TestSignal(Waveform waveform, double frequency, double sampleRate, float amplitude = 0.5f);
+    
+    /** the exact period length in samples */
+    double getPeriodLength() const { return sampleRate / frequency; }
+    
+    /** adds noise, hum or an offset at the given signal to noise ratio (RMS) to the rendered samples.
+     The noise is the same sequence every time for the same seed. */
+    void setInterference(Interference interference, double signalToNoiseRatioInDecibels, int64 seed = 1);
+    
+    /** renders the next samples */
+    void render(float* samples, int numSamples);
+    
+private:
+    const double frequency;
+    const double sampleRate;
+    double rmsLevel;
+    
+    Interference interference;
+    double interferenceLevel; // RMS
+    Random random;
+    
+    /** sine and cosine amplitudes of the harmonics (the fundamental first) */
+    Array<double> sineAmplitudes;
+    Array<double> cosineAmplitudes;
+    int64 position;
+};
+
+
+#endif  // TESTSIGNAL_H_INCLUDED
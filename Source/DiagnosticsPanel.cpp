@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    DiagnosticsPanel.cpp
+    Created: 17 Oct 2026 6:48:21pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "DiagnosticsPanel.h"
+
+namespace
+{
+    const int refreshIntervalMs = 500;
+    const int histogramWidth = 45;
+    
+    String formatSeconds(double ms)
+    {
+        return String(ms / 1000.0, 1) + "s";
+    }
+}
+
+DiagnosticsPanel::DiagnosticsPanel(VCOTuner& t)
+: tuner(t)
+{
+    telemetry = tuner.getTelemetry();
+    setMouseCursor(MouseCursor::PointingHandCursor);
+    startTimer(refreshIntervalMs);
+}
+
+DiagnosticsPanel::~DiagnosticsPanel()
+{
+    stopTimer();
+}
+
+void DiagnosticsPanel::timerCallback()
+{
+    if (!isShowing())
+        return;
+    
+    telemetry = tuner.getTelemetry();
+    repaint();
+}
+
+void DiagnosticsPanel::paint(Graphics& g)
+{
+    const bool problems = telemetry.numOverruns > 0 || telemetry.numXRuns > 0 || telemetry.numOverflows > 0;
+    
+    // histogram of the callback durations, with the overruns in red
+    Rectangle<int> area = getLocalBounds().reduced(2);
+    const Rectangle<int> histogramArea = area.removeFromRight(histogramWidth);
+    const float barWidth = histogramArea.getWidth() / (float) TunerTelemetry::numLoadBins;
+    int64 maxCount = 1;
+    for (int i = 0; i < TunerTelemetry::numLoadBins; i++)
+        maxCount = jmax(maxCount, telemetry.loadHistogram[i]);
+    for (int i = 0; i < TunerTelemetry::numLoadBins; i++)
+    {
+        if (telemetry.loadHistogram[i] == 0)
+            continue;
+        
+        // logarithmic, so that a few slow callbacks are still visible
+        const float height = histogramArea.getHeight() * (float) (log(1.0 + telemetry.loadHistogram[i]) / log(1.0 + maxCount));
+        g.setColour(TunerTelemetry::getLoadBinEnd(i) > 1.0 ? Colours::red : Colours::darkgrey);
+        g.fillRect(histogramArea.getX() + i * barWidth, histogramArea.getBottom() - jmax(1.0f, height),
+                   jmax(1.0f, barWidth - 1.0f), jmax(1.0f, height));
+    }
+    
+    double lockMs = 0, settleMs = 0, collectMs = 0;
+    for (const TunerTelemetry::NoteTiming& note : telemetry.notes)
+    {
+        lockMs += note.lockMs;
+        settleMs += note.settleMs;
+        collectMs += note.collectMs;
+    }
+    
+    String text;
+    text << "CPU max " << String(roundToInt(telemetry.maxLoad * 100.0)) << "%";
+    if (telemetry.numXRuns >= 0)
+        text << ", " << String(telemetry.numXRuns) << " xruns";
+    if (telemetry.numOverflows > 0)
+        text << ", " << String(telemetry.numOverflows) << " overflows";
+    if (!telemetry.notes.isEmpty())
+        text << ", lock/settle/collect " << formatSeconds(lockMs) << "/" << formatSeconds(settleMs) << "/" << formatSeconds(collectMs);
+    
+    g.setColour(problems ? Colours::darkred : Colours::black);
+    g.setFont(12.0f);
+    g.drawFittedText(text, area.withTrimmedRight(4), Justification::centredRight, 1, 0.8f);
+}
+
+void DiagnosticsPanel::mouseUp(const MouseEvent& e)
+{
+    if (!e.mouseWasClicked())
+        return;
+    
+    telemetry = tuner.getTelemetry();
+    repaint();
+    
+    std::unique_ptr<TextEditor> details = std::make_unique<TextEditor>("Diagnostics");
+    details->setMultiLine(true);
+    details->setReadOnly(true);
+    details->setScrollbarsShown(true);
+    details->setFont(Font(Font::getDefaultMonospacedFontName(), 12.0f, Font::plain));
+    details->setText(telemetry.getDescription(), false);
+    details->setSize(520, 320);
+    
+    CallOutBox::launchAsynchronously(std::move(details), getScreenBounds(), nullptr);
+}
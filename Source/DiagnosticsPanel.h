@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+
+    DiagnosticsPanel.h
+    Created: 17 Oct 2026 6:48:21pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef DIAGNOSTICSPANEL_H_INCLUDED
+#define DIAGNOSTICSPANEL_H_INCLUDED
+
+#include "VCOTuner.h"
+
+/** Shows the performance counters of a tuner in a single line: the longest audio callback,
+    the xruns and where the time of the measured notes went, with a small histogram of the
+    callback durations. Clicking it opens the full report.
+ */
+class DiagnosticsPanel: public Component,
+                        private Timer
+{
+public:
+    DiagnosticsPanel(VCOTuner& t);
+    ~DiagnosticsPanel() override;
+    
+    void paint(Graphics& g) override;
+    void mouseUp(const MouseEvent& e) override;
+    
+private:
+    void timerCallback() override;
+    
+    VCOTuner& tuner;
+    TunerTelemetry::Snapshot telemetry;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DiagnosticsPanel)
+};
+
+
+#endif  // DIAGNOSTICSPANEL_H_INCLUDED
@@ -0,0 +1,478 @@
+/*
+  ==============================================================================
+
+    FleetAnalytics.cpp
+    Created: 18 Oct 2026 4:12:05pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "FleetAnalytics.h"
+#include "RunningStatistics.h"
+
+namespace
+{
+    /** each job summarises this many sweeps at most, so that the cores are kept busy
+     even when some sweeps are much longer than others */
+    const int maxNumSweepsPerJob = 64;
+    
+    String getGroupName(const SweepArchive::Info& info, FleetAnalytics::Grouping grouping)
+    {
+        String name;
+        switch (grouping)
+        {
+            case FleetAnalytics::byInterface:
+                name = (info.interfaceBrand.trim() + " " + info.interfaceDevice.trim()).trim();
+                break;
+            case FleetAnalytics::byMidiOutput:
+                name = info.midiOutput;
+                break;
+            case FleetAnalytics::byAudioDevice:
+                name = info.audioDevice;
+                break;
+            default:
+                name = info.getDutModel();
+                break;
+        }
+        return name.isNotEmpty() ? name : "(unknown)";
+    }
+}
+
+//==============================================================================
+class FleetAnalytics::SummaryJob: public ThreadPoolJob
+{
+public:
+    SummaryJob(const Array<SweepArchive::Sweep>& s, Array<Array<Summary>>& r, int first, int last)
+    : ThreadPoolJob("Fleet analytics"), sweeps(s), results(r), firstSweep(first), lastSweep(last)
+    {
+    }
+    
+    JobStatus runJob() override
+    {
+        // every job writes its own elements of the results, which were allocated before
+        for (int i = firstSweep; i < lastSweep; i++)
+            summarise(sweeps.getReference(i), i, results.getReference(i));
+        return jobHasFinished;
+    }
+    
+private:
+    const Array<SweepArchive::Sweep>& sweeps;
+    Array<Array<Summary>>& results;
+    int firstSweep;
+    int lastSweep;
+};
+
+//==============================================================================
+FleetAnalytics::FleetAnalytics(const SweepArchive& a)
+: archive(a), pool(SystemStats::getNumCpus())
+{
+}
+
+FleetAnalytics::~FleetAnalytics()
+{
+    pool.removeAllJobs(true, 10000);
+}
+
+String FleetAnalytics::getGroupingName(Grouping grouping)
+{
+    switch (grouping)
+    {
+        case byInterface:
+            return "Interface";
+        case byMidiOutput:
+            return "MIDI output";
+        case byAudioDevice:
+            return "Audio device";
+        default:
+            return "DUT model";
+    }
+}
+
+String FleetAnalytics::getOscillatorKey(const SweepArchive::Info& info, int lane)
+{
+    return info.getDutModel().toLowerCase() + "\n" + info.serialNumber.trim().toLowerCase() + "\n" + String(lane);
+}
+
+//==============================================================================
+void FleetAnalytics::summarise(const SweepArchive::Sweep& sweep, int index, Array<Summary>& summaries)
+{
+    const int numMeasurements = sweep.getNumMeasurements();
+    const int32* lanes = sweep.getLanes();
+    const int32* midiPitches = sweep.getMidiPitches();
+    const double* offsets = sweep.getColumn(SweepArchive::Sweep::pitchOffset);
+    
+    int numLanes = 0;
+    for (int i = 0; i < numMeasurements; i++)
+        numLanes = jmax(numLanes, (int) lanes[i] + 1);
+    numLanes = jmin(numLanes, (int) VCOTuner::maxNumLanes);
+    
+    for (int lane = 0; lane < numLanes; lane++)
+    {
+        Summary summary;
+        summary.sweep = index;
+        summary.lane = lane;
+        summary.timeMs = sweep.getInfo().time.toMilliseconds();
+        summary.oscillator = getOscillatorKey(sweep.getInfo(), lane);
+        for (int note = 0; note < numNotes; note++)
+            summary.offsets[note] = std::numeric_limits<double>::quiet_NaN();
+        
+        // if a note was measured more than once, the last result counts, as in the Visualizer
+        for (int i = 0; i < numMeasurements; i++)
+        {
+            if (lanes[i] == lane && midiPitches[i] >= 0 && midiPitches[i] < numNotes)
+                summary.offsets[midiPitches[i]] = offsets[i];
+        }
+        
+        // the least squares line through the offsets gives the scaling error
+        double n = 0, sumX = 0, sumY = 0, sumXX = 0, sumXY = 0;
+        for (int note = 0; note < numNotes; note++)
+        {
+            const double y = summary.offsets[note];
+            if (std::isnan(y))
+                continue;
+            n++;
+            sumX += note;
+            sumY += y;
+            sumXX += note * (double) note;
+            sumXY += note * y;
+        }
+        if (n == 0)
+            continue;
+        
+        const double mean = sumY / n;
+        double sumOfSquares = 0;
+        for (int note = 0; note < numNotes; note++)
+        {
+            if (!std::isnan(summary.offsets[note]))
+                sumOfSquares += (summary.offsets[note] - mean) * (summary.offsets[note] - mean);
+        }
+        const double denominator = n * sumXX - sumX * sumX;
+        summary.numMeasuredNotes = (int) n;
+        summary.trackingError = sqrt(sumOfSquares / n);
+        summary.scaleError = denominator > 0 ? 12.0 * (n * sumXY - sumX * sumY) / denominator : 0.0;
+        summaries.add(summary);
+    }
+}
+
+Array<SweepArchive::Sweep> FleetAnalytics::getSweeps(const Array<int>& indices) const
+{
+    Array<SweepArchive::Sweep> sweeps;
+    sweeps.ensureStorageAllocated(indices.size());
+    for (int index : indices)
+        sweeps.add(archive.getSweep(index));
+    return sweeps;
+}
+
+Array<FleetAnalytics::Summary> FleetAnalytics::summariseAll(const Array<SweepArchive::Sweep>& sweeps) const
+{
+    Array<Array<Summary>> results;
+    results.resize(sweeps.size());
+    
+    const int numJobs = jmin(jmax(1, pool.getNumThreads()) * 4, (sweeps.size() + 1) / 2);
+    const int sweepsPerJob = numJobs > 0 ? jmin(maxNumSweepsPerJob, (sweeps.size() + numJobs - 1) / numJobs) : 0;
+    OwnedArray<SummaryJob> jobs;
+    for (int first = 0; first < sweeps.size(); first += sweepsPerJob)
+    {
+        SummaryJob* job = jobs.add(new SummaryJob(sweeps, results, first, jmin(sweeps.size(), first + sweepsPerJob)));
+        pool.addJob(job, false);
+    }
+    for (SummaryJob* job : jobs)
+        pool.waitForJobToFinish(job, -1);
+    
+    Array<Summary> summaries;
+    for (const Array<Summary>& sweepSummaries : results)
+        summaries.addArray(sweepSummaries);
+    return summaries;
+}
+
+Array<FleetAnalytics::Summary> FleetAnalytics::getLatestOfEachOscillator(const Array<Summary>& summaries)
+{
+    Array<Summary> latest;
+    HashMap<String, int> indexOfOscillator;
+    for (const Summary& summary : summaries)
+    {
+        if (!indexOfOscillator.contains(summary.oscillator))
+        {
+            indexOfOscillator.set(summary.oscillator, latest.size());
+            latest.add(summary);
+        }
+        else if (summary.timeMs >= latest.getReference(indexOfOscillator[summary.oscillator]).timeMs)
+            latest.set(indexOfOscillator[summary.oscillator], summary);
+    }
+    return latest;
+}
+
+Array<FleetAnalytics::Summary> FleetAnalytics::getSummariesBetween(const Array<Summary>& summaries, Time from, Time to)
+{
+    Array<Summary> between;
+    for (const Summary& summary : summaries)
+    {
+        if ((from == Time() || summary.timeMs >= from.toMilliseconds())
+            && (to == Time() || summary.timeMs <= to.toMilliseconds()))
+            between.add(summary);
+    }
+    return between;
+}
+
+//==============================================================================
+Array<FleetAnalytics::NoteStatistics> FleetAnalytics::getNoteStatistics(const SweepArchive::Query& query, bool perOscillator) const
+{
+    return getNoteStatistics(summariseAll(getSweeps(archive.find(query))), perOscillator);
+}
+
+Array<FleetAnalytics::NoteStatistics> FleetAnalytics::getNoteStatistics(const Array<Summary>& summaries, bool perOscillator)
+{
+    const Array<Summary> values = perOscillator ? getLatestOfEachOscillator(summaries) : summaries;
+    
+    RunningStatistics statistics[numNotes];
+    double minimum[numNotes], maximum[numNotes];
+    for (const Summary& summary : values)
+    {
+        for (int note = 0; note < numNotes; note++)
+        {
+            const double offset = summary.offsets[note];
+            if (std::isnan(offset))
+                continue;
+            
+            if (statistics[note].getNumValues() == 0)
+                minimum[note] = maximum[note] = offset;
+            statistics[note].add(offset);
+            minimum[note] = jmin(minimum[note], offset);
+            maximum[note] = jmax(maximum[note], offset);
+        }
+    }
+    
+    Array<NoteStatistics> notes;
+    for (int note = 0; note < numNotes; note++)
+    {
+        if (statistics[note].getNumValues() == 0)
+            continue;
+        
+        NoteStatistics s;
+        s.midiPitch = note;
+        s.numValues = statistics[note].getNumValues();
+        s.mean = statistics[note].getMean();
+        s.standardDeviation = sqrt(statistics[note].getVariance());
+        s.min = minimum[note];
+        s.max = maximum[note];
+        notes.add(s);
+    }
+    return notes;
+}
+
+Array<Array<VCOTuner::measurement_t>> FleetAnalytics::getLatestResults(const SweepArchive::Query& query) const
+{
+    return getLatestResults(summariseAll(getSweeps(archive.find(query))));
+}
+
+Array<Array<VCOTuner::measurement_t>> FleetAnalytics::getLatestResults(const Array<Summary>& summaries)
+{
+    Array<Array<VCOTuner::measurement_t>> results;
+    for (const Summary& summary : getLatestOfEachOscillator(summaries))
+    {
+        Array<VCOTuner::measurement_t> sweep;
+        for (int note = 0; note < numNotes; note++)
+        {
+            if (std::isnan(summary.offsets[note]))
+                continue;
+            
+            VCOTuner::measurement_t m = {};
+            m.lane = 0;
+            m.midiPitch = note;
+            m.pitchOffset = summary.offsets[note];
+            m.rawPitchOffset = m.pitchOffset;
+            m.pitch = note + m.pitchOffset;
+            m.frequency = 440.0 * pow(2.0, (m.pitch - 69.0) / 12.0);
+            m.rawFrequency = m.frequency;
+            sweep.add(m);
+        }
+        results.add(sweep);
+    }
+    return results;
+}
+
+Array<FleetAnalytics::Drift> FleetAnalytics::getDrift(const SweepArchive::Query& query, Time first, Time second) const
+{
+    if (second < first)
+        std::swap(first, second);
+    
+    SweepArchive::Query untilSecond(query);
+    untilSecond.from = Time();
+    untilSecond.to = second;
+    const Array<SweepArchive::Sweep> sweeps = getSweeps(archive.find(untilSecond));
+    return getDrift(sweeps, summariseAll(sweeps), first, second);
+}
+
+Array<FleetAnalytics::Drift> FleetAnalytics::getDrift(const Array<SweepArchive::Sweep>& sweeps, const Array<Summary>& summaries,
+                                                      Time first, Time second)
+{
+    // oldest first, so the latest sweep on each side is the last one that is seen
+    HashMap<String, int> before, after;
+    for (int i = 0; i < summaries.size(); i++)
+    {
+        if (summaries.getReference(i).timeMs <= first.toMilliseconds())
+            before.set(summaries.getReference(i).oscillator, i);
+        else
+            after.set(summaries.getReference(i).oscillator, i);
+    }
+    
+    Array<Drift> drifts;
+    for (HashMap<String, int>::Iterator it(after); it.next();)
+    {
+        if (!before.contains(it.getKey()))
+            continue;
+        
+        const Summary& old = summaries.getReference(before[it.getKey()]);
+        const Summary& current = summaries.getReference(it.getValue());
+        RunningStatistics changes;
+        double maxChange = 0;
+        for (int note = 0; note < numNotes; note++)
+        {
+            const double change = current.offsets[note] - old.offsets[note];
+            if (std::isnan(change))
+                continue;
+            changes.add(change);
+            if (std::abs(change) > std::abs(maxChange))
+                maxChange = change;
+        }
+        if (changes.getNumValues() == 0)
+            continue;
+        
+        const SweepArchive::Info& info = sweeps.getReference(current.sweep).getInfo();
+        Drift drift;
+        drift.dutModel = info.getDutModel();
+        drift.serialNumber = info.serialNumber;
+        drift.lane = current.lane;
+        drift.before = Time(old.timeMs);
+        drift.after = Time(current.timeMs);
+        drift.numNotes = changes.getNumValues();
+        drift.meanChange = changes.getMean();
+        drift.maxChange = maxChange;
+        drifts.add(drift);
+    }
+    
+    // the HashMap has no order, so ties are broken by the oscillator
+    std::sort(drifts.begin(), drifts.end(), [] (const Drift& a, const Drift& b)
+    {
+        if (std::abs(a.meanChange) != std::abs(b.meanChange))
+            return std::abs(a.meanChange) > std::abs(b.meanChange);
+        if (a.dutModel != b.dutModel)
+            return a.dutModel < b.dutModel;
+        if (a.serialNumber != b.serialNumber)
+            return a.serialNumber < b.serialNumber;
+        return a.lane < b.lane;
+    });
+    return drifts;
+}
+
+FleetAnalytics::Comparison FleetAnalytics::compareTrackingError(const SweepArchive::Query& query, Grouping grouping) const
+{
+    const Array<SweepArchive::Sweep> sweeps = getSweeps(archive.find(query));
+    return compareTrackingError(sweeps, summariseAll(sweeps), grouping);
+}
+
+FleetAnalytics::Comparison FleetAnalytics::compareTrackingError(const Array<SweepArchive::Sweep>& sweeps, const Array<Summary>& summaries,
+                                                                Grouping grouping)
+{
+    // the groups are in the order in which they first appear
+    StringArray names;
+    Array<RunningStatistics> trackingErrors;
+    Array<RunningStatistics> scaleErrors;
+    RunningStatistics all;
+    int lastSweep = -1;
+    String name;
+    for (const Summary& summary : summaries)
+    {
+        // the lanes of a sweep follow each other
+        if (summary.sweep != lastSweep)
+        {
+            name = getGroupName(sweeps.getReference(summary.sweep).getInfo(), grouping);
+            lastSweep = summary.sweep;
+        }
+        int group = names.indexOf(name);
+        if (group < 0)
+        {
+            group = names.size();
+            names.add(name);
+            trackingErrors.add(RunningStatistics());
+            scaleErrors.add(RunningStatistics());
+        }
+        trackingErrors.getReference(group).add(summary.trackingError);
+        scaleErrors.getReference(group).add(summary.scaleError);
+        all.add(summary.trackingError);
+    }
+    
+    Comparison comparison;
+    double sumOfSquaresBetween = 0;
+    for (int i = 0; i < names.size(); i++)
+    {
+        const RunningStatistics& s = trackingErrors.getReference(i);
+        Group group;
+        group.name = names[i];
+        group.numValues = s.getNumValues();
+        group.meanTrackingError = s.getMean();
+        group.trackingErrorDeviation = sqrt(s.getVariance());
+        group.meanScaleError = scaleErrors.getReference(i).getMean();
+        comparison.groups.add(group);
+        
+        sumOfSquaresBetween += s.getNumValues() * (s.getMean() - all.getMean()) * (s.getMean() - all.getMean());
+    }
+    const double sumOfSquaresTotal = all.getVariance() * (all.getNumValues() - 1);
+    comparison.varianceExplained = sumOfSquaresTotal > 0 ? jlimit(0.0, 1.0, sumOfSquaresBetween / sumOfSquaresTotal) : 0.0;
+    
+    std::stable_sort(comparison.groups.begin(), comparison.groups.end(), [] (const Group& a, const Group& b)
+    {
+        return a.meanTrackingError < b.meanTrackingError;
+    });
+    return comparison;
+}
+
+Array<SweepArchive::Sweep> FleetAnalytics::getSweepsForOverview(const SweepArchive::Query& query) const
+{
+    // the drift looks further back than the query
+    SweepArchive::Query allTimes(query);
+    allTimes.from = Time();
+    allTimes.to = Time();
+    return getSweeps(archive.find(allTimes));
+}
+
+FleetAnalytics::Overview FleetAnalytics::getOverview(const Array<SweepArchive::Sweep>& sweeps, const SweepArchive::Query& query,
+                                                     bool perOscillator, Time first, Time second, Grouping grouping) const
+{
+    const Array<Summary> summaries = summariseAll(sweeps);
+    const Array<Summary> selected = getSummariesBetween(summaries, query.from, query.to);
+    
+    Overview overview;
+    overview.notes = getNoteStatistics(selected, perOscillator);
+    overview.latestResults = getLatestResults(selected);
+    if (first != Time() && second != Time())
+    {
+        if (second < first)
+            std::swap(first, second);
+        overview.drifts = getDrift(sweeps, getSummariesBetween(summaries, Time(), second), first, second);
+    }
+    overview.comparison = compareTrackingError(sweeps, selected, grouping);
+    return overview;
+}
+
+Array<VCOTuner::measurement_t> FleetAnalytics::toMeasurements(const Array<NoteStatistics>& statistics, int lane)
+{
+    Array<VCOTuner::measurement_t> results;
+    for (const NoteStatistics& s : statistics)
+    {
+        VCOTuner::measurement_t m = {};
+        m.lane = lane;
+        m.midiPitch = s.midiPitch;
+        m.pitchOffset = s.mean;
+        m.rawPitchOffset = m.pitchOffset;
+        m.pitchDeviation = s.standardDeviation;
+        m.pitch = s.midiPitch + s.mean;
+        m.frequency = 440.0 * pow(2.0, (m.pitch - 69.0) / 12.0);
+        m.rawFrequency = m.frequency;
+        m.numMeasurements = s.numValues;
+        results.add(m);
+    }
+    return results;
+}
@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    FleetAnalytics.h
+    Created: 18 Oct 2026 4:12:05pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef FLEETANALYTICS_H_INCLUDED
+#define FLEETANALYTICS_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SweepArchive.h"
+
+/** Answers questions about all the oscillators in a SweepArchive: how much the notes of a
+    DUT model vary between its units, which units drifted between two dates, and whether
+    the interface (or another device) makes a difference to the tracking error.
+    
+    An oscillator is one input of one unit, i.e. a DUT model, a serial number and a lane.
+    Sweeps without a serial number are taken as one unit of their model.
+    
+    The selected sweeps are first summarised in parallel, on as many threads as there are
+    cores: each scan reads the offsets of one sweep out of the mapped file. The summaries
+    are then combined on the calling thread, in the order of the archive, so that the
+    results don't depend on the number of threads. The archive must not be changed while
+    a query runs.
+    
+    getOverview() answers all the questions at once from a single scan. It doesn't use the
+    archive itself, so that it can run on a background thread.
+ */
+class FleetAnalytics
+{
+public:
+    FleetAnalytics(const SweepArchive& archive);
+    ~FleetAnalytics();
+    
+    /** the pitch offsets of one note, all in semitones like VCOTuner::measurement_t */
+    struct NoteStatistics
+    {
+        int midiPitch;
+        int numValues;
+        double mean;
+        double standardDeviation; // between the values, not the deviation of a measurement
+        double min;
+        double max;
+    };
+    /** one value per oscillator from its latest sweep, or one per sweep if perOscillator
+     is false. Only the notes that were measured at least once are returned, in ascending order. */
+    Array<NoteStatistics> getNoteStatistics(const SweepArchive::Query& query, bool perOscillator) const;
+    /** the results of the latest sweep of each oscillator, all on lane 0 */
+    Array<Array<VCOTuner::measurement_t>> getLatestResults(const SweepArchive::Query& query) const;
+    
+    /** the change of one oscillator between two sweeps */
+    struct Drift
+    {
+        String dutModel;
+        String serialNumber;
+        int lane;
+        Time before; // the start of the two sweeps
+        Time after;
+        int numNotes; // that were measured in both
+        double meanChange; // in semitones, positive if it got sharper
+        double maxChange; // the largest change of a single note, either way
+    };
+    /** compares the latest sweep of each oscillator up to the first time with its latest
+     sweep up to the second one. The time range of the query is ignored. Oscillators
+     without a sweep on both sides are left out, the others are sorted by how far they
+     have drifted, the largest first. */
+    Array<Drift> getDrift(const SweepArchive::Query& query, Time first, Time second) const;
+    
+    enum Grouping
+    {
+        byInterface = 0,
+        byMidiOutput,
+        byAudioDevice,
+        byDutModel,
+        numGroupings
+    };
+    static String getGroupingName(Grouping grouping);
+    
+    /** the tracking error of the sweeps of one group */
+    struct Group
+    {
+        String name;
+        int numValues; // one per lane of each sweep
+        /** the RMS of the pitch offsets around their mean, i.e. the error that is left
+         after the oscillator was tuned at the best note */
+        double meanTrackingError;
+        double trackingErrorDeviation;
+        /** the slope of the pitch offsets, in semitones per octave */
+        double meanScaleError;
+    };
+    struct Comparison
+    {
+        Array<Group> groups; // the smallest tracking error first
+        /** the share of the variance of the tracking error that is explained by the groups
+         (eta squared), from 0 (no difference) to 1 (all of it) */
+        double varianceExplained;
+    };
+    Comparison compareTrackingError(const SweepArchive::Query& query, Grouping grouping) const;
+    
+    /** the results of all the queries above */
+    struct Overview
+    {
+        Array<NoteStatistics> notes;
+        Array<Array<VCOTuner::measurement_t>> latestResults;
+        Array<Drift> drifts; // empty if the times weren't given
+        Comparison comparison;
+    };
+    /** the sweeps that getOverview() needs for a query. This is the only part that uses the
+     archive, so it must be called on the thread that adds to it. */
+    Array<SweepArchive::Sweep> getSweepsForOverview(const SweepArchive::Query& query) const;
+    /** answers the queries above from the sweeps of getSweepsForOverview(), which are only
+     scanned once. Can be called on any thread. The drift is only compared if both times
+     are given. */
+    Overview getOverview(const Array<SweepArchive::Sweep>& sweeps, const SweepArchive::Query& query,
+                         bool perOscillator, Time first, Time second, Grouping grouping) const;
+    
+    /** the statistics as results that a Visualizer can show: the mean as the pitch offset
+     and the standard deviation as the deviation */
+    static Array<VCOTuner::measurement_t> toMeasurements(const Array<NoteStatistics>& statistics, int lane = 0);
+    
+private:
+    static const int numNotes = 128;
+    
+    /** one lane of a sweep */
+    struct Summary
+    {
+        int sweep; // the index in the summarised sweeps
+        int lane;
+        int64 timeMs;
+        String oscillator; // the key of the oscillator, see getOscillatorKey()
+        double offsets[numNotes]; // NaN for the notes that weren't measured
+        int numMeasuredNotes;
+        double trackingError;
+        double scaleError;
+    };
+    static String getOscillatorKey(const SweepArchive::Info& info, int lane);
+    static void summarise(const SweepArchive::Sweep& sweep, int index, Array<Summary>& summaries);
+    
+    /** the views of the sweeps with these indices. The archive itself isn't safe to use
+     from other threads, the views are. */
+    Array<SweepArchive::Sweep> getSweeps(const Array<int>& indices) const;
+    /** the summaries of the sweeps, in their order */
+    Array<Summary> summariseAll(const Array<SweepArchive::Sweep>& sweeps) const;
+    /** the latest summary of each oscillator, in the order of their first appearance */
+    static Array<Summary> getLatestOfEachOscillator(const Array<Summary>& summaries);
+    /** the summaries of the sweeps that were started within the range, Time() is open ended */
+    static Array<Summary> getSummariesBetween(const Array<Summary>& summaries, Time from, Time to);
+    
+    /** the queries on summaries, oldest first */
+    static Array<NoteStatistics> getNoteStatistics(const Array<Summary>& summaries, bool perOscillator);
+    static Array<Array<VCOTuner::measurement_t>> getLatestResults(const Array<Summary>& summaries);
+    /** the first time must not be after the second, and the summaries must not go beyond it */
+    static Array<Drift> getDrift(const Array<SweepArchive::Sweep>& sweeps, const Array<Summary>& summaries, Time first, Time second);
+    static Comparison compareTrackingError(const Array<SweepArchive::Sweep>& sweeps, const Array<Summary>& summaries, Grouping grouping);
+    
+    class SummaryJob;
+    
+    const SweepArchive& archive;
+    mutable ThreadPool pool;
+    
+    JUCE_DECLARE_NON_COPYABLE(FleetAnalytics)
+};
+
+
+#endif  // FLEETANALYTICS_H_INCLUDED
@@ -0,0 +1,280 @@
+/*
+  ==============================================================================
+
+    FleetWindow.cpp
+    Created: 18 Oct 2026 5:03:44pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "FleetWindow.h"
+
+namespace
+{
+    /** the latest sweeps of this many oscillators are drawn behind the statistics */
+    const int maxNumOscillatorsShown = 200;
+    /** the drift is compared over this time by default */
+    const int defaultDriftDays = 30;
+    const int numDriftsShown = 20;
+    /** each oscillator is compared as it was at the end of both days */
+    const RelativeTime endOfDay = RelativeTime::days(1) - RelativeTime::milliseconds(1);
+    
+    String formatCents(double semitones)
+    {
+        return String(semitones * 100.0, 1);
+    }
+    
+    String formatSignedCents(double semitones)
+    {
+        return (semitones >= 0 ? "+" : "") + formatCents(semitones);
+    }
+    
+    String formatDate(const Time& time)
+    {
+        return time.formatted("%Y-%m-%d");
+    }
+}
+
+FleetWindow::FleetWindow(VCOTuner* t)
+: analytics(getSweepArchive()),
+  updatePool(1),
+  display(t)
+{
+    numUpdates = 0;
+    
+    modelLabel.setText("DUT model: ", dontSendNotification);
+    modelLabel.setJustificationType(Justification::centredRight);
+    addAndMakeVisible(&modelLabel);
+    
+    model.addListener(this);
+    addAndMakeVisible(&model);
+    
+    perOscillator.setButtonText("Latest sweep of each unit only");
+    perOscillator.setToggleState(true, dontSendNotification);
+    perOscillator.addListener(this);
+    addAndMakeVisible(&perOscillator);
+    
+    groupingLabel.setText("Compare: ", dontSendNotification);
+    groupingLabel.setJustificationType(Justification::centredRight);
+    addAndMakeVisible(&groupingLabel);
+    
+    for (int i = 0; i < FleetAnalytics::numGroupings; i++)
+        grouping.addItem(FleetAnalytics::getGroupingName((FleetAnalytics::Grouping) i), i + 1);
+    grouping.setSelectedId(FleetAnalytics::byInterface + 1, dontSendNotification);
+    grouping.addListener(this);
+    addAndMakeVisible(&grouping);
+    
+    driftLabel.setText("Drift from/to: ", dontSendNotification);
+    driftLabel.setJustificationType(Justification::centredRight);
+    addAndMakeVisible(&driftLabel);
+    
+    const Time now = Time::getCurrentTime();
+    driftFrom.setText(formatDate(now - RelativeTime::days(defaultDriftDays)), false);
+    driftTo.setText(formatDate(now), false);
+    addAndMakeVisible(&driftFrom);
+    addAndMakeVisible(&driftTo);
+    
+    refresh.setButtonText("Update");
+    refresh.addListener(this);
+    addAndMakeVisible(&refresh);
+    
+    addAndMakeVisible(&display);
+    
+    summary.setMultiLine(true);
+    summary.setReadOnly(true);
+    summary.setScrollbarsShown(true);
+    summary.setFont(Font(Font::getDefaultMonospacedFontName(), 12.0f, Font::plain));
+    summary.setText("Reading the archive ...", false);
+    addAndMakeVisible(&summary);
+    
+    setSize(800, 700);
+    updateModels();
+    update();
+}
+
+FleetWindow::~FleetWindow()
+{
+    // the running update uses the analytics
+    updatePool.removeAllJobs(false, -1);
+}
+
+void FleetWindow::resized()
+{
+    const int borderWidth = 10;
+    const int height = 20;
+    
+    int y = borderWidth;
+    modelLabel.setBounds(borderWidth, y, 80, height);
+    model.setBounds(modelLabel.getRight(), y, 220, height);
+    perOscillator.setBounds(model.getRight() + borderWidth, y, 220, height);
+    refresh.setBounds(getWidth() - borderWidth - 100, y, 100, height);
+    
+    y += height + borderWidth;
+    groupingLabel.setBounds(borderWidth, y, 80, height);
+    grouping.setBounds(groupingLabel.getRight(), y, 220, height);
+    driftLabel.setBounds(grouping.getRight() + borderWidth, y, 100, height);
+    driftFrom.setBounds(driftLabel.getRight(), y, 90, height);
+    driftTo.setBounds(driftFrom.getRight() + borderWidth, y, 90, height);
+    
+    y += height + borderWidth;
+    const int displayHeight = (getHeight() - y - 2 * borderWidth) / 2;
+    display.setBounds(borderWidth, y, getWidth() - 2 * borderWidth, displayHeight);
+    summary.setBounds(borderWidth, display.getBottom() + borderWidth,
+                      getWidth() - 2 * borderWidth, getHeight() - display.getBottom() - 2 * borderWidth);
+}
+
+void FleetWindow::paint(Graphics& g)
+{
+    g.fillAll(Colours::lightgrey);
+}
+
+void FleetWindow::buttonClicked (Button* bttn)
+{
+    // new sweeps may have been added since
+    if (bttn == &refresh)
+        updateModels();
+    update();
+}
+
+void FleetWindow::comboBoxChanged (ComboBox*)
+{
+    update();
+}
+
+//==============================================================================
+void FleetWindow::updateModels()
+{
+    const String selected = model.getText();
+    model.clear(dontSendNotification);
+    model.addItem("All models", 1);
+    model.addItemList(getSweepArchive().getDutModels(), 2);
+    
+    model.setSelectedId(1, dontSendNotification);
+    for (int i = 1; i < model.getNumItems(); i++)
+    {
+        if (model.getItemText(i) == selected)
+            model.setSelectedItemIndex(i, dontSendNotification);
+    }
+}
+
+void FleetWindow::update()
+{
+    Settings settings;
+    if (model.getSelectedId() > 1)
+        settings.query.dutModel = model.getText();
+    settings.perOscillator = perOscillator.getToggleState();
+    settings.driftFrom = Time::fromISO8601(driftFrom.getText().trim());
+    settings.driftTo = Time::fromISO8601(driftTo.getText().trim());
+    settings.grouping = (FleetAnalytics::Grouping) (grouping.getSelectedId() - 1);
+    
+    // only the views of the sweeps are taken here, the archive isn't safe to use in the background
+    const Array<SweepArchive::Sweep> sweeps = analytics.getSweepsForOverview(settings.query);
+    const bool hasDates = settings.driftFrom != Time() && settings.driftTo != Time();
+    const Time first = hasDates ? settings.driftFrom + endOfDay : Time();
+    const Time second = hasDates ? settings.driftTo + endOfDay : Time();
+    
+    // the destructor waits for the job, so the analytics stay valid
+    const FleetAnalytics& a = analytics;
+    const int updateNumber = ++numUpdates;
+    Component::SafePointer<FleetWindow> window(this);
+    updatePool.removeAllJobs(false, 0);
+    updatePool.addJob([&a, sweeps, settings, first, second, updateNumber, window]
+    {
+        const FleetAnalytics::Overview overview = a.getOverview(sweeps, settings.query, settings.perOscillator,
+                                                                first, second, settings.grouping);
+        MessageManager::callAsync([window, overview, settings, updateNumber]
+        {
+            if (window != nullptr && updateNumber == window->numUpdates)
+                window->showOverview(overview, settings);
+        });
+    });
+}
+
+void FleetWindow::showOverview(const FleetAnalytics::Overview& overview, const Settings& settings)
+{
+    // the oscillators are drawn like previous sweeps, the statistics like the current one
+    display.clearCache();
+    display.setMaxNumPreviousSweeps(maxNumOscillatorsShown);
+    for (const Array<VCOTuner::measurement_t>& results : overview.latestResults)
+    {
+        for (const VCOTuner::measurement_t& m : results)
+            display.newMeasurementReady(m);
+        display.tunerFinished();
+    }
+    for (const VCOTuner::measurement_t& m : FleetAnalytics::toMeasurements(overview.notes))
+        display.newMeasurementReady(m);
+    
+    String text;
+    text << describeNotes(overview.notes, settings) << newLine
+         << describeDrift(overview.drifts, settings) << newLine
+         << describeTrackingError(overview.comparison, settings);
+    summary.setText(text, false);
+}
+
+String FleetWindow::describeNotes(const Array<FleetAnalytics::NoteStatistics>& notes, const Settings& settings)
+{
+    String text;
+    if (notes.isEmpty())
+    {
+        text << "There are no sweeps of this model in the archive." << newLine;
+        return text;
+    }
+    
+    text << (settings.perOscillator ? "Pitch offsets of the oscillators" : "Pitch offsets of all sweeps")
+         << " in cents:" << newLine
+         << "note   values      mean    spread       min       max" << newLine;
+    for (const FleetAnalytics::NoteStatistics& note : notes)
+    {
+        text << String(note.midiPitch).paddedLeft(' ', 4)
+             << String(note.numValues).paddedLeft(' ', 9)
+             << formatCents(note.mean).paddedLeft(' ', 10)
+             << formatCents(note.standardDeviation).paddedLeft(' ', 10)
+             << formatCents(note.min).paddedLeft(' ', 10)
+             << formatCents(note.max).paddedLeft(' ', 10) << newLine;
+    }
+    return text;
+}
+
+String FleetWindow::describeDrift(const Array<FleetAnalytics::Drift>& drifts, const Settings& settings)
+{
+    String text;
+    const Time from = settings.driftFrom;
+    const Time to = settings.driftTo;
+    if (from == Time() || to == Time())
+    {
+        text << "Enter the dates to compare like " << formatDate(Time::getCurrentTime()) << "." << newLine;
+        return text;
+    }
+    
+    text << "Drift between " << formatDate(from) << " and " << formatDate(to) << ", "
+         << String(drifts.size()) << " oscillators:" << newLine;
+    for (int i = 0; i < jmin(numDriftsShown, drifts.size()); i++)
+    {
+        const FleetAnalytics::Drift& drift = drifts.getReference(i);
+        text << "    " << drift.dutModel;
+        if (drift.serialNumber.isNotEmpty())
+            text << " #" << drift.serialNumber;
+        text << ", input " << String(drift.lane + 1) << ": " << formatSignedCents(drift.meanChange)
+             << " cents (max " << formatSignedCents(drift.maxChange) << ", " << String(drift.numNotes)
+             << " notes, " << formatDate(drift.before) << " to " << formatDate(drift.after) << ")" << newLine;
+    }
+    return text;
+}
+
+String FleetWindow::describeTrackingError(const FleetAnalytics::Comparison& comparison, const Settings& settings)
+{
+    String text;
+    text << "Tracking error by " << FleetAnalytics::getGroupingName(settings.grouping).toLowerCase()
+         << ", which explains " << String(roundToInt(comparison.varianceExplained * 100.0))
+         << "% of its variance:" << newLine;
+    for (const FleetAnalytics::Group& group : comparison.groups)
+    {
+        text << "    " << group.name << ": " << formatCents(group.meanTrackingError)
+             << " +/- " << formatCents(group.trackingErrorDeviation) << " cents, scale "
+             << formatSignedCents(group.meanScaleError) << " cents/octave ("
+             << String(group.numValues) << " values)" << newLine;
+    }
+    return text;
+}
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    FleetWindow.h
+    Created: 18 Oct 2026 5:03:44pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef FLEETWINDOW_H_INCLUDED
+#define FLEETWINDOW_H_INCLUDED
+
+#include "VCOTuner.h"
+#include "Visualizer.h"
+#include "FleetAnalytics.h"
+
+//==============================================================================
+/** Shows what the FleetAnalytics found in the archive of the app: the mean and the spread
+    of every note of a DUT model in a Visualizer, with the latest sweep of each oscillator
+    behind them, and below it the notes, the oscillators that drifted between two dates
+    and the tracking error of the interfaces (or other devices) as text.
+    
+    The archive is scanned in the background, the window shows the results when they are done.
+ */
+class FleetWindow: public Component,
+                   public Button::Listener,
+                   public ComboBox::Listener
+{
+public:
+    FleetWindow(VCOTuner* t);
+    virtual ~FleetWindow() override;
+    
+    void resized() override;
+    void paint(Graphics& g) override;
+    
+    virtual void buttonClicked (Button* bttn) override;
+    virtual void comboBoxChanged (ComboBox* comboBoxThatHasChanged) override;
+    
+private:
+    /** what an update shows, as the controls were when it was started */
+    struct Settings
+    {
+        SweepArchive::Query query;
+        bool perOscillator;
+        Time driftFrom; // Time() if the dates couldn't be read
+        Time driftTo;
+        FleetAnalytics::Grouping grouping;
+    };
+    
+    /** lists the DUT models that are in the archive now */
+    void updateModels();
+    /** runs all queries again in the background and shows their results when they are done */
+    void update();
+    void showOverview(const FleetAnalytics::Overview& overview, const Settings& settings);
+    
+    static String describeNotes(const Array<FleetAnalytics::NoteStatistics>& notes, const Settings& settings);
+    static String describeDrift(const Array<FleetAnalytics::Drift>& drifts, const Settings& settings);
+    static String describeTrackingError(const FleetAnalytics::Comparison& comparison, const Settings& settings);
+    
+    FleetAnalytics analytics;
+    /** a single thread. An update that hasn't started yet is replaced by the next one. */
+    ThreadPool updatePool;
+    int numUpdates; // the results of older updates are dropped
+    
+    Label modelLabel;
+    ComboBox model;
+    ToggleButton perOscillator;
+    Label groupingLabel;
+    ComboBox grouping;
+    Label driftLabel;
+    TextEditor driftFrom;
+    TextEditor driftTo;
+    TextButton refresh;
+    Visualizer display;
+    TextEditor summary;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FleetWindow)
+};
+
+
+#endif  // FLEETWINDOW_H_INCLUDED
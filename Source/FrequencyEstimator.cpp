@@ -0,0 +1,453 @@
+/*
+  ==============================================================================
+
+    FrequencyEstimator.cpp
+    Created: 17 Oct 2026 11:38:52pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "FrequencyEstimator.h"
+
+namespace
+{
+    /** without an expected period, periods up to this frequency are found */
+    const double minFrequency = 20.0;
+    /** the shortest lag range of the YIN estimator, so that high notes are compared over many periods */
+    const double minYinFrameMs = 20.0;
+    /** YIN: the first dip of the normalised difference below this is the period */
+    const double yinThreshold = 0.1;
+    /** YIN: if the normalised difference never gets below this, there is no period */
+    const double yinMaxAperiodicity = 0.5;
+    /** YIN: how far the exact minimum may be away from the estimated one */
+    const int maxRefinementSteps = 4;
+    /** a subharmonic of the strongest peak that is at least this strong (relative to it) is the fundamental */
+    const float fundamentalThreshold = 0.1f;
+    /** the strongest peak is checked for being up to this harmonic */
+    const int maxHarmonic = 8;
+    
+    /** the shortest power of two FFT that can hold the given number of samples */
+    int getFFTOrder(int numSamples)
+    {
+        int order = 1;
+        while ((1 << order) < numSamples)
+            order++;
+        return order;
+    }
+    
+    /** the longest period an estimator must be able to find */
+    double getMaxPeriodLength(double sampleRate, double expectedPeriodLength)
+    {
+        if (expectedPeriodLength > 0)
+            return 2.0 * expectedPeriodLength;
+        return sampleRate / minFrequency;
+    }
+}
+
+std::unique_ptr<FrequencyEstimator> FrequencyEstimator::create(Type type)
+{
+    switch (type)
+    {
+        case yin:
+            return std::make_unique<YinEstimator>();
+        case spectralPeak:
+            return std::make_unique<SpectralPeakEstimator>(false);
+        case spectralPhase:
+            return std::make_unique<SpectralPeakEstimator>(true);
+        case zeroCrossingsCubic:
+            return std::make_unique<ZeroCrossingEstimator>(ZeroCrossingDetector::cubic);
+        case zeroCrossingsSinc:
+            return std::make_unique<ZeroCrossingEstimator>(ZeroCrossingDetector::sinc);
+        case zeroCrossingsOversampledSinc:
+            return std::make_unique<ZeroCrossingEstimator>(ZeroCrossingDetector::oversampledSinc);
+        case zeroCrossings:
+        default:
+            return std::make_unique<ZeroCrossingEstimator>(ZeroCrossingDetector::linear);
+    }
+}
+
+String FrequencyEstimator::getName(Type type)
+{
+    switch (type)
+    {
+        case yin:
+            return "YIN";
+        case spectralPeak:
+            return "Spectral peak";
+        case spectralPhase:
+            return "Spectral phase";
+        case zeroCrossingsCubic:
+            return "Zero crossings, cubic";
+        case zeroCrossingsSinc:
+            return "Zero crossings, sinc";
+        case zeroCrossingsOversampledSinc:
+            return "Zero crossings, 64x sinc";
+        case zeroCrossings:
+        default:
+            return "Zero crossings";
+    }
+}
+
+//==============================================================================
+ZeroCrossingEstimator::ZeroCrossingEstimator(ZeroCrossingDetector::Interpolation i)
+    : interpolation(i),
+      detector(i),
+      conditioning(SignalConditioner::off)
+{
+    reset(44100.0, 0);
+}
+
+void ZeroCrossingEstimator::reset(double sampleRate, double expectedPeriodLength)
+{
+    detector = ZeroCrossingDetector(interpolation);
+    lastCrossing = -1;
+    
+    conditioner.setMode(conditioning);
+    conditioner.reset(sampleRate, expectedPeriodLength);
+}
+
+void ZeroCrossingEstimator::setConditioning(SignalConditioner::Mode mode)
+{
+    conditioning = mode;
+}
+
+int ZeroCrossingEstimator::process(const float* samples, int numSamples, Period* periods, int maxNumPeriods)
+{
+    // at most every second sample can be a crossing, so a chunk always fits into crossingPositions[]
+    int numPeriods = 0;
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += 2 * maxNumCrossingsPerChunk)
+    {
+        const int maxNumCrossings = jmin((int) maxNumCrossingsPerChunk, maxNumPeriods - numPeriods);
+        if (maxNumCrossings <= 0)
+        {
+            // the rest of the block is skipped, the next period must not span the gap
+            lastCrossing = -1;
+            break;
+        }
+        
+        const int chunkLength = jmin(2 * maxNumCrossingsPerChunk, numSamples - chunkStart);
+        const float* chunk = samples + chunkStart;
+        if (conditioner.getMode() != SignalConditioner::off)
+        {
+            FloatVectorOperations::copy(conditioned, chunk, chunkLength);
+            conditioner.process(conditioned, chunkLength);
+            detector.setHysteresis(conditioner.getHysteresis());
+            chunk = conditioned;
+        }
+        
+        const int numCrossings = detector.process(chunk, chunkLength, crossingPositions, maxNumCrossings);
+        for (int i = 0; i < numCrossings; i++)
+        {
+            // the interpolation of the first crossings would see the silence before the measurement
+            if (crossingPositions[i] < detector.getLatency())
+                continue;
+            
+            if (lastCrossing >= 0)
+            {
+                periods[numPeriods++] = { crossingPositions[i], crossingPositions[i] - lastCrossing };
+                conditioner.trackPeriod(crossingPositions[i] - lastCrossing);
+            }
+            lastCrossing = crossingPositions[i];
+        }
+    }
+    return numPeriods;
+}
+
+//==============================================================================
+YinEstimator::YinEstimator()
+{
+    reset(44100.0, 0);
+}
+
+void YinEstimator::reset(double sampleRate, double expectedPeriodLength)
+{
+    maxLag = jmax((int) std::ceil(getMaxPeriodLength(sampleRate, expectedPeriodLength)),
+                  (int) (minYinFrameMs * sampleRate / 1000.0));
+    frameLength = 2 * maxLag;
+    hopSize = maxLag / 2;
+    
+    const int order = getFFTOrder(frameLength);
+    if (fft == nullptr || fft->getSize() != (1 << order))
+    {
+        fft = std::make_unique<dsp::FFT>(order);
+        frameSpectrum.allocate((size_t) (2 * fft->getSize()), true);
+        windowSpectrum.allocate((size_t) (2 * fft->getSize()), true);
+    }
+    frame.allocate((size_t) frameLength, true);
+    difference.allocate((size_t) (maxLag + 1), true);
+    
+    numSamplesInFrame = 0;
+    position = 0;
+}
+
+int YinEstimator::process(const float* samples, int numSamples, Period* periods, int maxNumPeriods)
+{
+    int numPeriods = 0;
+    int i = 0;
+    while (i < numSamples)
+    {
+        const int numToCopy = jmin(numSamples - i, frameLength - numSamplesInFrame);
+        FloatVectorOperations::copy(frame + numSamplesInFrame, samples + i, numToCopy);
+        numSamplesInFrame += numToCopy;
+        position += numToCopy;
+        i += numToCopy;
+        
+        if (numSamplesInFrame < frameLength)
+            break;
+        
+        const double period = analyseFrame();
+        if (period > 0 && numPeriods < maxNumPeriods)
+            periods[numPeriods++] = { (double) position, period };
+        
+        // the frames overlap, keep the end for the next one
+        memmove(frame, frame + hopSize, sizeof(float) * (size_t) (frameLength - hopSize));
+        numSamplesInFrame = frameLength - hopSize;
+    }
+    return numPeriods;
+}
+
+double YinEstimator::analyseFrame()
+{
+    const int fftSize = fft->getSize();
+    
+    // cross correlation of the first maxLag samples with the whole frame:
+    // frameSpectrum[lag] = sum(frame[j] * frame[j + lag]) over j < maxLag
+    zeromem(frameSpectrum, sizeof(float) * (size_t) (2 * fftSize));
+    zeromem(windowSpectrum, sizeof(float) * (size_t) (2 * fftSize));
+    FloatVectorOperations::copy(frameSpectrum, frame, frameLength);
+    FloatVectorOperations::copy(windowSpectrum, frame, maxLag);
+    fft->performRealOnlyForwardTransform(frameSpectrum, true);
+    fft->performRealOnlyForwardTransform(windowSpectrum, true);
+    for (int k = 0; k <= fftSize / 2; k++)
+    {
+        const float re = frameSpectrum[2 * k] * windowSpectrum[2 * k] + frameSpectrum[2 * k + 1] * windowSpectrum[2 * k + 1];
+        const float im = frameSpectrum[2 * k + 1] * windowSpectrum[2 * k] - frameSpectrum[2 * k] * windowSpectrum[2 * k + 1];
+        frameSpectrum[2 * k] = re;
+        frameSpectrum[2 * k + 1] = im;
+    }
+    fft->performRealOnlyInverseTransform(frameSpectrum);
+    
+    // difference function d(lag) = energy(0) + energy(lag) - 2 * correlation(lag),
+    // normalised by its mean over all shorter lags
+    double windowEnergy = 0;
+    for (int j = 0; j < maxLag; j++)
+        windowEnergy += frame[j] * frame[j];
+    double lagEnergy = windowEnergy;
+    double sumOfDifferences = 0;
+    difference[0] = 1.0;
+    for (int lag = 1; lag <= maxLag; lag++)
+    {
+        lagEnergy += frame[lag + maxLag - 1] * frame[lag + maxLag - 1] - frame[lag - 1] * frame[lag - 1];
+        const double d = jmax(0.0, windowEnergy + lagEnergy - 2.0 * frameSpectrum[lag]);
+        sumOfDifferences += d;
+        difference[lag] = sumOfDifferences > 0 ? d * lag / sumOfDifferences : 1.0;
+    }
+    
+    // the deepest point of the first dip below the threshold. With noise, the dips at the
+    // period and all its multiples are about as deep, so the threshold is raised above
+    // the deepest one - otherwise a random multiple would be chosen.
+    int deepestLag = 2;
+    for (int lag = 3; lag <= maxLag; lag++)
+    {
+        if (difference[lag] < difference[deepestLag])
+            deepestLag = lag;
+    }
+    if (difference[deepestLag] > yinMaxAperiodicity)
+        return 0;
+    
+    const double threshold = jmax(yinThreshold, 2.0 * difference[deepestLag]);
+    int coarseLag = 2;
+    while (difference[coarseLag] >= threshold)
+        coarseLag++;
+    for (int lag = coarseLag; lag <= maxLag && difference[lag] < threshold; lag++)
+    {
+        if (difference[lag] < difference[coarseLag])
+            coarseLag = lag;
+    }
+    
+    // refine the period at multiples of it. Every step doubles the multiple, so that the
+    // error of the previous step can't make it miss the right minimum.
+    auto refine = [this] (int lag) -> double
+    {
+        double d = getDifference(lag);
+        for (int step = 0; step < maxRefinementSteps; step++)
+        {
+            if (lag > 1 && getDifference(lag - 1) < d)
+                d = getDifference(--lag);
+            else if (lag < maxLag && getDifference(lag + 1) < d)
+                d = getDifference(++lag);
+            else
+                break;
+        }
+        if (lag <= 1 || lag >= maxLag)
+            return lag;
+        
+        const double before = getDifference(lag - 1);
+        const double after = getDifference(lag + 1);
+        const double curvature = before - 2.0 * d + after;
+        if (curvature <= 0)
+            return lag;
+        return lag + 0.5 * (before - after) / curvature;
+    };
+    
+    int multiple = 1;
+    double period = refine(coarseLag);
+    while (2 * multiple * period < maxLag - 1)
+    {
+        multiple *= 2;
+        period = refine(roundToInt(multiple * period)) / multiple;
+    }
+    const int largestMultiple = (int) ((maxLag - 1) / period);
+    if (largestMultiple > multiple)
+        period = refine(roundToInt(largestMultiple * period)) / largestMultiple;
+    
+    return period;
+}
+
+double YinEstimator::getDifference(int lag) const
+{
+    double sum = 0;
+    for (int j = 0; j < maxLag; j++)
+    {
+        const double delta = frame[j] - frame[j + lag];
+        sum += delta * delta;
+    }
+    return sum;
+}
+
+//==============================================================================
+SpectralPeakEstimator::SpectralPeakEstimator(bool usePhaseRefinement)
+: phaseRefinement(usePhaseRefinement)
+{
+    reset(44100.0, 0);
+}
+
+void SpectralPeakEstimator::reset(double sampleRate, double expectedPeriodLength)
+{
+    // the fundamental must be a few bins above DC and apart from the next harmonic
+    const int order = getFFTOrder(jmax(1024, (int) std::ceil(4.0 * getMaxPeriodLength(sampleRate, expectedPeriodLength))));
+    if (fft == nullptr || fft->getSize() != (1 << order))
+    {
+        fft = std::make_unique<dsp::FFT>(order);
+        fftSize = fft->getSize();
+        hopSize = fftSize / 4;
+        
+        frame.allocate((size_t) fftSize, true);
+        window.allocate((size_t) fftSize, false);
+        for (int i = 0; i < fftSize; i++)
+            window[i] = 0.5f - 0.5f * std::cos(MathConstants<float>::twoPi * (float) i / (float) fftSize);
+        spectrum.allocate((size_t) (2 * fftSize), true);
+        previousSpectrum.allocate((size_t) (2 * fftSize), true);
+        magnitudes.allocate((size_t) (fftSize / 2 + 1), true);
+    }
+    
+    numSamplesInFrame = 0;
+    position = 0;
+    hasPreviousSpectrum = false;
+}
+
+int SpectralPeakEstimator::process(const float* samples, int numSamples, Period* periods, int maxNumPeriods)
+{
+    int numPeriods = 0;
+    int i = 0;
+    while (i < numSamples)
+    {
+        const int numToCopy = jmin(numSamples - i, fftSize - numSamplesInFrame);
+        FloatVectorOperations::copy(frame + numSamplesInFrame, samples + i, numToCopy);
+        numSamplesInFrame += numToCopy;
+        position += numToCopy;
+        i += numToCopy;
+        
+        if (numSamplesInFrame < fftSize)
+            break;
+        
+        const double period = analyseFrame();
+        if (period > 0 && numPeriods < maxNumPeriods)
+            periods[numPeriods++] = { (double) position, period };
+        
+        // the frames overlap, keep the end for the next one
+        memmove(frame, frame + hopSize, sizeof(float) * (size_t) (fftSize - hopSize));
+        numSamplesInFrame = fftSize - hopSize;
+    }
+    return numPeriods;
+}
+
+double SpectralPeakEstimator::analyseFrame()
+{
+    zeromem(spectrum, sizeof(float) * (size_t) (2 * fftSize));
+    FloatVectorOperations::multiply(spectrum, frame, window, fftSize);
+    fft->performRealOnlyForwardTransform(spectrum, true);
+    for (int k = 0; k <= fftSize / 2; k++)
+        magnitudes[k] = std::sqrt(spectrum[2 * k] * spectrum[2 * k] + spectrum[2 * k + 1] * spectrum[2 * k + 1]);
+    
+    const int bin = findFundamental();
+    double frequencyInBins = 0;
+    if (bin > 0 && phaseRefinement)
+    {
+        // the phase has advanced by the exact frequency since the previous frame. The
+        // peak bin is within half a bin of it, so the deviation from the bin frequency
+        // is well within the unambiguous range of +/- 2 bins.
+        if (hasPreviousSpectrum)
+        {
+            const double phase = std::atan2(spectrum[2 * bin + 1], spectrum[2 * bin]);
+            const double previousPhase = std::atan2(previousSpectrum[2 * bin + 1], previousSpectrum[2 * bin]);
+            const double binAdvance = MathConstants<double>::twoPi * hopSize / fftSize;
+            double deviation = phase - previousPhase - binAdvance * bin;
+            deviation -= MathConstants<double>::twoPi * std::floor(deviation / MathConstants<double>::twoPi + 0.5);
+            frequencyInBins = bin + deviation / binAdvance;
+        }
+    }
+    else if (bin > 0)
+    {
+        // parabola through the log magnitudes around the peak
+        const double before = std::log(magnitudes[bin - 1] + 1e-20);
+        const double peak = std::log(magnitudes[bin] + 1e-20);
+        const double after = std::log(magnitudes[bin + 1] + 1e-20);
+        const double curvature = before - 2.0 * peak + after;
+        frequencyInBins = curvature < 0 ? bin + 0.5 * (before - after) / curvature : bin;
+    }
+    
+    FloatVectorOperations::copy(previousSpectrum, spectrum, 2 * fftSize);
+    hasPreviousSpectrum = bin > 0;
+    
+    if (frequencyInBins <= 0)
+        return 0;
+    return fftSize / frequencyInBins;
+}
+
+int SpectralPeakEstimator::findFundamental() const
+{
+    const int numBins = fftSize / 2;
+    
+    // the strongest peak, away from DC
+    int peak = 2;
+    for (int k = 3; k < numBins; k++)
+    {
+        if (magnitudes[k] > magnitudes[peak])
+            peak = k;
+    }
+    if (magnitudes[peak] <= 0)
+        return 0;
+    
+    // it may be a harmonic (e.g. of a pulse wave). The fundamental is the lowest
+    // subharmonic that is a clear peak as well.
+    for (int harmonic = maxHarmonic; harmonic >= 2; harmonic--)
+    {
+        const int candidate = roundToInt((double) peak / harmonic);
+        if (candidate < 3)
+            continue;
+        
+        int best = candidate;
+        for (int k = candidate - 1; k <= candidate + 1; k++)
+        {
+            if (magnitudes[k] > magnitudes[best])
+                best = k;
+        }
+        if (magnitudes[best] > magnitudes[best - 1] && magnitudes[best] >= magnitudes[best + 1]
+            && magnitudes[best] > fundamentalThreshold * magnitudes[peak])
+            return best;
+    }
+    return peak;
+}
@@ -0,0 +1,173 @@
+/*
+  ==============================================================================
+
+    FrequencyEstimator.h
+    Created: 17 Oct 2026 11:38:52pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef FREQUENCYESTIMATOR_H_INCLUDED
+#define FREQUENCYESTIMATOR_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ZeroCrossingDetector.h"
+#include "SignalConditioner.h"
+
+/** Turns the recorded samples of one oscillator into estimates of its period length.
+
+    The tuner feeds the samples of a measurement block by block, off the audio thread.
+    Every estimate is reported with the position where the analysed signal ended, so
+    that the tuner can tell when the oscillator has settled and how much of the signal
+    has been measured. An estimator may report one estimate per period (zero crossings)
+    or one per analysis frame (YIN, spectral peak).
+ */
+class FrequencyEstimator
+{
+public:
+    enum Type
+    {
+        zeroCrossings = 0,
+        zeroCrossingsCubic,
+        zeroCrossingsSinc,
+        zeroCrossingsOversampledSinc,
+        yin,
+        spectralPeak,
+        spectralPhase
+    };
+    static const int numTypes = 7;
+    
+    static std::unique_ptr<FrequencyEstimator> create(Type type);
+    static String getName(Type type);
+    
+    struct Period
+    {
+        double endPosition; // in samples since reset()
+        double length; // in samples
+    };
+    
+    virtual ~FrequencyEstimator() {}
+    
+    /** starts a new measurement. Positions are counted from the next sample on.
+     @param sampleRate              the sample rate of the recording
+     @param expectedPeriodLength    rough period length of the new note, or 0 if unknown.
+                                    Periods up to twice as long are still found.
+     */
+    virtual void reset(double sampleRate, double expectedPeriodLength) = 0;
+    
+    /** analyses the next block of samples and returns the number of periods found.
+     There is at most one period per two samples, so with maxNumPeriods >= numSamples / 2
+     nothing gets lost. */
+    virtual int process(const float* samples, int numSamples, Period* periods, int maxNumPeriods) = 0;
+    
+    /** filters the signal before it is analysed. Only the zero crossings need it,
+     the other estimators ignore it. Takes effect with the next reset(). */
+    virtual void setConditioning(SignalConditioner::Mode /*mode*/) {}
+};
+
+//==============================================================================
+/** Measures the time between rising zero crossings. Very precise on clean waveforms
+    with a single crossing per period, fooled by noise and ringing around zero.
+    The higher order interpolations follow the curvature of the waveform around the
+    crossing, which matters on high notes with only a few samples per period.
+ */
+class ZeroCrossingEstimator: public FrequencyEstimator
+{
+public:
+    ZeroCrossingEstimator(ZeroCrossingDetector::Interpolation interpolation);
+    
+    void reset(double sampleRate, double expectedPeriodLength) override;
+    int process(const float* samples, int numSamples, Period* periods, int maxNumPeriods) override;
+    void setConditioning(SignalConditioner::Mode mode) override;
+    
+private:
+    const ZeroCrossingDetector::Interpolation interpolation;
+    ZeroCrossingDetector detector;
+    double lastCrossing; // -1 until the first crossing was found
+    
+    SignalConditioner conditioner;
+    SignalConditioner::Mode conditioning;
+    
+    static const int maxNumCrossingsPerChunk = 512;
+    double crossingPositions[maxNumCrossingsPerChunk];
+    float conditioned[2 * maxNumCrossingsPerChunk];
+};
+
+//==============================================================================
+/** The YIN estimator: finds the lag at which the signal best matches itself
+    (cumulative mean normalised difference function). Insensitive to the waveform,
+    noise and ringing, as long as the signal repeats.
+    
+    The difference function is calculated for all lags with an FFT cross correlation
+    to find the period. It is then refined with a parabola through the exact
+    difference at the largest multiple of the period that fits into the frame, so
+    that the interpolation error is spread over many periods.
+ */
+class YinEstimator: public FrequencyEstimator
+{
+public:
+    YinEstimator();
+    
+    void reset(double sampleRate, double expectedPeriodLength) override;
+    int process(const float* samples, int numSamples, Period* periods, int maxNumPeriods) override;
+    
+private:
+    /** returns the period length in the current frame, or 0 if there is none */
+    double analyseFrame();
+    /** exact difference function of the current frame at a lag */
+    double getDifference(int lag) const;
+    
+    int maxLag; // also the length of the compared window
+    int frameLength;
+    int hopSize;
+    
+    HeapBlock<float> frame;
+    int numSamplesInFrame;
+    int64 position;
+    
+    std::unique_ptr<dsp::FFT> fft;
+    HeapBlock<float> frameSpectrum;
+    HeapBlock<float> windowSpectrum;
+    HeapBlock<double> difference;
+};
+
+//==============================================================================
+/** Looks for the fundamental in the spectrum of a Hann windowed frame. Its
+    frequency is refined either with a parabola through the log magnitudes around
+    the peak, or from the phase advance since the previous frame (phase vocoder),
+    which is far more precise on a stable tone.
+ */
+class SpectralPeakEstimator: public FrequencyEstimator
+{
+public:
+    SpectralPeakEstimator(bool usePhaseRefinement);
+    
+    void reset(double sampleRate, double expectedPeriodLength) override;
+    int process(const float* samples, int numSamples, Period* periods, int maxNumPeriods) override;
+    
+private:
+    /** returns the period length in the current frame, or 0 if there is none */
+    double analyseFrame();
+    /** the bin of the fundamental, or 0 if there is no clear peak */
+    int findFundamental() const;
+    
+    const bool phaseRefinement;
+    
+    int fftSize;
+    int hopSize;
+    
+    HeapBlock<float> frame;
+    int numSamplesInFrame;
+    int64 position;
+    
+    std::unique_ptr<dsp::FFT> fft;
+    HeapBlock<float> window;
+    HeapBlock<float> spectrum;
+    HeapBlock<float> magnitudes;
+    HeapBlock<float> previousSpectrum;
+    bool hasPreviousSpectrum;
+};
+
+
+#endif  // FREQUENCYESTIMATOR_H_INCLUDED
@@ -0,0 +1,1032 @@
+/*
+  ==============================================================================
+
+    HeadlessSweep.cpp
+    Created: 18 Oct 2026 9:41:17am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "HeadlessSweep.h"
+#include "TuningTable.h"
+#include "FleetAnalytics.h"
+#include "ReportRenderer.h"
+
+extern ApplicationProperties& getAppProperties();
+
+namespace
+{
+    /** how often the results are written while a sweep is running */
+    const int resultIntervalMs = 50;
+    
+    /** reads an integer option. Returns an error message if it's there but not valid. */
+    String parseInt(const ArgumentList& args, StringRef option, int minimum, int maximum, int& value)
+    {
+        if (!args.containsOption(option))
+            return {};
+        
+        const String text = args.getValueForOption(option).trim();
+        if (text.isEmpty() || !text.containsOnly("0123456789")
+            || text.getIntValue() < minimum || text.getIntValue() > maximum)
+            return String(option) + " must be a number from " + String(minimum) + " to " + String(maximum);
+        
+        value = text.getIntValue();
+        return {};
+    }
+    
+    /** reads an ISO 8601 date or time. Only a date means its start, or its end if endOfDay is set. */
+    String parseDate(const ArgumentList& args, StringRef option, bool endOfDay, Time& value)
+    {
+        if (!args.containsOption(option))
+            return {};
+        
+        const String text = args.getValueForOption(option).trim();
+        const Time time = Time::fromISO8601(text);
+        if (text.isEmpty() || time == Time())
+            return String(option) + " must be a date like 2026-10-18 or 2026-10-18T14:30:00";
+        
+        const bool isDateOnly = !text.containsChar('T');
+        value = isDateOnly && endOfDay ? time + RelativeTime::days(1) - RelativeTime::milliseconds(1) : time;
+        return {};
+    }
+    
+    String getSweepCsvHeader()
+    {
+        return "index,time,dutBrand,dutDevice,serialNumber,interfaceBrand,interfaceDevice,calibration,numMeasurements";
+    }
+    
+    /** writes the report of one stored sweep, see HeadlessSweep::writeReports() */
+    class ReportJob: public ThreadPoolJob
+    {
+    public:
+        ReportJob(const SweepArchive::Sweep& s, const File& f, ReportRenderer::Format fmt, int d)
+        : ThreadPoolJob("Report"), sweep(s), file(f), format(fmt), dpi(d)
+        {
+        }
+        
+        JobStatus runJob() override
+        {
+            error = ReportRenderer::write(ReportRenderer::Content(sweep), format, dpi, file);
+            return jobHasFinished;
+        }
+        
+        const SweepArchive::Sweep sweep;
+        const File file;
+        const ReportRenderer::Format format;
+        const int dpi;
+        String error; // once the job has finished
+    };
+}
+
+HeadlessSweep::HeadlessSweep()
+: bench(session.addBench("Headless"))
+{
+    writeJson = false;
+    calibrate = false;
+    archive = true;
+    numSweeps = 1;
+    currentSweep = 0;
+    sweepStartTime = 0;
+    firstErrorExitCode = 0;
+    finished = false;
+    numDroppedResults = 0;
+    
+    bench->getTuner().addListener(this);
+    bench->getTuner().addResultQueue(&results);
+}
+
+HeadlessSweep::~HeadlessSweep()
+{
+    stopTimer();
+    if (replaySource != nullptr)
+    {
+        // the replay device clocks the tuner, so it has to go first
+        bench->getDeviceManager().closeAudioDevice();
+        bench->getTuner().setMidiSink(nullptr);
+    }
+    bench->getTuner().removeResultQueue(&results);
+    bench->getTuner().removeListener(this);
+}
+
+bool HeadlessSweep::isRequested(const ArgumentList& args)
+{
+    return args.containsOption("--headless") || args.containsOption("--list-devices")
+           || args.containsOption("--list-sweeps") || args.containsOption("--fleet")
+           || args.containsOption("--reports");
+}
+
+String HeadlessSweep::getUsage()
+{
+    String usage;
+    usage << "Usage: VCOTuner --headless [options]" << newLine
+          << "  --audio-type <name>      the audio driver type, e.g. ALSA, CoreAudio or ASIO" << newLine
+          << "  --audio-device <name>    the input device (default: as in the app's settings)" << newLine
+          << "  --inputs <n>             the number of input channels, one oscillator on each (1)" << newLine
+          << "  --midi-output <name>     the MIDI output (default: as in the app's settings)" << newLine
+          << "  --midi-channel <n>       the MIDI channel of the first input (1)" << newLine
+          << "  --lowest <note>          the lowest MIDI note (48)" << newLine
+          << "  --highest <note>         the highest MIDI note (72)" << newLine
+          << "  --increment <n>          the interval between the notes (6)" << newLine
+          << "  --resolution <n>         the number of periods per note (100)" << newLine
+          << "  --confidence <cents>     stop a note once its pitch is known within +/- this (0 = never)" << newLine
+          << "  --reference-interval <s> measure the reference again this often and correct the drift (0 = never)" << newLine
+          << "  --estimator <name>       how the frequency is estimated (Zero crossings)" << newLine
+          << "  --input-filter <filter>  off, dc or band-pass, before the zero crossings (off)" << newLine
+          << "  --order <order>          monotonic, serpentine, random or min-jump (monotonic)" << newLine
+          << "  --sweeps <n>             the number of sweeps (1)" << newLine
+          << "  --format csv|json        one CSV line or one JSON object per result (csv)" << newLine
+          << "  --output <file>          write the results to a file instead of stdout" << newLine
+          << "  --tuning <file>          write the tuning tables (.scl, .kbm, .syx, .csv) of the last sweep" << newLine
+          << "  --calibrate              find the corrections that bring every note in tune" << newLine
+          << "  --correction bend|rpn    correct with pitch bend or with the fine tuning RPN (bend)" << newLine
+          << "  --bend-range <n>         the pitch bend range of the interface in semitones (2)" << newLine
+          << "  --list-devices           list the audio and MIDI devices and exit" << newLine
+          << "  --replay <file|folder>   sweep recordings (e.g. a folder of 60.wav, 61.wav ...) instead of a device" << newLine
+          << "  --archive <file>         store the sweeps in this archive (default: the app's)" << newLine
+          << "  --no-archive             don't store the sweeps" << newLine
+          << "  --dut-brand <text>       the brand of the DUT (default: as in the last report)" << newLine
+          << "  --dut-device <text>      the model of the DUT (default: as in the last report)" << newLine
+          << "  --serial <text>          the serial number of the DUT" << newLine
+          << "  --interface-brand <text> the brand of the interface (default: as in the last report)" << newLine
+          << "  --interface-device <text> the model of the interface (default: as in the last report)" << newLine
+          << "  --notes <text>           notes about the sweep (default: as in the last report)" << newLine
+          << "  --list-sweeps            list the stored sweeps of the DUT options and exit" << newLine
+          << "  --from <date>            with --list-sweeps and --reports, only sweeps started on or after this date" << newLine
+          << "  --to <date>              with --list-sweeps and --reports, only sweeps started on or before this date" << newLine
+          << "  --fleet notes|drift|tracking  analyse the stored sweeps of the DUT options and exit:" << newLine
+          << "                           the offsets of each note over all units, the drift of each unit" << newLine
+          << "                           between --from and --to, or the tracking error of each --group-by" << newLine
+          << "  --per-sweep              with --fleet notes, one value per sweep instead of per unit" << newLine
+          << "  --group-by <devices>     with --fleet tracking: interface, midi, audio or model (interface)" << newLine
+          << "  --reports <folder>       write a report of each stored sweep of the DUT options and exit" << newLine
+          << "  --report-format <type>   with --reports: png, jpeg, svg or pdf (png)" << newLine
+          << "  --dpi <n>                with --reports, the resolution of png and jpeg reports (96)" << newLine
+          << newLine
+          << "Exit codes: 0 done, 1 invalid arguments, 2 device not available, 3 output not writable," << newLine
+          << "4 interrupted, 10 + n for the n-th error of the tuner (see VCOTuner::Errors)" << newLine;
+    return usage;
+}
+
+//==============================================================================
+void HeadlessSweep::start(const ArgumentList& args)
+{
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << getUsage();
+        finish(success);
+        return;
+    }
+    
+    if (args.containsOption("--list-devices"))
+    {
+        listDevices();
+        finish(success);
+        return;
+    }
+    
+    String error = openArchive(args);
+    if (error.isNotEmpty())
+    {
+        std::cerr << error << std::endl;
+        finish(outputNotWritable);
+        return;
+    }
+    
+    if (args.containsOption("--list-sweeps"))
+    {
+        listSweeps(args);
+        return;
+    }
+    
+    if (args.containsOption("--fleet"))
+    {
+        analyseFleet(args);
+        return;
+    }
+    
+    if (args.containsOption("--reports"))
+    {
+        writeReports(args);
+        return;
+    }
+    
+    error = configure(args);
+    if (error.isNotEmpty())
+    {
+        std::cerr << error << std::endl << std::endl << getUsage();
+        finish(invalidArguments);
+        return;
+    }
+    
+    int numInputs = 1;
+    parseInt(args, "--inputs", 1, VCOTuner::maxNumLanes, numInputs);
+    String deviceError;
+    if (args.containsOption("--replay"))
+    {
+        deviceError = openReplayDevice(args, numInputs);
+    }
+    else
+    {
+        deviceError = openAudioDevice(args, numInputs);
+        if (deviceError.isEmpty())
+            deviceError = selectMidiOutput(args);
+    }
+    if (deviceError.isNotEmpty())
+    {
+        std::cerr << deviceError << std::endl;
+        finish(deviceNotAvailable);
+        return;
+    }
+    
+    if (args.containsOption("--output"))
+    {
+        const File file = args.getFileForOption("--output");
+        file.deleteFile();
+        output.reset(new FileOutputStream(file));
+        if (output->failedToOpen())
+        {
+            std::cerr << "Can't write " << file.getFullPathName() << std::endl;
+            finish(outputNotWritable);
+            return;
+        }
+    }
+    
+    if (args.containsOption("--tuning"))
+        tuningFile = args.getFileForOption("--tuning");
+    
+    if (!writeJson)
+        writeLine(calibrate ? getCalibrationCsvHeader() : getCsvHeader());
+    
+    currentSweep = 1;
+    sweepStartTime = Time::getMillisecondCounterHiRes();
+    sweepStartDate = Time::getCurrentTime();
+    startTimer(resultIntervalMs);
+    if (calibrate)
+        bench->getTuner().startCalibration();
+    else
+        bench->getTuner().start();
+}
+
+void HeadlessSweep::stop()
+{
+    if (bench->getTuner().isRunning())
+        bench->getTuner().stop();
+    else
+        finish(interrupted);
+}
+
+String HeadlessSweep::configure(const ArgumentList& args)
+{
+    VCOTuner& tuner = bench->getTuner();
+    
+    int firstMidiChannel = 1;
+    if (getAppProperties().getUserSettings()->containsKey("MIDIChannel"))
+        firstMidiChannel = getAppProperties().getUserSettings()->getIntValue("MIDIChannel");
+    int numInputs = 1;
+    int lowest = 48, highest = 72, increment = 6;
+    int resolution = 100;
+    
+    StringArray errors;
+    errors.add(parseInt(args, "--inputs", 1, VCOTuner::maxNumLanes, numInputs));
+    errors.add(parseInt(args, "--midi-channel", 1, 16, firstMidiChannel));
+    errors.add(parseInt(args, "--lowest", 0, 127, lowest));
+    errors.add(parseInt(args, "--highest", 0, 127, highest));
+    errors.add(parseInt(args, "--increment", 1, 127, increment));
+    errors.add(parseInt(args, "--resolution", 1, 1000000, resolution));
+    errors.add(parseInt(args, "--sweeps", 1, 1000000, numSweeps));
+    if (lowest > highest)
+        errors.add("--lowest must not be above --highest");
+    
+    double confidence = 0;
+    if (args.containsOption("--confidence"))
+    {
+        const String text = args.getValueForOption("--confidence").trim();
+        confidence = text.getDoubleValue();
+        if (!text.containsOnly("0123456789.") || confidence < 0)
+            errors.add("--confidence must be a number of cents, 0 or above");
+    }
+    
+    double referenceInterval = 0;
+    if (args.containsOption("--reference-interval"))
+    {
+        const String text = args.getValueForOption("--reference-interval").trim();
+        referenceInterval = text.getDoubleValue();
+        if (text.isEmpty() || !text.containsOnly("0123456789."))
+            errors.add("--reference-interval must be a number of seconds, 0 or above");
+    }
+    
+    FrequencyEstimator::Type estimator = FrequencyEstimator::zeroCrossings;
+    if (args.containsOption("--estimator"))
+    {
+        const String name = args.getValueForOption("--estimator").trim();
+        StringArray names;
+        int found = -1;
+        for (int i = 0; i < FrequencyEstimator::numTypes; i++)
+        {
+            names.add(FrequencyEstimator::getName((FrequencyEstimator::Type) i));
+            if (names[i].equalsIgnoreCase(name))
+                found = i;
+        }
+        if (found < 0)
+            errors.add("--estimator must be one of: " + names.joinIntoString(", "));
+        else
+            estimator = (FrequencyEstimator::Type) found;
+    }
+    
+    SignalConditioner::Mode conditioning = SignalConditioner::off;
+    if (args.containsOption("--input-filter"))
+    {
+        const StringArray names { "off", "dc", "band-pass" };
+        const int found = names.indexOf(args.getValueForOption("--input-filter").trim(), true);
+        if (found < 0)
+            errors.add("--input-filter must be one of: " + names.joinIntoString(", "));
+        else
+            conditioning = (SignalConditioner::Mode) found;
+    }
+    
+    SweepPlanner::Strategy order = SweepPlanner::monotonic;
+    if (args.containsOption("--order"))
+    {
+        const StringArray names { "monotonic", "serpentine", "random", "min-jump" };
+        const int found = names.indexOf(args.getValueForOption("--order").trim(), true);
+        if (found < 0)
+            errors.add("--order must be one of: " + names.joinIntoString(", "));
+        else
+            order = (SweepPlanner::Strategy) found;
+    }
+    
+    VCOTuner::CorrectionMessage correction = VCOTuner::pitchBend;
+    if (args.containsOption("--correction"))
+    {
+        const String name = args.getValueForOption("--correction").trim().toLowerCase();
+        if (name == "rpn")
+            correction = VCOTuner::fineTuning;
+        else if (name != "bend")
+            errors.add("--correction must be bend or rpn");
+    }
+    
+    int pitchBendRange = 2;
+    errors.add(parseInt(args, "--bend-range", 1, 96, pitchBendRange));
+    calibrate = args.containsOption("--calibrate");
+    archiveInfo = getArchiveInfo(args);
+    
+    if (args.containsOption("--format"))
+    {
+        const String format = args.getValueForOption("--format").trim().toLowerCase();
+        if (format == "json")
+            writeJson = true;
+        else if (format != "csv")
+            errors.add("--format must be csv or json");
+    }
+    
+    errors.removeEmptyStrings();
+    if (!errors.isEmpty())
+        return errors.joinIntoString(newLine);
+    
+    // the same lanes as in the app, one MIDI channel after the other
+    Array<VCOTuner::LaneSetup> lanes;
+    for (int i = 0; i < numInputs; i++)
+    {
+        VCOTuner::LaneSetup lane;
+        lane.inputChannel = i;
+        lane.midiChannel = (firstMidiChannel - 1 + i) % 16 + 1;
+        lanes.add(lane);
+    }
+    tuner.setLanes(lanes);
+    tuner.setNumMeasurementRange(lowest, increment, highest);
+    tuner.setResolution(resolution);
+    tuner.setTargetConfidenceInterval(confidence);
+    tuner.setReferenceInterval(referenceInterval);
+    tuner.setEstimator(estimator);
+    tuner.setConditioning(conditioning);
+    tuner.setSweepOrder(order);
+    tuner.setCorrectionMessage(correction, pitchBendRange);
+    return {};
+}
+
+String HeadlessSweep::openAudioDevice(const ArgumentList& args, int numInputs)
+{
+    AudioDeviceManager& deviceManager = bench->getDeviceManager();
+    
+    // starts with the devices of the app, they are replaced by those given
+    std::unique_ptr<XmlElement> savedState (getAppProperties().getUserSettings()
+                                           ->getXmlValue ("audioDeviceState"));
+    String error = bench->initialise(numInputs, savedState.get());
+    
+    if (args.containsOption("--audio-type"))
+    {
+        const String typeName = args.getValueForOption("--audio-type").trim();
+        bool found = false;
+        for (AudioIODeviceType* type : deviceManager.getAvailableDeviceTypes())
+            found = found || type->getTypeName().equalsIgnoreCase(typeName);
+        if (!found)
+            return "There is no audio driver type \"" + typeName + "\", see --list-devices";
+        
+        deviceManager.setCurrentAudioDeviceType(typeName, true);
+    }
+    
+    AudioDeviceManager::AudioDeviceSetup setup;
+    deviceManager.getAudioDeviceSetup(setup);
+    if (args.containsOption("--audio-device"))
+    {
+        const String name = args.getValueForOption("--audio-device").trim();
+        AudioIODeviceType* type = deviceManager.getCurrentDeviceTypeObject();
+        if (type == nullptr || !type->getDeviceNames(true).contains(name))
+            return "There is no audio input \"" + name + "\", see --list-devices";
+        
+        setup.inputDeviceName = name;
+    }
+    setup.useDefaultInputChannels = false;
+    setup.inputChannels.clear();
+    setup.inputChannels.setRange(0, numInputs, true);
+    error = deviceManager.setAudioDeviceSetup(setup, true);
+    
+    if (error.isEmpty() && deviceManager.getCurrentAudioDevice() == nullptr)
+        error = "No audio device could be opened";
+    if (error.isEmpty()
+        && deviceManager.getCurrentAudioDevice()->getActiveInputChannels().countNumberOfSetBits() < numInputs)
+        error = "The audio device doesn't have " + String(numInputs) + " inputs";
+    return error;
+}
+
+String HeadlessSweep::selectMidiOutput(const ArgumentList& args)
+{
+    if (!args.containsOption("--midi-output"))
+        return {};
+    
+    const String name = args.getValueForOption("--midi-output").trim();
+    for (const MidiDeviceInfo& device : MidiOutput::getAvailableDevices())
+    {
+        if (device.name.equalsIgnoreCase(name))
+        {
+            bench->setMidiOutput(device.identifier);
+            return {};
+        }
+    }
+    return "There is no MIDI output \"" + name + "\", see --list-devices";
+}
+
+String HeadlessSweep::openReplayDevice(const ArgumentList& args, int numInputs)
+{
+    const File file = args.getFileForOption("--replay");
+    replaySource = std::make_shared<ReplaySource>();
+    const bool loaded = file.isDirectory() ? replaySource->loadDirectory(file)
+                                           : replaySource->loadFile(file);
+    if (!loaded)
+        return replaySource->getLastError();
+    if (replaySource->getNumChannels() < numInputs)
+        return "The recordings don't have " + String(numInputs) + " channels";
+    
+    // only the replay device is made available, so that no sound card is touched
+    VCOTuner& tuner = bench->getTuner();
+    AudioDeviceManager& deviceManager = bench->getDeviceManager();
+    deviceManager.addAudioDeviceType(std::make_unique<ReplayAudioIODeviceType>(replaySource, &tuner));
+    deviceManager.setCurrentAudioDeviceType(ReplayAudioIODeviceType::deviceName, true);
+    
+    AudioDeviceManager::AudioDeviceSetup setup;
+    deviceManager.getAudioDeviceSetup(setup);
+    setup.inputDeviceName = ReplayAudioIODeviceType::deviceName;
+    setup.outputDeviceName = ReplayAudioIODeviceType::deviceName;
+    setup.sampleRate = replaySource->getSampleRate();
+    setup.useDefaultInputChannels = false;
+    setup.inputChannels.clear();
+    setup.inputChannels.setRange(0, numInputs, true);
+    const String error = deviceManager.setAudioDeviceSetup(setup, true);
+    if (error.isNotEmpty())
+        return error;
+    if (deviceManager.getCurrentAudioDevice() == nullptr)
+        return "The recordings could not be played";
+    
+    replayMidi.reset(new ReplayMidiOutput(replaySource));
+    tuner.setMidiSink(replayMidi.get());
+    tuner.setUsesVirtualClock(true);
+    return {};
+}
+
+void HeadlessSweep::listDevices()
+{
+    for (AudioIODeviceType* type : bench->getDeviceManager().getAvailableDeviceTypes())
+    {
+        type->scanForDevices();
+        std::cout << "Audio inputs (--audio-type \"" << type->getTypeName() << "\"):" << std::endl;
+        for (const String& name : type->getDeviceNames(true))
+            std::cout << "    " << name << std::endl;
+    }
+    
+    std::cout << "MIDI outputs:" << std::endl;
+    for (const MidiDeviceInfo& device : MidiOutput::getAvailableDevices())
+        std::cout << "    " << device.name << std::endl;
+}
+
+String HeadlessSweep::openArchive(const ArgumentList& args)
+{
+    archive = !args.containsOption("--no-archive");
+    if (!args.containsOption("--archive"))
+    {
+        // the app has only logged why its archive couldn't be opened
+        if (archive && !getSweepArchive().isOpen())
+            return "Can't open the sweep archive " + SweepArchive::getDefaultFile().getFullPathName()
+                   + ", see --archive and --no-archive";
+        return {};
+    }
+    
+    // replaces the app's archive for the lifetime of the process, which only runs the sweeps
+    const File file = args.getFileForOption("--archive");
+    const String error = getSweepArchive().open(file);
+    if (error.isNotEmpty())
+        return error;
+    if (!file.exists() && (args.containsOption("--list-sweeps") || args.containsOption("--fleet")
+                           || args.containsOption("--reports")))
+        return "There is no archive " + file.getFullPathName();
+    return {};
+}
+
+SweepArchive::Info HeadlessSweep::getArchiveInfo(const ArgumentList& args) const
+{
+    // the defaults are what was entered for the last report
+    PropertiesFile* settings = getAppProperties().getUserSettings();
+    SweepArchive::Info info;
+    info.dutBrand = settings->getValue("DUT-Brand");
+    info.dutDevice = settings->getValue("DUT-Device");
+    info.interfaceBrand = settings->getValue("Interface-Brand");
+    info.interfaceDevice = settings->getValue("Interface-Device");
+    info.notes = settings->getValue("Notes");
+    
+    if (args.containsOption("--dut-brand"))
+        info.dutBrand = args.getValueForOption("--dut-brand").trim();
+    if (args.containsOption("--dut-device"))
+        info.dutDevice = args.getValueForOption("--dut-device").trim();
+    if (args.containsOption("--serial"))
+        info.serialNumber = args.getValueForOption("--serial").trim();
+    if (args.containsOption("--interface-brand"))
+        info.interfaceBrand = args.getValueForOption("--interface-brand").trim();
+    if (args.containsOption("--interface-device"))
+        info.interfaceDevice = args.getValueForOption("--interface-device").trim();
+    if (args.containsOption("--notes"))
+        info.notes = args.getValueForOption("--notes");
+    return info;
+}
+
+String HeadlessSweep::configureQuery(const ArgumentList& args, SweepArchive::Query& query)
+{
+    // unlike a sweep, only the DUT options that are given select the sweeps
+    query.dutBrand = args.getValueForOption("--dut-brand").trim();
+    query.dutDevice = args.getValueForOption("--dut-device").trim();
+    query.serialNumber = args.getValueForOption("--serial").trim();
+    
+    StringArray errors;
+    errors.add(parseDate(args, "--from", false, query.from));
+    errors.add(parseDate(args, "--to", true, query.to));
+    if (args.containsOption("--format"))
+    {
+        const String format = args.getValueForOption("--format").trim().toLowerCase();
+        if (format == "json")
+            writeJson = true;
+        else if (format != "csv")
+            errors.add("--format must be csv or json");
+    }
+    errors.removeEmptyStrings();
+    return errors.joinIntoString(newLine);
+}
+
+void HeadlessSweep::listSweeps(const ArgumentList& args)
+{
+    SweepArchive::Query query;
+    const String error = configureQuery(args, query);
+    if (error.isNotEmpty())
+    {
+        std::cerr << error << std::endl << std::endl << getUsage();
+        finish(invalidArguments);
+        return;
+    }
+    
+    const SweepArchive& sweeps = getSweepArchive();
+    if (!writeJson)
+        writeLine(getSweepCsvHeader());
+    for (int index : sweeps.find(query))
+    {
+        const SweepArchive::Sweep sweep = sweeps.getSweep(index);
+        const SweepArchive::Info& info = sweep.getInfo();
+        if (writeJson)
+        {
+            DynamicObject::Ptr line = new DynamicObject();
+            line->setProperty("index", index);
+            line->setProperty("time", info.time.toISO8601(true));
+            line->setProperty("dutBrand", info.dutBrand);
+            line->setProperty("dutDevice", info.dutDevice);
+            line->setProperty("serialNumber", info.serialNumber);
+            line->setProperty("interfaceBrand", info.interfaceBrand);
+            line->setProperty("interfaceDevice", info.interfaceDevice);
+            line->setProperty("calibration", info.isCalibration);
+            line->setProperty("numMeasurements", sweep.getNumMeasurements());
+            writeLine(JSON::toString(var(line.get()), true));
+        }
+        else
+        {
+            StringArray fields;
+            fields.add(String(index));
+            fields.add(info.time.toISO8601(true));
+            fields.add(info.dutBrand.quoted());
+            fields.add(info.dutDevice.quoted());
+            fields.add(info.serialNumber.quoted());
+            fields.add(info.interfaceBrand.quoted());
+            fields.add(info.interfaceDevice.quoted());
+            fields.add(info.isCalibration ? "1" : "0");
+            fields.add(String(sweep.getNumMeasurements()));
+            writeLine(fields.joinIntoString(","));
+        }
+    }
+    finish(success);
+}
+
+String HeadlessSweep::archiveSweep()
+{
+    if (!archive || sweepResults.isEmpty())
+        return {};
+    
+    SweepArchive::Info info = SweepArchive::describe(bench->getTuner());
+    info.time = sweepStartDate;
+    info.dutBrand = archiveInfo.dutBrand;
+    info.dutDevice = archiveInfo.dutDevice;
+    info.serialNumber = archiveInfo.serialNumber;
+    info.interfaceBrand = archiveInfo.interfaceBrand;
+    info.interfaceDevice = archiveInfo.interfaceDevice;
+    info.notes = archiveInfo.notes;
+    return getSweepArchive().append(info, sweepResults);
+}
+
+void HeadlessSweep::analyseFleet(const ArgumentList& args)
+{
+    SweepArchive::Query query;
+    StringArray errors;
+    errors.add(configureQuery(args, query));
+    
+    const String analysis = args.getValueForOption("--fleet").trim().toLowerCase();
+    if (analysis != "notes" && analysis != "drift" && analysis != "tracking")
+        errors.add("--fleet must be notes, drift or tracking");
+    if (analysis == "drift" && (!args.containsOption("--from") || !args.containsOption("--to")))
+        errors.add("--fleet drift needs the two dates to compare as --from and --to");
+    
+    FleetAnalytics::Grouping grouping = FleetAnalytics::byInterface;
+    if (args.containsOption("--group-by"))
+    {
+        const String name = args.getValueForOption("--group-by").trim().toLowerCase();
+        const char* names[FleetAnalytics::numGroupings] = { "interface", "midi", "audio", "model" };
+        int found = -1;
+        for (int i = 0; i < FleetAnalytics::numGroupings; i++)
+        {
+            if (name == names[i])
+                found = i;
+        }
+        if (found < 0)
+            errors.add("--group-by must be interface, midi, audio or model");
+        else
+            grouping = (FleetAnalytics::Grouping) found;
+    }
+    
+    errors.removeEmptyStrings();
+    if (!errors.isEmpty())
+    {
+        std::cerr << errors.joinIntoString(newLine) << std::endl << std::endl << getUsage();
+        finish(invalidArguments);
+        return;
+    }
+    
+    // the rows are the same in both formats, only the way they are written differs
+    const FleetAnalytics analytics(getSweepArchive());
+    StringArray columns;
+    Array<Array<var>> rows;
+    if (analysis == "notes")
+    {
+        columns.addTokens("midiPitch,numValues,mean,standardDeviation,min,max", ",", "");
+        for (const FleetAnalytics::NoteStatistics& note : analytics.getNoteStatistics(query, !args.containsOption("--per-sweep")))
+            rows.add({ note.midiPitch, note.numValues, note.mean, note.standardDeviation, note.min, note.max });
+    }
+    else if (analysis == "drift")
+    {
+        // each unit as it was at the end of both days, unless times are given
+        Time first, second;
+        parseDate(args, "--from", true, first);
+        parseDate(args, "--to", true, second);
+        columns.addTokens("dutModel,serialNumber,input,before,after,numNotes,meanChange,maxChange", ",", "");
+        for (const FleetAnalytics::Drift& drift : analytics.getDrift(query, first, second))
+            rows.add({ drift.dutModel, drift.serialNumber, drift.lane + 1, drift.before.toISO8601(true),
+                       drift.after.toISO8601(true), drift.numNotes, drift.meanChange, drift.maxChange });
+    }
+    else
+    {
+        const FleetAnalytics::Comparison comparison = analytics.compareTrackingError(query, grouping);
+        columns.addTokens("group,numValues,meanTrackingError,trackingErrorDeviation,meanScaleError,varianceExplained", ",", "");
+        for (const FleetAnalytics::Group& group : comparison.groups)
+            rows.add({ group.name, group.numValues, group.meanTrackingError, group.trackingErrorDeviation,
+                       group.meanScaleError, comparison.varianceExplained });
+    }
+    
+    if (!writeJson)
+        writeLine(columns.joinIntoString(","));
+    for (const Array<var>& row : rows)
+    {
+        if (writeJson)
+        {
+            DynamicObject::Ptr line = new DynamicObject();
+            for (int i = 0; i < columns.size(); i++)
+                line->setProperty(columns[i], row[i]);
+            writeLine(JSON::toString(var(line.get()), true));
+        }
+        else
+        {
+            StringArray fields;
+            for (const var& value : row)
+            {
+                if (value.isString())
+                    fields.add(value.toString().quoted());
+                else
+                    fields.add(value.isDouble() ? String((double) value, 6) : value.toString());
+            }
+            writeLine(fields.joinIntoString(","));
+        }
+    }
+    finish(success);
+}
+
+void HeadlessSweep::writeReports(const ArgumentList& args)
+{
+    SweepArchive::Query query;
+    StringArray errors;
+    errors.add(configureQuery(args, query));
+    
+    ReportRenderer::Format format = ReportRenderer::png;
+    if (args.containsOption("--report-format")
+        && !ReportRenderer::getFormatForName(args.getValueForOption("--report-format"), format))
+        errors.add("--report-format must be png, jpeg, svg or pdf");
+    int dpi = ReportRenderer::defaultDpi;
+    errors.add(parseInt(args, "--dpi", 24, 1200, dpi));
+    
+    const String folderName = args.getValueForOption("--reports").trim();
+    if (folderName.isEmpty())
+        errors.add("--reports needs the folder to write the reports to");
+    
+    errors.removeEmptyStrings();
+    if (!errors.isEmpty())
+    {
+        std::cerr << errors.joinIntoString(newLine) << std::endl << std::endl << getUsage();
+        finish(invalidArguments);
+        return;
+    }
+    
+    const File folder = args.getFileForOption("--reports");
+    const Result created = folder.createDirectory();
+    if (created.failed())
+    {
+        std::cerr << "Can't create " << folder.getFullPathName() << ": " << created.getErrorMessage() << std::endl;
+        finish(outputNotWritable);
+        return;
+    }
+    
+    // the sweeps are taken from the archive here, the reports are rendered on all cores
+    const SweepArchive& sweeps = getSweepArchive();
+    ThreadPool pool(SystemStats::getNumCpus());
+    OwnedArray<ReportJob> jobs;
+    for (int index : sweeps.find(query))
+    {
+        const SweepArchive::Sweep sweep = sweeps.getSweep(index);
+        const File file = folder.getChildFile(ReportRenderer::getFileName(sweep.getInfo(), index, format));
+        pool.addJob(jobs.add(new ReportJob(sweep, file, format, dpi)), false);
+    }
+    
+    // one line per report, in the order of the archive
+    bool failed = false;
+    if (!writeJson)
+        writeLine("file");
+    for (ReportJob* job : jobs)
+    {
+        pool.waitForJobToFinish(job, -1);
+        if (job->error.isNotEmpty())
+        {
+            std::cerr << job->error << std::endl;
+            failed = true;
+        }
+        else if (writeJson)
+        {
+            DynamicObject::Ptr line = new DynamicObject();
+            line->setProperty("file", job->file.getFullPathName());
+            writeLine(JSON::toString(var(line.get()), true));
+        }
+        else
+            writeLine(job->file.getFullPathName().quoted());
+    }
+    finish(failed ? outputNotWritable : success);
+}
+
+//==============================================================================
+String HeadlessSweep::getCsvHeader()
+{
+    return "sweep,input,midiPitch,frequency,pitch,pitchOffset,rawPitchOffset,rawFrequency,freqDeviation,pitchDeviation,"
+           "pitchConfidenceInterval,numMeasurements,settleTime,settleWaitTime,timestamp";
+}
+
+String HeadlessSweep::toCsvLine(int sweep, const VCOTuner::measurement_t& m)
+{
+    StringArray fields;
+    fields.add(String(sweep));
+    fields.add(String(m.lane + 1));
+    fields.add(String(m.midiPitch));
+    fields.add(String(m.frequency, 6));
+    fields.add(String(m.pitch, 6));
+    fields.add(String(m.pitchOffset, 6));
+    fields.add(String(m.rawPitchOffset, 6));
+    fields.add(String(m.rawFrequency, 6));
+    fields.add(String(m.freqDeviation, 6));
+    fields.add(String(m.pitchDeviation, 6));
+    fields.add(String(m.pitchConfidenceInterval, 6));
+    fields.add(String(m.numMeasurements));
+    fields.add(String(m.settleTime, 2));
+    fields.add(String(m.settleWaitTime, 2));
+    fields.add(m.timestamp.toISO8601(true));
+    return fields.joinIntoString(",");
+}
+
+String HeadlessSweep::toJsonLine(int sweep, const VCOTuner::measurement_t& m)
+{
+    DynamicObject::Ptr line = new DynamicObject();
+    line->setProperty("sweep", sweep);
+    line->setProperty("input", m.lane + 1);
+    line->setProperty("midiPitch", m.midiPitch);
+    line->setProperty("frequency", m.frequency);
+    line->setProperty("pitch", m.pitch);
+    line->setProperty("pitchOffset", m.pitchOffset);
+    line->setProperty("rawPitchOffset", m.rawPitchOffset);
+    line->setProperty("rawFrequency", m.rawFrequency);
+    line->setProperty("freqDeviation", m.freqDeviation);
+    line->setProperty("pitchDeviation", m.pitchDeviation);
+    line->setProperty("pitchConfidenceInterval", m.pitchConfidenceInterval);
+    line->setProperty("numMeasurements", m.numMeasurements);
+    line->setProperty("settleTime", m.settleTime);
+    line->setProperty("settleWaitTime", m.settleWaitTime);
+    line->setProperty("timestamp", m.timestamp.toISO8601(true));
+    return JSON::toString(var(line.get()), true);
+}
+
+String HeadlessSweep::getCalibrationCsvHeader()
+{
+    return "sweep,input,midiPitch,correction,residual,numAttempts,converged";
+}
+
+String HeadlessSweep::toCsvLine(int sweep, const VCOTuner::calibration_t& c)
+{
+    StringArray fields;
+    fields.add(String(sweep));
+    fields.add(String(c.lane + 1));
+    fields.add(String(c.midiPitch));
+    fields.add(String(c.correction, 6));
+    fields.add(String(c.residual, 6));
+    fields.add(String(c.numAttempts));
+    fields.add(c.converged ? "1" : "0");
+    return fields.joinIntoString(",");
+}
+
+String HeadlessSweep::toJsonLine(int sweep, const VCOTuner::calibration_t& c)
+{
+    DynamicObject::Ptr line = new DynamicObject();
+    line->setProperty("sweep", sweep);
+    line->setProperty("input", c.lane + 1);
+    line->setProperty("midiPitch", c.midiPitch);
+    line->setProperty("correction", c.correction);
+    line->setProperty("residual", c.residual);
+    line->setProperty("numAttempts", c.numAttempts);
+    line->setProperty("converged", c.converged);
+    return JSON::toString(var(line.get()), true);
+}
+
+void HeadlessSweep::writeLine(const String& line)
+{
+    // flushed right away, so that a long run can be followed while it's going
+    if (output != nullptr)
+    {
+        output->writeText(line + "\n", false, false, nullptr);
+        output->flush();
+    }
+    else
+        std::cout << line << std::endl;
+}
+
+void HeadlessSweep::printErrors()
+{
+    const StringArray errors = bench->getTuner().getLastErrors();
+    for (const String& error : errors)
+    {
+        std::cerr << "Error: " << error << std::endl;
+        if (firstErrorExitCode == 0)
+            firstErrorExitCode = firstTunerError + VCOTuner::Errors::getCode(error);
+    }
+}
+
+void HeadlessSweep::finish(int exitCode)
+{
+    if (finished)
+        return;
+    finished = true;
+    stopTimer();
+    
+    if (output != nullptr)
+        output->flush();
+    
+    JUCEApplicationBase::getInstance()->setApplicationReturnValue(exitCode);
+    JUCEApplicationBase::quit();
+}
+
+//==============================================================================
+void HeadlessSweep::timerCallback()
+{
+    writeResults();
+}
+
+void HeadlessSweep::writeResults()
+{
+    VCOTuner::measurement_t m;
+    while (results.pop(m))
+    {
+        // a calibration reports its result separately, see below
+        sweepResults.add(m);
+        if (!calibrate)
+            writeLine(writeJson ? toJsonLine(currentSweep, m) : toCsvLine(currentSweep, m));
+    }
+    
+    if (results.getNumDropped() > numDroppedResults)
+    {
+        numDroppedResults = results.getNumDropped();
+        std::cerr << numDroppedResults << " results were lost, the output didn't keep up" << std::endl;
+    }
+}
+
+void HeadlessSweep::newCalibrationReady(const VCOTuner::calibration_t& c)
+{
+    sweepCalibrations.add(c);
+    writeLine(writeJson ? toJsonLine(currentSweep, c) : toCsvLine(currentSweep, c));
+}
+
+void HeadlessSweep::tunerStopped()
+{
+    // the audio device is restarted while it's set up, before the first sweep
+    if (currentSweep == 0)
+        return;
+    
+    writeResults();
+    
+    // stopped before the sweep was done, either by an error or by stop()
+    printErrors();
+    finish(firstErrorExitCode != 0 ? firstErrorExitCode : (int) interrupted);
+}
+
+void HeadlessSweep::tunerFinished()
+{
+    writeResults();
+    printErrors();
+    std::cerr << "Sweep " << currentSweep << " of " << numSweeps << " done in "
+              << String((Time::getMillisecondCounterHiRes() - sweepStartTime) / 1000.0, 1) << " s" << std::endl;
+    
+    const String archiveError = archiveSweep();
+    if (archiveError.isNotEmpty())
+    {
+        std::cerr << archiveError << std::endl;
+        finish(outputNotWritable);
+        return;
+    }
+    
+    if (currentSweep >= numSweeps)
+    {
+        if (tuningFile != File() && !sweepResults.isEmpty())
+        {
+            const String error = calibrate ? TuningTable::exportAll(sweepCalibrations, tuningFile)
+                                           : TuningTable::exportAll(sweepResults, tuningFile);
+            if (error.isNotEmpty())
+            {
+                std::cerr << error << std::endl;
+                finish(outputNotWritable);
+                return;
+            }
+        }
+        
+        // the notes that failed on some of the inputs decide the exit code
+        finish(firstErrorExitCode != 0 ? firstErrorExitCode : (int) success);
+        return;
+    }
+    
+    currentSweep++;
+    sweepResults.clearQuick();
+    sweepCalibrations.clearQuick();
+    sweepStartTime = Time::getMillisecondCounterHiRes();
+    sweepStartDate = Time::getCurrentTime();
+    if (calibrate)
+        bench->getTuner().startCalibration();
+    else
+        bench->getTuner().start();
+}
+
+void HeadlessSweep::tunerStatusChanged()
+{
+    // the errors of single inputs don't stop the sweep, but shouldn't wait until its end
+    printErrors();
+}
@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    HeadlessSweep.h
+    Created: 18 Oct 2026 9:41:17am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef HEADLESSSWEEP_H_INCLUDED
+#define HEADLESSSWEEP_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TunerSession.h"
+#include "SweepArchive.h"
+#include "ReplayAudioIODevice.h"
+
+/** Runs sweeps without any window, configured from the command line. Every result is
+    written as a line of CSV or JSON as soon as it is measured, so that overnight runs
+    on lab machines can be scripted and piped into other tools.
+    
+    VCOTuner --headless [options]
+    
+    --audio-type <name>      the audio driver type, e.g. ALSA, CoreAudio or ASIO
+    --audio-device <name>    the input device, by name. Without it, the device from the
+                             audio settings of the app is used.
+    --inputs <n>             the number of input channels, one oscillator on each (1)
+    --midi-output <name>     the MIDI output, by name. Without it, the one from the audio
+                             settings of the app is used.
+    --midi-channel <n>       the MIDI channel of the first input, the others follow (1)
+    --lowest <note>          the lowest MIDI note (48)
+    --highest <note>         the highest MIDI note (72)
+    --increment <n>          the interval between the notes (6)
+    --resolution <n>         the number of periods per note (100)
+    --confidence <cents>     stop a note as soon as its pitch is known within +/- this (0)
+    --reference-interval <s> measures the reference note again every so many seconds and
+                             at the end, and takes its drift out of the pitches, see
+                             VCOTuner::setReferenceInterval() (0 = only at the start)
+    --estimator <name>       how the frequency is estimated, e.g. "Zero crossings"
+    --input-filter <filter>  filters the signal before its zero crossings are timed: off, dc
+                             or band-pass, see SignalConditioner (off)
+    --order <order>          the order of the notes: monotonic, serpentine, random or
+                             min-jump, see SweepPlanner::Strategy (monotonic)
+    --sweeps <n>             the number of sweeps (1)
+    --format csv|json        one line of CSV or one JSON object per result (csv)
+    --output <file>          writes the results to a file instead of stdout
+    --tuning <file>          writes the tuning tables of the last sweep next to this file,
+                             see TuningTable::exportAll()
+    --calibrate              calibrates instead of sweeping, see VCOTuner::startCalibration().
+                             The lines and the tuning tables hold the corrections it found.
+    --correction bend|rpn    corrects with pitch bend or with the fine tuning RPN (bend)
+    --bend-range <n>         the pitch bend range of the interface in semitones (2)
+    --list-devices           lists the audio and MIDI devices and exits
+    --replay <file|folder>   plays recordings instead of measuring an oscillator, see
+                             ReplaySource. A folder holds one file per note ("60.wav"),
+                             each channel is one input. The tuner runs on a virtual clock,
+                             so the sweep takes as long as its analysis, not the recording.
+                             The audio and MIDI options are ignored.
+    
+    Every sweep is stored in the SweepArchive of the app, together with the details of
+    the DUT. Those that aren't given are taken from the last report.
+    
+    --archive <file>         stores the sweeps in this archive instead of the app's
+    --no-archive             doesn't store the sweeps at all
+    --dut-brand <text>       the brand of the DUT
+    --dut-device <text>      the model of the DUT
+    --serial <text>          the serial number of the DUT (none)
+    --interface-brand <text> the brand of the MIDI-CV interface
+    --interface-device <text> the model of the MIDI-CV interface
+    --notes <text>           notes about the sweep
+    --list-sweeps            lists the stored sweeps and exits. The DUT options and
+                             --from/--to <ISO 8601 date> select which ones.
+    --fleet notes|drift|tracking
+                             analyses the stored sweeps of the DUT options, see
+                             FleetAnalytics, and exits. notes gives the statistics of
+                             each note over the units (or each sweep with --per-sweep),
+                             drift the change of each unit between --from and --to,
+                             tracking the tracking error of each --group-by
+                             interface|midi|audio|model (interface).
+    --reports <folder>       writes the report of each stored sweep of the DUT options
+                             (and --from/--to) into the folder and exits. They are
+                             rendered in parallel, see ReportRenderer.
+    --report-format png|jpeg|svg|pdf
+                             the format of the reports (png)
+    --dpi <n>                the resolution of png and jpeg reports (96)
+    
+    The process exits with one of the ExitCodes. Errors of the tuner get their own code,
+    so that a script can tell a missing MIDI interface from an oscillator that doesn't
+    settle.
+ */
+class HeadlessSweep: private VCOTuner::Listener,
+                     private Timer
+{
+public:
+    enum ExitCode
+    {
+        success = 0,
+        invalidArguments = 1,
+        deviceNotAvailable = 2,
+        outputNotWritable = 3,
+        interrupted = 4,
+        /** the tuner's errors are added to this, see VCOTuner::Errors::getCode() */
+        firstTunerError = 10
+    };
+    
+    HeadlessSweep();
+    ~HeadlessSweep();
+    
+    /** true if the app should run without a window */
+    static bool isRequested(const ArgumentList& args);
+    static String getUsage();
+    
+    /** sets everything up and starts the first sweep. The app is quit with the exit code
+     when all sweeps are done, or right away if something went wrong. */
+    void start(const ArgumentList& args);
+    /** stops the running sweep, e.g. when the process was asked to quit */
+    void stop();
+    
+    /** the header of the CSV lines */
+    static String getCsvHeader();
+    static String toCsvLine(int sweep, const VCOTuner::measurement_t& m);
+    static String toJsonLine(int sweep, const VCOTuner::measurement_t& m);
+    static String getCalibrationCsvHeader();
+    static String toCsvLine(int sweep, const VCOTuner::calibration_t& c);
+    static String toJsonLine(int sweep, const VCOTuner::calibration_t& c);
+    
+private:
+    /** returns an error message if the arguments aren't valid */
+    String configure(const ArgumentList& args);
+    String openAudioDevice(const ArgumentList& args, int numInputs);
+    String selectMidiOutput(const ArgumentList& args);
+    /** plays the recordings of --replay through the tuner instead */
+    String openReplayDevice(const ArgumentList& args, int numInputs);
+    void listDevices();
+    /** returns an error message if the archive can't be opened */
+    String openArchive(const ArgumentList& args);
+    /** the details of the DUT, the devices are added for each sweep */
+    SweepArchive::Info getArchiveInfo(const ArgumentList& args) const;
+    /** the DUT, --from/--to and --format options of the commands that read the archive.
+     Returns an error message if they aren't valid. */
+    String configureQuery(const ArgumentList& args, SweepArchive::Query& query);
+    void listSweeps(const ArgumentList& args);
+    /** writes one line per row of the selected FleetAnalytics query */
+    void analyseFleet(const ArgumentList& args);
+    /** writes a report of each selected sweep and one line with its file */
+    void writeReports(const ArgumentList& args);
+    /** stores the finished sweep, returns an error message if it couldn't be written */
+    String archiveSweep();
+    
+    void writeLine(const String& line);
+    /** writes the results that came in since the last time */
+    void writeResults();
+    void printErrors();
+    void finish(int exitCode);
+    
+    /** the results are picked up from a queue, so that a slow output never holds up
+     the tuner. Everything else is rare enough to be written right away. */
+    void timerCallback() override;
+    
+    /** inherited from VCOTuner::Listener */
+    void newCalibrationReady(const VCOTuner::calibration_t& c) override;
+    void tunerStopped() override;
+    void tunerFinished() override;
+    void tunerStatusChanged() override;
+    
+    TunerSession session;
+    TunerSession::Bench* bench;
+    std::shared_ptr<ReplaySource> replaySource; // nullptr unless --replay is used
+    std::unique_ptr<ReplayMidiOutput> replayMidi;
+    VCOTuner::ResultQueue results;
+    int numDroppedResults; // reported so far
+    
+    bool writeJson;
+    bool calibrate;
+    std::unique_ptr<FileOutputStream> output; // nullptr writes to stdout
+    File tuningFile; // no tuning tables are written if it's empty
+    bool archive;
+    SweepArchive::Info archiveInfo;
+    Array<VCOTuner::measurement_t> sweepResults; // of the running sweep
+    Array<VCOTuner::calibration_t> sweepCalibrations;
+    int numSweeps;
+    int currentSweep; // counted from 1
+    double sweepStartTime;
+    Time sweepStartDate; // stored with the sweep
+    int firstErrorExitCode; // the exit code of the first error of the tuner, 0 = none yet
+    bool finished;
+    
+    JUCE_DECLARE_NON_COPYABLE(HeadlessSweep)
+};
+
+
+#endif  // HEADLESSSWEEP_H_INCLUDED
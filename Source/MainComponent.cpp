@@ -1,398 +1,762 @@
-/*
-  ==============================================================================
-
-    MainComponent.cpp
-    Created: 17 May 2016 8:21:04pm
-    Author:  Johannes Neumann
-
-  ==============================================================================
-*/
-
-#include "../JuceLibraryCode/JuceHeader.h"
-#include "MainComponent.h"
-#include "ReportCreatorWindow.h"
-
-MainComponent::MainComponent() : tuner(&deviceManager), display(&tuner)
-{
-    std::unique_ptr<XmlElement> savedAudioState (getAppProperties().getUserSettings()
-                                               ->getXmlValue ("audioDeviceState"));
-    
-    deviceManager.initialise (1, 0, savedAudioState.get(), true);
-    
-    setVisible (true);
-    
-    Process::setPriority (Process::HighPriority);
-    
-    audioSettings.setName("AudioSettingsBttn");
-    audioSettings.setButtonText("Audio Settings");
-    audioSettings.addListener(this);
-    addAndMakeVisible(&audioSettings);
-    
-    startStop.setName("StartStopBttn");
-    startStop.setButtonText("Start");
-    startStop.addListener(this);
-    addAndMakeVisible(&startStop);
-    
-    report.setName("ReportBttn");
-    report.setButtonText("Create Report");
-    report.addListener(this);
-    addAndMakeVisible(&report);
-    
-    statusLabel.setName("Status Label");
-    statusLabel.setJustificationType(juce::Justification::centred);
-    addAndMakeVisible(&statusLabel);
-    
-    regimeLabel.setName("Regime Label");
-    regimeLabel.setText("Pitch range: ", dontSendNotification);
-    regimeLabel.setJustificationType(juce::Justification::centredRight);
-    addAndMakeVisible(&regimeLabel);
-    
-    regime.setName("RegimeSelector");
-    regime.addItemList(StringArray(regimeTexts, numRegimes), 1);
-    regime.addListener(this);
-    if (getAppProperties().getUserSettings()->containsKey("RegimeID"))
-        regime.setSelectedId(getAppProperties().getUserSettings()->getIntValue("RegimeID"));
-    else
-        regime.setSelectedId(1);
-    addAndMakeVisible(&regime);
-    
-    resolutionLabel.setName("Resolution Label");
-    resolutionLabel.setText("Resolution: ", dontSendNotification);
-    resolutionLabel.setJustificationType(juce::Justification::centredRight);
-    addAndMakeVisible(&resolutionLabel);
-    
-    resolution.setName("ResolutionSelector");
-    resolution.addItemList(StringArray(resolutionsTexts, numResolutions), 1);
-    resolution.addListener(this);
-    if (getAppProperties().getUserSettings()->containsKey("ResolutionID"))
-        resolution.setSelectedId(getAppProperties().getUserSettings()->getIntValue("ResolutionID"));
-    else
-        resolution.setSelectedId(1);
-    addAndMakeVisible(&resolution);
-    
-    display.setName("ResultsDisplay");
-    addAndMakeVisible(&display);
-    
-    tuner.addListener(this);
-    tuner.addListener(&display);
-    if (getAppProperties().getUserSettings()->containsKey("MIDIChannel"))
-        tuner.setMidiChannel(getAppProperties().getUserSettings()->getIntValue("MIDIChannel"));
-    else
-        tuner.setMidiChannel(1);
-    
-    cycle = false;
-    creatingReport = false;
-    
-    // for first-time starters, display a help message and the audio settings
-    if ((!getAppProperties().getUserSettings()->containsKey("hideWelcomeScreen"))
-        || (getAppProperties().getUserSettings()->getIntValue("hideWelcomeScreen") != 1))
-    {
-        NativeMessageBox::showMessageBox(AlertWindow::AlertIconType::InfoIcon, "Welcome!", welcomeText);
-        showAudioSettings();
-        getAppProperties().getUserSettings()->setValue("hideWelcomeScreen", 1);
-    }
-}
-
-MainComponent::~MainComponent()
-{
-    tuner.removeListener(this);
-    getAppProperties().getUserSettings()->setValue("RegimeID", regime.getSelectedId());
-    getAppProperties().getUserSettings()->setValue("ResolutionID", resolution.getSelectedId());
-}
-
-
-void MainComponent::resized()
-{
-    const int borderWidth = 10;
-    const int buttonWidth = 100;
-    const int buttonHeight = 20;
-    
-    audioSettings.setBounds(borderWidth, borderWidth, buttonWidth, buttonHeight);
-    report.setBounds(getWidth() - buttonWidth - borderWidth, borderWidth, buttonWidth, buttonHeight);
-    startStop.setBounds(report.getX() - buttonWidth - borderWidth, borderWidth, buttonWidth, buttonHeight);
-    statusLabel.setBounds(audioSettings.getRight() + borderWidth,
-                          borderWidth,
-                          startStop.getX() - borderWidth - borderWidth - audioSettings.getRight(),
-                          buttonHeight);
-    
-    regime.setBounds(getWidth() - 120 - borderWidth, audioSettings.getBottom() + borderWidth, 120, buttonHeight);
-    regimeLabel.setBounds(regime.getX() - 80 - borderWidth, audioSettings.getBottom() + borderWidth, 80, buttonHeight);
-    resolution.setBounds(regimeLabel.getX() - 120 - borderWidth, audioSettings.getBottom() + borderWidth, 120, buttonHeight);
-    resolutionLabel.setBounds(resolution.getX() - 80 - borderWidth, audioSettings.getBottom() + borderWidth, 80, buttonHeight);
-    
-    display.setBounds(borderWidth,
-                      regimeLabel.getBottom() + borderWidth,
-                      getWidth() - 2 * borderWidth,
-                      getHeight() - 2* borderWidth - regimeLabel.getBottom());
-
-}
-
-void MainComponent::paint(Graphics& g)
-{
-    g.setColour(Colours::lightgrey);
-    g.fillAll();
-}
-
-
-void MainComponent::buttonClicked (Button* bttn)
-{
-    if (bttn == &audioSettings)
-        showAudioSettings();
-    else if (bttn == &startStop)
-    {
-        // re-apply the currently selected settings on a start.
-        // this prevents the VCOTuner and the comboboxes being out of
-        // sync after a report (when report is finished, the settings from the
-        // report remain active but the comboboxes still show the old value)
-        if (!tuner.isRunning())
-        {
-            comboBoxChanged(&regime);
-            comboBoxChanged(&resolution);
-        }
-        tuner.toggleState();
-        if (tuner.isRunning())
-        {
-            display.clearCache();
-            cycle = true;
-        }
-    }
-    else if (bttn == &report)
-    {
-        ReportCreatorWindow* reportWindow = new ReportCreatorWindow(&tuner, &display);
-        
-        DialogWindow::LaunchOptions o;
-        o.content.setOwned (reportWindow);
-        o.dialogTitle                   = "Create Report";
-        o.componentToCentreAround       = this;
-        o.dialogBackgroundColour        = Colours::lightgrey;
-        o.escapeKeyTriggersCloseButton  = false;
-        o.resizable                     = true;
-        o.useNativeTitleBar             = true;
-        
-        o.launchAsync();
-    }
-}
-
-void MainComponent::startCreatingReport()
-{
-    tuner.setNumMeasurementRange(reportRange.startNote, reportRange.interval, reportRange.endNote);
-    display.clearCache();
-    creatingReport = true;
-}
-
-void MainComponent::comboBoxChanged (ComboBox* comboBoxThatHasChanged)
-{
-    if (comboBoxThatHasChanged == &regime)
-    {
-        bool wasRunning = false;
-        bool wasCycling = cycle;
-        if (tuner.isRunning())
-        {
-            wasRunning = true;
-            tuner.toggleState();
-        }
-        
-        int selected = comboBoxThatHasChanged->getSelectedId() - 1;
-        tuner.setNumMeasurementRange(regimes[selected].startNote, regimes[selected].interval, regimes[selected].endNote);
-        display.clearCache();
-        
-        
-        if (wasRunning)
-        {
-            tuner.toggleState();
-            cycle = wasCycling;
-        }
-    }
-    else if (comboBoxThatHasChanged == &resolution)
-    {
-        bool wasRunning = false;
-        bool wasCycling = cycle;
-        if (tuner.isRunning())
-        {
-            wasRunning = true;
-            tuner.toggleState();
-        }
-        
-        int selected = comboBoxThatHasChanged->getSelectedId() - 1;
-        tuner.setResolution(resolutions[selected]);        
-        
-        if (wasRunning)
-        {
-            tuner.toggleState();
-            cycle = wasCycling;
-        }
-    }
-}
-
-void MainComponent::showAudioSettings()
-{
-    class SettingsWrapperComponent: public Component,
-                                    public ComboBox::Listener,
-                                    public TextButton::Listener
-    {
-    public:
-        SettingsWrapperComponent(VCOTuner* tunerToUse, juce::AudioDeviceManager& m)
-        : selectorComponent(m, 1, 1, 0, 0, false, true, false, false)
-        {
-            t = tunerToUse;
-            
-            channelLabel.setName("MidiChannel Label");
-            channelLabel.setText("MIDI Channel: ", dontSendNotification);
-            channelLabel.setJustificationType(juce::Justification::centredRight);
-            addAndMakeVisible(&channelLabel);
-            
-            channelEdit.setName("MidiChannel Edit");
-            const char* items[16] = {"1", "2", "3", "4", "5", "6", "7", "8",
-                                     "9", "10", "11", "12", "13", "14", "15", "16"};
-            channelEdit.addItemList(StringArray(items, 16), 1);
-            channelEdit.addListener(this);
-            if (getAppProperties().getUserSettings()->containsKey("MIDIChannel"))
-                channelEdit.setSelectedId(getAppProperties().getUserSettings()->getIntValue("MIDIChannel"));
-            else
-                channelEdit.setSelectedId(1);
-            addAndMakeVisible(&channelEdit);
-            
-            close.setButtonText("Close");
-            close.addListener(this);
-            addAndMakeVisible(&close);
-            
-            addAndMakeVisible(&selectorComponent);
-        }
-        
-        void comboBoxChanged (ComboBox* comboBoxThatHasChanged) override
-        {
-            int channel = comboBoxThatHasChanged->getSelectedId();
-            t->setMidiChannel(channel);
-            getAppProperties().getUserSettings()->setValue("MIDIChannel", channel);
-        }
-        
-        void resized() override
-        {
-            const int height = selectorComponent.getItemHeight();
-            const int border = 10;
-            
-            selectorComponent.setBounds(0, 0, getWidth(), getHeight() - 4*border - 2*height);
-            // selectorComponent overwrites its height in its resized() function. But it doesnt seem to work
-            channelEdit.setBounds(proportionOfWidth (0.35f), selectorComponent.getBottom() + border, proportionOfWidth (0.6f), height);
-            channelLabel.setBounds(0, selectorComponent.getBottom() + border, proportionOfWidth (0.35f), height);
-            close.setBounds(border, getHeight() - border - height, getWidth() - 2*border, height);
-        }
-        
-        void buttonClicked (Button* bttn) override
-        {
-            if (bttn == &close)
-            {
-                if (DialogWindow* dw = findParentComponentOfClass<DialogWindow>())
-                    dw->exitModalState (0);
-            }
-        }
-        
-    private:
-        AudioDeviceSelectorComponent selectorComponent;
-        Label channelLabel;
-        TextButton close;
-        ComboBox channelEdit;
-        VCOTuner* t;
-    };
-    
-    SettingsWrapperComponent content(&tuner, deviceManager);
-    content.setSize(400, 410);
-    
-    
-    DialogWindow::LaunchOptions o;
-    o.content.setNonOwned (&content);
-    o.dialogTitle                   = "Audio & Midi Settings";
-    o.componentToCentreAround       = this;
-    o.dialogBackgroundColour        = Colours::lightgrey;
-    o.escapeKeyTriggersCloseButton  = true;
-    o.resizable                     = true;
-    o.useNativeTitleBar             = true;
-    
-    o.runModal();
-    
-    std::unique_ptr<XmlElement> audioState (deviceManager.createStateXml());
-    
-    getAppProperties().getUserSettings()->setValue ("audioDeviceState", audioState.get());
-    getAppProperties().getUserSettings()->saveIfNeeded();
-}
-
-
-void MainComponent::tunerStarted()
-{
-    startStop.setButtonText("Stop");
-}
-
-void MainComponent::tunerStatusChanged(String statusString)
-{
-    if (creatingReport)
-        statusLabel.setText("Creating Report: " + statusString, juce::dontSendNotification);
-    else
-        statusLabel.setText(statusString, juce::dontSendNotification);
-}
-
-void MainComponent::tunerStopped()
-{
-    StringArray errors = tuner.getLastErrors();
-    for (int i = 0; i < errors.size(); i++)
-        NativeMessageBox::showMessageBox(AlertWindow::WarningIcon, "Error!", errors[i]);
-    
-    startStop.setButtonText("Start");
-    cycle = false;
-    creatingReport = false;
-}
-
-void MainComponent::tunerFinished()
-{
-    startStop.setButtonText("Start");
-    
-    if (creatingReport)
-    {
-        creatingReport = false;
-    }
-    
-    if (cycle)
-        tuner.toggleState();
-}
-
-const MainComponent::regime_t MainComponent::regimes[numRegimes] = {
-    {54, 66, 6},
-    {54, 66, 3},
-    {54, 66, 1},
-    {48, 72, 12},
-    {48, 72, 6},
-    {48, 72, 1},
-    {36, 84, 12},
-    {36, 84, 6},
-    {36, 84, 1},
-    {24, 96, 12},
-    {24, 96, 6},
-    {24, 96, 1},
-};
-const char* MainComponent::regimeTexts[numRegimes] = {
-    "narrow > coarse (54-66, +6)",
-    "narrow > normal (54-66, +3)",
-    "narrow > fine (54-66, +1)",
-    "medium > coarse (48-72, +12)",
-    "medium > normal (48-72, +6)",
-    "medium > fine (48-72, +1)",
-    "large > coarse (36-84, +12)",
-    "large > normal (36-84, +6)",
-    "large > fine (36-84, +1)",
-    "huge > coarse (24-96, +12)",
-    "huge > normal (24-96, +6)",
-    "huge > fine (24-96, +1)",
-};
-
-const int MainComponent::resolutions[numResolutions] = {20, 50, 100, 200, 400};
-const char* MainComponent::resolutionsTexts[numResolutions] = {
-    "20 - quick & dirty",
-    "50 - not quite enough",
-    "100 - okay",
-    "200 - neat and tidy",
-    "400 - never accurate enough"
-};
-
-const MainComponent::regime_t MainComponent::reportRange = {24, 96, 1};
-
-const String MainComponent::welcomeText = String("Welcome to the VCO Tuner!") + newLine + newLine + "Please follow these steps to get running:" + newLine + "1) connect a MIDI-CV interface to your Computer" + newLine + "2) connect the CV output of the interface to your oscillators frequency input" + newLine + "3) Connect one of the oscillators basic waveforms (sine, saw, triangle, pulse, etc.) directly to your soundcard (use attenuation to avoid clipping)." + newLine + newLine + "When you close this dialog, the audio settings panel will open. Please select your audio and midi device there." + newLine + newLine + "Have fun!" + newLine + newLine + "PS: If you find bugs, please raise an issue on the github repository under https://github.com/TheSlowGrowth/VCOTuner. Thanks!";
-
+/*
+  ==============================================================================
+
+    MainComponent.cpp
+    Created: 17 May 2016 8:21:04pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MainComponent.h"
+#include "ReportCreatorWindow.h"
+#include "TuningTable.h"
+#include "SweepArchive.h"
+#include "FleetWindow.h"
+
+namespace
+{
+    const int statusRefreshIntervalMs = 100;
+}
+
+MainComponent::MainComponent()
+: bench(*session.addBench("Bench 1")),
+  deviceManager(bench.getDeviceManager()),
+  tuner(bench.getTuner()),
+  display(&tuner),
+  diagnostics(tuner)
+{
+    std::unique_ptr<XmlElement> savedAudioState (getAppProperties().getUserSettings()
+                                               ->getXmlValue ("audioDeviceState"));
+    
+    bench.initialise (1, savedAudioState.get());
+    
+    setVisible (true);
+    
+    Process::setPriority (Process::HighPriority);
+    
+    audioSettings.setName("AudioSettingsBttn");
+    audioSettings.setButtonText("Audio Settings");
+    audioSettings.addListener(this);
+    addAndMakeVisible(&audioSettings);
+    
+    startStop.setName("StartStopBttn");
+    startStop.setButtonText("Start");
+    startStop.addListener(this);
+    addAndMakeVisible(&startStop);
+    
+    report.setName("ReportBttn");
+    report.setButtonText("Create Report");
+    report.addListener(this);
+    addAndMakeVisible(&report);
+    
+    exportTuning.setName("ExportTuningBttn");
+    exportTuning.setButtonText("Export Tuning");
+    exportTuning.addListener(this);
+    addAndMakeVisible(&exportTuning);
+    
+    calibrate.setName("CalibrateBttn");
+    calibrate.setButtonText("Calibrate");
+    calibrate.addListener(this);
+    addAndMakeVisible(&calibrate);
+    
+    fleet.setName("FleetBttn");
+    fleet.setButtonText("Fleet Analysis");
+    fleet.addListener(this);
+    addAndMakeVisible(&fleet);
+    
+    statusLabel.setName("Status Label");
+    statusLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(&statusLabel);
+    
+    diagnostics.setName("Diagnostics");
+    addAndMakeVisible(&diagnostics);
+    
+    regimeLabel.setName("Regime Label");
+    regimeLabel.setText("Pitch range: ", dontSendNotification);
+    regimeLabel.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(&regimeLabel);
+    
+    regime.setName("RegimeSelector");
+    regime.addItemList(StringArray(regimeTexts, numRegimes), 1);
+    regime.addListener(this);
+    if (getAppProperties().getUserSettings()->containsKey("RegimeID"))
+        regime.setSelectedId(getAppProperties().getUserSettings()->getIntValue("RegimeID"));
+    else
+        regime.setSelectedId(1);
+    addAndMakeVisible(&regime);
+    
+    resolutionLabel.setName("Resolution Label");
+    resolutionLabel.setText("Resolution: ", dontSendNotification);
+    resolutionLabel.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(&resolutionLabel);
+    
+    resolution.setName("ResolutionSelector");
+    resolution.addItemList(StringArray(resolutionsTexts, numResolutions), 1);
+    resolution.addListener(this);
+    if (getAppProperties().getUserSettings()->containsKey("ResolutionID"))
+        resolution.setSelectedId(getAppProperties().getUserSettings()->getIntValue("ResolutionID"));
+    else
+        resolution.setSelectedId(1);
+    addAndMakeVisible(&resolution);
+    
+    confidenceLabel.setName("Confidence Label");
+    confidenceLabel.setText("Stop at: ", dontSendNotification);
+    confidenceLabel.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(&confidenceLabel);
+    
+    confidence.setName("ConfidenceSelector");
+    confidence.addItemList(StringArray(confidencesTexts, numConfidences), 1);
+    confidence.addListener(this);
+    if (getAppProperties().getUserSettings()->containsKey("ConfidenceID"))
+        confidence.setSelectedId(getAppProperties().getUserSettings()->getIntValue("ConfidenceID"));
+    else
+        confidence.setSelectedId(1);
+    addAndMakeVisible(&confidence);
+    
+    estimatorLabel.setName("Estimator Label");
+    estimatorLabel.setText("Method: ", dontSendNotification);
+    estimatorLabel.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(&estimatorLabel);
+    
+    estimator.setName("EstimatorSelector");
+    for (int i = 0; i < FrequencyEstimator::numTypes; i++)
+        estimator.addItem(FrequencyEstimator::getName((FrequencyEstimator::Type) i), i + 1);
+    estimator.addListener(this);
+    if (getAppProperties().getUserSettings()->containsKey("EstimatorID"))
+        estimator.setSelectedId(getAppProperties().getUserSettings()->getIntValue("EstimatorID"));
+    else
+        estimator.setSelectedId(1);
+    addAndMakeVisible(&estimator);
+    
+    conditioningLabel.setName("Conditioning Label");
+    conditioningLabel.setText("Input filter: ", dontSendNotification);
+    conditioningLabel.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(&conditioningLabel);
+    
+    conditioning.setName("ConditioningSelector");
+    for (int i = 0; i < SignalConditioner::numModes; i++)
+        conditioning.addItem(SignalConditioner::getName((SignalConditioner::Mode) i), i + 1);
+    conditioning.addListener(this);
+    if (getAppProperties().getUserSettings()->containsKey("ConditioningID"))
+        conditioning.setSelectedId(getAppProperties().getUserSettings()->getIntValue("ConditioningID"));
+    else
+        conditioning.setSelectedId(1);
+    addAndMakeVisible(&conditioning);
+    
+    orderLabel.setName("Order Label");
+    orderLabel.setText("Order: ", dontSendNotification);
+    orderLabel.setJustificationType(juce::Justification::centredRight);
+    addAndMakeVisible(&orderLabel);
+    
+    order.setName("OrderSelector");
+    for (int i = 0; i < SweepPlanner::numStrategies; i++)
+        order.addItem(SweepPlanner::getName((SweepPlanner::Strategy) i), i + 1);
+    order.addListener(this);
+    if (getAppProperties().getUserSettings()->containsKey("SweepOrderID"))
+        order.setSelectedId(getAppProperties().getUserSettings()->getIntValue("SweepOrderID"));
+    else
+        order.setSelectedId(1);
+    addAndMakeVisible(&order);
+    
+    display.setName("ResultsDisplay");
+    addAndMakeVisible(&display);
+    
+    tuner.addListener(this);
+    tuner.addListener(&display);
+    updateLanes();
+    updateCorrection();
+    
+    cycle = false;
+    creatingReport = false;
+    shownStatusVersion = 0;
+    shownCreatingReport = false;
+    startTimer(statusRefreshIntervalMs);
+    
+    // for first-time starters, display a help message and the audio settings
+    if ((!getAppProperties().getUserSettings()->containsKey("hideWelcomeScreen"))
+        || (getAppProperties().getUserSettings()->getIntValue("hideWelcomeScreen") != 1))
+    {
+        NativeMessageBox::showMessageBox(AlertWindow::AlertIconType::InfoIcon, "Welcome!", welcomeText);
+        showAudioSettings();
+        getAppProperties().getUserSettings()->setValue("hideWelcomeScreen", 1);
+    }
+}
+
+MainComponent::~MainComponent()
+{
+    stopTimer();
+    tuner.removeListener(this);
+    getAppProperties().getUserSettings()->setValue("RegimeID", regime.getSelectedId());
+    getAppProperties().getUserSettings()->setValue("ResolutionID", resolution.getSelectedId());
+    getAppProperties().getUserSettings()->setValue("ConfidenceID", confidence.getSelectedId());
+    getAppProperties().getUserSettings()->setValue("EstimatorID", estimator.getSelectedId());
+    getAppProperties().getUserSettings()->setValue("ConditioningID", conditioning.getSelectedId());
+    getAppProperties().getUserSettings()->setValue("SweepOrderID", order.getSelectedId());
+}
+
+
+void MainComponent::resized()
+{
+    const int borderWidth = 10;
+    const int buttonWidth = 100;
+    const int buttonHeight = 20;
+    
+    audioSettings.setBounds(borderWidth, borderWidth, buttonWidth, buttonHeight);
+    report.setBounds(getWidth() - buttonWidth - borderWidth, borderWidth, buttonWidth, buttonHeight);
+    startStop.setBounds(report.getX() - buttonWidth - borderWidth, borderWidth, buttonWidth, buttonHeight);
+    exportTuning.setBounds(borderWidth, audioSettings.getBottom() + borderWidth, buttonWidth, buttonHeight);
+    calibrate.setBounds(exportTuning.getRight() + borderWidth, audioSettings.getBottom() + borderWidth, buttonWidth, buttonHeight);
+    fleet.setBounds(borderWidth, exportTuning.getBottom() + borderWidth, buttonWidth, buttonHeight);
+    
+    // the status gets the larger part of the space between the buttons
+    const int statusWidth = startStop.getX() - borderWidth - borderWidth - audioSettings.getRight();
+    const int diagnosticsWidth = jmin(320, statusWidth / 2);
+    diagnostics.setBounds(startStop.getX() - borderWidth - diagnosticsWidth, borderWidth, diagnosticsWidth, buttonHeight);
+    statusLabel.setBounds(audioSettings.getRight() + borderWidth,
+                          borderWidth,
+                          diagnostics.getX() - audioSettings.getRight() - borderWidth,
+                          buttonHeight);
+    
+    regime.setBounds(getWidth() - 120 - borderWidth, audioSettings.getBottom() + borderWidth, 120, buttonHeight);
+    regimeLabel.setBounds(regime.getX() - 80 - borderWidth, audioSettings.getBottom() + borderWidth, 80, buttonHeight);
+    resolution.setBounds(regimeLabel.getX() - 120 - borderWidth, audioSettings.getBottom() + borderWidth, 120, buttonHeight);
+    resolutionLabel.setBounds(resolution.getX() - 80 - borderWidth, audioSettings.getBottom() + borderWidth, 80, buttonHeight);
+    
+    confidence.setBounds(getWidth() - 120 - borderWidth, regime.getBottom() + borderWidth, 120, buttonHeight);
+    confidenceLabel.setBounds(confidence.getX() - 80 - borderWidth, regime.getBottom() + borderWidth, 80, buttonHeight);
+    estimator.setBounds(confidenceLabel.getX() - 120 - borderWidth, regime.getBottom() + borderWidth, 120, buttonHeight);
+    estimatorLabel.setBounds(estimator.getX() - 80 - borderWidth, regime.getBottom() + borderWidth, 80, buttonHeight);
+    
+    order.setBounds(getWidth() - 120 - borderWidth, confidence.getBottom() + borderWidth, 120, buttonHeight);
+    orderLabel.setBounds(order.getX() - 80 - borderWidth, confidence.getBottom() + borderWidth, 80, buttonHeight);
+    conditioning.setBounds(orderLabel.getX() - 120 - borderWidth, confidence.getBottom() + borderWidth, 120, buttonHeight);
+    conditioningLabel.setBounds(conditioning.getX() - 80 - borderWidth, confidence.getBottom() + borderWidth, 80, buttonHeight);
+    
+    display.setBounds(borderWidth,
+                      order.getBottom() + borderWidth,
+                      getWidth() - 2 * borderWidth,
+                      getHeight() - 2* borderWidth - order.getBottom());
+
+}
+
+void MainComponent::paint(Graphics& g)
+{
+    g.setColour(Colours::lightgrey);
+    g.fillAll();
+}
+
+
+void MainComponent::buttonClicked (Button* bttn)
+{
+    if (bttn == &audioSettings)
+        showAudioSettings();
+    else if (bttn == &startStop)
+    {
+        // re-apply the currently selected settings on a start.
+        // this prevents the VCOTuner and the comboboxes being out of
+        // sync after a report (when report is finished, the settings from the
+        // report remain active but the comboboxes still show the old value)
+        if (!tuner.isRunning())
+        {
+            comboBoxChanged(&regime);
+            comboBoxChanged(&resolution);
+        }
+        tuner.toggleState();
+        if (tuner.isRunning())
+        {
+            display.clearCache();
+            calibrations.clearQuick();
+            cycle = true;
+        }
+    }
+    else if (bttn == &calibrate)
+    {
+        if (tuner.isRunning())
+            tuner.toggleState();
+        else
+        {
+            comboBoxChanged(&regime);
+            comboBoxChanged(&resolution);
+            display.clearCache();
+            calibrations.clearQuick();
+            cycle = false;
+            tuner.startCalibration();
+        }
+    }
+    else if (bttn == &report)
+    {
+        ReportCreatorWindow* reportWindow = new ReportCreatorWindow(&tuner, &display);
+        
+        DialogWindow::LaunchOptions o;
+        o.content.setOwned (reportWindow);
+        o.dialogTitle                   = "Create Report";
+        o.componentToCentreAround       = this;
+        o.dialogBackgroundColour        = Colours::lightgrey;
+        o.escapeKeyTriggersCloseButton  = false;
+        o.resizable                     = true;
+        o.useNativeTitleBar             = true;
+        
+        o.launchAsync();
+    }
+    else if (bttn == &exportTuning)
+        exportTuningTables();
+    else if (bttn == &fleet)
+    {
+        DialogWindow::LaunchOptions o;
+        o.content.setOwned (new FleetWindow(&tuner));
+        o.dialogTitle                   = "Fleet Analysis";
+        o.componentToCentreAround       = this;
+        o.dialogBackgroundColour        = Colours::lightgrey;
+        o.escapeKeyTriggersCloseButton  = true;
+        o.resizable                     = true;
+        o.useNativeTitleBar             = true;
+        
+        o.launchAsync();
+    }
+}
+
+void MainComponent::exportTuningTables()
+{
+    const Array<VCOTuner::measurement_t> results = display.getResults();
+    if (results.isEmpty() && calibrations.isEmpty())
+    {
+        NativeMessageBox::showMessageBox(AlertWindow::InfoIcon, "Export Tuning", "Please run a measurement first.");
+        return;
+    }
+    
+    // don't use native file chooser for linux - it crashes on some systems
+#ifdef JUCE_LINUX
+    FileChooser fileChooser("Export tuning tables ... ", File(), "*.scl;*.kbm;*.syx;*.csv", false);
+#else
+    FileChooser fileChooser("Export tuning tables ... ", File(), "*.scl;*.kbm;*.syx;*.csv", true);
+#endif
+    if (fileChooser.browseForFileToSave(false))
+    {
+        const String error = calibrations.isEmpty() ? TuningTable::exportAll(results, fileChooser.getResult())
+                                                    : TuningTable::exportAll(calibrations, fileChooser.getResult());
+        if (error.isNotEmpty())
+            NativeMessageBox::showMessageBox(AlertWindow::WarningIcon, "Error!", error);
+    }
+}
+
+void MainComponent::archiveSweep()
+{
+    // the reason why it couldn't be opened was logged when the app started
+    const Array<VCOTuner::measurement_t> results = display.getResults();
+    if (results.isEmpty() || !getSweepArchive().isOpen())
+        return;
+    
+    PropertiesFile* settings = getAppProperties().getUserSettings();
+    SweepArchive::Info info = SweepArchive::describe(tuner);
+    info.time = sweepStartTime;
+    info.dutBrand = settings->getValue("DUT-Brand");
+    info.dutDevice = settings->getValue("DUT-Device");
+    info.interfaceBrand = settings->getValue("Interface-Brand");
+    info.interfaceDevice = settings->getValue("Interface-Device");
+    info.notes = settings->getValue("Notes");
+    
+    // this runs in a callback of the tuner, which must not run again from a modal loop
+    const String error = getSweepArchive().append(info, results);
+    if (error.isNotEmpty())
+        NativeMessageBox::showMessageBoxAsync(AlertWindow::WarningIcon, "Error!", error);
+}
+
+void MainComponent::startCreatingReport()
+{
+    tuner.setNumMeasurementRange(reportRange.startNote, reportRange.interval, reportRange.endNote);
+    display.clearCache();
+    calibrations.clearQuick();
+    creatingReport = true;
+}
+
+void MainComponent::comboBoxChanged (ComboBox* comboBoxThatHasChanged)
+{
+    if (comboBoxThatHasChanged == &regime)
+    {
+        bool wasRunning = false;
+        bool wasCycling = cycle;
+        if (tuner.isRunning())
+        {
+            wasRunning = true;
+            tuner.toggleState();
+        }
+        
+        int selected = comboBoxThatHasChanged->getSelectedId() - 1;
+        tuner.setNumMeasurementRange(regimes[selected].startNote, regimes[selected].interval, regimes[selected].endNote);
+        display.clearCache();
+        
+        
+        if (wasRunning)
+        {
+            tuner.toggleState();
+            cycle = wasCycling;
+        }
+    }
+    else if (comboBoxThatHasChanged == &resolution)
+    {
+        bool wasRunning = false;
+        bool wasCycling = cycle;
+        if (tuner.isRunning())
+        {
+            wasRunning = true;
+            tuner.toggleState();
+        }
+        
+        int selected = comboBoxThatHasChanged->getSelectedId() - 1;
+        tuner.setResolution(resolutions[selected]);        
+        
+        if (wasRunning)
+        {
+            tuner.toggleState();
+            cycle = wasCycling;
+        }
+    }
+    else if (comboBoxThatHasChanged == &confidence)
+    {
+        bool wasRunning = false;
+        bool wasCycling = cycle;
+        if (tuner.isRunning())
+        {
+            wasRunning = true;
+            tuner.toggleState();
+        }
+        
+        int selected = comboBoxThatHasChanged->getSelectedId() - 1;
+        tuner.setTargetConfidenceInterval(confidences[selected]);
+        
+        if (wasRunning)
+        {
+            tuner.toggleState();
+            cycle = wasCycling;
+        }
+    }
+    else if (comboBoxThatHasChanged == &estimator)
+    {
+        bool wasRunning = false;
+        bool wasCycling = cycle;
+        if (tuner.isRunning())
+        {
+            wasRunning = true;
+            tuner.toggleState();
+        }
+        
+        int selected = comboBoxThatHasChanged->getSelectedId() - 1;
+        tuner.setEstimator((FrequencyEstimator::Type) selected);
+        
+        if (wasRunning)
+        {
+            tuner.toggleState();
+            cycle = wasCycling;
+        }
+    }
+    else if (comboBoxThatHasChanged == &conditioning)
+    {
+        bool wasRunning = false;
+        bool wasCycling = cycle;
+        if (tuner.isRunning())
+        {
+            wasRunning = true;
+            tuner.toggleState();
+        }
+        
+        int selected = comboBoxThatHasChanged->getSelectedId() - 1;
+        tuner.setConditioning((SignalConditioner::Mode) selected);
+        
+        if (wasRunning)
+        {
+            tuner.toggleState();
+            cycle = wasCycling;
+        }
+    }
+    else if (comboBoxThatHasChanged == &order)
+    {
+        // the running sweep keeps its order, the next one is planned with the new one
+        int selected = comboBoxThatHasChanged->getSelectedId() - 1;
+        tuner.setSweepOrder((SweepPlanner::Strategy) selected);
+    }
+}
+
+void MainComponent::showAudioSettings()
+{
+    class SettingsWrapperComponent: public Component,
+                                    public ComboBox::Listener,
+                                    public TextButton::Listener
+    {
+    public:
+        SettingsWrapperComponent(VCOTuner* tunerToUse, juce::AudioDeviceManager& m)
+        : selectorComponent(m, 1, VCOTuner::maxNumLanes, 0, 0, false, true, false, false)
+        {
+            t = tunerToUse;
+            
+            channelLabel.setName("MidiChannel Label");
+            channelLabel.setText("MIDI Channel (first input): ", dontSendNotification);
+            channelLabel.setJustificationType(juce::Justification::centredRight);
+            addAndMakeVisible(&channelLabel);
+            
+            channelEdit.setName("MidiChannel Edit");
+            const char* items[16] = {"1", "2", "3", "4", "5", "6", "7", "8",
+                                     "9", "10", "11", "12", "13", "14", "15", "16"};
+            channelEdit.addItemList(StringArray(items, 16), 1);
+            channelEdit.addListener(this);
+            if (getAppProperties().getUserSettings()->containsKey("MIDIChannel"))
+                channelEdit.setSelectedId(getAppProperties().getUserSettings()->getIntValue("MIDIChannel"));
+            else
+                channelEdit.setSelectedId(1);
+            addAndMakeVisible(&channelEdit);
+            
+            correctionLabel.setName("Correction Label");
+            correctionLabel.setText("Calibrate with: ", dontSendNotification);
+            correctionLabel.setJustificationType(juce::Justification::centredRight);
+            addAndMakeVisible(&correctionLabel);
+            
+            correctionEdit.setName("Correction Edit");
+            correctionEdit.addItemList(StringArray(correctionTexts, numCorrections), 1);
+            if (getAppProperties().getUserSettings()->containsKey("CorrectionID"))
+                correctionEdit.setSelectedId(getAppProperties().getUserSettings()->getIntValue("CorrectionID"));
+            else
+                correctionEdit.setSelectedId(1);
+            correctionEdit.addListener(this);
+            addAndMakeVisible(&correctionEdit);
+            
+            close.setButtonText("Close");
+            close.addListener(this);
+            addAndMakeVisible(&close);
+            
+            addAndMakeVisible(&selectorComponent);
+        }
+        
+        void comboBoxChanged (ComboBox* comboBoxThatHasChanged) override
+        {
+            if (comboBoxThatHasChanged == &correctionEdit)
+            {
+                // applied when the dialog is closed
+                getAppProperties().getUserSettings()->setValue("CorrectionID", correctionEdit.getSelectedId());
+                return;
+            }
+            
+            int channel = comboBoxThatHasChanged->getSelectedId();
+            t->setMidiChannel(channel);
+            getAppProperties().getUserSettings()->setValue("MIDIChannel", channel);
+        }
+        
+        void resized() override
+        {
+            const int height = selectorComponent.getItemHeight();
+            const int border = 10;
+            
+            selectorComponent.setBounds(0, 0, getWidth(), getHeight() - 5*border - 3*height);
+            // selectorComponent overwrites its height in its resized() function. But it doesnt seem to work
+            channelEdit.setBounds(proportionOfWidth (0.35f), selectorComponent.getBottom() + border, proportionOfWidth (0.6f), height);
+            channelLabel.setBounds(0, selectorComponent.getBottom() + border, proportionOfWidth (0.35f), height);
+            correctionEdit.setBounds(proportionOfWidth (0.35f), channelEdit.getBottom() + border, proportionOfWidth (0.6f), height);
+            correctionLabel.setBounds(0, channelEdit.getBottom() + border, proportionOfWidth (0.35f), height);
+            close.setBounds(border, getHeight() - border - height, getWidth() - 2*border, height);
+        }
+        
+        void buttonClicked (Button* bttn) override
+        {
+            if (bttn == &close)
+            {
+                if (DialogWindow* dw = findParentComponentOfClass<DialogWindow>())
+                    dw->exitModalState (0);
+            }
+        }
+        
+    private:
+        AudioDeviceSelectorComponent selectorComponent;
+        Label channelLabel;
+        TextButton close;
+        ComboBox channelEdit;
+        Label correctionLabel;
+        ComboBox correctionEdit;
+        VCOTuner* t;
+    };
+    
+    SettingsWrapperComponent content(&tuner, deviceManager);
+    content.setSize(400, 440);
+    
+    
+    DialogWindow::LaunchOptions o;
+    o.content.setNonOwned (&content);
+    o.dialogTitle                   = "Audio & Midi Settings";
+    o.componentToCentreAround       = this;
+    o.dialogBackgroundColour        = Colours::lightgrey;
+    o.escapeKeyTriggersCloseButton  = true;
+    o.resizable                     = true;
+    o.useNativeTitleBar             = true;
+    
+    o.runModal();
+    
+    updateLanes();
+    updateCorrection();
+    
+    std::unique_ptr<XmlElement> audioState (deviceManager.createStateXml());
+    
+    getAppProperties().getUserSettings()->setValue ("audioDeviceState", audioState.get());
+    getAppProperties().getUserSettings()->saveIfNeeded();
+}
+
+void MainComponent::updateLanes()
+{
+    int firstMidiChannel = 1;
+    if (getAppProperties().getUserSettings()->containsKey("MIDIChannel"))
+        firstMidiChannel = getAppProperties().getUserSettings()->getIntValue("MIDIChannel");
+    
+    int numInputs = 1;
+    if (AudioIODevice* device = deviceManager.getCurrentAudioDevice())
+        numInputs = jlimit(1, (int) VCOTuner::maxNumLanes, device->getActiveInputChannels().countNumberOfSetBits());
+    
+    Array<VCOTuner::LaneSetup> lanes;
+    bool changed = numInputs != tuner.getNumLanes();
+    for (int i = 0; i < numInputs; i++)
+    {
+        VCOTuner::LaneSetup lane;
+        lane.inputChannel = i;
+        lane.midiChannel = (firstMidiChannel - 1 + i) % 16 + 1;
+        lanes.add(lane);
+        
+        if (!changed)
+            changed = tuner.getLaneSetup(i).inputChannel != lane.inputChannel
+                      || tuner.getLaneSetup(i).midiChannel != lane.midiChannel;
+    }
+    
+    // setting the lanes stops the tuner, so only do it when something has changed
+    if (changed)
+    {
+        tuner.setLanes(lanes);
+        display.clearCache();
+    }
+}
+
+void MainComponent::updateCorrection()
+{
+    int selected = 0;
+    if (getAppProperties().getUserSettings()->containsKey("CorrectionID"))
+        selected = jlimit(0, numCorrections - 1, getAppProperties().getUserSettings()->getIntValue("CorrectionID") - 1);
+    
+    // changing it stops a running calibration, so only do it when something has changed
+    const VCOTuner::CorrectionMessage message = pitchBendRanges[selected] > 0 ? VCOTuner::pitchBend : VCOTuner::fineTuning;
+    const double range = pitchBendRanges[selected] > 0 ? pitchBendRanges[selected] : tuner.getPitchBendRange();
+    if (message != tuner.getCorrectionMessage() || range != tuner.getPitchBendRange())
+        tuner.setCorrectionMessage(message, range);
+}
+
+
+void MainComponent::tunerStarted()
+{
+    sweepStartTime = Time::getCurrentTime();
+    startStop.setButtonText("Stop");
+}
+
+void MainComponent::timerCallback()
+{
+    const uint32 version = tuner.getStatusVersion();
+    if (version == shownStatusVersion && creatingReport == shownCreatingReport)
+        return;
+    shownStatusVersion = version;
+    shownCreatingReport = creatingReport;
+    
+    const String statusString = VCOTuner::describe(tuner.getStatus());
+    if (creatingReport)
+        statusLabel.setText("Creating Report: " + statusString, juce::dontSendNotification);
+    else
+        statusLabel.setText(statusString, juce::dontSendNotification);
+}
+
+void MainComponent::tunerStopped()
+{
+    StringArray errors = tuner.getLastErrors();
+    for (int i = 0; i < errors.size(); i++)
+        NativeMessageBox::showMessageBox(AlertWindow::WarningIcon, "Error!", errors[i]);
+    
+    startStop.setButtonText("Start");
+    cycle = false;
+    creatingReport = false;
+}
+
+void MainComponent::newCalibrationReady(const VCOTuner::calibration_t& c)
+{
+    calibrations.add(c);
+}
+
+void MainComponent::tunerFinished()
+{
+    startStop.setButtonText("Start");
+    
+    // a report is archived with the details entered for it, once they are submitted
+    if (creatingReport)
+    {
+        creatingReport = false;
+    }
+    else
+        archiveSweep();
+    
+    if (cycle)
+        tuner.toggleState();
+}
+
+const MainComponent::regime_t MainComponent::regimes[numRegimes] = {
+    {54, 66, 6},
+    {54, 66, 3},
+    {54, 66, 1},
+    {48, 72, 12},
+    {48, 72, 6},
+    {48, 72, 1},
+    {36, 84, 12},
+    {36, 84, 6},
+    {36, 84, 1},
+    {24, 96, 12},
+    {24, 96, 6},
+    {24, 96, 1},
+};
+const char* MainComponent::regimeTexts[numRegimes] = {
+    "narrow > coarse (54-66, +6)",
+    "narrow > normal (54-66, +3)",
+    "narrow > fine (54-66, +1)",
+    "medium > coarse (48-72, +12)",
+    "medium > normal (48-72, +6)",
+    "medium > fine (48-72, +1)",
+    "large > coarse (36-84, +12)",
+    "large > normal (36-84, +6)",
+    "large > fine (36-84, +1)",
+    "huge > coarse (24-96, +12)",
+    "huge > normal (24-96, +6)",
+    "huge > fine (24-96, +1)",
+};
+
+const int MainComponent::resolutions[numResolutions] = {20, 50, 100, 200, 400, 10000};
+const char* MainComponent::resolutionsTexts[numResolutions] = {
+    "20 - quick & dirty",
+    "50 - not quite enough",
+    "100 - okay",
+    "200 - neat and tidy",
+    "400 - never accurate enough",
+    "10000 - metrology grade"
+};
+
+// with a target confidence, the resolution is the maximum number of periods per note
+const double MainComponent::confidences[numConfidences] = {0, 1.0, 0.5, 0.2, 0.1, 0.05};
+const char* MainComponent::confidencesTexts[numConfidences] = {
+    "all periods",
+    "+/- 1 cent",
+    "+/- 0.5 cent",
+    "+/- 0.2 cent",
+    "+/- 0.1 cent",
+    "+/- 0.05 cent"
+};
+
+// the range of the pitch bend must match the one set up on the MIDI-CV interface
+const double MainComponent::pitchBendRanges[numCorrections] = {2.0, 12.0, 24.0, 0};
+const char* MainComponent::correctionTexts[numCorrections] = {
+    "Pitch bend, +/- 2 semitones",
+    "Pitch bend, +/- 12 semitones",
+    "Pitch bend, +/- 24 semitones",
+    "Fine tuning (RPN 1)"
+};
+
+const MainComponent::regime_t MainComponent::reportRange = {24, 96, 1};
+
+const String MainComponent::welcomeText = String("Welcome to the VCO Tuner!") + newLine + newLine + "Please follow these steps to get running:" + newLine + "1) connect a MIDI-CV interface to your Computer" + newLine + "2) connect the CV output of the interface to your oscillators frequency input" + newLine + "3) Connect one of the oscillators basic waveforms (sine, saw, triangle, pulse, etc.) directly to your soundcard (use attenuation to avoid clipping)." + newLine + newLine + "When you close this dialog, the audio settings panel will open. Please select your audio and midi device there." + newLine + newLine + "Have fun!" + newLine + newLine + "PS: If you find bugs, please raise an issue on the github repository under https://github.com/TheSlowGrowth/VCOTuner. Thanks!";
+
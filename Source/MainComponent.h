@@ -1,86 +1,129 @@
-/*
-  ==============================================================================
-
-    MainComponent.h
-    Created: 17 May 2016 8:21:04pm
-    Author:  Johannes Neumann
-
-  ==============================================================================
-*/
-
-#ifndef MAINCOMPONENT_H_INCLUDED
-#define MAINCOMPONENT_H_INCLUDED
-
-#include "VCOTuner.h"
-#include "Visualizer.h"
-
-//==============================================================================
-ApplicationProperties& getAppProperties();
-
-//==============================================================================
-/**
- */
-class MainComponent: public Component,
-                     public VCOTuner::Listener,
-                     public Button::Listener,
-                     public ComboBox::Listener
-{
-public:
-    MainComponent();
-    virtual ~MainComponent() override;
-    
-    void resized() override;
-    void paint(Graphics& g) override;
-    
-    virtual void buttonClicked (Button* bttn) override;
-    virtual void comboBoxChanged (ComboBox* comboBoxThatHasChanged) override;
-    
-    virtual void tunerStarted() override;
-    virtual void tunerStopped() override;
-    virtual void tunerFinished() override;
-    virtual void tunerStatusChanged(String statusString) override;
-    
-    void startCreatingReport();
-    
-private:
-    //==============================================================================
-    AudioDeviceManager deviceManager;
-    VCOTuner tuner;
-    
-    void showAudioSettings();
-    
-    TextButton audioSettings;
-    TextButton startStop;
-    TextButton report;
-    Visualizer display;
-    Label statusLabel;
-    Label regimeLabel;
-    ComboBox regime;
-    Label resolutionLabel;
-    ComboBox resolution;
-    
-    typedef struct
-    {
-        int startNote;
-        int endNote;
-        int interval;
-    } regime_t;
-    static const int numRegimes = 12;
-    static const regime_t regimes[numRegimes];
-    static const char* regimeTexts[numRegimes];
-    static const regime_t reportRange;
-    static const int numResolutions = 5;
-    static const int resolutions[numResolutions];
-    static const char* resolutionsTexts[numResolutions];
-    
-    bool cycle;
-    bool creatingReport;
-    
-    static const String welcomeText;
-    
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
-};
-
-
-
-#endif  // MAINCOMPONENT_H_INCLUDED
+/*
+  ==============================================================================
+
+    MainComponent.h
+    Created: 17 May 2016 8:21:04pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef MAINCOMPONENT_H_INCLUDED
+#define MAINCOMPONENT_H_INCLUDED
+
+#include "VCOTuner.h"
+#include "TunerSession.h"
+#include "Visualizer.h"
+#include "DiagnosticsPanel.h"
+
+//==============================================================================
+ApplicationProperties& getAppProperties();
+
+//==============================================================================
+/**
+ */
+class MainComponent: public Component,
+                     public VCOTuner::Listener,
+                     public Button::Listener,
+                     public ComboBox::Listener,
+                     private Timer
+{
+public:
+    MainComponent();
+    virtual ~MainComponent() override;
+    
+    void resized() override;
+    void paint(Graphics& g) override;
+    
+    virtual void buttonClicked (Button* bttn) override;
+    virtual void comboBoxChanged (ComboBox* comboBoxThatHasChanged) override;
+    
+    virtual void tunerStarted() override;
+    virtual void tunerStopped() override;
+    virtual void tunerFinished() override;
+    virtual void newCalibrationReady(const VCOTuner::calibration_t& c) override;
+    
+    void startCreatingReport();
+    
+private:
+    //==============================================================================
+    TunerSession session;
+    /** the window shows the first bench of the session */
+    TunerSession::Bench& bench;
+    AudioDeviceManager& deviceManager;
+    VCOTuner& tuner;
+    
+    void showAudioSettings();
+    /** measures one oscillator per active input channel. The first one is played on the
+     selected MIDI channel, the others on the following channels. */
+    void updateLanes();
+    /** applies the correction message selected in the settings */
+    void updateCorrection();
+    /** writes the shown results as Scala, MIDI tuning dump and CSV files. After a
+     calibration, the corrections it found are written instead. */
+    void exportTuningTables();
+    /** stores the results of a finished sweep in the archive, with the details of the DUT
+     that were last entered for a report */
+    void archiveSweep();
+    
+    TextButton audioSettings;
+    TextButton startStop;
+    TextButton report;
+    TextButton exportTuning;
+    TextButton calibrate;
+    TextButton fleet;
+    Visualizer display;
+    Label statusLabel;
+    /** the status is polled, the label never holds up the tuner */
+    uint32 shownStatusVersion;
+    bool shownCreatingReport;
+    void timerCallback() override;
+    DiagnosticsPanel diagnostics;
+    Label regimeLabel;
+    ComboBox regime;
+    Label resolutionLabel;
+    ComboBox resolution;
+    Label confidenceLabel;
+    ComboBox confidence;
+    Label estimatorLabel;
+    ComboBox estimator;
+    Label conditioningLabel;
+    ComboBox conditioning;
+    Label orderLabel;
+    ComboBox order;
+    
+    typedef struct
+    {
+        int startNote;
+        int endNote;
+        int interval;
+    } regime_t;
+    static const int numRegimes = 12;
+    static const regime_t regimes[numRegimes];
+    static const char* regimeTexts[numRegimes];
+    static const regime_t reportRange;
+    static const int numResolutions = 6;
+    static const int resolutions[numResolutions];
+    static const char* resolutionsTexts[numResolutions];
+    static const int numConfidences = 6;
+    static const double confidences[numConfidences];
+    static const char* confidencesTexts[numConfidences];
+    static const int numCorrections = 4;
+    static const double pitchBendRanges[numCorrections]; // 0 = RPN fine tuning
+    static const char* correctionTexts[numCorrections];
+    
+    /** of the last calibration, empty after a normal sweep */
+    Array<VCOTuner::calibration_t> calibrations;
+    Time sweepStartTime;
+    
+    bool cycle;
+    bool creatingReport;
+    
+    static const String welcomeText;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
+};
+
+
+
+#endif  // MAINCOMPONENT_H_INCLUDED
@@ -0,0 +1,470 @@
+/*
+  ==============================================================================
+
+    ReplayAudioIODevice.cpp
+    Created: 17 Oct 2026 9:12:40am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ReplayAudioIODevice.h"
+
+ReplaySource::ReplaySource()
+{
+    formatManager.registerBasicFormats();
+    fileSampleRate = 44100.0;
+    numChannels = 0;
+    selectedNote = -1;
+    selectionCounter = 0;
+    lastSelectionCounter = 0;
+    playingSegment = nullptr;
+    playPosition = 0;
+}
+
+ReplaySource::~ReplaySource()
+{
+
+}
+
+void ReplaySource::clear()
+{
+    segments.clear();
+    numChannels = 0;
+    lastError = String();
+    playingSegment = nullptr;
+}
+
+bool ReplaySource::loadFile(const File& file)
+{
+    clear();
+    return addSegmentsFromFile(file, -1);
+}
+
+bool ReplaySource::loadDirectory(const File& directory)
+{
+    clear();
+    
+    if (!directory.isDirectory())
+    {
+        lastError = "Not a directory: " + directory.getFullPathName();
+        return false;
+    }
+    
+    Array<File> files = directory.findChildFiles(File::findFiles, false, "*.wav;*.aif;*.aiff;*.flac");
+    for (int i = 0; i < files.size(); i++)
+    {
+        String name = files[i].getFileNameWithoutExtension();
+        if (!name.containsOnly("0123456789"))
+            continue;
+        
+        int midiNote = name.getIntValue();
+        if (midiNote < 0 || midiNote > 127)
+            continue;
+        
+        if (!addSegmentsFromFile(files[i], midiNote))
+            return false;
+    }
+    
+    if (segments.size() == 0)
+    {
+        lastError = "No recordings named after a MIDI note (e.g. \"60.wav\") found in " + directory.getFullPathName();
+        return false;
+    }
+    return true;
+}
+
+bool ReplaySource::addSegmentsFromFile(const File& file, int midiNote)
+{
+    std::unique_ptr<AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr)
+    {
+        lastError = "Unable to read " + file.getFullPathName();
+        return false;
+    }
+    
+    if (segments.size() > 0 && (reader->sampleRate != fileSampleRate || (int) reader->numChannels != numChannels))
+    {
+        lastError = "All recordings must have the same sample rate and number of channels: " + file.getFullPathName();
+        return false;
+    }
+    fileSampleRate = reader->sampleRate;
+    numChannels = (int) reader->numChannels;
+    
+    AudioBuffer<float> audio((int) reader->numChannels, (int) reader->lengthInSamples);
+    reader->read(&audio, 0, (int) reader->lengthInSamples, 0, true, true);
+    
+    // a single recording may be split into per-note segments by labeled cue points
+    Array<int> cueNotes;
+    Array<int> cueOffsets;
+    if (midiNote < 0)
+    {
+        const StringPairArray& metadata = reader->metadataValues;
+        int numLabels = metadata.getValue("NumCueLabels", "0").getIntValue();
+        int numCues = metadata.getValue("NumCuePoints", "0").getIntValue();
+        for (int l = 0; l < numLabels; l++)
+        {
+            String label = metadata.getValue("CueLabel" + String(l) + "Text", "").trim();
+            String identifier = metadata.getValue("CueLabel" + String(l) + "Identifier", "");
+            if (label.isEmpty() || !label.containsOnly("0123456789") || label.getIntValue() > 127)
+                continue;
+            
+            for (int c = 0; c < numCues; c++)
+            {
+                if (metadata.getValue("Cue" + String(c) + "Identifier", "") == identifier)
+                {
+                    int offset = metadata.getValue("Cue" + String(c) + "Offset", "0").getIntValue();
+                    // keep the cues sorted by their position in the file
+                    int insertAt = 0;
+                    while (insertAt < cueOffsets.size() && cueOffsets[insertAt] < offset)
+                        insertAt++;
+                    cueOffsets.insert(insertAt, offset);
+                    cueNotes.insert(insertAt, label.getIntValue());
+                    break;
+                }
+            }
+        }
+    }
+    
+    if (cueOffsets.size() == 0)
+    {
+        Segment* segment = new Segment();
+        segment->midiNote = midiNote;
+        segment->recorded.makeCopyOf(audio);
+        segments.add(segment);
+        return true;
+    }
+    
+    for (int i = 0; i < cueOffsets.size(); i++)
+    {
+        int start = jlimit(0, audio.getNumSamples(), cueOffsets[i]);
+        int end = (i + 1 < cueOffsets.size()) ? cueOffsets[i + 1] : audio.getNumSamples();
+        end = jlimit(start, audio.getNumSamples(), end);
+        if (end == start)
+            continue;
+        
+        Segment* segment = new Segment();
+        segment->midiNote = cueNotes[i];
+        segment->recorded.setSize(audio.getNumChannels(), end - start);
+        for (int ch = 0; ch < audio.getNumChannels(); ch++)
+            segment->recorded.copyFrom(ch, 0, audio, ch, start, end - start);
+        segments.add(segment);
+    }
+    return true;
+}
+
+bool ReplaySource::hasSegmentForNote(int midiNote) const
+{
+    return findSegment(midiNote) != nullptr;
+}
+
+const ReplaySource::Segment* ReplaySource::findSegment(int midiNote) const
+{
+    for (int i = 0; i < segments.size(); i++)
+    {
+        if (segments[i]->midiNote == midiNote || segments[i]->midiNote < 0)
+            return segments[i];
+    }
+    return nullptr;
+}
+
+void ReplaySource::selectNote(int midiNote)
+{
+    selectedNote = midiNote;
+    selectionCounter++;
+}
+
+void ReplaySource::prepareToPlay(double sampleRate)
+{
+    for (int i = 0; i < segments.size(); i++)
+    {
+        Segment* segment = segments[i];
+        if (sampleRate == fileSampleRate)
+        {
+            segment->playback.makeCopyOf(segment->recorded);
+            continue;
+        }
+        
+        double ratio = fileSampleRate / sampleRate;
+        int numOutputSamples = (int) (segment->recorded.getNumSamples() / ratio) - 4;
+        segment->playback.setSize(segment->recorded.getNumChannels(), jmax(0, numOutputSamples));
+        for (int ch = 0; ch < segment->recorded.getNumChannels(); ch++)
+        {
+            LagrangeInterpolator interpolator;
+            interpolator.process(ratio,
+                                 segment->recorded.getReadPointer(ch),
+                                 segment->playback.getWritePointer(ch),
+                                 segment->playback.getNumSamples());
+        }
+    }
+    
+    lastSelectionCounter = selectionCounter;
+    playingSegment = findSegment(selectedNote);
+    playPosition = 0;
+}
+
+void ReplaySource::renderNextBlock(AudioBuffer<float>& buffer)
+{
+    // switch over to a newly selected note
+    uint32 counter = selectionCounter;
+    if (counter != lastSelectionCounter)
+    {
+        lastSelectionCounter = counter;
+        playingSegment = findSegment(selectedNote);
+        playPosition = 0;
+    }
+    
+    if (playingSegment == nullptr || playingSegment->playback.getNumSamples() == 0)
+    {
+        buffer.clear();
+        return;
+    }
+    
+    const AudioBuffer<float>& audio = playingSegment->playback;
+    int numChannelsToCopy = jmin(buffer.getNumChannels(), audio.getNumChannels());
+    int bufferPosition = 0;
+    while (bufferPosition < buffer.getNumSamples())
+    {
+        if (playPosition >= audio.getNumSamples())
+            playPosition = 0;
+        
+        int numToCopy = jmin(buffer.getNumSamples() - bufferPosition, audio.getNumSamples() - playPosition);
+        for (int ch = 0; ch < numChannelsToCopy; ch++)
+            buffer.copyFrom(ch, bufferPosition, audio, ch, playPosition, numToCopy);
+        bufferPosition += numToCopy;
+        playPosition += numToCopy;
+    }
+    
+    for (int ch = numChannelsToCopy; ch < buffer.getNumChannels(); ch++)
+        buffer.clear(ch, 0, buffer.getNumSamples());
+}
+
+//==============================================================================
+ReplayAudioIODevice::ReplayAudioIODevice(const String& deviceName, std::shared_ptr<ReplaySource> s,
+                                         VCOTuner* tunerToClock)
+: AudioIODevice(deviceName, ReplayAudioIODeviceType::deviceName),
+  Thread("Replay Audio Device")
+{
+    source = s;
+    tuner = tunerToClock;
+    tunerIsIdle = true;
+    opened = false;
+    currentSampleRate = source->getSampleRate();
+    bufferSize = getDefaultBufferSize();
+    currentCallback = nullptr;
+}
+
+ReplayAudioIODevice::~ReplayAudioIODevice()
+{
+    close();
+    cancelPendingUpdate();
+}
+
+StringArray ReplayAudioIODevice::getOutputChannelNames()
+{
+    return StringArray("Output 1", "Output 2");
+}
+
+StringArray ReplayAudioIODevice::getInputChannelNames()
+{
+    StringArray names;
+    for (int i = 0; i < jmax(1, source->getNumChannels()); i++)
+        names.add("Recording " + String(i + 1));
+    return names;
+}
+
+Array<double> ReplayAudioIODevice::getAvailableSampleRates()
+{
+    Array<double> rates = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+    rates.addIfNotAlreadyThere(source->getSampleRate());
+    rates.sort();
+    return rates;
+}
+
+Array<int> ReplayAudioIODevice::getAvailableBufferSizes()
+{
+    return { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+}
+
+String ReplayAudioIODevice::open(const BigInteger& inputChannels,
+                                 const BigInteger& outputChannels,
+                                 double sampleRate,
+                                 int bufferSizeSamples)
+{
+    close();
+    
+    currentSampleRate = sampleRate > 0 ? sampleRate : source->getSampleRate();
+    bufferSize = bufferSizeSamples > 0 ? bufferSizeSamples : getDefaultBufferSize();
+    
+    activeInputChannels = inputChannels;
+    activeInputChannels.setRange(jmax(1, source->getNumChannels()), 256, false);
+    activeOutputChannels = outputChannels;
+    activeOutputChannels.setRange(2, 256, false);
+    
+    source->prepareToPlay(currentSampleRate);
+    sourceBuffer.setSize(jmax(1, source->getNumChannels()), bufferSize);
+    outputBuffer.setSize(jmax(1, activeOutputChannels.countNumberOfSetBits()), bufferSize);
+    
+    inputPointers.clear();
+    for (int ch = 0; ch < sourceBuffer.getNumChannels(); ch++)
+    {
+        if (activeInputChannels[ch])
+            inputPointers.add(sourceBuffer.getReadPointer(ch));
+    }
+    
+    lastError = String();
+    opened = true;
+    startThread(8);
+    return lastError;
+}
+
+void ReplayAudioIODevice::close()
+{
+    stop();
+    stopThread(2000);
+    opened = false;
+}
+
+void ReplayAudioIODevice::start(AudioIODeviceCallback* callback)
+{
+    if (!opened || callback == nullptr || callback == currentCallback)
+        return;
+    
+    stop();
+    callback->audioDeviceAboutToStart(this);
+    
+    const ScopedLock sl(callbackLock);
+    currentCallback = callback;
+}
+
+void ReplayAudioIODevice::stop()
+{
+    AudioIODeviceCallback* lastCallback = nullptr;
+    {
+        const ScopedLock sl(callbackLock);
+        lastCallback = currentCallback;
+        currentCallback = nullptr;
+    }
+    
+    if (lastCallback != nullptr)
+        lastCallback->audioDeviceStopped();
+}
+
+void ReplayAudioIODevice::run()
+{
+    const double blockDurationMs = 1000.0 * bufferSize / currentSampleRate;
+    double nextBlockTime = Time::getMillisecondCounterHiRes();
+    
+    while (!threadShouldExit())
+    {
+        bool processed = false;
+        {
+            const ScopedLock sl(callbackLock);
+            if (currentCallback != nullptr)
+            {
+                source->renderNextBlock(sourceBuffer);
+                outputBuffer.clear();
+                currentCallback->audioDeviceIOCallback(inputPointers.getRawDataPointer(),
+                                                       inputPointers.size(),
+                                                       outputBuffer.getArrayOfWritePointers(),
+                                                       activeOutputChannels.countNumberOfSetBits(),
+                                                       bufferSize);
+                processed = true;
+            }
+        }
+        
+        if (!processed)
+        {
+            // nobody is listening - don't burn the CPU
+            wait(10);
+            nextBlockTime = Time::getMillisecondCounterHiRes();
+        }
+        else if (advanceTuner())
+        {
+            nextBlockTime = Time::getMillisecondCounterHiRes();
+        }
+        else
+        {
+            nextBlockTime += blockDurationMs;
+            double timeToWait = nextBlockTime - Time::getMillisecondCounterHiRes();
+            if (timeToWait >= 1.0)
+                wait((int) timeToWait);
+        }
+    }
+}
+
+bool ReplayAudioIODevice::advanceTuner()
+{
+    if (tuner == nullptr)
+        return false;
+    
+    // the tuner's state machine runs on the message thread, so its clock is advanced there
+    clockAdvanced.reset();
+    triggerAsyncUpdate();
+    while (!clockAdvanced.wait(10))
+    {
+        if (threadShouldExit())
+            return true;
+    }
+    return !tunerIsIdle;
+}
+
+void ReplayAudioIODevice::handleAsyncUpdate()
+{
+    const VCOTuner::Status::Activity activity = tuner->getStatus().activity;
+    tunerIsIdle = !tuner->usesVirtualClock()
+                  || activity == VCOTuner::Status::idle || activity == VCOTuner::Status::done;
+    if (!tunerIsIdle)
+        tuner->advanceClock(1000.0 * bufferSize / currentSampleRate);
+    clockAdvanced.signal();
+}
+
+//==============================================================================
+const char* const ReplayAudioIODeviceType::deviceName = "File Replay";
+
+ReplayAudioIODeviceType::ReplayAudioIODeviceType(std::shared_ptr<ReplaySource> s, VCOTuner* tunerToClock)
+: AudioIODeviceType(deviceName)
+{
+    source = s;
+    tuner = tunerToClock;
+}
+
+StringArray ReplayAudioIODeviceType::getDeviceNames(bool /*wantInputNames*/) const
+{
+    return StringArray(deviceName);
+}
+
+int ReplayAudioIODeviceType::getDefaultDeviceIndex(bool /*forInput*/) const
+{
+    return 0;
+}
+
+int ReplayAudioIODeviceType::getIndexOfDevice(AudioIODevice* device, bool /*asInput*/) const
+{
+    if (device != nullptr && device->getName() == deviceName)
+        return 0;
+    return -1;
+}
+
+AudioIODevice* ReplayAudioIODeviceType::createDevice(const String& outputDeviceName,
+                                                     const String& inputDeviceName)
+{
+    if (outputDeviceName != deviceName && inputDeviceName != deviceName)
+        return nullptr;
+    
+    return new ReplayAudioIODevice(deviceName, source, tuner);
+}
+
+//==============================================================================
+ReplayMidiOutput::ReplayMidiOutput(std::shared_ptr<ReplaySource> s)
+{
+    source = s;
+}
+
+void ReplayMidiOutput::sendMessageNow(const MidiMessage& message)
+{
+    // note offs are ignored - a MIDI-CV interface keeps the last CV as well
+    if (message.isNoteOn())
+        source->selectNote(message.getNoteNumber());
+}
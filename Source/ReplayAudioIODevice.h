@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+    ReplayAudioIODevice.h
+    Created: 17 Oct 2026 9:12:40am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef REPLAYAUDIOIODEVICE_H_INCLUDED
+#define REPLAYAUDIOIODEVICE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "VCOTuner.h"
+
+//==============================================================================
+/** Recorded oscillator signals for the replay device. Holds one segment of audio
+    per MIDI note. The segment of the most recently selected note is played in a loop.
+ */
+class ReplaySource
+{
+public:
+    ReplaySource();
+    ~ReplaySource();
+    
+    /** loads a single recording. If the file contains cue points that are labeled with
+     a MIDI note number (e.g. "60"), the audio from each cue point up to the next one
+     is used for that note. Otherwise the whole file is played for every note. */
+    bool loadFile(const File& file);
+    
+    /** loads one recording per note. Files must be named after their MIDI note number,
+     e.g. "60.wav". Notes without a file are replayed as silence. */
+    bool loadDirectory(const File& directory);
+    
+    String getLastError() const { return lastError; }
+    
+    double getSampleRate() const { return fileSampleRate; }
+    int getNumChannels() const { return numChannels; }
+    bool hasSegmentForNote(int midiNote) const;
+    
+    /** selects the segment to play. Can be called from any thread, playback
+     switches over at the start of the next block. */
+    void selectNote(int midiNote);
+    
+    /** resamples all segments to the playback rate. Must not be called while playing. */
+    void prepareToPlay(double sampleRate);
+    
+    /** renders the next block of all channels. Only to be called from the playback thread. */
+    void renderNextBlock(AudioBuffer<float>& buffer);
+    
+private:
+    struct Segment
+    {
+        int midiNote; // -1 if the segment is played for all notes
+        AudioBuffer<float> recorded;
+        AudioBuffer<float> playback;
+    };
+    
+    bool addSegmentsFromFile(const File& file, int midiNote);
+    const Segment* findSegment(int midiNote) const;
+    void clear();
+    
+    AudioFormatManager formatManager;
+    OwnedArray<Segment> segments;
+    double fileSampleRate;
+    int numChannels;
+    String lastError;
+    
+    /** written by selectNote(), read by the playback thread */
+    std::atomic<int> selectedNote;
+    std::atomic<uint32> selectionCounter;
+    
+    /** the following are only to be accessed from the playback thread */
+    uint32 lastSelectionCounter;
+    const Segment* playingSegment;
+    int playPosition;
+    
+    JUCE_DECLARE_NON_COPYABLE(ReplaySource)
+};
+
+//==============================================================================
+/** An audio device that streams a ReplaySource into its callback instead of
+    recording from a sound card.
+    
+    Without a tuner, blocks are delivered at the rate of a real sound card. With one
+    that uses a virtual clock (see VCOTuner::setUsesVirtualClock()), the device runs in
+    lockstep with it, like VCOSimulation does: after each block, the playback thread
+    waits until the message thread has advanced the tuner's clock by the length of the
+    block. A sweep then runs as fast as the tuner can analyse the recording, and the
+    tuner can never fall behind and lose samples. While the tuner has nothing to do,
+    the blocks are delivered in real time again.
+ */
+class ReplayAudioIODevice: public AudioIODevice,
+                           private Thread,
+                           private AsyncUpdater
+{
+public:
+    /** the tuner, if any, must outlive the device */
+    ReplayAudioIODevice(const String& deviceName, std::shared_ptr<ReplaySource> source,
+                        VCOTuner* tunerToClock = nullptr);
+    ~ReplayAudioIODevice() override;
+    
+    StringArray getOutputChannelNames() override;
+    StringArray getInputChannelNames() override;
+    Array<double> getAvailableSampleRates() override;
+    Array<int> getAvailableBufferSizes() override;
+    int getDefaultBufferSize() override { return 512; }
+    
+    String open(const BigInteger& inputChannels,
+                const BigInteger& outputChannels,
+                double sampleRate,
+                int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override { return opened; }
+    
+    void start(AudioIODeviceCallback* callback) override;
+    void stop() override;
+    bool isPlaying() override { return currentCallback != nullptr; }
+    
+    String getLastError() override { return lastError; }
+    int getCurrentBufferSizeSamples() override { return bufferSize; }
+    double getCurrentSampleRate() override { return currentSampleRate; }
+    int getCurrentBitDepth() override { return 32; }
+    BigInteger getActiveOutputChannels() const override { return activeOutputChannels; }
+    BigInteger getActiveInputChannels() const override { return activeInputChannels; }
+    int getOutputLatencyInSamples() override { return 0; }
+    int getInputLatencyInSamples() override { return 0; }
+    
+private:
+    void run() override;
+    /** waits until the message thread has advanced the tuner's clock by one block.
+     Returns false if the tuner didn't need it because it is idle. */
+    bool advanceTuner();
+    void handleAsyncUpdate() override;
+    
+    std::shared_ptr<ReplaySource> source;
+    VCOTuner* tuner; // nullptr = real time
+    
+    /** signalled by the message thread when it has advanced the tuner's clock */
+    WaitableEvent clockAdvanced;
+    std::atomic<bool> tunerIsIdle;
+    
+    bool opened;
+    String lastError;
+    double currentSampleRate;
+    int bufferSize;
+    BigInteger activeInputChannels;
+    BigInteger activeOutputChannels;
+    
+    CriticalSection callbackLock;
+    AudioIODeviceCallback* currentCallback;
+    
+    /** the following are only to be accessed from the playback thread */
+    AudioBuffer<float> sourceBuffer;
+    AudioBuffer<float> outputBuffer;
+    Array<const float*> inputPointers;
+    
+    JUCE_DECLARE_NON_COPYABLE(ReplayAudioIODevice)
+};
+
+//==============================================================================
+/** Makes the replay device available to an AudioDeviceManager. */
+class ReplayAudioIODeviceType: public AudioIODeviceType
+{
+public:
+    /** the devices run in lockstep with the tuner, if one is given, see ReplayAudioIODevice */
+    ReplayAudioIODeviceType(std::shared_ptr<ReplaySource> source, VCOTuner* tunerToClock = nullptr);
+    
+    void scanForDevices() override {}
+    StringArray getDeviceNames(bool wantInputNames = false) const override;
+    int getDefaultDeviceIndex(bool forInput) const override;
+    int getIndexOfDevice(AudioIODevice* device, bool asInput) const override;
+    bool hasSeparateInputsAndOutputs() const override { return false; }
+    AudioIODevice* createDevice(const String& outputDeviceName,
+                                const String& inputDeviceName) override;
+    
+    static const char* const deviceName;
+    
+private:
+    std::shared_ptr<ReplaySource> source;
+    VCOTuner* tuner;
+};
+
+//==============================================================================
+/** Stand-in for the MIDI-CV interface. Every note on selects the matching
+    segment of the replay source.
+ */
+class ReplayMidiOutput: public VCOTuner::MidiSink
+{
+public:
+    ReplayMidiOutput(std::shared_ptr<ReplaySource> source);
+    
+    void sendMessageNow(const MidiMessage& message) override;
+    
+private:
+    std::shared_ptr<ReplaySource> source;
+};
+
+
+#endif  // REPLAYAUDIOIODEVICE_H_INCLUDED
@@ -1,40 +1,53 @@
-/*
-  ==============================================================================
-
-    ReportDisplayScreen.h
-    Created: 2 Jul 2016 4:12:22pm
-    Author:  Johannes Neumann
-
-  ==============================================================================
-*/
-
-#ifndef REPORTDISPLAYSCREEN_H_INCLUDED
-#define REPORTDISPLAYSCREEN_H_INCLUDED
-
-#include "ReportCreatorWindow.h"
-
-class ReportDisplayScreen: public Component,
-                           public Button::Listener
-{
-public:
-    ReportDisplayScreen(VCOTuner* t, Visualizer* v, ReportCreatorWindow* parent);
-    virtual ~ReportDisplayScreen() override;
-    
-    void buttonClicked (Button* bttn) override;
-    void resized() override;
-    void paint(Graphics& g) override;
-    
-private:
-    void drawReport();
-    
-    VCOTuner* tuner;
-    Visualizer* visualizer;
-    ReportCreatorWindow* parent;
-  
-    Image img;
-    TextButton save;
-    TextButton close;
-};
-
-
-#endif  // REPORTDISPLAYSCREEN_H_INCLUDED
+/*
+  ==============================================================================
+
+    ReportDisplayScreen.h
+    Created: 2 Jul 2016 4:12:22pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef REPORTDISPLAYSCREEN_H_INCLUDED
+#define REPORTDISPLAYSCREEN_H_INCLUDED
+
+#include "ReportCreatorWindow.h"
+#include "ReportRenderer.h"
+
+/** Shows the report of the sweep and saves it as an image, SVG or PDF file. The preview
+    and the files are rendered on a background thread, so that the window stays responsive
+    while a large image is encoded.
+ */
+class ReportDisplayScreen: public Component,
+                           public Button::Listener
+{
+public:
+    ReportDisplayScreen(VCOTuner* t, Visualizer* v, ReportCreatorWindow* parent);
+    virtual ~ReportDisplayScreen() override;
+    
+    void buttonClicked (Button* bttn) override;
+    void resized() override;
+    void paint(Graphics& g) override;
+    
+private:
+    void renderPreview();
+    void saveReport(const File& file, ReportRenderer::Format format);
+    
+    VCOTuner* tuner;
+    Visualizer* visualizer;
+    ReportCreatorWindow* parent;
+    
+    /** copied when the screen is opened, the jobs only read it */
+    const ReportRenderer::Content content;
+    /** a single thread, one job at a time. Saving is only enabled once the preview is done,
+     so that no job ever waits behind another one. */
+    ThreadPool renderPool;
+    
+    Image preview; // invalid until it's rendered
+    TextButton save;
+    ComboBox resolution; // of the image formats
+    TextButton close;
+};
+
+
+#endif  // REPORTDISPLAYSCREEN_H_INCLUDED
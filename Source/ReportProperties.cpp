@@ -13,4 +13,5 @@
 const double ReportProperties::desiredAdjustmentFrequency = 440.0;
 const double ReportProperties::allowedDeviation = 10.0;
 
+const double ReportProperties::referenceInterval = 30.0; // seconds
 const double ReportProperties::desiredDriftMargin = 0.02; // 2 cents
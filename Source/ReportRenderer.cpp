@@ -0,0 +1,775 @@
+/*
+  ==============================================================================
+
+    ReportRenderer.cpp
+    Created: 18 Oct 2026 6:20:31pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "ReportRenderer.h"
+#include "Visualizer.h"
+
+extern ApplicationProperties& getAppProperties();
+
+namespace
+{
+    /** the graph of every report has the same scale, so that they can be compared */
+    const double graphMin = -0.15;
+    const double graphMax = 0.15;
+    
+    const float jpegQuality = 0.9f;
+    /** PDF pages are measured in points of 1/72 inch */
+    const float pointsPerUnit = 72.0f / ReportRenderer::defaultDpi;
+    
+    String describeDrift(double referenceFrequency, double remeasuredFrequency, bool corrected)
+    {
+        if (remeasuredFrequency <= 0 || referenceFrequency <= 0)
+            return "not measured";
+        
+        const double pitchDrift = 12.0 * log(remeasuredFrequency / referenceFrequency) / log(2.0);
+        String driftString;
+        if (std::abs(pitchDrift) >= 1)
+            driftString = String(pitchDrift, 2) + " semitones";
+        else if (String(std::abs(pitchDrift), 2) == "1.00")
+            driftString = String(pitchDrift, 2) + " semitone";
+        else
+            driftString = String(pitchDrift * 100, 1) + " cents";
+        if (std::abs(pitchDrift) >= 2)
+            driftString += " (Holy crap! R u ok?)";
+        else if (std::abs(pitchDrift) >= 0.5)
+            driftString += " (Oh dear.)";
+        else if (std::abs(pitchDrift) > 0.02)
+            driftString += corrected ? " (corrected)" : " (not quite stable)";
+        return driftString;
+    }
+    
+    /** a number for the SVG and PDF files, without the trailing zeros */
+    String formatNumber(double value)
+    {
+        String text(value, 3);
+        text = text.trimCharactersAtEnd("0").trimCharactersAtEnd(".");
+        return text == "-0" ? "0" : text;
+    }
+    
+    /** "a b c d e f", the order of SVG's matrix() and PDF's cm */
+    String formatMatrix(const AffineTransform& t)
+    {
+        return formatNumber(t.mat00) + " " + formatNumber(t.mat10) + " " + formatNumber(t.mat01) + " "
+               + formatNumber(t.mat11) + " " + formatNumber(t.mat02) + " " + formatNumber(t.mat12);
+    }
+    
+    MemoryBlock compress(const void* data, size_t size)
+    {
+        // JUCE's "GZIP" stream writes the zlib format that PDF's FlateDecode expects
+        MemoryOutputStream compressed;
+        {
+            GZIPCompressorOutputStream zip(compressed, 9);
+            zip.write(data, size);
+        }
+        return compressed.getMemoryBlock();
+    }
+    
+    //==============================================================================
+    /** What the vector formats have in common, like JUCE's PostScript renderer: the
+        transform, the clip and the fill of each state are kept here, and all drawing is
+        reduced to filled paths in the coordinates of the page. The clip is only known
+        as its bounds, which is all that Graphics asks for. */
+    class VectorContext: public LowLevelGraphicsContext
+    {
+    public:
+        VectorContext()
+        {
+            state.clip = Rectangle<float>(0.0f, 0.0f, (float) ReportRenderer::width, (float) ReportRenderer::height);
+        }
+        
+        bool isVectorDevice() const override { return true; }
+        void setOrigin(Point<int> origin) override { addTransform(AffineTransform::translation((float) origin.x, (float) origin.y)); }
+        void addTransform(const AffineTransform& t) override { state.transform = t.followedBy(state.transform); }
+        float getPhysicalPixelScaleFactor() override { return 1.0f; }
+        
+        bool clipToRectangle(const Rectangle<int>& r) override
+        {
+            Path path;
+            path.addRectangle(r);
+            clipToPath(path, AffineTransform());
+            return !isClipEmpty();
+        }
+        
+        bool clipToRectangleList(const RectangleList<int>& rectangles) override
+        {
+            Path path;
+            for (const Rectangle<int>& r : rectangles)
+                path.addRectangle(r);
+            clipToPath(path, AffineTransform());
+            return !isClipEmpty();
+        }
+        
+        void excludeClipRectangle(const Rectangle<int>& r) override
+        {
+            // the rectangle becomes a hole in the current clip
+            Path path;
+            path.addRectangle(r);
+            path.applyTransform(state.transform);
+            path.addRectangle(state.clip);
+            path.setUsingNonZeroWinding(false);
+            clipToPagePath(path);
+        }
+        
+        void clipToPath(const Path& path, const AffineTransform& t) override
+        {
+            Path pagePath(path);
+            pagePath.applyTransform(t.followedBy(state.transform));
+            clipToPagePath(pagePath);
+        }
+        
+        void clipToImageAlpha(const Image& image, const AffineTransform& t) override
+        {
+            // can't be masked by an image, its bounds are the closest
+            Path path;
+            path.addRectangle(image.getBounds());
+            clipToPath(path, t);
+        }
+        
+        bool clipRegionIntersects(const Rectangle<int>& r) override
+        {
+            return state.clip.intersects(r.toFloat().transformedBy(state.transform));
+        }
+        
+        Rectangle<int> getClipBounds() const override
+        {
+            return state.clip.transformedBy(state.transform.inverted()).getSmallestIntegerContainer();
+        }
+        
+        bool isClipEmpty() const override { return state.clip.isEmpty(); }
+        
+        void saveState() override
+        {
+            stack.add(state);
+            state.numClips = 0;
+            writeSaveState();
+        }
+        
+        void restoreState() override
+        {
+            if (stack.isEmpty())
+            {
+                jassertfalse;
+                return;
+            }
+            
+            writeRestoreState(state.numClips);
+            state = stack.getLast();
+            stack.removeLast();
+        }
+        
+        void beginTransparencyLayer(float opacity) override
+        {
+            // the opacity is applied to each shape of the layer instead of the whole layer
+            saveState();
+            state.layerOpacity *= opacity;
+        }
+        
+        void endTransparencyLayer() override { restoreState(); }
+        
+        void setFill(const FillType& fill) override { state.fill = fill; }
+        void setOpacity(float opacity) override { state.fill.setOpacity(opacity); }
+        void setInterpolationQuality(Graphics::ResamplingQuality) override {}
+        
+        void fillRect(const Rectangle<int>& r, bool) override { fillRect(r.toFloat()); }
+        
+        void fillRect(const Rectangle<float>& r) override
+        {
+            Path path;
+            path.addRectangle(r);
+            fillPath(path, AffineTransform());
+        }
+        
+        void fillRectList(const RectangleList<float>& rectangles) override
+        {
+            Path path;
+            for (const Rectangle<float>& r : rectangles)
+                path.addRectangle(r);
+            fillPath(path, AffineTransform());
+        }
+        
+        void fillPath(const Path& path, const AffineTransform& t) override
+        {
+            Path pagePath(path);
+            pagePath.applyTransform(t.followedBy(state.transform));
+            if (state.clip.intersects(pagePath.getBounds()))
+                writePath(pagePath, getFillColour());
+        }
+        
+        void drawImage(const Image& image, const AffineTransform& t) override
+        {
+            if (image.isValid())
+                writeImage(image, t.followedBy(state.transform), state.fill.getOpacity() * state.layerOpacity);
+        }
+        
+        void drawLine(const Line<float>& line) override
+        {
+            Path path;
+            path.addLineSegment(line, 1.0f);
+            fillPath(path, AffineTransform());
+        }
+        
+        void setFont(const Font& font) override { state.font = font; }
+        const Font& getFont() override { return state.font; }
+        
+        void drawGlyph(int glyphNumber, const AffineTransform& t) override
+        {
+            Typeface* typeface = state.font.getTypeface();
+            if (typeface == nullptr)
+                return;
+            
+            Path path;
+            typeface->getOutlineForGlyph(glyphNumber, path);
+            const float fontHeight = state.font.getHeight();
+            fillPath(path, AffineTransform::scale(fontHeight * state.font.getHorizontalScale(), fontHeight).followedBy(t));
+        }
+    
+    protected:
+        struct State
+        {
+            AffineTransform transform;
+            Rectangle<float> clip; // the bounds, in page coordinates
+            int numClips = 0; // that were added since the state was saved
+            FillType fill;
+            float layerOpacity = 1.0f;
+            Font font;
+        };
+        State state;
+        Array<State> stack;
+        
+        /** the paths are in page coordinates */
+        virtual void writeSaveState() = 0;
+        virtual void writeRestoreState(int numClips) = 0;
+        virtual void writeClip(const Path& path) = 0;
+        virtual void writePath(const Path& path, Colour colour) = 0;
+        virtual void writeImage(const Image& image, const AffineTransform& t, float opacity) = 0;
+        
+        void restoreAllStates()
+        {
+            while (!stack.isEmpty())
+                restoreState();
+        }
+    
+    private:
+        void clipToPagePath(const Path& path)
+        {
+            state.clip = state.clip.getIntersection(path.getBounds());
+            state.numClips++;
+            writeClip(path);
+        }
+        
+        Colour getFillColour() const
+        {
+            // the report only uses plain colours, a gradient gets its middle one
+            const Colour colour = state.fill.isGradient() ? state.fill.gradient->getColourAtPosition(0.5)
+                                                          : state.fill.colour;
+            return colour.withMultipliedAlpha(state.fill.getOpacity() * state.layerOpacity);
+        }
+    };
+    
+    //==============================================================================
+    /** writes SVG right into the stream. Each clip opens a group that is closed with the
+        state it was added to. */
+    class SvgContext: public VectorContext
+    {
+    public:
+        SvgContext(OutputStream& s)
+        : out(s), numClipPaths(0)
+        {
+            out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                << "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" version=\"1.1\""
+                << " width=\"" << String(ReportRenderer::width) << "px\" height=\"" << String(ReportRenderer::height) << "px\""
+                << " viewBox=\"0 0 " << String(ReportRenderer::width) << " " << String(ReportRenderer::height) << "\">\n";
+        }
+        
+        void finish()
+        {
+            restoreAllStates();
+            writeRestoreState(state.numClips);
+            out << "</svg>\n";
+        }
+    
+    private:
+        void writeSaveState() override {}
+        
+        void writeRestoreState(int numClips) override
+        {
+            for (int i = 0; i < numClips; i++)
+                out << "</g>\n";
+        }
+        
+        void writeClip(const Path& path) override
+        {
+            const String id = "clip" + String(numClipPaths++);
+            out << "<clipPath id=\"" << id << "\"><path d=\"";
+            writePathData(path);
+            out << "\"" << (path.isUsingNonZeroWinding() ? "" : " clip-rule=\"evenodd\"") << "/></clipPath>\n"
+                << "<g clip-path=\"url(#" << id << ")\">\n";
+        }
+        
+        void writePath(const Path& path, Colour colour) override
+        {
+            out << "<path d=\"";
+            writePathData(path);
+            out << "\" fill=\"#" << colour.toDisplayString(false) << "\"";
+            if (colour.getAlpha() < 255)
+                out << " fill-opacity=\"" << formatNumber(colour.getFloatAlpha()) << "\"";
+            if (!path.isUsingNonZeroWinding())
+                out << " fill-rule=\"evenodd\"";
+            out << "/>\n";
+        }
+        
+        void writeImage(const Image& image, const AffineTransform& t, float opacity) override
+        {
+            MemoryOutputStream png;
+            PNGImageFormat().writeImageToStream(image, png);
+            out << "<image width=\"" << String(image.getWidth()) << "\" height=\"" << String(image.getHeight())
+                << "\" transform=\"matrix(" << formatMatrix(t) << ")\"";
+            if (opacity < 1.0f)
+                out << " opacity=\"" << formatNumber(opacity) << "\"";
+            out << " xlink:href=\"data:image/png;base64," << Base64::toBase64(png.getData(), png.getDataSize()) << "\"/>\n";
+        }
+        
+        void writePathData(const Path& path)
+        {
+            Path::Iterator i(path);
+            while (i.next())
+            {
+                switch (i.elementType)
+                {
+                    case Path::Iterator::startNewSubPath:
+                        out << "M" << formatNumber(i.x1) << " " << formatNumber(i.y1);
+                        break;
+                    case Path::Iterator::lineTo:
+                        out << "L" << formatNumber(i.x1) << " " << formatNumber(i.y1);
+                        break;
+                    case Path::Iterator::quadraticTo:
+                        out << "Q" << formatNumber(i.x1) << " " << formatNumber(i.y1) << " "
+                            << formatNumber(i.x2) << " " << formatNumber(i.y2);
+                        break;
+                    case Path::Iterator::cubicTo:
+                        out << "C" << formatNumber(i.x1) << " " << formatNumber(i.y1) << " "
+                            << formatNumber(i.x2) << " " << formatNumber(i.y2) << " "
+                            << formatNumber(i.x3) << " " << formatNumber(i.y3);
+                        break;
+                    case Path::Iterator::closePath:
+                        out << "Z";
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+        
+        OutputStream& out;
+        int numClipPaths;
+    };
+    
+    //==============================================================================
+    /** collects the content stream of a single page and the images on it, and writes the
+        whole file at the end, because the objects must be listed with their offsets */
+    class PdfContext: public VectorContext
+    {
+    public:
+        PdfContext()
+        {
+            // in points, with the y axis pointing down like in JUCE
+            content << formatMatrix(AffineTransform(pointsPerUnit, 0, 0, 0, -pointsPerUnit, ReportRenderer::height * pointsPerUnit))
+                    << " cm\n";
+        }
+        
+        /** returns an error message if the file couldn't be written */
+        String finish(OutputStream& stream)
+        {
+            restoreAllStates();
+            
+            MemoryOutputStream pdf;
+            Array<int64> offsets; // of the objects, which are numbered from 1
+            auto beginObject = [&] ()
+            {
+                offsets.add(pdf.getPosition());
+                pdf << String(offsets.size()) << " 0 obj\n";
+            };
+            auto writeStream = [&] (const MemoryBlock& data, const String& dictionary)
+            {
+                const MemoryBlock compressed = compress(data.getData(), data.getSize());
+                pdf << "<< " << (dictionary.isEmpty() ? String() : dictionary + " ") << "/Length " << String((int64) compressed.getSize())
+                    << " /Filter /FlateDecode >>\nstream\n";
+                pdf.write(compressed.getData(), compressed.getSize());
+                pdf << "\nendstream\nendobj\n";
+            };
+            const int firstImageObject = 5;
+            
+            // the comment with the binary characters marks the file as binary
+            pdf << "%PDF-1.4\n%\xe2\xe3\xcf\xd3\n";
+            beginObject();
+            pdf << "<< /Type /Catalog /Pages 2 0 R >>\nendobj\n";
+            beginObject();
+            pdf << "<< /Type /Pages /Kids [3 0 R] /Count 1 >>\nendobj\n";
+            
+            beginObject();
+            pdf << "<< /Type /Page /Parent 2 0 R /MediaBox [0 0 " << formatNumber(ReportRenderer::width * pointsPerUnit)
+                << " " << formatNumber(ReportRenderer::height * pointsPerUnit) << "] /Contents 4 0 R"
+                << " /Resources << /ExtGState <<";
+            for (int alpha = alphas.findNextSetBit(0); alpha >= 0; alpha = alphas.findNextSetBit(alpha + 1))
+                pdf << " /A" << String(alpha) << " << /ca " << formatNumber(alpha / 255.0) << " >>";
+            pdf << " >> /XObject <<";
+            for (int i = 0; i < images.size(); i++)
+                pdf << " /Im" << String(i) << " " << String(firstImageObject + 2 * i) << " 0 R";
+            pdf << " >> >> >>\nendobj\n";
+            
+            beginObject();
+            writeStream(content.getMemoryBlock(), {});
+            
+            // each image with its alpha channel as a soft mask
+            for (int i = 0; i < images.size(); i++)
+            {
+                const PdfImage& image = *images[i];
+                const String size = "/Type /XObject /Subtype /Image /Width " + String(image.width)
+                                    + " /Height " + String(image.height) + " /BitsPerComponent 8";
+                beginObject();
+                writeStream(image.colours, size + " /ColorSpace /DeviceRGB /SMask "
+                                           + String(firstImageObject + 2 * i + 1) + " 0 R");
+                beginObject();
+                writeStream(image.alphas, size + " /ColorSpace /DeviceGray");
+            }
+            
+            const int64 xrefPosition = pdf.getPosition();
+            pdf << "xref\n0 " << String(offsets.size() + 1) << "\n"
+                << "0000000000 65535 f \n";
+            for (int64 offset : offsets)
+                pdf << String(offset).paddedLeft('0', 10) << " 00000 n \n";
+            pdf << "trailer\n<< /Size " << String(offsets.size() + 1) << " /Root 1 0 R >>\n"
+                << "startxref\n" << String(xrefPosition) << "\n%%EOF\n";
+            
+            if (!stream.write(pdf.getData(), pdf.getDataSize()))
+                return "Error writing the PDF file";
+            return {};
+        }
+    
+    private:
+        void writeSaveState() override
+        {
+            content << "q\n";
+        }
+        
+        void writeRestoreState(int) override
+        {
+            content << "Q\n";
+        }
+        
+        void writeClip(const Path& path) override
+        {
+            writePathData(path);
+            content << (path.isUsingNonZeroWinding() ? "W n\n" : "W* n\n");
+        }
+        
+        void writePath(const Path& path, Colour colour) override
+        {
+            alphas.setBit(colour.getAlpha());
+            content << formatNumber(colour.getFloatRed()) << " " << formatNumber(colour.getFloatGreen()) << " "
+                    << formatNumber(colour.getFloatBlue()) << " rg /A" << String(colour.getAlpha()) << " gs\n";
+            writePathData(path);
+            content << (path.isUsingNonZeroWinding() ? "f\n" : "f*\n");
+        }
+        
+        void writeImage(const Image& image, const AffineTransform& t, float opacity) override
+        {
+            // images are drawn into the unit square, with their first row at the top
+            const AffineTransform unitToImage(image.getWidth(), 0, 0, 0, -image.getHeight(), image.getHeight());
+            const int alpha = jlimit(0, 255, roundToInt(opacity * 255.0f));
+            alphas.setBit(alpha);
+            content << "q /A" << String(alpha) << " gs " << formatMatrix(unitToImage.followedBy(t))
+                    << " cm /Im" << String(images.size()) << " Do Q\n";
+            images.add(new PdfImage(image));
+        }
+        
+        void writePathData(const Path& path)
+        {
+            // PDF has no quadratic curves, they are written as cubic ones
+            float x = 0, y = 0;
+            Path::Iterator i(path);
+            while (i.next())
+            {
+                switch (i.elementType)
+                {
+                    case Path::Iterator::startNewSubPath:
+                        content << formatNumber(i.x1) << " " << formatNumber(i.y1) << " m\n";
+                        x = i.x1;
+                        y = i.y1;
+                        break;
+                    case Path::Iterator::lineTo:
+                        content << formatNumber(i.x1) << " " << formatNumber(i.y1) << " l\n";
+                        x = i.x1;
+                        y = i.y1;
+                        break;
+                    case Path::Iterator::quadraticTo:
+                        content << formatNumber(x + (i.x1 - x) * 2.0f / 3.0f) << " " << formatNumber(y + (i.y1 - y) * 2.0f / 3.0f) << " "
+                                << formatNumber(i.x2 + (i.x1 - i.x2) * 2.0f / 3.0f) << " " << formatNumber(i.y2 + (i.y1 - i.y2) * 2.0f / 3.0f) << " "
+                                << formatNumber(i.x2) << " " << formatNumber(i.y2) << " c\n";
+                        x = i.x2;
+                        y = i.y2;
+                        break;
+                    case Path::Iterator::cubicTo:
+                        content << formatNumber(i.x1) << " " << formatNumber(i.y1) << " "
+                                << formatNumber(i.x2) << " " << formatNumber(i.y2) << " "
+                                << formatNumber(i.x3) << " " << formatNumber(i.y3) << " c\n";
+                        x = i.x3;
+                        y = i.y3;
+                        break;
+                    case Path::Iterator::closePath:
+                        content << "h\n";
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+        
+        /** the samples of an image, one byte per channel */
+        struct PdfImage
+        {
+            PdfImage(const Image& image)
+            : width(image.getWidth()), height(image.getHeight()),
+              colours((size_t) (width * height * 3)), alphas((size_t) (width * height))
+            {
+                const Image::BitmapData pixels(image, Image::BitmapData::readOnly);
+                uint8* colour = static_cast<uint8*>(colours.getData());
+                uint8* alpha = static_cast<uint8*>(alphas.getData());
+                for (int y = 0; y < height; y++)
+                {
+                    for (int x = 0; x < width; x++)
+                    {
+                        const Colour c = pixels.getPixelColour(x, y);
+                        *colour++ = c.getRed();
+                        *colour++ = c.getGreen();
+                        *colour++ = c.getBlue();
+                        *alpha++ = c.getAlpha();
+                    }
+                }
+            }
+            
+            int width;
+            int height;
+            MemoryBlock colours;
+            MemoryBlock alphas;
+        };
+        
+        MemoryOutputStream content;
+        OwnedArray<PdfImage> images;
+        BigInteger alphas; // the opacities that were used, each one needs a graphics state
+    };
+}
+
+//==============================================================================
+ReportRenderer::Content::Content(VCOTuner& tuner, const Array<VCOTuner::measurement_t>& r)
+: results(r)
+{
+    PropertiesFile* settings = getAppProperties().getUserSettings();
+    dutBrand = settings->getValue("DUT-Brand");
+    dutDevice = settings->getValue("DUT-Device");
+    interfaceBrand = settings->getValue("Interface-Brand");
+    interfaceDevice = settings->getValue("Interface-Device");
+    notes = settings->getValue("Notes");
+    
+    sampleRate = tuner.getCurrentSampleRate();
+    referencePitch = tuner.getReferencePitch();
+    referenceFrequency = tuner.getReferenceFrequency();
+    
+    // a sweep with interleaved references ends with one, the others measure it once more afterwards
+    driftCorrected = tuner.getNumReferenceMeasurements() > 1;
+    if (driftCorrected)
+        remeasuredFrequency = referenceFrequency * pow(2.0, tuner.getReferenceDrift() / 12.0);
+    else
+        remeasuredFrequency = tuner.getSingleMeasurementResult();
+}
+
+ReportRenderer::Content::Content(const SweepArchive::Sweep& sweep)
+: results(sweep.getMeasurements())
+{
+    const SweepArchive::Info& info = sweep.getInfo();
+    dutBrand = info.dutBrand;
+    dutDevice = info.dutDevice;
+    serialNumber = info.serialNumber;
+    interfaceBrand = info.interfaceBrand;
+    interfaceDevice = info.interfaceDevice;
+    notes = info.notes;
+    
+    sampleRate = info.sampleRate;
+    referencePitch = info.referencePitch;
+    referenceFrequency = info.referenceFrequencies[0];
+    
+    // the reference isn't stored again, but the correction of the last note of the first
+    // lane is close to its drift at the end. Without a correction, it's unknown.
+    remeasuredFrequency = 0;
+    driftCorrected = false;
+    for (const VCOTuner::measurement_t& m : results)
+    {
+        if (m.lane == 0 && m.rawPitchOffset != m.pitchOffset)
+        {
+            remeasuredFrequency = referenceFrequency * pow(2.0, (m.rawPitchOffset - m.pitchOffset) / 12.0);
+            driftCorrected = true;
+        }
+    }
+}
+
+//==============================================================================
+String ReportRenderer::getFormatName(Format format)
+{
+    switch (format)
+    {
+        case png: return "png";
+        case jpeg: return "jpeg";
+        case svg: return "svg";
+        case pdf: return "pdf";
+        default: break;
+    }
+    return {};
+}
+
+bool ReportRenderer::getFormatForName(const String& name, Format& format)
+{
+    const String extension = name.trim().trimCharactersAtStart(".").toLowerCase();
+    for (int i = 0; i < numFormats; i++)
+    {
+        if (extension == getFormatName((Format) i) || (i == jpeg && extension == "jpg"))
+        {
+            format = (Format) i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReportRenderer::paint(Graphics& g, const Content& content)
+{
+    g.fillAll(Colours::white);
+    
+    g.setColour(Colours::black);
+    
+    const int contentHeight = 16;
+    const int lineHeight = contentHeight + contentHeight/4;
+    Rectangle<int> leftColumnLabels(10, 10, 170, contentHeight);
+    Rectangle<int> leftColumnContent(170, 10, 230, contentHeight);
+    Rectangle<int> rightColumnLabels(420, 10, 120, contentHeight);
+    Rectangle<int> rightColumnContent(540, 10, width - 10 - 540, contentHeight);
+    
+    String dut = "'" + content.dutDevice + "' (" + content.dutBrand + ")";
+    if (content.serialNumber.isNotEmpty())
+        dut += " #" + content.serialNumber;
+    
+    g.drawText("Device under test:", leftColumnLabels, Justification::topLeft);
+    g.drawText(dut, leftColumnContent, Justification::topLeft);
+    leftColumnLabels.translate(0, lineHeight);
+    leftColumnContent.translate(0, lineHeight);
+    
+    g.drawText("CV Interface:", leftColumnLabels, Justification::topLeft);
+    g.drawText("'" + content.interfaceDevice + "' (" + content.interfaceBrand + ")", leftColumnContent, Justification::topLeft);
+    leftColumnLabels.translate(0, lineHeight);
+    leftColumnContent.translate(0, lineHeight);
+    
+    g.drawText("Samplerate:", leftColumnLabels, Justification::topLeft);
+    g.drawText(String(content.sampleRate / 1000) + " kHz", leftColumnContent, Justification::topLeft);
+    leftColumnLabels.translate(0, lineHeight);
+    leftColumnContent.translate(0, lineHeight);
+    
+    g.drawText("Reference frequency:", leftColumnLabels, Justification::topLeft);
+    g.drawText(String(content.referenceFrequency) + " Hz", leftColumnContent, Justification::topLeft);
+    leftColumnLabels.translate(0, lineHeight);
+    leftColumnContent.translate(0, lineHeight);
+    
+    g.drawText("Drift during measurement:", leftColumnLabels, Justification::topLeft);
+    g.drawText(describeDrift(content.referenceFrequency, content.remeasuredFrequency, content.driftCorrected), leftColumnContent, Justification::topLeft);
+    leftColumnLabels.translate(0, lineHeight);
+    leftColumnContent.translate(0, lineHeight);
+    
+    g.drawText("Notes:", rightColumnLabels, Justification::topLeft);
+    Rectangle<int> noteArea = rightColumnContent.withHeight(lineHeight + contentHeight);
+    g.drawMultiLineText(content.notes, noteArea.getX(), noteArea.getY() + juce::roundToInt(g.getCurrentFont().getHeight()), noteArea.getWidth());
+    
+    g.saveState();
+    int bottom = jmax(leftColumnLabels.getBottom(), leftColumnContent.getBottom(),
+                      rightColumnLabels.getBottom(), rightColumnContent.getBottom());
+    Rectangle<int> graphArea(10, bottom + 10, width - 20, height - 10 - bottom - 10);
+    g.reduceClipRegion(graphArea);
+    g.setOrigin(graphArea.getTopLeft());
+    Visualizer::paintResults(g, content.results, content.referencePitch, graphArea.getWidth(), graphArea.getHeight(), graphMin, graphMax);
+    g.restoreState();
+}
+
+Image ReportRenderer::renderImage(const Content& content, int dpi)
+{
+    // a software image, because native ones can't be drawn off the message thread everywhere
+    const float scale = dpi / (float) defaultDpi;
+    Image image(Image::RGB, jmax(1, roundToInt(width * scale)), jmax(1, roundToInt(height * scale)), true, SoftwareImageType());
+    Graphics g(image);
+    g.addTransform(AffineTransform::scale(scale));
+    paint(g, content);
+    return image;
+}
+
+String ReportRenderer::write(const Content& content, Format format, int dpi, OutputStream& stream)
+{
+    if (format == svg)
+    {
+        SvgContext context(stream);
+        {
+            Graphics g(context);
+            paint(g, content);
+        }
+        context.finish();
+        return {};
+    }
+    
+    if (format == pdf)
+    {
+        PdfContext context;
+        {
+            Graphics g(context);
+            paint(g, content);
+        }
+        return context.finish(stream);
+    }
+    
+    const Image image = renderImage(content, dpi);
+    PNGImageFormat pngFormat;
+    JPEGImageFormat jpegFormat;
+    jpegFormat.setQuality(jpegQuality);
+    ImageFileFormat& imageFormat = format == jpeg ? static_cast<ImageFileFormat&>(jpegFormat) : pngFormat;
+    if (!imageFormat.writeImageToStream(image, stream))
+        return "Error writing the report image";
+    return {};
+}
+
+String ReportRenderer::write(const Content& content, Format format, int dpi, const File& file)
+{
+    // not the end of an older, longer file
+    if (file.existsAsFile() && !file.deleteFile())
+        return "Can't replace " + file.getFullPathName();
+    
+    FileOutputStream stream(file);
+    if (stream.failedToOpen())
+        return "Can't write " + file.getFullPathName();
+    
+    String error = write(content, format, dpi, stream);
+    stream.flush();
+    if (error.isEmpty() && stream.getStatus().failed())
+        error = "Error writing " + file.getFullPathName() + ": " + stream.getStatus().getErrorMessage();
+    return error;
+}
+
+String ReportRenderer::getFileName(const SweepArchive::Info& info, int index, Format format)
+{
+    String name;
+    name << String(index).paddedLeft('0', 5) << " " << info.time.formatted("%Y-%m-%d %H%M%S")
+         << " " << info.getDutModel();
+    if (info.serialNumber.isNotEmpty())
+        name << " " << info.serialNumber;
+    return File::createLegalFileName(name.trim()) + "." + getFormatName(format);
+}
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    ReportRenderer.h
+    Created: 18 Oct 2026 6:20:31pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef REPORTRENDERER_H_INCLUDED
+#define REPORTRENDERER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "VCOTuner.h"
+#include "SweepArchive.h"
+
+/** Draws the report of a sweep: the details of the DUT and the interface on top and the
+    results below, like the Visualizer shows them.
+    
+    Everything that is shown is copied into the Content first, so that the report can be
+    rendered on any thread without touching the tuner, the settings or a component. The
+    page is width x height units of 1/96 inch, like a CSS pixel. Images are rendered at
+    any resolution, SVG and PDF files get the same drawing as vector paths. The text is
+    converted to outlines, so that the files look the same without the fonts.
+ */
+class ReportRenderer
+{
+public:
+    /** the size of the page, in units of 1/96 inch */
+    static const int width = 800;
+    static const int height = 600;
+    /** the resolution at which the page has its size in pixels */
+    static const int defaultDpi = 96;
+    
+    /** everything that is shown in a report */
+    struct Content
+    {
+        /** from the tuner's last sweep and the details that were entered for the report */
+        Content(VCOTuner& tuner, const Array<VCOTuner::measurement_t>& results);
+        /** from a sweep in the archive */
+        Content(const SweepArchive::Sweep& sweep);
+        
+        String dutBrand;
+        String dutDevice;
+        String serialNumber;
+        String interfaceBrand;
+        String interfaceDevice;
+        String notes;
+        
+        double sampleRate;
+        int referencePitch;
+        double referenceFrequency;
+        /** of the reference note, measured again after the sweep. 0 if it wasn't. */
+        double remeasuredFrequency;
+        /** the drift was taken out of the results, see VCOTuner::setReferenceInterval() */
+        bool driftCorrected;
+        
+        Array<VCOTuner::measurement_t> results;
+    };
+    
+    enum Format
+    {
+        png = 0,
+        jpeg,
+        svg,
+        pdf,
+        numFormats
+    };
+    /** e.g. "png", which is also the extension of the files */
+    static String getFormatName(Format format);
+    /** returns false if there is no format with this name or extension */
+    static bool getFormatForName(const String& name, Format& format);
+    
+    /** draws the report into the area from (0, 0) to (width, height) */
+    static void paint(Graphics& g, const Content& content);
+    
+    /** renders the report into a new image of the size at this resolution */
+    static Image renderImage(const Content& content, int dpi);
+    
+    /** writes the report in the format. The resolution is only used by the image formats.
+     Returns an error message if it couldn't be written. */
+    static String write(const Content& content, Format format, int dpi, OutputStream& stream);
+    static String write(const Content& content, Format format, int dpi, const File& file);
+    
+    /** the name of the file for the report of a sweep in the archive, e.g. for batches */
+    static String getFileName(const SweepArchive::Info& info, int index, Format format);
+};
+
+
+#endif  // REPORTRENDERER_H_INCLUDED
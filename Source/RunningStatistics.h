@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    RunningStatistics.h
+    Created: 17 Oct 2026 3:12:48pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef RUNNINGSTATISTICS_H_INCLUDED
+#define RUNNINGSTATISTICS_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** Mean and variance of a stream of values, updated with each new value
+    (Welford's algorithm). Takes constant time and memory, no matter how many
+    values are added.
+    
+    Also tracks the correlation between adjacent values, so that the standard
+    error of the mean can be estimated for values that aren't independent.
+ */
+class RunningStatistics
+{
+public:
+    RunningStatistics() { reset(); }
+    
+    void reset()
+    {
+        numValues = 0;
+        mean = 0;
+        sumOfSquaredDeviations = 0;
+        firstValue = 0;
+        lastShiftedValue = 0;
+        sumOfShiftedValues = 0;
+        sumOfAdjacentProducts = 0;
+    }
+    
+    void add(double value)
+    {
+        numValues++;
+        const double delta = value - mean;
+        mean += delta / (double) numValues;
+        sumOfSquaredDeviations += delta * (value - mean);
+        
+        // the raw sums are taken relative to the first value to keep them small
+        if (numValues == 1)
+            firstValue = value;
+        const double shifted = value - firstValue;
+        sumOfShiftedValues += shifted;
+        sumOfAdjacentProducts += shifted * lastShiftedValue;
+        lastShiftedValue = shifted;
+    }
+    
+    int getNumValues() const { return numValues; }
+    double getMean() const { return mean; }
+    
+    /** sample variance around the mean */
+    double getVariance() const
+    {
+        if (numValues < 2)
+            return 0;
+        return sumOfSquaredDeviations / (double) (numValues - 1);
+    }
+    
+    /** sample variance around any other value, e.g. a mean that was calculated
+     in another domain */
+    double getVarianceAround(double value) const
+    {
+        if (numValues < 2)
+            return 0;
+        const double offset = mean - value;
+        return (sumOfSquaredDeviations + numValues * offset * offset) / (double) (numValues - 1);
+    }
+    
+    /** correlation of each value with the previous one, from -1 to 1 */
+    double getLag1Autocorrelation() const
+    {
+        if (numValues < 3 || sumOfSquaredDeviations <= 0)
+            return 0;
+        
+        // sum of (x[i] - mean) * (x[i-1] - mean). The first shifted value is zero.
+        const double shiftedMean = sumOfShiftedValues / (double) numValues;
+        const double covariance = sumOfAdjacentProducts
+                                  - shiftedMean * (2.0 * sumOfShiftedValues - lastShiftedValue)
+                                  + (numValues - 1) * shiftedMean * shiftedMean;
+        return jlimit(-1.0, 1.0, covariance / sumOfSquaredDeviations);
+    }
+    
+    /** standard error of the mean, corrected for the correlation between adjacent values.
+     Positively correlated values (e.g. a slow wander) are treated as a first order
+     autoregressive process, they carry less information than independent ones.
+     Negatively correlated values (e.g. the lengths of two periods that share a noisy
+     zero crossing) carry more: their errors cancel out in the mean.
+     
+     The correlation is only an estimate itself. The upper end of its 95% confidence
+     interval is used, so that the error is rather over- than underestimated. */
+    double getStandardErrorOfMean() const
+    {
+        if (numValues < 2)
+            return 0;
+        
+        const double n = (double) numValues;
+        double r = getLag1Autocorrelation();
+        r = jmin(0.95, r + 1.96 * sqrt(jmax(0.0, 1.0 - 3.0 * r * r + 4.0 * r * r * r * r) / n)); // Bartlett
+        
+        double varianceFactor;
+        if (r >= 0)
+            varianceFactor = (1.0 + r) / (1.0 - r);
+        else // only adjacent values are correlated. The error can't get below that of the first and last value.
+            varianceFactor = jmax(1.0 + 2.0 * r * (n - 1.0) / n, 1.0 / n);
+        return sqrt(getVariance() / n * varianceFactor);
+    }
+    
+private:
+    int numValues;
+    double mean;
+    double sumOfSquaredDeviations;
+    
+    double firstValue;
+    double lastShiftedValue;
+    double sumOfShiftedValues;
+    double sumOfAdjacentProducts; // sum of shifted x[i] * x[i-1]
+};
+
+
+#endif  // RUNNINGSTATISTICS_H_INCLUDED
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    SeqLock.h
+    Created: 18 Oct 2026 9:41:27pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef SEQLOCK_H_INCLUDED
+#define SEQLOCK_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** Passes a small value from one thread that writes it to any number of threads that
+    read it, without locks and without allocating.
+    
+    The writer never waits. It makes the sequence number odd while it writes and even
+    again when it's done, and a reader copies the value until the sequence number was
+    even and the same before and after the copy. A reader only retries while a write is
+    in progress, which takes a few dozen stores. The value is kept in atomic words, so a
+    copy that is thrown away isn't a data race either.
+ */
+template <typename Type>
+class SeqLock
+{
+public:
+    static_assert(std::is_trivially_copyable<Type>::value, "the value is copied word by word");
+    
+    SeqLock() : sequence(0)
+    {
+        for (int i = 0; i < numWords; i++)
+            words[i].store(0, std::memory_order_relaxed);
+    }
+    
+    /** must always be called from the same thread, or under the same lock */
+    void write(const Type& value)
+    {
+        uint64 copy[numWords] = {};
+        memcpy(copy, &value, sizeof(Type));
+        
+        const uint32 s = sequence.load(std::memory_order_relaxed);
+        sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int i = 0; i < numWords; i++)
+            words[i].store(copy[i], std::memory_order_relaxed);
+        sequence.store(s + 2, std::memory_order_release);
+    }
+    
+    /** can be called from any thread. Returns the value of the last complete write,
+     all zeros before the first one. */
+    Type read() const
+    {
+        uint64 copy[numWords];
+        for (;;)
+        {
+            const uint32 before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+                continue;
+            
+            for (int i = 0; i < numWords; i++)
+                copy[i] = words[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+                break;
+        }
+        
+        Type value;
+        memcpy(&value, copy, sizeof(Type));
+        return value;
+    }
+    
+    /** counts the writes, so that a reader can tell whether anything has changed */
+    uint32 getVersion() const { return sequence.load(std::memory_order_acquire) / 2; }
+    
+private:
+    static const int numWords = (int) ((sizeof(Type) + sizeof(uint64) - 1) / sizeof(uint64));
+    std::atomic<uint64> words[numWords];
+    std::atomic<uint32> sequence;
+    
+    JUCE_DECLARE_NON_COPYABLE(SeqLock)
+};
+
+
+#endif  // SEQLOCK_H_INCLUDED
@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+    SettleDetector.cpp
+    Created: 17 Oct 2026 4:05:31pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SettleDetector.h"
+
+namespace
+{
+    /** a trend over the window (or a single period) below this is always considered flat */
+    const double toleranceInCents = 0.1;
+    /** a trend below this many standard errors is considered to be jitter */
+    const double trendSignificance = 2.0;
+    /** a period that deviates from the trend by more than this many standard deviations is an outlier */
+    const double outlierSignificance = 4.0;
+    /** max deviation of a single period from the average */
+    const double maxRelativeDeviation = 0.1;
+    /** at high frequencies, a few periods are combined so that the window isn't too short
+     to see a slow slew and the jitter is averaged a bit */
+    const double minimumBlockTimeMs = 2.0;
+}
+
+SettleDetector::SettleDetector()
+{
+    reset(44100.0, 0, 0, 0);
+}
+
+void SettleDetector::reset(double sr, double previousLength, double minimumDepartureInOctaves, double minimumSettleTimeMs)
+{
+    sampleRate = sr;
+    previousPeriodLength = previousLength;
+    minimumDeparture = minimumDepartureInOctaves;
+    minimumSettlePosition = minimumSettleTimeMs * sampleRate / 1000.0;
+    maxDeparturePosition = maxDepartureTimeMs * sampleRate / 1000.0;
+    minimumBlockLength = minimumBlockTimeMs * sampleRate / 1000.0;
+    minimumWindowLength = minWindowTimeMs * sampleRate / 1000.0;
+    
+    numBlocks = 0;
+    blockLength = 0;
+    numPeriodsInBlock = 0;
+    settled = false;
+    jittery = false;
+    settlePosition = 0;
+    detectionPosition = 0;
+    settledPeriodLength = 0;
+}
+
+bool SettleDetector::addPeriod(double endPosition, double periodLength)
+{
+    if (settled)
+        return true;
+    
+    // the periods don't have to follow each other directly (e.g. the estimates of
+    // overlapping analysis frames), so the block is measured by their positions
+    if (numPeriodsInBlock == 0)
+        blockStart = endPosition - periodLength;
+    blockLength += periodLength;
+    numPeriodsInBlock++;
+    if (endPosition - blockStart < minimumBlockLength)
+        return false;
+    
+    const int head = numBlocks % maxWindowLength;
+    periodLengths[head] = blockLength / numPeriodsInBlock;
+    startPositions[head] = blockStart;
+    numBlocks++;
+    blockLength = 0;
+    numPeriodsInBlock = 0;
+    
+    // the fewest of the latest blocks that span the minimum time, or all of them
+    if (numBlocks < minWindowLength)
+        return false;
+    int windowLength = minWindowLength;
+    while (windowLength < maxWindowLength
+           && endPosition - startPositions[(numBlocks - windowLength) % maxWindowLength] < minimumWindowLength)
+    {
+        if (windowLength == numBlocks)
+            return false;
+        windowLength++;
+    }
+    
+    // the oldest block in the window
+    const int tail = (numBlocks - windowLength) % maxWindowLength;
+    const double windowStart = startPositions[tail];
+    if (windowStart < minimumSettlePosition)
+        return false;
+    
+    // oldest period first
+    double window[maxWindowLength];
+    double sum = 0;
+    for (int i = 0; i < windowLength; i++)
+    {
+        window[i] = periodLengths[(tail + i) % maxWindowLength];
+        sum += window[i];
+    }
+    const double average = sum / (double) windowLength;
+    
+    jittery = false;
+    for (int i = 0; i < windowLength; i++)
+    {
+        if (std::abs(window[i] - average) >= average * maxRelativeDeviation)
+            jittery = true;
+    }
+    if (jittery)
+        return false;
+    
+    // fit a line through the period lengths (x = 0 ... windowLength-1)
+    const double xMean = (windowLength - 1) / 2.0;
+    double sxx = 0;
+    double sxy = 0;
+    for (int i = 0; i < windowLength; i++)
+    {
+        const double x = i - xMean;
+        sxx += x * x;
+        sxy += x * (window[i] - average);
+    }
+    const double slope = sxy / sxx;
+    
+    double residuals[maxWindowLength];
+    double sumOfSquaredResiduals = 0;
+    for (int i = 0; i < windowLength; i++)
+    {
+        residuals[i] = window[i] - (average + slope * (i - xMean));
+        sumOfSquaredResiduals += residuals[i] * residuals[i];
+    }
+    const double jitter = sqrt(sumOfSquaredResiduals / (windowLength - 2));
+    
+    // the trend across the window must be flat or drowned in jitter
+    const double tolerance = average * (pow(2.0, toleranceInCents / 1200.0) - 1.0);
+    const double trend = std::abs(slope) * (windowLength - 1);
+    const double trendError = jitter / sqrt(sxx) * (windowLength - 1);
+    if (trend > jmax(tolerance, trendSignificance * trendError))
+        return false;
+    
+    // and no block may stick out (e.g. the last one before a step). Each block is compared
+    // to the jitter of all the other blocks, so that a single large one can't hide itself.
+    for (int i = 0; i < windowLength; i++)
+    {
+        const double x = i - xMean;
+        const double leverage = 1.0 / windowLength + x * x / sxx;
+        const double r2 = residuals[i] * residuals[i] / (1.0 - leverage);
+        const double othersJitter = sqrt(jmax(0.0, sumOfSquaredResiduals - r2) / (windowLength - 3));
+        if (std::abs(residuals[i]) > jmax(tolerance, outlierSignificance * othersJitter * sqrt(1.0 - leverage)))
+            return false;
+    }
+    
+    // still at the pitch of the previous note?
+    if (previousPeriodLength > 0 && minimumDeparture > 0 && windowStart < maxDeparturePosition)
+    {
+        if (std::abs(log2(average / previousPeriodLength)) < minimumDeparture)
+            return false;
+    }
+    
+    settled = true;
+    settlePosition = windowStart;
+    detectionPosition = endPosition;
+    settledPeriodLength = average;
+    return true;
+}
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    SettleDetector.h
+    Created: 17 Oct 2026 4:05:31pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef SETTLEDETECTOR_H_INCLUDED
+#define SETTLEDETECTOR_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** Watches the period lengths of an oscillator after a note on and decides when
+    its frequency has settled at the new pitch.
+    
+    The periods are combined into blocks of at least a few milliseconds. The
+    window of blocks that is looked at spans a minimum time, with at least a few
+    and at most maxWindowLength blocks. At high pitches it holds many short
+    blocks of several periods, at low pitches a few single periods, so that a low
+    note doesn't have to wait for many long periods. The average period lengths
+    of the blocks in the window are fitted with a straight line. The oscillator is
+    considered settled when the trend of that line is flat (below a small fixed
+    tolerance, or not significant compared to the jitter) and no block sticks out
+    from it.
+    
+    While the MIDI note is still on its way, the oscillator sits perfectly stable
+    at the previous pitch. If the period of the previous note is known, the new
+    periods must have moved away from it before they are accepted. Otherwise
+    everything before a minimum time (e.g. the input latency) is ignored.
+ */
+class SettleDetector
+{
+public:
+    SettleDetector();
+    
+    /** starts watching a new note.
+     @param sampleRate                   the sample rate of the positions and period lengths
+     @param previousPeriodLength         settled period of the previous note or 0 if unknown
+     @param minimumDepartureInOctaves    how far the frequency must have moved away from the
+                                         previous note. 0 if it isn't expected to change
+     @param minimumSettleTimeMs          periods that started before this time are ignored
+     */
+    void reset(double sampleRate, double previousPeriodLength, double minimumDepartureInOctaves, double minimumSettleTimeMs);
+    
+    /** adds the next period and returns true as soon as the frequency has settled.
+     @param endPosition     the position where this period ended (or the analysed signal, for
+                            estimates that span several periods), in samples since the note on
+     */
+    bool addPeriod(double endPosition, double periodLength);
+    
+    bool isSettled() const { return settled; }
+    
+    /** true if the periods are too jittery to ever be considered settled */
+    bool isJittery() const { return jittery; }
+    
+    /** time from the note on to the start of the first settled period */
+    double getSettleTimeMs() const { return settlePosition * 1000.0 / sampleRate; }
+    
+    /** time from the note on until the settling was detected, which is what the
+     measurement had to wait. Longer than getSettleTimeMs() by the window. */
+    double getDetectionTimeMs() const { return detectionPosition * 1000.0 / sampleRate; }
+    
+    /** average period length of the blocks that triggered the detection */
+    double getSettledPeriodLength() const { return settledPeriodLength; }
+    
+    /** the number of blocks in the window, see above */
+    static const int minWindowLength = 6;
+    static const int maxWindowLength = 16;
+    /** the window spans at least this time, unless it is full */
+    static const int minWindowTimeMs = 32;
+    /** if the frequency doesn't move away from the previous note within this time,
+     it is accepted anyway (and the tuner can report that the pitch doesn't change) */
+    static const int maxDepartureTimeMs = 1000;
+    
+private:
+    double sampleRate;
+    double previousPeriodLength;
+    double minimumDeparture;
+    double minimumSettlePosition;
+    double maxDeparturePosition;
+    
+    double minimumBlockLength;
+    
+    double blockStart;
+    double blockLength; // sum of the period lengths in the current block
+    int numPeriodsInBlock;
+    
+    double minimumWindowLength; // in samples
+    
+    double periodLengths[maxWindowLength]; // average period length of each block
+    double startPositions[maxWindowLength];
+    int numBlocks;
+    
+    bool settled;
+    bool jittery;
+    double settlePosition;
+    double detectionPosition;
+    double settledPeriodLength;
+    
+    JUCE_DECLARE_NON_COPYABLE(SettleDetector)
+};
+
+
+#endif  // SETTLEDETECTOR_H_INCLUDED
@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+    SignalConditioner.cpp
+    Created: 18 Oct 2026 11:07:52pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SignalConditioner.h"
+
+namespace
+{
+    /** cutoff of the DC blocker, far below the lowest note */
+    const double dcCutoff = 5.0;
+    /** the band-pass lets through this many octaves on each side of the note */
+    const double bandPassOctaves = 1.0;
+    /** the low-pass is left out above this fraction of the sample rate */
+    const double maxLowPassFrequency = 0.45;
+    /** the band-pass is tuned again when the average of this many periods ... */
+    const int numTrackedPeriods = 8;
+    /** ... is further than this from the note it's tuned to (a quarter octave) */
+    const double maxTuningErrorInOctaves = 0.25;
+    /** this part of the negative peaks is the hysteresis */
+    const float hysteresisFraction = 0.25f;
+    /** the peaks decay with this time constant, so that the hysteresis follows a quieter signal */
+    const double peakDecayMs = 100.0;
+    
+    const double butterworthQ = 1.0 / MathConstants<double>::sqrt2;
+}
+
+String SignalConditioner::getName(Mode mode)
+{
+    switch (mode)
+    {
+        case dcBlocker:
+            return "DC blocker";
+        case bandPass:
+            return "Band-pass";
+        case off:
+        default:
+            return "Off";
+    }
+}
+
+//==============================================================================
+void SignalConditioner::Biquad::setHighPass(double frequency, double sampleRate)
+{
+    const double w = MathConstants<double>::twoPi * frequency / sampleRate;
+    const double alpha = sin(w) / (2.0 * butterworthQ);
+    const double a0 = 1.0 + alpha;
+    b0 = (1.0 + cos(w)) / 2.0 / a0;
+    b1 = -(1.0 + cos(w)) / a0;
+    b2 = b0;
+    a1 = -2.0 * cos(w) / a0;
+    a2 = (1.0 - alpha) / a0;
+}
+
+void SignalConditioner::Biquad::setLowPass(double frequency, double sampleRate)
+{
+    const double w = MathConstants<double>::twoPi * frequency / sampleRate;
+    const double alpha = sin(w) / (2.0 * butterworthQ);
+    const double a0 = 1.0 + alpha;
+    b0 = (1.0 - cos(w)) / 2.0 / a0;
+    b1 = (1.0 - cos(w)) / a0;
+    b2 = b0;
+    a1 = -2.0 * cos(w) / a0;
+    a2 = (1.0 - alpha) / a0;
+}
+
+void SignalConditioner::Biquad::setBypass()
+{
+    b0 = 1.0;
+    b1 = b2 = a1 = a2 = 0;
+}
+
+//==============================================================================
+SignalConditioner::SignalConditioner()
+{
+    mode = off;
+    sampleRate = 0;
+    dcCoefficient = 0;
+    lastInput = 0;
+    lastOutput = 0;
+    highPass.setBypass();
+    highPass.clear();
+    lowPass.setBypass();
+    lowPass.clear();
+    centrePeriodLength = 0;
+    trackedSum = 0;
+    numTracked = 0;
+    negativePeak = 0;
+    peakDecayPerSample = 0;
+}
+
+void SignalConditioner::setMode(Mode newMode)
+{
+    if (newMode == mode)
+        return;
+    
+    // the state of the old mode doesn't mean anything to the new one
+    mode = newMode;
+    lastInput = 0;
+    lastOutput = 0;
+    highPass.clear();
+    lowPass.clear();
+    negativePeak = 0;
+    tune(mode == bandPass ? centrePeriodLength : 0);
+}
+
+void SignalConditioner::reset(double newSampleRate, double expectedPeriodLength)
+{
+    if (newSampleRate != sampleRate)
+    {
+        sampleRate = newSampleRate;
+        dcCoefficient = exp(-MathConstants<double>::twoPi * dcCutoff / sampleRate);
+        peakDecayPerSample = exp(-1000.0 / (peakDecayMs * sampleRate));
+        lastInput = 0;
+        lastOutput = 0;
+        highPass.clear();
+        lowPass.clear();
+        negativePeak = 0;
+    }
+    
+    trackedSum = 0;
+    numTracked = 0;
+    tune(mode == bandPass ? expectedPeriodLength : 0);
+}
+
+void SignalConditioner::tune(double periodLength)
+{
+    centrePeriodLength = periodLength;
+    if (periodLength <= 0 || sampleRate <= 0)
+    {
+        highPass.setBypass();
+        lowPass.setBypass();
+        return;
+    }
+    
+    const double frequency = sampleRate / periodLength;
+    const double width = pow(2.0, bandPassOctaves);
+    highPass.setHighPass(frequency / width, sampleRate);
+    if (frequency * width < maxLowPassFrequency * sampleRate)
+        lowPass.setLowPass(frequency * width, sampleRate);
+    else
+        lowPass.setBypass();
+}
+
+void SignalConditioner::process(float* samples, int numSamples)
+{
+    if (mode == off || numSamples <= 0)
+        return;
+    
+    for (int i = 0; i < numSamples; i++)
+    {
+        const double x = samples[i];
+        lastOutput = x - lastInput + dcCoefficient * lastOutput;
+        lastInput = x;
+        
+        double y = lastOutput;
+        if (mode == bandPass)
+            y = lowPass.process(highPass.process(y));
+        samples[i] = (float) y;
+    }
+    
+    const float minimum = FloatVectorOperations::findMinimum(samples, numSamples);
+    negativePeak = jmax(-minimum, negativePeak * (float) pow(peakDecayPerSample, numSamples));
+}
+
+void SignalConditioner::trackPeriod(double periodLength)
+{
+    if (mode != bandPass || periodLength <= 0)
+        return;
+    
+    trackedSum += periodLength;
+    numTracked++;
+    if (numTracked < numTrackedPeriods)
+        return;
+    
+    const double meanPeriodLength = trackedSum / numTracked;
+    trackedSum = 0;
+    numTracked = 0;
+    if (centrePeriodLength <= 0 || std::abs(log2(meanPeriodLength / centrePeriodLength)) > maxTuningErrorInOctaves)
+        tune(meanPeriodLength);
+}
+
+float SignalConditioner::getHysteresis() const
+{
+    return mode == off ? 0.0f : hysteresisFraction * negativePeak;
+}
@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    SignalConditioner.h
+    Created: 18 Oct 2026 11:07:52pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef SIGNALCONDITIONER_H_INCLUDED
+#define SIGNALCONDITIONER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** Cleans up the recorded signal before its zero crossings are timed.
+
+    A DC blocker takes out the offset of e.g. a pulse wave that isn't AC coupled,
+    which moves the crossings to a flatter part of the waveform. The band-pass (a
+    Butterworth high-pass an octave below the note and a low-pass an octave above it)
+    takes out hum and most of the noise. It is tuned to the expected period of each
+    note, or to the measured one when that is unknown or far off. Both filters only
+    delay the signal by a constant time at a stable pitch, so the periods stay the same.
+    
+    The filters keep their state from one note to the next, so that the offset doesn't
+    have to be learned again each time.
+    
+    The conditioner also follows the negative peaks of the filtered signal. The zero
+    crossing detector uses a part of them as the hysteresis, see getHysteresis().
+ */
+class SignalConditioner
+{
+public:
+    enum Mode
+    {
+        off = 0,
+        dcBlocker,  // DC blocker and hysteresis
+        bandPass    // the same with the tracking band-pass
+    };
+    static const int numModes = 3;
+    
+    static String getName(Mode mode);
+    
+    SignalConditioner();
+    
+    void setMode(Mode newMode);
+    Mode getMode() const { return mode; }
+    
+    /** prepares for a new note, 0 if its period length is unknown */
+    void reset(double sampleRate, double expectedPeriodLength);
+    
+    /** filters the samples in place */
+    void process(float* samples, int numSamples);
+    
+    /** tells the band-pass the length of a measured period. If the average of the last
+     few is far from the one the filter is tuned to, it is tuned to them instead. */
+    void trackPeriod(double periodLength);
+    
+    /** how far below zero the signal must have been before a rising crossing counts,
+     so that noise around zero can't add crossings. 0 when the mode is off. */
+    float getHysteresis() const;
+    
+private:
+    /** transposed direct form II */
+    struct Biquad
+    {
+        void setHighPass(double frequency, double sampleRate);
+        void setLowPass(double frequency, double sampleRate);
+        void setBypass();
+        void clear() { z1 = z2 = 0; }
+        
+        double process(double x)
+        {
+            const double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+        
+        double b0, b1, b2, a1, a2;
+        double z1, z2;
+    };
+    
+    /** tunes the band-pass to a note, 0 switches it off */
+    void tune(double periodLength);
+    
+    Mode mode;
+    double sampleRate;
+    
+    double dcCoefficient; // pole of the DC blocker
+    double lastInput, lastOutput;
+    
+    Biquad highPass, lowPass;
+    double centrePeriodLength; // the band-pass is tuned to this, 0 = not tuned
+    double trackedSum; // of the periods since the band-pass was last checked
+    int numTracked;
+    
+    float negativePeak;
+    double peakDecayPerSample;
+};
+
+
+#endif  // SIGNALCONDITIONER_H_INCLUDED
@@ -0,0 +1,265 @@
+/*
+  ==============================================================================
+
+    SimulatedVCO.cpp
+    Created: 17 Oct 2026 11:02:17am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SimulatedVCO.h"
+
+SimulatedVCO::SimulatedVCO()
+{
+    prepareToPlay(48000.0);
+}
+
+SimulatedVCO::SimulatedVCO(const Parameters& p)
+: parameters(p)
+{
+    prepareToPlay(48000.0);
+}
+
+void SimulatedVCO::setParameters(const Parameters& newParameters)
+{
+    parameters = newParameters;
+    prepareToPlay(sampleRate);
+}
+
+void SimulatedVCO::prepareToPlay(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    sampleCounter = 0;
+    random.setSeed(parameters.seed);
+    
+    noteOnSample = 0;
+    currentNote = parameters.referenceNote;
+    pitchBend = 0;
+    fineTuning = 0;
+    rpnNumber = -1;
+    fineTuningMsb = 64;
+    targetVoltage = getControlVoltage(parameters.referenceNote);
+    currentVoltage = targetVoltage;
+    latencySamples = parameters.latencyMs * sampleRate / 1000.0;
+    if (parameters.slewTimeMs > 0)
+        slewCoefficient = 1.0 - exp(-1000.0 / (parameters.slewTimeMs * sampleRate));
+    else
+        slewCoefficient = 1.0;
+    
+    phase = 0;
+    periodJitter = 1.0;
+    phaseIncrement = parameters.referenceFrequency * pow(2.0, getOctavesAboveReference(currentVoltage)) / sampleRate;
+}
+
+double SimulatedVCO::getControlVoltage(double midiPitch) const
+{
+    double voltage = midiPitch / 12.0;
+    if (parameters.dacBits > 0)
+    {
+        double stepSize = parameters.dacRange / (double) (1 << parameters.dacBits);
+        voltage = std::round(voltage / stepSize) * stepSize;
+    }
+    return voltage;
+}
+
+double SimulatedVCO::getOctavesAboveReference(double controlVoltage) const
+{
+    double octaves = controlVoltage - parameters.referenceNote / 12.0;
+    double cents = octaves * parameters.scaleError
+                 + octaves * octaves * parameters.expConverterBow
+                 + parameters.offset;
+    return octaves + cents / 1200.0;
+}
+
+double SimulatedVCO::getSettledFrequency(int midiNote) const
+{
+    return parameters.referenceFrequency * pow(2.0, getOctavesAboveReference(getControlVoltage(midiNote)));
+}
+
+void SimulatedVCO::sendMessageNow(const MidiMessage& message)
+{
+    if (parameters.midiChannel > 0 && message.getChannel() != parameters.midiChannel)
+        return;
+    
+    // note offs are ignored - most MIDI-CV interfaces hold the CV of the last note
+    if (message.isNoteOn())
+    {
+        currentNote = message.getNoteNumber();
+        updateControlVoltage();
+    }
+    else if (message.isPitchWheel())
+    {
+        pitchBend = (message.getPitchWheelValue() - 8192) * parameters.pitchBendRange / 8192.0;
+        updateControlVoltage();
+    }
+    else if (message.isController())
+    {
+        const int value = message.getControllerValue();
+        switch (message.getControllerNumber())
+        {
+            case 101:
+                rpnNumber = (value << 7) | (rpnNumber >= 0 ? rpnNumber & 0x7f : 0);
+                break;
+            case 100:
+                rpnNumber = (rpnNumber >= 0 ? rpnNumber & 0x3f80 : 0) | value;
+                break;
+            case 6:
+                if (rpnNumber == 1)
+                    fineTuningMsb = value;
+                break;
+            case 38:
+                if (rpnNumber == 1)
+                {
+                    fineTuning = (((fineTuningMsb << 7) | value) - 8192) / 8192.0;
+                    updateControlVoltage();
+                }
+                break;
+        }
+    }
+}
+
+void SimulatedVCO::updateControlVoltage()
+{
+    noteOnSample = sampleCounter + (int64) latencySamples;
+    targetVoltage = getControlVoltage(currentNote + pitchBend + fineTuning);
+}
+
+void SimulatedVCO::renderNextBlock(float* output, int numSamples)
+{
+    // the drift changes so slowly that updating it once per block is good enough
+    double driftInOctaves = parameters.thermalDrift * (sampleCounter / sampleRate / 60.0) / 1200.0;
+    double frequency = parameters.referenceFrequency * pow(2.0, getOctavesAboveReference(currentVoltage) + driftInOctaves);
+    
+    for (int i = 0; i < numSamples; i++)
+    {
+        if (sampleCounter >= noteOnSample && currentVoltage != targetVoltage)
+        {
+            currentVoltage += (targetVoltage - currentVoltage) * slewCoefficient;
+            if (std::abs(targetVoltage - currentVoltage) < 1e-9)
+                currentVoltage = targetVoltage;
+            frequency = parameters.referenceFrequency * pow(2.0, getOctavesAboveReference(currentVoltage) + driftInOctaves);
+        }
+        
+        phaseIncrement = frequency * periodJitter / sampleRate;
+        output[i] = getNextSample();
+        sampleCounter++;
+    }
+}
+
+float SimulatedVCO::getNextSample()
+{
+    phase += phaseIncrement;
+    if (phase >= 1.0)
+    {
+        phase -= 1.0;
+        
+        // a new period starts - pick its jitter (Box-Muller)
+        if (parameters.jitter > 0)
+        {
+            double u1 = jmax(1e-12, random.nextDouble());
+            double u2 = random.nextDouble();
+            double gaussian = sqrt(-2.0 * log(u1)) * cos(2.0 * MathConstants<double>::pi * u2);
+            periodJitter = pow(2.0, gaussian * parameters.jitter / 1200.0);
+        }
+    }
+    
+    // polyBLEP residual to band-limit the discontinuities of saw and square
+    auto polyBlep = [this] (double t)
+    {
+        double dt = phaseIncrement;
+        if (t < dt)
+        {
+            t /= dt;
+            return t + t - t * t - 1.0;
+        }
+        if (t > 1.0 - dt)
+        {
+            t = (t - 1.0) / dt;
+            return t * t + t + t + 1.0;
+        }
+        return 0.0;
+    };
+    
+    double value = 0;
+    switch (parameters.waveform)
+    {
+        case sine:
+            value = sin(2.0 * MathConstants<double>::pi * phase);
+            break;
+        case triangle:
+            value = (phase < 0.5) ? (4.0 * phase - 1.0) : (3.0 - 4.0 * phase);
+            break;
+        case saw:
+            value = 2.0 * phase - 1.0 - polyBlep(phase);
+            break;
+        case square:
+        {
+            double shiftedPhase = phase + 0.5;
+            if (shiftedPhase >= 1.0)
+                shiftedPhase -= 1.0;
+            value = (phase < 0.5) ? 1.0 : -1.0;
+            value += polyBlep(phase);
+            value -= polyBlep(shiftedPhase);
+        } break;
+    }
+    
+    float sample = (float) value * parameters.amplitude;
+    if (parameters.noiseLevel > 0)
+        sample += parameters.noiseLevel * 1.7320508f * (2.0f * random.nextFloat() - 1.0f);
+    return sample;
+}
+
+//==============================================================================
+VCOSimulation::VCOSimulation(VCOTuner& t, SimulatedVCO& v, double sr, int bs)
+: VCOSimulation(t, Array<SimulatedVCO*>(&v), sr, bs)
+{
+}
+
+VCOSimulation::VCOSimulation(VCOTuner& t, const Array<SimulatedVCO*>& v, double sr, int bs)
+: tuner(t), vcos(v), buffer(v.size(), bs)
+{
+    sampleRate = sr;
+    blockSize = bs;
+    numSamplesProcessed = 0;
+    
+    for (int i = 0; i < vcos.size(); i++)
+        vcos[i]->prepareToPlay(sampleRate);
+    tuner.prepareToPlay(sampleRate);
+    tuner.setMidiSink(this);
+    tuner.setUsesVirtualClock(true);
+}
+
+VCOSimulation::~VCOSimulation()
+{
+    // deadlines of a running state machine can't be carried over to the real clock
+    tuner.stop();
+    tuner.setUsesVirtualClock(false);
+    tuner.setMidiSink(nullptr);
+}
+
+void VCOSimulation::processBlock()
+{
+    for (int i = 0; i < vcos.size(); i++)
+        vcos[i]->renderNextBlock(buffer.getWritePointer(i), blockSize);
+    tuner.audioDeviceIOCallback(buffer.getArrayOfReadPointers(), vcos.size(), nullptr, 0, blockSize);
+    numSamplesProcessed += blockSize;
+    tuner.advanceClock(1000.0 * blockSize / sampleRate);
+}
+
+bool VCOSimulation::runUntilFinished(double maxSeconds)
+{
+    const double endTime = getElapsedSeconds() + maxSeconds;
+    while (tuner.isRunning() && getElapsedSeconds() < endTime)
+        processBlock();
+    
+    return tuner.hasFinished();
+}
+
+void VCOSimulation::sendMessageNow(const MidiMessage& message)
+{
+    // every oscillator filters the messages by its own MIDI channel
+    for (int i = 0; i < vcos.size(); i++)
+        vcos[i]->sendMessageNow(message);
+}
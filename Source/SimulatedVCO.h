@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    SimulatedVCO.h
+    Created: 17 Oct 2026 11:02:17am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef SIMULATEDVCO_H_INCLUDED
+#define SIMULATEDVCO_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "VCOTuner.h"
+
+//==============================================================================
+/** A virtual oscillator behind a virtual MIDI-CV interface. Models the typical
+    imperfections of both so that the tuner can be exercised without hardware.
+ */
+class SimulatedVCO: public VCOTuner::MidiSink
+{
+public:
+    enum Waveform
+    {
+        sine,
+        triangle,
+        saw,
+        square
+    };
+    
+    struct Parameters
+    {
+        /** frequency of the reference note with a perfect interface and oscillator */
+        double referenceFrequency = 440.0;
+        int referenceNote = 69;
+        
+        /** V/oct scale error in cents per octave */
+        double scaleError = 0.0;
+        /** constant pitch offset in cents */
+        double offset = 0.0;
+        /** bow of the exponential converter in cents per octave squared,
+            relative to the reference note */
+        double expConverterBow = 0.0;
+        /** thermal drift in cents per minute */
+        double thermalDrift = 0.0;
+        /** rms pitch jitter in cents, applied to every period */
+        double jitter = 0.0;
+        
+        /** resolution of the interface DAC in bits (0 = ideal) */
+        int dacBits = 0;
+        /** output range of the interface DAC in volts (1V per octave) */
+        double dacRange = 10.0;
+        /** MIDI channel the interface listens to (0 = all channels) */
+        int midiChannel = 0;
+        /** in semitones. The channel fine tuning (RPN 1) always spans +/- 1 semitone. */
+        double pitchBendRange = 2.0;
+        /** time until a note on arrives at the CV output */
+        double latencyMs = 0.0;
+        /** time constant of the CV slew after each note on */
+        double slewTimeMs = 0.0;
+        
+        Waveform waveform = saw;
+        float amplitude = 0.5f;
+        /** rms level of white noise added to the output */
+        float noiseLevel = 0.0f;
+        /** of the jitter and the noise, so that a run can be repeated exactly */
+        int64 seed = 1;
+    };
+    
+    SimulatedVCO();
+    SimulatedVCO(const Parameters& parameters);
+    
+    void setParameters(const Parameters& newParameters);
+    const Parameters& getParameters() const { return parameters; }
+    
+    /** resets the oscillator, the virtual time and the random generator */
+    void prepareToPlay(double sampleRate);
+    
+    /** renders the next block. Must be called from the same thread as sendMessageNow(). */
+    void renderNextBlock(float* output, int numSamples);
+    
+    /** the frequency the model settles at for a MIDI note, ignoring jitter and drift */
+    double getSettledFrequency(int midiNote) const;
+    
+    /** inherited from VCOTuner::MidiSink */
+    void sendMessageNow(const MidiMessage& message) override;
+    
+private:
+    /** the control voltage the interface outputs for a fractional note (1V per octave above note 0) */
+    double getControlVoltage(double midiPitch) const;
+    /** the bend and the fine tuning apply to the last note, after the latency */
+    void updateControlVoltage();
+    /** the pitch offset in octaves that the oscillator produces for a control voltage */
+    double getOctavesAboveReference(double controlVoltage) const;
+    float getNextSample();
+    
+    Parameters parameters;
+    Random random;
+    
+    double sampleRate;
+    int64 sampleCounter;
+    
+    int64 noteOnSample; // when the last note on reaches the CV output
+    int currentNote;
+    double pitchBend; // in semitones
+    double fineTuning; // in semitones
+    int rpnNumber; // the selected registered parameter, -1 = none
+    int fineTuningMsb;
+    double targetVoltage;
+    double currentVoltage;
+    double slewCoefficient;
+    double latencySamples;
+    
+    double phase;
+    double phaseIncrement;
+    double periodJitter; // jitter factor for the current period
+    
+    JUCE_DECLARE_NON_COPYABLE(SimulatedVCO)
+};
+
+//==============================================================================
+/** Runs a VCOTuner against one or more SimulatedVCOs in lockstep. Audio is
+    rendered block by block and the tuners state machine is advanced by the
+    duration of each block, so complete sweeps run as fast as the CPU allows.
+    
+    Each oscillator is rendered into its own input channel, all of them receive
+    the MIDI messages of the tuner.
+ */
+class VCOSimulation: public VCOTuner::MidiSink
+{
+public:
+    VCOSimulation(VCOTuner& tuner, SimulatedVCO& vco, double sampleRate = 48000.0, int blockSize = 256);
+    VCOSimulation(VCOTuner& tuner, const Array<SimulatedVCO*>& vcos, double sampleRate = 48000.0, int blockSize = 256);
+    ~VCOSimulation();
+    
+    /** processes a single block of audio */
+    void processBlock();
+    
+    /** processes audio until the tuner has stopped or finished, or until the given
+     amount of virtual time has elapsed. Returns true if the tuner finished. */
+    bool runUntilFinished(double maxSeconds);
+    
+    /** virtual time since the simulation was created */
+    double getElapsedSeconds() const { return (double) numSamplesProcessed / sampleRate; }
+    
+    /** inherited from VCOTuner::MidiSink */
+    void sendMessageNow(const MidiMessage& message) override;
+    
+private:
+    VCOTuner& tuner;
+    Array<SimulatedVCO*> vcos;
+    double sampleRate;
+    int blockSize;
+    int64 numSamplesProcessed;
+    AudioBuffer<float> buffer;
+    
+    JUCE_DECLARE_NON_COPYABLE(VCOSimulation)
+};
+
+
+#endif  // SIMULATEDVCO_H_INCLUDED
@@ -1,85 +1,109 @@
-/*
-  ==============================================================================
-
-   This file is part of the JUCE library.
-   Copyright (c) 2015 - ROLI Ltd.
-
-   Permission is granted to use this software under the terms of either:
-   a) the GPL v2 (or any later version)
-   b) the Affero GPL v3
-
-   Details of these licenses can be found at: www.gnu.org/licenses
-
-   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
-   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
-   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
-
-   ------------------------------------------------------------------------------
-
-   To release a closed-source product which uses JUCE, commercial licenses are
-   available: visit www.juce.com for more information.
-
-  ==============================================================================
-*/
-
-#include "../JuceLibraryCode/JuceHeader.h"
-#include "MainWindow.h"
-
-//==============================================================================
-class VCOTunerApp  : public JUCEApplication
-{
-public:
-    VCOTunerApp() {}
-
-    void initialise (const String&) override
-    {
-        // initialise our settings file..
-
-        PropertiesFile::Options options;
-        options.applicationName     = "VCO Tuner Application";
-        options.filenameSuffix      = "settings";
-        options.osxLibrarySubFolder = "Application Support";
-
-        appProperties.reset(new ApplicationProperties());
-        appProperties->setStorageParameters (options);
-
-        LookAndFeel::setDefaultLookAndFeel (&lookAndFeel);
-
-        mainWindow.reset(new MainWindow());
-        mainWindow->setUsingNativeTitleBar (true);
-    }
-
-    void shutdown() override
-    {
-        mainWindow.reset();
-        appProperties.reset();
-        LookAndFeel::setDefaultLookAndFeel (nullptr);
-    }
-
-    void systemRequestedQuit() override
-    {
-        if (mainWindow != nullptr)
-            mainWindow->tryToQuitApplication();
-        else
-            JUCEApplicationBase::quit();
-    }
-
-    const String getApplicationName() override       { return "VCO Tuner"; }
-    const String getApplicationVersion() override    { return ProjectInfo::versionString; }
-    bool moreThanOneInstanceAllowed() override       { return true; }
-
-    ApplicationCommandManager commandManager;
-    std::unique_ptr<ApplicationProperties> appProperties;
-    LookAndFeel_V3 lookAndFeel;
-
-private:
-    std::unique_ptr<MainWindow> mainWindow;
-};
-
-static VCOTunerApp& getApp()                      { return *dynamic_cast<VCOTunerApp*>(JUCEApplication::getInstance()); }
-ApplicationCommandManager& getCommandManager()      { return getApp().commandManager; }
-ApplicationProperties& getAppProperties()           { return *getApp().appProperties; }
-
-
-// This kicks the whole thing off..
-START_JUCE_APPLICATION (VCOTunerApp)
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2015 - ROLI Ltd.
+
+   Permission is granted to use this software under the terms of either:
+   a) the GPL v2 (or any later version)
+   b) the Affero GPL v3
+
+   Details of these licenses can be found at: www.gnu.org/licenses
+
+   JUCE is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+   A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+
+   ------------------------------------------------------------------------------
+
+   To release a closed-source product which uses JUCE, commercial licenses are
+   available: visit www.juce.com for more information.
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "MainWindow.h"
+#include "HeadlessSweep.h"
+#include "SweepArchive.h"
+
+//==============================================================================
+class VCOTunerApp  : public JUCEApplication
+{
+public:
+    VCOTunerApp() {}
+
+    void initialise (const String&) override
+    {
+        // initialise our settings file..
+
+        PropertiesFile::Options options;
+        options.applicationName     = "VCO Tuner Application";
+        options.filenameSuffix      = "settings";
+        options.osxLibrarySubFolder = "Application Support";
+
+        appProperties.reset(new ApplicationProperties());
+        appProperties->setStorageParameters (options);
+
+        // all sweeps are kept, in the window as well as without it
+        sweepArchive.reset(new SweepArchive());
+        const String archiveError = sweepArchive->open (SweepArchive::getDefaultFile());
+        if (archiveError.isNotEmpty())
+            Logger::writeToLog (archiveError);
+
+        // scripted runs don't open a window at all
+        const ArgumentList args (getApplicationName(), getCommandLineParameterArray());
+        if (HeadlessSweep::isRequested (args))
+        {
+            headlessSweep.reset(new HeadlessSweep());
+            headlessSweep->start (args);
+            return;
+        }
+        
+        LookAndFeel::setDefaultLookAndFeel (&lookAndFeel);
+
+        mainWindow.reset(new MainWindow());
+        mainWindow->setUsingNativeTitleBar (true);
+    }
+
+    void shutdown() override
+    {
+        headlessSweep.reset();
+        mainWindow.reset();
+        sweepArchive.reset();
+        appProperties.reset();
+        LookAndFeel::setDefaultLookAndFeel (nullptr);
+    }
+
+    void systemRequestedQuit() override
+    {
+        if (mainWindow != nullptr)
+            mainWindow->tryToQuitApplication();
+        else if (headlessSweep != nullptr)
+            headlessSweep->stop();
+        else
+            JUCEApplicationBase::quit();
+    }
+
+    const String getApplicationName() override       { return "VCO Tuner"; }
+    const String getApplicationVersion() override    { return ProjectInfo::versionString; }
+    bool moreThanOneInstanceAllowed() override       { return true; }
+
+    ApplicationCommandManager commandManager;
+    std::unique_ptr<ApplicationProperties> appProperties;
+    std::unique_ptr<SweepArchive> sweepArchive;
+    LookAndFeel_V3 lookAndFeel;
+
+private:
+    std::unique_ptr<MainWindow> mainWindow;
+    std::unique_ptr<HeadlessSweep> headlessSweep;
+};
+
+static VCOTunerApp& getApp()                      { return *dynamic_cast<VCOTunerApp*>(JUCEApplication::getInstance()); }
+ApplicationCommandManager& getCommandManager()      { return getApp().commandManager; }
+ApplicationProperties& getAppProperties()           { return *getApp().appProperties; }
+SweepArchive& getSweepArchive()                     { return *getApp().sweepArchive; }
+
+
+// This kicks the whole thing off..
+START_JUCE_APPLICATION (VCOTunerApp)
@@ -0,0 +1,548 @@
+/*
+  ==============================================================================
+
+    SweepArchive.cpp
+    Created: 18 Oct 2026 2:36:51pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SweepArchive.h"
+
+extern ApplicationProperties& getAppProperties();
+
+namespace
+{
+    const char fileMagic[8] = { 'V', 'C', 'O', 'S', 'W', 'E', 'E', 'P' };
+    /** version 2 added the raw pitch offsets */
+    const uint32 fileVersion = 2;
+    const int64 fileHeaderSize = 16;
+    
+    const uint32 recordMagic = 0x31575352; // "RSW1"
+    const uint32 calibrationFlag = 1;
+    const uint32 rawPitchOffsetFlag = 2; // the record has all columns
+    
+    /** the fixed part at the start of every record. Everything after it is aligned to 8 bytes:
+        - the reference frequencies, one double per lane
+        - the strings of the Info, each one a uint32 length and its UTF-8 bytes, padded
+        - the double columns, then the timestamps, then the int32 columns, padded */
+    struct RecordHeader
+    {
+        uint32 magic;
+        uint32 flags;
+        int64 recordSize; // including this header
+        int64 timeMs;
+        double sampleRate;
+        int32 referencePitch;
+        int32 numLanes;
+        int32 numMeasurements;
+        uint32 stringsSize; // including the padding
+        uint32 checksum; // of everything after the header
+        uint32 reserved[3];
+    };
+    static_assert(sizeof(RecordHeader) == 64, "the header is part of the file format");
+    
+    const int numStrings = 8;
+    const int numIntColumns = 3;
+    
+    /** checks the magic and the version at the start of an archive */
+    String readFileHeader(const File& file, uint32& version)
+    {
+        FileInputStream in(file);
+        char magic[sizeof(fileMagic)] = {};
+        if (in.failedToOpen())
+            return "Can't read " + file.getFullPathName();
+        if (in.read(magic, sizeof(magic)) != (int) sizeof(magic) || memcmp(magic, fileMagic, sizeof(magic)) != 0)
+            return file.getFullPathName() + " is not a sweep archive";
+        version = (uint32) in.readInt();
+        if (version > fileVersion)
+            return file.getFullPathName() + " was written by a newer version of the app";
+        return {};
+    }
+    
+    int64 padTo8(int64 size)
+    {
+        return (size + 7) & ~(int64) 7;
+    }
+    
+    int64 getColumnsOffset(const RecordHeader& header)
+    {
+        return (int64) sizeof(RecordHeader) + header.numLanes * (int64) sizeof(double) + header.stringsSize;
+    }
+    
+    int getNumColumns(const RecordHeader& header)
+    {
+        return (header.flags & rawPitchOffsetFlag) != 0 ? (int) SweepArchive::Sweep::numColumns
+                                                        : (int) SweepArchive::Sweep::rawPitchOffset;
+    }
+    
+    int64 getRecordSize(const RecordHeader& header)
+    {
+        const int64 n = header.numMeasurements;
+        return getColumnsOffset(header)
+               + getNumColumns(header) * n * (int64) sizeof(double)
+               + n * (int64) sizeof(int64)
+               + padTo8(numIntColumns * n * (int64) sizeof(int32));
+    }
+    
+    /** FNV-1a, only to find records that weren't written completely */
+    uint32 getChecksum(const char* data, int64 size)
+    {
+        uint32 hash = 2166136261u;
+        for (int64 i = 0; i < size; i++)
+        {
+            hash ^= (uint8) data[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+    
+    String* getStrings(SweepArchive::Info& info, int index)
+    {
+        String* strings[numStrings] = { &info.dutBrand, &info.dutDevice, &info.serialNumber,
+                                        &info.interfaceBrand, &info.interfaceDevice, &info.notes,
+                                        &info.audioDevice, &info.midiOutput };
+        return strings[index];
+    }
+}
+
+//==============================================================================
+String SweepArchive::Info::getDutModel() const
+{
+    return (dutBrand.trim() + " " + dutDevice.trim()).trim();
+}
+
+SweepArchive::Info SweepArchive::describe(VCOTuner& tuner)
+{
+    Info info;
+    info.time = Time::getCurrentTime();
+    info.isCalibration = tuner.isCalibrating();
+    if (AudioDeviceManager* deviceManager = tuner.getDeviceManager())
+    {
+        if (AudioIODevice* device = deviceManager->getCurrentAudioDevice())
+            info.audioDevice = device->getName();
+        
+        const String midiOutput = deviceManager->getDefaultMidiOutputIdentifier();
+        for (const MidiDeviceInfo& device : MidiOutput::getAvailableDevices())
+        {
+            if (device.identifier == midiOutput)
+                info.midiOutput = device.name;
+        }
+    }
+    
+    info.sampleRate = tuner.getCurrentSampleRate();
+    info.referencePitch = tuner.getReferencePitch();
+    for (int i = 0; i < tuner.getNumLanes(); i++)
+        info.referenceFrequencies.add(tuner.getReferenceFrequency(i));
+    return info;
+}
+
+SweepArchive::Mapping::Mapping(const File& f)
+: file(f, MemoryMappedFile::readOnly)
+{
+}
+
+//==============================================================================
+SweepArchive::Sweep::Sweep()
+: columns(nullptr), numMeasurements(0), numStoredColumns(numColumns)
+{
+}
+
+const double* SweepArchive::Sweep::getColumn(Column column) const
+{
+    // the drift of older sweeps wasn't corrected, their offsets are raw already
+    if (column >= numStoredColumns)
+        column = column == rawPitchOffset ? pitchOffset : frequency;
+    return reinterpret_cast<const double*>(columns) + column * numMeasurements;
+}
+
+const int64* SweepArchive::Sweep::getTimestamps() const
+{
+    return reinterpret_cast<const int64*>(columns + numStoredColumns * numMeasurements * sizeof(double));
+}
+
+const int32* SweepArchive::Sweep::getLanes() const
+{
+    return reinterpret_cast<const int32*>(getTimestamps() + numMeasurements);
+}
+
+const int32* SweepArchive::Sweep::getMidiPitches() const
+{
+    return getLanes() + numMeasurements;
+}
+
+const int32* SweepArchive::Sweep::getNumPeriods() const
+{
+    return getLanes() + 2 * numMeasurements;
+}
+
+VCOTuner::measurement_t SweepArchive::Sweep::getMeasurement(int index) const
+{
+    jassert(isPositiveAndBelow(index, numMeasurements));
+    
+    VCOTuner::measurement_t m;
+    m.lane = getLanes()[index];
+    m.midiPitch = getMidiPitches()[index];
+    m.frequency = getColumn(frequency)[index];
+    m.pitch = getColumn(pitch)[index];
+    m.pitchOffset = getColumn(pitchOffset)[index];
+    m.rawPitchOffset = getColumn(rawPitchOffset)[index];
+    m.rawFrequency = m.frequency * pow(2.0, (m.rawPitchOffset - m.pitchOffset) / 12.0); // not stored
+    m.freqDeviation = getColumn(freqDeviation)[index];
+    m.pitchDeviation = getColumn(pitchDeviation)[index];
+    m.pitchConfidenceInterval = getColumn(pitchConfidenceInterval)[index];
+    m.numMeasurements = getNumPeriods()[index];
+    m.settleTime = getColumn(settleTime)[index];
+    m.settleWaitTime = 0; // not stored
+    m.timestamp = Time(getTimestamps()[index]);
+    return m;
+}
+
+Array<VCOTuner::measurement_t> SweepArchive::Sweep::getMeasurements() const
+{
+    Array<VCOTuner::measurement_t> measurements;
+    measurements.ensureStorageAllocated(numMeasurements);
+    for (int i = 0; i < numMeasurements; i++)
+        measurements.add(getMeasurement(i));
+    return measurements;
+}
+
+//==============================================================================
+SweepArchive::SweepArchive()
+: version(fileVersion), validSize(0)
+{
+}
+
+SweepArchive::~SweepArchive()
+{
+}
+
+File SweepArchive::getDefaultFile()
+{
+    return getAppProperties().getUserSettings()->getFile().getSiblingFile("Sweeps.vcosweeps");
+}
+
+String SweepArchive::open(const File& fileToOpen)
+{
+    close();
+    
+    if (fileToOpen.existsAsFile() && fileToOpen.getSize() > 0)
+    {
+        const String error = readFileHeader(fileToOpen, version);
+        if (error.isNotEmpty())
+            return error;
+    }
+    else
+        version = fileVersion;
+    
+    file = fileToOpen;
+    remap();
+    indexRecords(fileHeaderSize);
+    return {};
+}
+
+void SweepArchive::close()
+{
+    file = File();
+    mapping = nullptr;
+    validSize = 0;
+    entries.clear();
+    entriesByTime.clear();
+    entriesByModel.clear();
+}
+
+bool SweepArchive::remap()
+{
+    mapping = nullptr;
+    if (file.getSize() < fileHeaderSize)
+        return false;
+    
+    mapping = new Mapping(file);
+    if (mapping->file.getData() == nullptr)
+    {
+        mapping = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void SweepArchive::indexRecords(int64 position)
+{
+    // without a mapping, the file is empty and doesn't even have its header yet
+    validSize = mapping != nullptr ? position : 0;
+    if (mapping == nullptr)
+        return;
+    
+    const char* data = static_cast<const char*>(mapping->file.getData());
+    const int64 size = (int64) mapping->file.getSize();
+    while (position + (int64) sizeof(RecordHeader) <= size)
+    {
+        RecordHeader header;
+        memcpy(&header, data + position, sizeof(header));
+        if (header.magic != recordMagic || header.numLanes < 0 || header.numLanes > VCOTuner::maxNumLanes
+            || header.numMeasurements < 0 || header.stringsSize % 8 != 0
+            || header.recordSize != getRecordSize(header) || position + header.recordSize > size)
+            break;
+        
+        // only the last record can have been cut off, the others were complete when the next
+        // one was written. Checking all of them would make opening a large archive slow.
+        const bool isLast = position + header.recordSize == size;
+        if (isLast && getChecksum(data + position + sizeof(header), header.recordSize - (int64) sizeof(header)) != header.checksum)
+            break;
+        
+        addToIndex(position, data + position);
+        position += header.recordSize;
+        validSize = position;
+    }
+}
+
+void SweepArchive::addToIndex(int64 offset, const char* record)
+{
+    RecordHeader header;
+    memcpy(&header, record, sizeof(header));
+    
+    Entry entry;
+    entry.offset = offset;
+    entry.timeMs = header.timeMs;
+    entry.numMeasurements = header.numMeasurements;
+    entry.numColumns = getNumColumns(header);
+    entry.info.time = Time(header.timeMs);
+    entry.info.isCalibration = (header.flags & calibrationFlag) != 0;
+    entry.info.sampleRate = header.sampleRate;
+    entry.info.referencePitch = header.referencePitch;
+    
+    const char* p = record + sizeof(header);
+    for (int i = 0; i < header.numLanes; i++)
+    {
+        double frequency;
+        memcpy(&frequency, p, sizeof(frequency));
+        entry.info.referenceFrequencies.add(frequency);
+        p += sizeof(frequency);
+    }
+    
+    const char* stringsEnd = p + header.stringsSize;
+    for (int i = 0; i < numStrings && p + sizeof(uint32) <= stringsEnd; i++)
+    {
+        uint32 length;
+        memcpy(&length, p, sizeof(length));
+        p += sizeof(length);
+        length = (uint32) jmin((int64) length, (int64) (stringsEnd - p));
+        *getStrings(entry.info, i) = String::fromUTF8(p, (int) length);
+        p += length;
+    }
+    
+    const int index = entries.size();
+    entries.add(entry);
+    
+    // sweeps are mostly added in order, so this rarely moves anything
+    auto insertByTime = [this, index] (Array<int>& indices)
+    {
+        int position = indices.size();
+        while (position > 0 && entries.getReference(indices[position - 1]).timeMs > entries.getReference(index).timeMs)
+            position--;
+        indices.insert(position, index);
+    };
+    insertByTime(entriesByTime);
+    insertByTime(entriesByModel.getReference(entry.info.getDutModel().toLowerCase()));
+}
+
+//==============================================================================
+String SweepArchive::append(const Info& info, const Array<VCOTuner::measurement_t>& measurements)
+{
+    if (!isOpen())
+        return "The sweep archive isn't open";
+    
+    RecordHeader header;
+    zerostruct(header);
+    header.magic = recordMagic;
+    header.flags = rawPitchOffsetFlag | (info.isCalibration ? calibrationFlag : 0);
+    header.timeMs = info.time.toMilliseconds();
+    header.sampleRate = info.sampleRate;
+    header.referencePitch = info.referencePitch;
+    header.numLanes = jmin(info.referenceFrequencies.size(), (int) VCOTuner::maxNumLanes);
+    header.numMeasurements = measurements.size();
+    
+    MemoryOutputStream payload;
+    for (int i = 0; i < header.numLanes; i++)
+        payload.write(&info.referenceFrequencies.getReference(i), sizeof(double));
+    
+    Info strings(info);
+    for (int i = 0; i < numStrings; i++)
+    {
+        const String& text = *getStrings(strings, i);
+        const uint32 length = (uint32) text.getNumBytesAsUTF8();
+        payload.write(&length, sizeof(length));
+        payload.write(text.toRawUTF8(), length);
+    }
+    payload.writeRepeatedByte(0, (size_t) (padTo8((int64) payload.getDataSize()) - (int64) payload.getDataSize()));
+    header.stringsSize = (uint32) (payload.getDataSize() - header.numLanes * sizeof(double));
+    
+    // column by column
+    const int n = measurements.size();
+    for (int column = 0; column < Sweep::numColumns; column++)
+    {
+        for (const VCOTuner::measurement_t& m : measurements)
+        {
+            const double values[Sweep::numColumns] = { m.frequency, m.pitch, m.pitchOffset, m.freqDeviation,
+                                                       m.pitchDeviation, m.pitchConfidenceInterval, m.settleTime,
+                                                       m.rawPitchOffset };
+            payload.write(&values[column], sizeof(double));
+        }
+    }
+    for (const VCOTuner::measurement_t& m : measurements)
+    {
+        const int64 timestamp = m.timestamp.toMilliseconds();
+        payload.write(&timestamp, sizeof(timestamp));
+    }
+    for (int column = 0; column < numIntColumns; column++)
+    {
+        for (const VCOTuner::measurement_t& m : measurements)
+        {
+            const int32 values[numIntColumns] = { m.lane, m.midiPitch, m.numMeasurements };
+            payload.write(&values[column], sizeof(int32));
+        }
+    }
+    payload.writeRepeatedByte(0, (size_t) (padTo8(numIntColumns * n * (int64) sizeof(int32)) - numIntColumns * n * (int64) sizeof(int32)));
+    
+    header.recordSize = (int64) sizeof(header) + (int64) payload.getDataSize();
+    header.checksum = getChecksum(static_cast<const char*>(payload.getData()), (int64) payload.getDataSize());
+    jassert(header.recordSize == getRecordSize(header));
+    
+    {
+        // the app and a headless run may write to the same archive
+        InterProcessLock lock("VCOTunerSweepArchive");
+        if (!lock.enter(2000))
+            return "The sweep archive is locked by another process";
+        
+        // take in what the other process has added since, and write after it. The archive
+        // may even have been created by it after this one was opened.
+        if (file.getSize() >= fileHeaderSize)
+        {
+            const String error = readFileHeader(file, version);
+            if (error.isNotEmpty())
+                return error;
+            if (file.getSize() > validSize)
+            {
+                // the records of the other process must not be taken for a broken end
+                if (!remap())
+                    return "Can't read " + file.getFullPathName();
+                indexRecords(jmax(validSize, fileHeaderSize));
+            }
+        }
+        
+        FileOutputStream out(file);
+        if (out.failedToOpen())
+            return "Can't write to " + file.getFullPathName();
+        
+        if (file.getSize() < fileHeaderSize)
+        {
+            // a file that is still mapped can't be truncated on Windows
+            mapping = nullptr;
+            out.setPosition(0);
+            out.truncate();
+            out.write(fileMagic, sizeof(fileMagic));
+            out.writeInt((int) fileVersion);
+            out.writeInt(0);
+            validSize = fileHeaderSize;
+            version = fileVersion;
+        }
+        else
+        {
+            // older versions of the app must not take the new records for broken ones
+            if (version < fileVersion)
+            {
+                out.setPosition(sizeof(fileMagic));
+                out.writeInt((int) fileVersion);
+                version = fileVersion;
+            }
+            
+            // after a record that was cut off
+            if (out.getPosition() != validSize)
+            {
+                mapping = nullptr;
+                out.setPosition(validSize);
+                out.truncate();
+            }
+        }
+        
+        const bool written = out.write(&header, sizeof(header))
+                             && out.write(payload.getData(), payload.getDataSize());
+        out.flush();
+        lock.exit();
+        if (!written || out.getStatus().failed())
+        {
+            remap();
+            return "Can't write to " + file.getFullPathName();
+        }
+    }
+    
+    // the record is read back from the new mapping, just like one from an older run
+    if (!remap())
+        return "Can't read " + file.getFullPathName();
+    indexRecords(validSize);
+    return {};
+}
+
+//==============================================================================
+SweepArchive::Sweep SweepArchive::getSweep(int index) const
+{
+    Sweep sweep;
+    if (!isPositiveAndBelow(index, entries.size()) || mapping == nullptr)
+        return sweep;
+    
+    const Entry& entry = entries.getReference(index);
+    const char* record = static_cast<const char*>(mapping->file.getData()) + entry.offset;
+    RecordHeader header;
+    memcpy(&header, record, sizeof(header));
+    
+    sweep.mapping = mapping;
+    sweep.columns = record + getColumnsOffset(header);
+    sweep.info = entry.info;
+    sweep.numMeasurements = entry.numMeasurements;
+    sweep.numStoredColumns = entry.numColumns;
+    return sweep;
+}
+
+Array<int> SweepArchive::find(const Query& query) const
+{
+    const String model = query.dutModel.isNotEmpty() ? query.dutModel.trim().toLowerCase()
+                                                     : (query.dutBrand.trim() + " " + query.dutDevice.trim()).trim().toLowerCase();
+    const bool byModel = query.dutModel.isNotEmpty() || (query.dutBrand.isNotEmpty() && query.dutDevice.isNotEmpty());
+    const Array<int> candidates = byModel ? entriesByModel[model] : entriesByTime;
+    
+    // both lists are sorted by time
+    const int64 from = query.from.toMilliseconds();
+    auto first = std::lower_bound(candidates.begin(), candidates.end(), from, [this] (int index, int64 time)
+    {
+        return entries.getReference(index).timeMs < time;
+    });
+    
+    Array<int> found;
+    for (auto it = first; it != candidates.end(); ++it)
+    {
+        const Entry& entry = entries.getReference(*it);
+        if (query.to != Time() && entry.timeMs > query.to.toMilliseconds())
+            break;
+        if (!query.includeCalibrations && entry.info.isCalibration)
+            continue;
+        if (query.dutBrand.isNotEmpty() && !entry.info.dutBrand.trim().equalsIgnoreCase(query.dutBrand.trim()))
+            continue;
+        if (query.dutDevice.isNotEmpty() && !entry.info.dutDevice.trim().equalsIgnoreCase(query.dutDevice.trim()))
+            continue;
+        if (query.serialNumber.isNotEmpty() && !entry.info.serialNumber.trim().equalsIgnoreCase(query.serialNumber.trim()))
+            continue;
+        found.add(*it);
+    }
+    return found;
+}
+
+StringArray SweepArchive::getDutModels() const
+{
+    StringArray models;
+    for (const Entry& entry : entries)
+        models.addIfNotAlreadyThere(entry.info.getDutModel(), true);
+    models.sort(true);
+    return models;
+}
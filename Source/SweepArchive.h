@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    SweepArchive.h
+    Created: 18 Oct 2026 2:36:51pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef SWEEPARCHIVE_H_INCLUDED
+#define SWEEPARCHIVE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "VCOTuner.h"
+
+//==============================================================================
+/** Keeps every finished sweep in one append-only binary file, so that the history of
+    an oscillator survives a restart and thousands of sweeps can be searched quickly.
+    
+    Each record holds the details of a sweep (when, which DUT and interface, the audio
+    and MIDI devices, the sample rate and the reference frequencies) followed by its
+    measurements, one column per field of VCOTuner::measurement_t. The file is memory
+    mapped, and the columns are read right out of the mapping without copying.
+    
+    When the file is opened, only the details of the records are read to build the index
+    by DUT model and by time; the measurements aren't touched. Records are never changed
+    once they are written. A record that was cut off (e.g. by a crash while it was
+    written) fails its checksum and is overwritten by the next one.
+    
+    The file uses the byte order of the machine, which is little endian on all
+    platforms that the app is built for. Not thread safe, but the Sweeps it returns
+    can be read on any thread, even after the archive was changed or closed.
+ */
+class SweepArchive
+{
+public:
+    /** the details of a sweep that are stored with its measurements */
+    struct Info
+    {
+        Time time; // when the sweep was started
+        bool isCalibration = false;
+        
+        /** as entered for a report */
+        String dutBrand;
+        String dutDevice;
+        String serialNumber;
+        String interfaceBrand;
+        String interfaceDevice;
+        String notes;
+        
+        String audioDevice;
+        String midiOutput;
+        double sampleRate = 0;
+        int referencePitch = 0;
+        Array<double> referenceFrequencies; // one per lane
+        
+        /** brand and device of the DUT, the key of the index */
+        String getDutModel() const;
+    };
+    
+    /** fills in the devices and the reference of the tuner's last sweep */
+    static Info describe(VCOTuner& tuner);
+    
+private:
+    struct Mapping: public ReferenceCountedObject
+    {
+        Mapping(const File& file);
+        MemoryMappedFile file;
+        typedef ReferenceCountedObjectPtr<Mapping> Ptr;
+    };
+    
+public:
+    /** one stored sweep. The columns point right into the mapped file, which stays
+     mapped as long as there is a Sweep that uses it. */
+    class Sweep
+    {
+    public:
+        Sweep();
+        
+        const Info& getInfo() const { return info; }
+        int getNumMeasurements() const { return numMeasurements; }
+        
+        enum Column
+        {
+            frequency = 0,
+            pitch,
+            pitchOffset,
+            freqDeviation,
+            pitchDeviation,
+            pitchConfidenceInterval,
+            settleTime,
+            rawPitchOffset, // sweeps from before the drift correction have their pitchOffset here
+            numColumns
+        };
+        const double* getColumn(Column column) const;
+        const int32* getLanes() const;
+        const int32* getMidiPitches() const;
+        const int32* getNumPeriods() const; // measurement_t::numMeasurements
+        const int64* getTimestamps() const; // in ms since 1970
+        
+        VCOTuner::measurement_t getMeasurement(int index) const;
+        Array<VCOTuner::measurement_t> getMeasurements() const;
+    
+    private:
+        friend class SweepArchive;
+        
+        Mapping::Ptr mapping;
+        const char* columns;
+        Info info;
+        int numMeasurements;
+        int numStoredColumns; // older records don't have all of them
+    };
+    
+    SweepArchive();
+    ~SweepArchive();
+    
+    /** opens a file, or creates it with the first sweep. Returns an error message if
+     it exists but isn't an archive. */
+    String open(const File& file);
+    void close();
+    bool isOpen() const { return file != File(); }
+    const File& getFile() const { return file; }
+    
+    /** the default archive, next to the settings of the app */
+    static File getDefaultFile();
+    
+    /** appends a sweep. Returns an error message if it couldn't be written, e.g. because
+     another process held the archive for too long. */
+    String append(const Info& info, const Array<VCOTuner::measurement_t>& measurements);
+    
+    /** the sweeps in the order they were added */
+    int getNumSweeps() const { return entries.size(); }
+    Sweep getSweep(int index) const;
+    
+    struct Query
+    {
+        /** empty fields match all sweeps, the others are compared ignoring the case */
+        String dutBrand;
+        String dutDevice;
+        String serialNumber;
+        /** brand and device as returned by getDutModels(), can be used instead of both */
+        String dutModel;
+        /** only sweeps started within this range, Time() is open ended */
+        Time from;
+        Time to;
+        bool includeCalibrations = true;
+    };
+    /** returns the indices of the matching sweeps, oldest first */
+    Array<int> find(const Query& query) const;
+    /** all DUT models in the archive, see Info::getDutModel() */
+    StringArray getDutModels() const;
+    
+private:
+    /** walks the records from the given position to the end of the file */
+    void indexRecords(int64 position);
+    void addToIndex(int64 offset, const char* record);
+    bool remap();
+    
+    File file;
+    uint32 version; // of the open file
+    Mapping::Ptr mapping;
+    int64 validSize; // the end of the last good record
+    
+    struct Entry
+    {
+        int64 offset;
+        int64 timeMs;
+        int numMeasurements;
+        int numColumns;
+        Info info;
+    };
+    Array<Entry> entries;
+    Array<int> entriesByTime;
+    HashMap<String, Array<int>> entriesByModel; // by the lower case model, by time
+    
+    JUCE_DECLARE_NON_COPYABLE(SweepArchive)
+};
+
+/** the archive that the app writes all of its sweeps to */
+SweepArchive& getSweepArchive();
+
+
+#endif  // SWEEPARCHIVE_H_INCLUDED
@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    SweepPlanner.cpp
+    Created: 18 Oct 2026 8:12:05pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SweepPlanner.h"
+
+namespace
+{
+    /** each older note weighs this much of the note after it */
+    const double forgettingFactor = 0.9;
+    /** notes in one direction before its fit is used */
+    const int minNumValues = 3;
+    /** the jumps must spread over this many semitones (standard deviation) to fit a slope.
+     Otherwise the mean settle time is used for all jumps. */
+    const double minimumJumpSpread = 1.0;
+    /** the guess before anything was measured. Only the order of the notes depends on it. */
+    const double guessedSettleTimeMs = 10.0;
+    const double guessedSettleTimeMsPerSemitone = 1.0;
+}
+
+String SweepPlanner::getName(Strategy strategy)
+{
+    switch (strategy)
+    {
+        case monotonic: return "Low to high";
+        case serpentine: return "Up and down";
+        case randomised: return "Random";
+        case minimumJump: return "Shortest settling";
+        default: return {};
+    }
+}
+
+//==============================================================================
+SweepPlanner::SettleModel::SettleModel()
+{
+    reset();
+}
+
+void SweepPlanner::SettleModel::reset()
+{
+    for (Fit& fit : fits)
+    {
+        fit.weight = 0;
+        fit.sumX = 0;
+        fit.sumY = 0;
+        fit.sumXX = 0;
+        fit.sumXY = 0;
+        fit.numValues = 0;
+    }
+}
+
+void SweepPlanner::SettleModel::addSettleTime(double jump, double settleTimeMs)
+{
+    Fit& fit = fits[jump < 0 ? 1 : 0];
+    const double x = std::abs(jump);
+    fit.weight = fit.weight * forgettingFactor + 1.0;
+    fit.sumX = fit.sumX * forgettingFactor + x;
+    fit.sumY = fit.sumY * forgettingFactor + settleTimeMs;
+    fit.sumXX = fit.sumXX * forgettingFactor + x * x;
+    fit.sumXY = fit.sumXY * forgettingFactor + x * settleTimeMs;
+    fit.numValues++;
+}
+
+bool SweepPlanner::SettleModel::canPredict(double jump) const
+{
+    return fits[jump < 0 ? 1 : 0].numValues >= minNumValues;
+}
+
+double SweepPlanner::SettleModel::getSettleTimeMs(double jump) const
+{
+    const Fit& fit = fits[jump < 0 ? 1 : 0];
+    const Fit& other = fits[jump < 0 ? 0 : 1];
+    if (fit.numValues >= minNumValues)
+        return getSettleTimeMs(fit, jump);
+    if (other.numValues >= minNumValues)
+        return getSettleTimeMs(other, jump);
+    return guessedSettleTimeMs + guessedSettleTimeMsPerSemitone * std::abs(jump);
+}
+
+double SweepPlanner::SettleModel::getSettleTimeMs(const Fit& fit, double jump)
+{
+    const double meanX = fit.sumX / fit.weight;
+    const double meanY = fit.sumY / fit.weight;
+    const double varianceX = fit.sumXX / fit.weight - meanX * meanX;
+    if (varianceX < minimumJumpSpread * minimumJumpSpread)
+        return meanY;
+    
+    // bigger jumps never settle faster, that would only be noise
+    const double slope = jmax(0.0, (fit.sumXY / fit.weight - meanX * meanY) / varianceX);
+    return jmax(0.0, meanY + slope * (std::abs(jump) - meanX));
+}
+
+//==============================================================================
+Array<int> SweepPlanner::plan(Strategy strategy, int lowest, int increment, int highest, int startPitch,
+                              const Array<const SettleModel*>& models, Random& random)
+{
+    Array<int> ascending;
+    for (int pitch = lowest; pitch <= highest; pitch += jmax(1, increment))
+        ascending.add(pitch);
+    
+    switch (strategy)
+    {
+        case serpentine:
+        {
+            Array<int> pitches;
+            for (int i = 0; i < ascending.size(); i += 2)
+                pitches.add(ascending[i]);
+            for (int i = ascending.size() - 1 - (ascending.size() % 2); i > 0; i -= 2)
+                pitches.add(ascending[i]);
+            return pitches;
+        }
+        case randomised:
+        {
+            Array<int> pitches(ascending);
+            for (int i = pitches.size() - 1; i > 0; i--)
+                pitches.swap(i, random.nextInt(i + 1));
+            return pitches;
+        }
+        case minimumJump:
+        {
+            // on a line, the fastest orders run through the notes below and above the start
+            // in one go each. Which part comes first and in which direction depends on the cost
+            // of the jumps, e.g. an oscillator that settles slowly after falling is best swept up.
+            Array<int> parts[2][2]; // below and above the start, ascending and descending
+            for (int pitch : ascending)
+            {
+                parts[pitch < startPitch ? 0 : 1][0].add(pitch);
+                parts[pitch < startPitch ? 0 : 1][1].insert(0, pitch);
+            }
+            
+            Array<int> best(ascending);
+            double bestTime = getSettleTimeMs(best, startPitch, models);
+            for (int first = 0; first < 2; first++)
+            {
+                for (int firstDirection = 0; firstDirection < 2; firstDirection++)
+                {
+                    for (int secondDirection = 0; secondDirection < 2; secondDirection++)
+                    {
+                        Array<int> pitches(parts[first][firstDirection]);
+                        pitches.addArray(parts[1 - first][secondDirection]);
+                        const double time = getSettleTimeMs(pitches, startPitch, models);
+                        if (time < bestTime)
+                        {
+                            best = pitches;
+                            bestTime = time;
+                        }
+                    }
+                }
+            }
+            return best;
+        }
+        case monotonic:
+        default:
+            return ascending;
+    }
+}
+
+double SweepPlanner::getSettleTimeMs(const Array<int>& pitches, int startPitch, const Array<const SettleModel*>& models)
+{
+    const SettleModel guess;
+    double time = 0;
+    int previous = startPitch;
+    for (int pitch : pitches)
+    {
+        // all oscillators play the same note, the slowest one decides
+        double settleTime = models.isEmpty() ? guess.getSettleTimeMs(pitch - previous) : 0.0;
+        for (const SettleModel* model : models)
+            settleTime = jmax(settleTime, model->getSettleTimeMs(pitch - previous));
+        time += settleTime;
+        previous = pitch;
+    }
+    return time;
+}
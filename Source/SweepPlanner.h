@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    SweepPlanner.h
+    Created: 18 Oct 2026 8:12:05pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef SWEEPPLANNER_H_INCLUDED
+#define SWEEPPLANNER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** Decides in which order the notes of a sweep are played, and predicts how long an
+    oscillator takes to settle after a jump of the control voltage.
+    
+    The settle time depends on the size of the jump and on its direction, e.g. because of
+    the slew of the interface or the thermal tail of the exponential converter. It is
+    learned from the notes that were measured, see SettleModel. The tuner uses the
+    prediction for the timeouts of a note, and the planner to find the order of the notes
+    that settles the fastest.
+ */
+class SweepPlanner
+{
+public:
+    enum Strategy
+    {
+        /** from the lowest to the highest note */
+        monotonic = 0,
+        /** every other note on the way up, the others on the way back down. Each part of
+         the range is measured early and late, and approached from both sides. */
+        serpentine,
+        /** a new random order for every sweep, so that drift doesn't follow the pitch */
+        randomised,
+        /** the order with the shortest predicted settle time, starting at the reference */
+        minimumJump,
+        numStrategies
+    };
+    
+    static String getName(Strategy strategy);
+    
+    /** Predicts the settle time of a note from the jump in semitones that led to it. Upward
+     and downward jumps are fitted with a straight line each. The older notes are weighted
+     down, so that the model follows a changed oscillator within a few notes. */
+    class SettleModel
+    {
+    public:
+        SettleModel();
+        
+        void reset();
+        void addSettleTime(double jump, double settleTimeMs);
+        
+        /** true if there were enough notes in the direction of the jump */
+        bool canPredict(double jump) const;
+        /** the settle time in ms. Without enough notes in the direction of the jump, the
+         other direction is used, without any notes it's a guess. */
+        double getSettleTimeMs(double jump) const;
+    
+    private:
+        struct Fit
+        {
+            double weight, sumX, sumY, sumXX, sumXY;
+            int numValues;
+        };
+        Fit fits[2]; // up, down
+        
+        static double getSettleTimeMs(const Fit& fit, double jump);
+    };
+    
+    /** returns the notes from lowest to highest, in the order of the strategy.
+     @param startPitch   the note that is playing before the first one, e.g. the reference
+     @param models       the settle time of a note is the longest of these
+     */
+    static Array<int> plan(Strategy strategy, int lowest, int increment, int highest, int startPitch,
+                           const Array<const SettleModel*>& models, Random& random);
+    
+    /** the predicted settle time of all notes in this order, in ms */
+    static double getSettleTimeMs(const Array<int>& pitches, int startPitch, const Array<const SettleModel*>& models);
+};
+
+
+#endif  // SWEEPPLANNER_H_INCLUDED
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    TunerSession.cpp
+    Created: 17 Oct 2026 10:14:06pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TunerSession.h"
+
+TunerSession::Bench::Bench(const String& n, ThreadPool& pool)
+: name(n), tuner(&deviceManager)
+{
+    tuner.setAnalysisPool(&pool);
+}
+
+String TunerSession::Bench::initialise(int numInputChannels, const XmlElement* savedState)
+{
+    return deviceManager.initialise(numInputChannels, 0, savedState, true);
+}
+
+//==============================================================================
+TunerSession::TunerSession(int numAnalysisThreads)
+: analysisPool(numAnalysisThreads > 0 ? numAnalysisThreads : SystemStats::getNumCpus())
+{
+}
+
+TunerSession::~TunerSession()
+{
+    for (int i = 0; i < benches.size(); i++)
+        benches[i]->tuner.removeListener(this);
+    benches.clear();
+}
+
+TunerSession::Bench* TunerSession::addBench(const String& name)
+{
+    Bench* bench = benches.add(new Bench(name, analysisPool));
+    bench->tuner.addListener(this);
+    return bench;
+}
+
+void TunerSession::removeBench(Bench* bench)
+{
+    bench->tuner.removeListener(this);
+    benches.removeObject(bench);
+}
+
+void TunerSession::startAll()
+{
+    for (int i = 0; i < benches.size(); i++)
+        benches[i]->tuner.start();
+}
+
+void TunerSession::stopAll()
+{
+    for (int i = 0; i < benches.size(); i++)
+        benches[i]->tuner.stop();
+}
+
+bool TunerSession::isAnyRunning() const
+{
+    for (int i = 0; i < benches.size(); i++)
+    {
+        if (benches[i]->tuner.isRunning())
+            return true;
+    }
+    return false;
+}
+
+double TunerSession::getProgress() const
+{
+    if (benches.size() == 0)
+        return 0;
+    
+    double sum = 0;
+    for (int i = 0; i < benches.size(); i++)
+        sum += benches[i]->tuner.getProgress();
+    return sum / benches.size();
+}
+
+String TunerSession::getStatusString() const
+{
+    StringArray lines;
+    for (int i = 0; i < benches.size(); i++)
+        lines.add(benches[i]->name + ": " + benches[i]->tuner.getStatusString());
+    return lines.joinIntoString("\n");
+}
+
+void TunerSession::newMeasurementReady(const VCOTuner::measurement_t& /*m*/)
+{
+    tunerProgressChanged();
+}
+
+void TunerSession::tunerStopped()
+{
+    tunerProgressChanged();
+    if (!isAnyRunning())
+        listeners.call(&Listener::sessionFinished);
+}
+
+void TunerSession::tunerFinished()
+{
+    tunerStopped();
+}
+
+void TunerSession::tunerProgressChanged()
+{
+    listeners.call(&Listener::sessionProgressChanged, getProgress());
+}
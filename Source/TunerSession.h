@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    TunerSession.h
+    Created: 17 Oct 2026 10:14:06pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef TUNERSESSION_H_INCLUDED
+#define TUNERSESSION_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "VCOTuner.h"
+
+//==============================================================================
+/** Runs several independent tuners in one process. Each bench has its own audio
+    device manager (and with it its own audio interface and default MIDI output)
+    and its own tuner. The tuners share one thread pool for the analysis of their
+    recorded samples, so that many benches don't queue up on the message thread.
+ */
+class TunerSession: private VCOTuner::Listener
+{
+public:
+    /** @param numAnalysisThreads   size of the shared analysis pool, 0 = one per CPU */
+    TunerSession(int numAnalysisThreads = 0);
+    ~TunerSession();
+    
+    /** one measurement station: an audio interface, a MIDI output and a tuner */
+    class Bench
+    {
+    public:
+        const String& getName() const { return name; }
+        AudioDeviceManager& getDeviceManager() { return deviceManager; }
+        VCOTuner& getTuner() { return tuner; }
+        
+        /** opens the audio device from a saved state (or the default device) */
+        String initialise(int numInputChannels, const XmlElement* savedState);
+        
+        /** selects the MIDI output that drives this bench's MIDI-CV interface */
+        void setMidiOutput(const String& identifier) { deviceManager.setDefaultMidiOutputDevice(identifier); }
+    
+    private:
+        friend class TunerSession;
+        Bench(const String& name, ThreadPool& analysisPool);
+        
+        String name;
+        AudioDeviceManager deviceManager;
+        VCOTuner tuner; // must be destroyed before the device manager
+        
+        JUCE_DECLARE_NON_COPYABLE(Bench)
+    };
+    
+    /** adds a new bench. The session keeps ownership. */
+    Bench* addBench(const String& name);
+    void removeBench(Bench* bench);
+    int getNumBenches() const { return benches.size(); }
+    Bench* getBench(int index) const { return benches[index]; }
+    
+    void startAll();
+    void stopAll();
+    bool isAnyRunning() const;
+    
+    /** progress of all benches together, from 0 to 1 */
+    double getProgress() const;
+    /** one line per bench with its name and status */
+    String getStatusString() const;
+    
+    class Listener
+    {
+    public:
+        virtual ~Listener() {}
+        
+        virtual void sessionProgressChanged(double /*progress*/) {}
+        /** called when the last running bench has stopped or finished */
+        virtual void sessionFinished() {}
+    };
+    
+    void addListener(Listener* l) { listeners.add(l); }
+    void removeListener(Listener* l) { listeners.remove(l); }
+    
+private:
+    /** inherited from VCOTuner::Listener. The session listens to all tuners. */
+    void newMeasurementReady(const VCOTuner::measurement_t& m) override;
+    void tunerStopped() override;
+    void tunerFinished() override;
+    
+    void tunerProgressChanged();
+    
+    ThreadPool analysisPool; // must outlive the benches
+    OwnedArray<Bench> benches;
+    ListenerList<Listener> listeners;
+    
+    JUCE_DECLARE_NON_COPYABLE(TunerSession)
+};
+
+
+#endif  // TUNERSESSION_H_INCLUDED
@@ -0,0 +1,296 @@
+/*
+  ==============================================================================
+
+    TunerTelemetry.cpp
+    Created: 17 Oct 2026 6:12:40pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TunerTelemetry.h"
+
+namespace
+{
+    const double loadBinEnds[TunerTelemetry::numLoadBins - 1] = { 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1.0, 2.0 };
+    /** the bins from here on hold the callbacks that took longer than their buffer */
+    const int firstOverrunBin = 7;
+    /** the slowest notes are listed in the report */
+    const int numSlowestNotes = 5;
+    
+    double ticksToMs(int64 ticks)
+    {
+        return Time::highResolutionTicksToSeconds(ticks) * 1000.0;
+    }
+    
+    String formatMs(double ms)
+    {
+        if (ms >= 10000.0)
+            return String(ms / 1000.0, 1) + " s";
+        if (ms < 1.0)
+            return String(ms, 3) + " ms";
+        return String(ms, 1) + " ms";
+    }
+    
+    String formatPercent(double fraction)
+    {
+        return String(roundToInt(fraction * 100.0)) + "%";
+    }
+}
+
+double TunerTelemetry::getLoadBinEnd(int bin)
+{
+    if (bin < numLoadBins - 1)
+        return loadBinEnds[bin];
+    return std::numeric_limits<double>::infinity();
+}
+
+String TunerTelemetry::getLoadBinName(int bin)
+{
+    if (bin < numLoadBins - 1)
+        return "< " + formatPercent(loadBinEnds[bin]);
+    return ">= " + formatPercent(loadBinEnds[numLoadBins - 2]);
+}
+
+TunerTelemetry::TunerTelemetry()
+: numCallbacks(0), maxLoad(0), numHandoffs(0), handoffTicksSum(0), maxHandoffTicks(0),
+  resetRequested(false), numPosts(0), postTicksSum(0), maxPostTicks(0), postResetRequested(false),
+  requestTicks(0), wakeUpTicks(0)
+{
+    for (int i = 0; i < numLoadBins; i++)
+        loadHistogram[i] = 0;
+    
+    maxWakeUpMs = 0;
+    numOverflows = 0;
+    analysisMs = 0;
+    startTimeMs = 0;
+    xRunBaseline = -1;
+}
+
+//==============================================================================
+void TunerTelemetry::audioCallbackFinished(int64 durationTicks, int numSamples, double sampleRate)
+{
+    if (resetRequested.exchange(false))
+    {
+        numCallbacks = 0;
+        for (int i = 0; i < numLoadBins; i++)
+            loadHistogram[i] = 0;
+        maxLoad = 0;
+        numHandoffs = 0;
+        handoffTicksSum = 0;
+        maxHandoffTicks = 0;
+    }
+    
+    if (numSamples <= 0 || sampleRate <= 0)
+        return;
+    
+    const double load = Time::highResolutionTicksToSeconds(durationTicks) * sampleRate / numSamples;
+    int bin = 0;
+    while (bin < numLoadBins - 1 && load >= loadBinEnds[bin])
+        bin++;
+    
+    // this is the only thread that writes, so there's no need for read-modify-write operations
+    loadHistogram[bin].store(loadHistogram[bin].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    numCallbacks.store(numCallbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (load > maxLoad.load(std::memory_order_relaxed))
+        maxLoad.store(load, std::memory_order_relaxed);
+}
+
+void TunerTelemetry::recordingStarted()
+{
+    const int64 requested = requestTicks.load();
+    if (requested == 0 || resetRequested.load())
+        return;
+    
+    const int64 ticks = Time::getHighResolutionTicks() - requested;
+    handoffTicksSum.store(handoffTicksSum.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+    if (ticks > maxHandoffTicks.load(std::memory_order_relaxed))
+        maxHandoffTicks.store(ticks, std::memory_order_relaxed);
+    numHandoffs.store(numHandoffs.load(std::memory_order_relaxed) + 1);
+}
+
+void TunerTelemetry::wakeUpRequested()
+{
+    // only the first request counts until the state machine has run
+    int64 expected = 0;
+    wakeUpTicks.compare_exchange_strong(expected, Time::getHighResolutionTicks());
+}
+
+//==============================================================================
+void TunerTelemetry::wakeUpPosted(int64 durationTicks)
+{
+    if (postResetRequested.exchange(false))
+    {
+        numPosts = 0;
+        postTicksSum = 0;
+        maxPostTicks = 0;
+    }
+    
+    postTicksSum.store(postTicksSum.load(std::memory_order_relaxed) + durationTicks, std::memory_order_relaxed);
+    if (durationTicks > maxPostTicks.load(std::memory_order_relaxed))
+        maxPostTicks.store(durationTicks, std::memory_order_relaxed);
+    numPosts.store(numPosts.load(std::memory_order_relaxed) + 1);
+}
+
+//==============================================================================
+void TunerTelemetry::reset(double nowMs, int deviceXRuns)
+{
+    // the audio thread and the one that posts the wake ups clear their own counters
+    resetRequested = true;
+    postResetRequested = true;
+    wakeUpTicks = 0;
+    
+    wakeUpMs.reset();
+    maxWakeUpMs = 0;
+    numOverflows = 0;
+    analysisMs = 0;
+    startTimeMs = nowMs;
+    xRunBaseline = deviceXRuns;
+    notes.clearQuick();
+}
+
+void TunerTelemetry::measurementRequested()
+{
+    requestTicks = Time::getHighResolutionTicks();
+}
+
+void TunerTelemetry::stateMachineWokeUp()
+{
+    const int64 requested = wakeUpTicks.exchange(0);
+    if (requested == 0)
+        return;
+    
+    const double ms = ticksToMs(Time::getHighResolutionTicks() - requested);
+    wakeUpMs.add(ms);
+    maxWakeUpMs = jmax(maxWakeUpMs, ms);
+}
+
+void TunerTelemetry::addAnalysisTime(int64 durationTicks)
+{
+    analysisMs += ticksToMs(durationTicks);
+}
+
+void TunerTelemetry::measurementOverflowed()
+{
+    numOverflows++;
+}
+
+void TunerTelemetry::addNote(const NoteTiming& note)
+{
+    if (notes.size() >= maxNumNotes)
+        notes.removeRange(0, notes.size() - maxNumNotes + 1);
+    notes.add(note);
+}
+
+TunerTelemetry::Snapshot TunerTelemetry::getSnapshot(double nowMs, int deviceXRuns) const
+{
+    Snapshot s;
+    
+    // the audio thread hasn't cleared its counters yet
+    const bool audioCountersValid = !resetRequested.load();
+    s.numCallbacks = audioCountersValid ? numCallbacks.load() : 0;
+    s.numOverruns = 0;
+    for (int i = 0; i < numLoadBins; i++)
+    {
+        s.loadHistogram[i] = audioCountersValid ? loadHistogram[i].load() : 0;
+        if (i >= firstOverrunBin)
+            s.numOverruns += s.loadHistogram[i];
+    }
+    s.maxLoad = audioCountersValid ? maxLoad.load() : 0;
+    
+    s.numHandoffs = audioCountersValid ? numHandoffs.load() : 0;
+    s.meanHandoffMs = s.numHandoffs > 0 ? ticksToMs(handoffTicksSum.load()) / s.numHandoffs : 0;
+    s.maxHandoffMs = s.numHandoffs > 0 ? ticksToMs(maxHandoffTicks.load()) : 0;
+    
+    // the device may have been restarted since, which resets its count
+    if (deviceXRuns < 0)
+        s.numXRuns = -1;
+    else if (xRunBaseline >= 0 && deviceXRuns >= xRunBaseline)
+        s.numXRuns = deviceXRuns - xRunBaseline;
+    else
+        s.numXRuns = deviceXRuns;
+    
+    s.numOverflows = numOverflows;
+    s.numWakeUps = wakeUpMs.getNumValues();
+    s.meanWakeUpMs = wakeUpMs.getMean();
+    s.maxWakeUpMs = maxWakeUpMs;
+    s.numPosts = postResetRequested.load() ? 0 : numPosts.load();
+    s.meanPostMs = s.numPosts > 0 ? ticksToMs(postTicksSum.load()) / s.numPosts : 0;
+    s.maxPostMs = s.numPosts > 0 ? ticksToMs(maxPostTicks.load()) : 0;
+    s.analysisMs = analysisMs;
+    s.elapsedMs = nowMs - startTimeMs;
+    s.notes = notes;
+    return s;
+}
+
+//==============================================================================
+String TunerTelemetry::Snapshot::getDescription() const
+{
+    String text;
+    
+    text << "Audio callbacks: " << String(numCallbacks)
+         << ", longest " << formatPercent(maxLoad) << " of the buffer"
+         << ", " << String(numOverruns) << " overruns"
+         << ", " << (numXRuns >= 0 ? String(numXRuns) : String("unknown")) << " xruns" << newLine;
+    for (int i = 0; i < numLoadBins; i++)
+    {
+        if (loadHistogram[i] > 0)
+            text << "    " << getLoadBinName(i).paddedRight(' ', 8) << String(loadHistogram[i]) << newLine;
+    }
+    
+    text << "Sample fifo overflows: " << String(numOverflows) << newLine;
+    text << "Measurement start to audio thread: " << formatMs(meanHandoffMs) << " average, "
+         << formatMs(maxHandoffMs) << " max (" << String(numHandoffs) << ")" << newLine;
+    text << "New samples to state machine: " << formatMs(meanWakeUpMs) << " average, "
+         << formatMs(maxWakeUpMs) << " max (" << String(numWakeUps) << ")" << newLine;
+    text << "    posting the wake up: " << formatMs(meanPostMs) << " average, "
+         << formatMs(maxPostMs) << " max (" << String(numPosts) << ")" << newLine;
+    text << "Analysis: " << formatMs(analysisMs) << newLine;
+    
+    // summed over all lanes, which measure in parallel
+    double lockMs = 0, settleMs = 0, collectMs = 0;
+    int numDiscarded = 0, numValid = 0;
+    int numOutcomes[3] = { 0, 0, 0 };
+    for (const NoteTiming& note : notes)
+    {
+        lockMs += note.lockMs;
+        settleMs += note.settleMs;
+        collectMs += note.collectMs;
+        numDiscarded += note.numDiscardedPeriods;
+        numValid += note.numValidPeriods;
+        numOutcomes[note.outcome]++;
+    }
+    
+    text << "Notes: " << String(notes.size()) << " in " << formatMs(elapsedMs)
+         << " (" << String(numOutcomes[completed]) << " completed, " << String(numOutcomes[failed])
+         << " failed, " << String(numOutcomes[abandoned]) << " abandoned)" << newLine;
+    if (notes.isEmpty())
+        return text;
+    
+    text << "    lock " << formatMs(lockMs) << ", settle " << formatMs(settleMs)
+         << ", collect " << formatMs(collectMs) << newLine;
+    text << "    " << String(numDiscarded) << " periods discarded before settling, "
+         << String(numValid) << " used" << newLine;
+    
+    Array<NoteTiming> slowest(notes);
+    std::sort(slowest.begin(), slowest.end(), [] (const NoteTiming& a, const NoteTiming& b)
+    {
+        return a.getTotalMs() > b.getTotalMs();
+    });
+    text << "Slowest notes:" << newLine;
+    for (int i = 0; i < jmin(numSlowestNotes, slowest.size()); i++)
+    {
+        const NoteTiming& note = slowest.getReference(i);
+        text << "    note " << String(note.midiPitch) << ", input " << String(note.lane + 1)
+             << ": " << formatMs(note.getTotalMs()) << " (lock " << formatMs(note.lockMs)
+             << ", settle " << formatMs(note.settleMs) << ", collect " << formatMs(note.collectMs)
+             << ", " << String(note.numDiscardedPeriods) << " periods discarded)";
+        if (note.outcome == failed)
+            text << ", failed";
+        else if (note.outcome == abandoned)
+            text << ", abandoned";
+        text << newLine;
+    }
+    return text;
+}
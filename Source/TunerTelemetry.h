@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    TunerTelemetry.h
+    Created: 17 Oct 2026 6:12:40pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef TUNERTELEMETRY_H_INCLUDED
+#define TUNERTELEMETRY_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "RunningStatistics.h"
+
+/** Performance counters of a tuner, to see where the time of a run goes.
+
+    The audio thread only touches a few atomics per callback: the time the callback took,
+    relative to the time its buffer covers, is sorted into a histogram. Everything else is
+    collected on the message thread while the state machine runs: how long each note spent
+    in the phases of its measurement, how many periods were thrown away, and how long the
+    two threads take to react to each other. A snapshot of all counters can be taken at any
+    time.
+ */
+class TunerTelemetry
+{
+public:
+    /** the callback durations are sorted into this many bins */
+    static const int numLoadBins = 9;
+    /** upper end of a bin, as a fraction of the buffer period. The last bin is open. */
+    static double getLoadBinEnd(int bin);
+    static String getLoadBinName(int bin);
+    
+    enum Outcome
+    {
+        completed = 0,
+        failed,     // timed out or the frequency never got stable
+        abandoned   // stopped, or started again because samples got lost
+    };
+    
+    /** where the time of one note on one lane went. All times are in ms. */
+    struct NoteTiming
+    {
+        int lane;
+        int midiPitch;
+        double lockMs; // from the note on until the first period was found
+        double settleMs; // from the first period until the oscillator had settled
+        double collectMs; // from then on until enough periods were measured
+        int numDiscardedPeriods; // periods before the oscillator had settled
+        int numValidPeriods; // periods that went into the result
+        Outcome outcome;
+        
+        double getTotalMs() const { return lockMs + settleMs + collectMs; }
+    };
+    
+    struct Snapshot
+    {
+        int64 numCallbacks;
+        int64 loadHistogram[numLoadBins];
+        int64 numOverruns; // callbacks that took longer than the buffer they processed
+        double maxLoad; // the longest callback, as a fraction of its buffer period
+        int numXRuns; // as reported by the audio device, -1 if it can't tell
+        int numOverflows; // measurements started again because the sample fifo was full
+        
+        /** from the message thread starting a measurement until the audio thread records it */
+        int numHandoffs;
+        double meanHandoffMs;
+        double maxHandoffMs;
+        /** from the audio thread posting new samples until the state machine runs */
+        int numWakeUps;
+        double meanWakeUpMs;
+        double maxWakeUpMs;
+        /** how long it took to post a wake up to the message thread */
+        int numPosts;
+        double meanPostMs;
+        double maxPostMs;
+        
+        double analysisMs; // spent in the frequency estimators
+        double elapsedMs; // since the counters were reset
+        Array<NoteTiming> notes; // oldest first
+        
+        /** a human readable report of everything above */
+        String getDescription() const;
+    };
+    
+    TunerTelemetry();
+    
+    //==============================================================================
+    /** the following are only to be called from the audio thread */
+    void audioCallbackFinished(int64 durationTicks, int numSamples, double sampleRate);
+    /** the audio thread has picked up a measurement requested with measurementRequested() */
+    void recordingStarted();
+    /** the audio thread is about to wake up the state machine */
+    void wakeUpRequested();
+    
+    //==============================================================================
+    /** only to be called from the thread that passes the wake ups on to the message thread */
+    void wakeUpPosted(int64 durationTicks);
+    
+    //==============================================================================
+    /** the following are only to be called from the message thread (or with the analysis
+     lock held). The times are in ms of the tuner's clock, the number of xruns is what
+     the audio device reports (-1 if there is none). */
+    void reset(double nowMs, int deviceXRuns);
+    void measurementRequested();
+    void stateMachineWokeUp();
+    void addAnalysisTime(int64 durationTicks);
+    void measurementOverflowed();
+    void addNote(const NoteTiming& note);
+    
+    Snapshot getSnapshot(double nowMs, int deviceXRuns) const;
+    
+private:
+    /** written by the audio thread only. The message thread asks it to clear them,
+     so that there is only ever a single writer. */
+    std::atomic<int64> numCallbacks;
+    std::atomic<int64> loadHistogram[numLoadBins];
+    std::atomic<double> maxLoad;
+    std::atomic<int> numHandoffs;
+    std::atomic<int64> handoffTicksSum;
+    std::atomic<int64> maxHandoffTicks;
+    std::atomic<bool> resetRequested;
+    
+    /** written by the thread that posts the wake ups only, cleared the same way */
+    std::atomic<int> numPosts;
+    std::atomic<int64> postTicksSum;
+    std::atomic<int64> maxPostTicks;
+    std::atomic<bool> postResetRequested;
+    
+    /** set by the message thread when it publishes a new measurement */
+    std::atomic<int64> requestTicks;
+    /** set by the audio thread when it wakes up the state machine, 0 while no wake up is pending */
+    std::atomic<int64> wakeUpTicks;
+    
+    /** the following are only accessed from the message thread */
+    RunningStatistics wakeUpMs;
+    double maxWakeUpMs;
+    int numOverflows;
+    double analysisMs;
+    double startTimeMs;
+    int xRunBaseline;
+    Array<NoteTiming> notes;
+    static const int maxNumNotes = 1000;
+    
+    JUCE_DECLARE_NON_COPYABLE(TunerTelemetry)
+};
+
+
+#endif  // TUNERTELEMETRY_H_INCLUDED
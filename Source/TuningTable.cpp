@@ -0,0 +1,254 @@
+/*
+  ==============================================================================
+
+    TuningTable.cpp
+    Created: 18 Oct 2026 11:02:48am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "TuningTable.h"
+
+namespace
+{
+    /** the MIDI Tuning Standard splits a semitone into this many steps */
+    const int mtsStepsPerSemitone = 1 << 14;
+    
+    String getSourceName(TuningTable::Source source)
+    {
+        switch (source)
+        {
+            case TuningTable::interpolated:
+                return "interpolated";
+            case TuningTable::extrapolated:
+                return "extrapolated";
+            default:
+                return "measured";
+        }
+    }
+}
+
+TuningTable::TuningTable(const Array<VCOTuner::measurement_t>& results, int lane)
+{
+    bool isMeasured[numNotes] = {};
+    for (const VCOTuner::measurement_t& m : results)
+    {
+        if (m.lane == lane && m.midiPitch >= 0 && m.midiPitch < numNotes)
+        {
+            offsets[m.midiPitch] = m.pitchOffset;
+            isMeasured[m.midiPitch] = true;
+        }
+    }
+    fillGaps(isMeasured);
+}
+
+TuningTable::TuningTable(const Array<VCOTuner::calibration_t>& calibrations, int lane)
+{
+    bool isMeasured[numNotes] = {};
+    for (const VCOTuner::calibration_t& c : calibrations)
+    {
+        if (c.lane == lane && c.midiPitch >= 0 && c.midiPitch < numNotes)
+        {
+            offsets[c.midiPitch] = -c.correction;
+            isMeasured[c.midiPitch] = true;
+        }
+    }
+    fillGaps(isMeasured);
+}
+
+void TuningTable::fillGaps(const bool* isMeasured)
+{
+    int lowest = -1, highest = -1;
+    for (int note = 0; note < numNotes; note++)
+    {
+        if (!isMeasured[note])
+            continue;
+        if (lowest < 0)
+            lowest = note;
+        highest = note;
+    }
+    
+    valid = lowest >= 0;
+    if (!valid)
+    {
+        for (int note = 0; note < numNotes; note++)
+        {
+            offsets[note] = 0;
+            sources[note] = extrapolated;
+        }
+        return;
+    }
+    
+    // outside of the measured range, along the line through both ends of it
+    const double slope = highest > lowest ? (offsets[highest] - offsets[lowest]) / (highest - lowest) : 0.0;
+    for (int note = 0; note < numNotes; note++)
+    {
+        if (note < lowest || note > highest)
+        {
+            offsets[note] = offsets[lowest] + slope * (note - lowest);
+            sources[note] = extrapolated;
+        }
+    }
+    
+    // inside, between the measured neighbours
+    int previous = lowest;
+    for (int note = lowest; note <= highest; note++)
+    {
+        if (isMeasured[note])
+        {
+            for (int i = previous + 1; i < note; i++)
+            {
+                const double t = (i - previous) / (double) (note - previous);
+                offsets[i] = offsets[previous] + t * (offsets[note] - offsets[previous]);
+                sources[i] = interpolated;
+            }
+            sources[note] = measured;
+            previous = note;
+        }
+    }
+}
+
+//==============================================================================
+String TuningTable::getScalaScale(const String& description) const
+{
+    // degree 0 is note 0, so the last degree (the "octave") is note 127
+    String text;
+    text << "! VCOTuner correction, one degree per MIDI note" << newLine
+         << "!" << newLine
+         << description.replaceCharacters("\r\n", "  ") << newLine
+         << " " << String(numNotes - 1) << newLine
+         << "!" << newLine;
+    for (int note = 1; note < numNotes; note++)
+        text << " " << String((getCorrectedPitch(note) - getCorrectedPitch(0)) * 100.0, 5) << newLine;
+    return text;
+}
+
+String TuningTable::getScalaKeyboardMapping() const
+{
+    const double frequencyOfFirstNote = 440.0 * std::pow(2.0, (getCorrectedPitch(0) - 69.0) / 12.0);
+    
+    String text;
+    text << "! VCOTuner correction, to be used with the .scl file of the same name" << newLine
+         << "! Size of map (0 = linear):" << newLine << "0" << newLine
+         << "! First MIDI note number to retune:" << newLine << "0" << newLine
+         << "! Last MIDI note number to retune:" << newLine << String(numNotes - 1) << newLine
+         << "! Middle note where the first entry of the mapping is mapped to:" << newLine << "0" << newLine
+         << "! Reference note for which the frequency is given:" << newLine << "0" << newLine
+         << "! Frequency to tune the above note to:" << newLine << String(frequencyOfFirstNote, 6) << newLine
+         << "! Scale degree to consider as formal octave:" << newLine << String(numNotes - 1) << newLine
+         << "! Mapping:" << newLine;
+    return text;
+}
+
+MemoryBlock TuningTable::getMidiTuningDump(int program, const String& name) const
+{
+    MemoryBlock data;
+    const uint8 header[] = { 0xf0, 0x7e, 0x7f /* all devices */, 0x08, 0x01, (uint8) jlimit(0, 127, program) };
+    data.append(header, sizeof(header));
+    
+    // exactly 16 ASCII characters
+    const String paddedName = name.retainCharacters(" !\"#$%&'()*+,-./0123456789:;<=>?@"
+                                                    "ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`"
+                                                    "abcdefghijklmnopqrstuvwxyz{|}~")
+                                  .substring(0, 16).paddedRight(' ', 16);
+    data.append(paddedName.toRawUTF8(), 16);
+    
+    for (int note = 0; note < numNotes; note++)
+    {
+        const double pitch = jlimit(0.0, 127.0, getCorrectedPitch(note));
+        int semitone = (int) std::floor(pitch);
+        int fraction = roundToInt((pitch - semitone) * mtsStepsPerSemitone);
+        if (fraction >= mtsStepsPerSemitone)
+        {
+            semitone++;
+            fraction = 0;
+        }
+        // 7f 7f 7f means "no change", so the highest pitch stops one step short of it
+        if (semitone >= 127)
+        {
+            semitone = 127;
+            fraction = jmin(fraction, mtsStepsPerSemitone - 2);
+        }
+        
+        const uint8 bytes[] = { (uint8) semitone, (uint8) (fraction >> 7), (uint8) (fraction & 0x7f) };
+        data.append(bytes, sizeof(bytes));
+    }
+    
+    // XOR of everything after the F0
+    uint8 checksum = 0;
+    for (size_t i = 1; i < data.getSize(); i++)
+        checksum ^= (uint8) data[(int) i];
+    const uint8 footer[] = { (uint8) (checksum & 0x7f), 0xf7 };
+    data.append(footer, sizeof(footer));
+    return data;
+}
+
+String TuningTable::getCsv() const
+{
+    String text;
+    text << "note,source,offsetCents,correctionCents" << newLine;
+    for (int note = 0; note < numNotes; note++)
+    {
+        text << String(note) << "," << getSourceName(sources[note]) << ","
+             << String(offsets[note] * 100.0, 4) << "," << String(-offsets[note] * 100.0, 4) << newLine;
+    }
+    return text;
+}
+
+//==============================================================================
+String TuningTable::exportAll(const Array<VCOTuner::measurement_t>& results, const File& file)
+{
+    int numLanes = 0;
+    for (const VCOTuner::measurement_t& m : results)
+        numLanes = jmax(numLanes, m.lane + 1);
+    
+    Array<TuningTable> tables;
+    for (int lane = 0; lane < numLanes; lane++)
+        tables.add(TuningTable(results, lane));
+    return exportTables(tables, file);
+}
+
+String TuningTable::exportAll(const Array<VCOTuner::calibration_t>& calibrations, const File& file)
+{
+    int numLanes = 0;
+    for (const VCOTuner::calibration_t& c : calibrations)
+        numLanes = jmax(numLanes, c.lane + 1);
+    
+    Array<TuningTable> tables;
+    for (int lane = 0; lane < numLanes; lane++)
+        tables.add(TuningTable(calibrations, lane));
+    return exportTables(tables, file);
+}
+
+String TuningTable::exportTables(const Array<TuningTable>& tables, const File& file)
+{
+    const int numLanes = tables.size();
+    if (numLanes == 0)
+        return "There are no results to export.";
+    
+    const String baseName = file.getFileNameWithoutExtension();
+    for (int lane = 0; lane < numLanes; lane++)
+    {
+        const TuningTable& table = tables.getReference(lane);
+        if (!table.isValid())
+            continue;
+        
+        const String name = numLanes > 1 ? baseName + "-input" + String(lane + 1) : baseName;
+        const String description = "VCOTuner correction for " + name + ", exported "
+                                   + Time::getCurrentTime().toString(true, true, false);
+        
+        const File scl = file.getSiblingFile(name + ".scl");
+        const File kbm = file.getSiblingFile(name + ".kbm");
+        const File syx = file.getSiblingFile(name + ".syx");
+        const File csv = file.getSiblingFile(name + ".csv");
+        const MemoryBlock dump = table.getMidiTuningDump(0, name);
+        if (!scl.replaceWithText(table.getScalaScale(description))
+            || !kbm.replaceWithText(table.getScalaKeyboardMapping())
+            || !syx.replaceWithData(dump.getData(), dump.getSize())
+            || !csv.replaceWithText(table.getCsv()))
+            return "Can't write the tuning tables to " + file.getParentDirectory().getFullPathName();
+    }
+    return {};
+}
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    TuningTable.h
+    Created: 18 Oct 2026 11:02:48am
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef TUNINGTABLE_H_INCLUDED
+#define TUNINGTABLE_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "VCOTuner.h"
+
+/** The pitch offset of one oscillator for every MIDI note, and the corrections that
+    bring it back in tune, in formats that MIDI-CV interfaces and synths can load.
+    
+    Notes between two measured ones are interpolated linearly. Below and above the
+    measured range, the offsets follow the straight line through the lowest and the
+    highest measured note, because the error of a VCO is mostly a scaling error and
+    that line isn't thrown off by the noise of a single note.
+    
+    The corrected pitch of a note is what has to be played so that the oscillator
+    hits the note: when it's 3 cents sharp, the note is played 3 cents lower.
+ */
+class TuningTable
+{
+public:
+    static const int numNotes = 128;
+    
+    enum Source
+    {
+        measured = 0,
+        interpolated,
+        extrapolated
+    };
+    
+    /** builds the table from the results of one lane (i.e. one oscillator). Results of
+     other lanes are ignored. If a note was measured more than once, the last result counts. */
+    TuningTable(const Array<VCOTuner::measurement_t>& results, int lane);
+    /** builds the table from the corrections that a calibration has found for one lane.
+     They were verified on the oscillator itself, so they are used as they are and the
+     offsets are taken to be the opposite of them. */
+    TuningTable(const Array<VCOTuner::calibration_t>& calibrations, int lane);
+    
+    /** false if the lane doesn't have any results */
+    bool isValid() const { return valid; }
+    
+    /** in semitones, positive if the oscillator is sharp */
+    double getPitchOffset(int note) const { return offsets[note]; }
+    Source getSource(int note) const { return sources[note]; }
+    /** the fractional MIDI note to play so that the oscillator is in tune */
+    double getCorrectedPitch(int note) const { return note - offsets[note]; }
+    
+    /** a Scala scale with one degree per MIDI note, to be used with getScalaKeyboardMapping() */
+    String getScalaScale(const String& description) const;
+    /** maps every MIDI note to its degree of getScalaScale(), tuned to A4 = 440 Hz */
+    String getScalaKeyboardMapping() const;
+    /** a MIDI Tuning Standard bulk tuning dump (non-real-time, sub-ID 08 01) */
+    MemoryBlock getMidiTuningDump(int program, const String& name) const;
+    /** one line per note: its offset and its correction in cents, and where they came from */
+    String getCsv() const;
+    
+    /** writes the .scl, .kbm, .syx and .csv files of all lanes next to the given file, which
+     only gives the name. With several lanes, the files of each one get "-input<n>" appended.
+     Returns an error message, or an empty string if all went fine. */
+    static String exportAll(const Array<VCOTuner::measurement_t>& results, const File& file);
+    static String exportAll(const Array<VCOTuner::calibration_t>& calibrations, const File& file);
+    
+private:
+    /** fills in the notes that weren't measured */
+    void fillGaps(const bool* isMeasured);
+    /** one table per lane, those without results are skipped */
+    static String exportTables(const Array<TuningTable>& tables, const File& file);
+    
+    double offsets[numNotes];
+    Source sources[numNotes];
+    bool valid;
+};
+
+
+#endif  // TUNINGTABLE_H_INCLUDED
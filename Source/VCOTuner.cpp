@@ -1,660 +1,1841 @@
-/*
-  ==============================================================================
-
-    VCOTuner.cpp
-    Created: 17 May 2016 8:21:15pm
-    Author:  Johannes Neumann
-
-  ==============================================================================
-*/
-
-#include "../JuceLibraryCode/JuceHeader.h"
-#include "VCOTuner.h"
-
-VCOTuner::VCOTuner(AudioDeviceManager* d)
-{
-    state = stopped;
-    numPeriodSamples = 10;
-    lowestPitch = 30;
-    highestPitch = 120;
-    pitchIncrement = 12;
-    deviceManager = d;
-    midiChannel = 1;
-    currentlyPlayingMidiNote = -1;
-    
-    d->addChangeListener(this);
-    d->addAudioCallback(this);
-    
-    startTimer(10);
-}
-
-VCOTuner::~VCOTuner()
-{
-    stopTimer();
-    
-    if (currentlyPlayingMidiNote >= 0)
-        trySendMidiNoteOff(currentlyPlayingMidiNote);
-    
-    deviceManager->removeAudioCallback(this);
-}
-
-
-void VCOTuner::setNumMeasurementRange(int lPitch, int pitchInc, int hPitch)
-{
-    lowestPitch = lPitch;
-    pitchIncrement = pitchInc;
-    highestPitch = hPitch;
-}
-
-void VCOTuner::addListener(Listener* l)
-{
-    listeners.add(l);
-}
-
-void VCOTuner::removeListener(Listener* l)
-{
-    listeners.remove(l);
-}
-
-void VCOTuner::toggleState()
-{
-    if (!isRunning())
-    {
-        switchState(prepRefMeasurement);
-    }
-    else
-    {
-        switchState(stopped);
-    }
-}
-
-void VCOTuner::start()
-{
-    if (!isRunning())
-        switchState(prepRefMeasurement);
-}
-
-void VCOTuner::stop()
-{
-    if (isRunning())
-        switchState(stopped);
-}
-
-void VCOTuner::startSingleMeasurement(int pitch)
-{
-    if (state != stopped && state != finished)
-        switchState(stopped);
-    
-    singleMeasurementPitch = pitch;
-    singleMeasurementResult = -1;
-    
-    switchState(prepareSingleMeasurement);
-}
-
-StringArray VCOTuner::getLastErrors()
-{
-    StringArray tmp = errors;
-    errors.clear();
-    return tmp;
-}
-
-void VCOTuner::timerCallback()
-{
-    switch (state)
-    {
-        case stopped:
-            break;
-        case prepRefMeasurement:
-            if (cycleCounter == 0)
-            {
-                // send reference midi note
-                referencePitch = (highestPitch + lowestPitch) / 2;
-                currentPitch = referencePitch;
-                trySendMidiNoteOn(currentPitch);
-            }
-            else
-            {
-                // after 100ms, we expect the oscillator to be settled at the new pitch
-                // (gives some safety margin for audio/midi interface latency)
-                if (cycleCounter >= 10)
-                {
-                    // start a measurement and see if we get a stable pitch here
-                    startMeasurement = true;
-                    switchState(refMeasurement);
-                    break;
-                }
-            }
-            cycleCounter++;
-            break;
-        case refMeasurement:
-        {
-            // measurement done
-            if (!startMeasurement)
-            {
-                // send note off
-                trySendMidiNoteOff(currentPitch);
-                
-                if (lError == notStable)
-                {
-                    errors.add(Errors::highJitter);
-                    switchState(stopped);
-                }
-                else
-                {
-                    // calculate frequency
-                    int numMeasurements = periodLengthsHead - indexOfFirstValidPeriodLength;
-                    double accumulator = 0;
-                    for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                        accumulator += periodLengths[i];
-                    
-                    double averagePeriod = accumulator / (double) numMeasurements;
-                    
-                    referenceFrequency = float(sampleRate / averagePeriod);
-                    
-                    // prepare next measurement
-                    currentPitch = lowestPitch;
-                    currentIndex = 0;
-                    switchState(prepMeasurement);
-                    break;
-                }
-            }
-
-            if (cycleCounter > 1000)
-            {
-                if (periodLengthsHead == 0)
-                    errors.add(Errors::noZeroCrossings);
-                else if (lError == notStable)
-                    errors.add(Errors::highJitterTimeOut);
-                else
-                    errors.add(Errors::stableTimeout);
-                stopMeasurement = true;
-                switchState(stopped);
-                break;
-            }
-            cycleCounter++;
-            break;
-        }
-        case prepMeasurement:
-            if (cycleCounter == 0)
-            {
-                // send midi note
-                trySendMidiNoteOn(currentPitch);
-            }
-            else
-            {
-                // after 100ms, we expect the oscillator to be settled at the new pitch
-                // (gives some safety margin for audio/midi interface latency)
-                if (cycleCounter >= 10)
-                {
-                    // start a measurement and see if we get a stable pitch here
-                    startMeasurement = true;
-                    switchState(measurement);
-                    break;
-                }
-            }
-            cycleCounter++;
-            break;
-        case measurement:
-        {
-            // measurement done
-            if (!startMeasurement)
-            {
-                // send note off
-                trySendMidiNoteOff(currentPitch);
-
-                if (lError == notStable)
-                {
-                    errors.add(Errors::highJitter);
-                    switchState(stopped);
-                }
-                else
-                {
-                    // calculate frequency
-                    int numMeasurements = periodLengthsHead - indexOfFirstValidPeriodLength;
-                    double accumulator = 0;
-                    for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                        accumulator += periodLengths[i];
-                    
-                    double averagePeriod = (double) accumulator / (double) numMeasurements;
-                    
-                    double frequency = sampleRate / averagePeriod;
-                    double pitch = 12.0 * log(frequency / referenceFrequency) / log(2.0) + referencePitch;
-                    
-                    // check if the frequency has changed compared to the reference frequency
-                    // if not, it is likely that the MIDI output is not working. Do this only for the very first measurement
-                    if (currentIndex == 0)
-                    {
-                        if (std::abs(frequency - referenceFrequency)/referenceFrequency < 0.1)
-                        {
-                            errors.add(Errors::noFrequencyChangeBetweenMeasurements);
-                            switchState(stopped);
-                        }
-                    }
-                    
-                    // estimate deviation of frequency and pitch
-                    double fAccumulator = 0;
-                    double pAccumulator = 0;
-                    for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                    {
-                        double f = sampleRate / (double) periodLengths[i];
-                        fAccumulator += pow(f - frequency, 2);
-                        pAccumulator += pow(12.0 * log(f / referenceFrequency) / log(2.0) + referencePitch - pitch, 2);
-                    }
-                    fAccumulator = fAccumulator / (numMeasurements - 1);
-                    pAccumulator = pAccumulator / (numMeasurements - 1);
-                    double fDeviation = sqrt(fAccumulator);
-                    double pDeviation = sqrt(pAccumulator);
-                    
-                    measurement_t m;
-                    m.timestamp = Time::getCurrentTime();
-                    m.frequency = frequency;
-                    m.pitch = pitch;
-                    m.midiPitch = currentPitch;
-                    m.pitchOffset = pitch - currentPitch;
-                    m.freqDeviation = fDeviation;
-                    m.pitchDeviation = pDeviation;
-                    m.numMeasurements = numMeasurements;
-                    listeners.call(&Listener::newMeasurementReady, m);
-                    
-                    // prepare next measurement
-                    currentPitch += pitchIncrement;
-                    currentIndex++;
-                    
-                    if (currentPitch <= highestPitch)
-                        switchState(prepMeasurement);
-                    else
-                        switchState(finished);
-                    break;
-                }
-            }
-            
-            float expectedFrequency = referenceFrequency * powf(2,((float) currentPitch - (float) referencePitch)/12.0f);
-            float expectedTime = 1.0f / (float) expectedFrequency * numPeriodSamples;
-            expectedTime *= 2;
-            int expectedCycles = juce::roundToInt(expectedTime * 100);
-            if (cycleCounter > expectedCycles)
-            {
-                if (periodLengthsHead == 0)
-                    errors.add(Errors::noZeroCrossings);
-                else if (lError == notStable)
-                    errors.add(Errors::highJitterTimeOut);
-                else
-                    errors.add(Errors::stableTimeout);
-                stopMeasurement = true;
-                switchState(stopped);
-                break;
-            }
-            cycleCounter++;
-            break;
-        }
-        case finished:
-            break;
-        case prepareContinuousFrequencyMeasurement:
-        {
-            // wait for low level state machine to stop measuring
-            if (stopMeasurement)
-                break;
-                
-            // send midi note and start measuring
-            trySendMidiNoteOn(continuousFrequencyMeasurementPitch);
-            startMeasurement = true;
-            switchState(continuousFrequencyMeasurement);
-            cycleCounter++;
-        } break;
-        case continuousFrequencyMeasurement:
-        {
-            // if the measurement is done)
-            if (!startMeasurement)
-            {
-                // calculate frequency
-                int numMeasurements = periodLengthsHead - indexOfFirstValidPeriodLength;
-                double accumulator = 0;
-                for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                    accumulator += periodLengths[i];
-                
-                double averagePeriod = (double) accumulator / (double) numMeasurements;
-                
-                double frequency = sampleRate / averagePeriod;
-                
-                // estimate deviation of frequency
-                double fAccumulator = 0;
-                for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                {
-                    double f = sampleRate / (double) periodLengths[i];
-                    fAccumulator += pow(f - frequency, 2);
-                }
-                fAccumulator = fAccumulator / (numMeasurements - 1);
-                double fDeviation = sqrt(fAccumulator);
-                
-                continuousFreqMeasurementResult = frequency;
-                continuousFreqMeasurementDeviation = fDeviation;
-                
-                // restart measurement
-                startMeasurement = true;
-            }
-            cycleCounter++;
-        } break;
-        case prepareSingleMeasurement:
-        {
-            // wait for low level state machine to stop measuring
-            if (stopMeasurement)
-                break;
-            
-            if (cycleCounter == 0)
-            {
-                // send midi note
-                trySendMidiNoteOn(singleMeasurementPitch);
-            }
-            else
-            {
-                // after 100ms, we expect the oscillator to be settled at the new pitch
-                // (gives some safety margin for audio/midi interface latency)
-                if (cycleCounter >= 10)
-                {
-                    // start a measurement and see if we get a stable pitch here
-                    startMeasurement = true;
-                    switchState(singleMeasurement);
-                    break;
-                }
-            }
-            cycleCounter++;
-        } break;
-        case singleMeasurement:
-        {
-            // measurement done
-            if (!startMeasurement)
-            {
-                // send note off
-                trySendMidiNoteOff(singleMeasurementPitch);
-                
-                if (lError == notStable)
-                {
-                    errors.add(Errors::highJitter);
-                    switchState(stopped);
-                }
-                else
-                {
-                    // calculate frequency
-                    int numMeasurements = periodLengthsHead - indexOfFirstValidPeriodLength;
-                    double accumulator = 0;
-                    for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                        accumulator += periodLengths[i];
-                    
-                    double averagePeriod = (double) accumulator / (double) numMeasurements;
-                    
-                    double frequency = sampleRate / averagePeriod;
-                    
-                    // estimate deviation of frequency
-                    double fAccumulator = 0;
-                    for (int i = indexOfFirstValidPeriodLength; i < periodLengthsHead; i++)
-                    {
-                        double f = sampleRate / (double) periodLengths[i];
-                        fAccumulator += pow(f - frequency, 2);
-                    }
-                    fAccumulator = fAccumulator / (numMeasurements - 1);
-                    double fDeviation = sqrt(fAccumulator);
-                    
-                    singleMeasurementResult = frequency;
-                    singleMeasurementDeviation = fDeviation;
-                    
-                    switchState(finished);
-                    break;
-                }
-            }
-            
-            // timeout handling
-            if (cycleCounter > 1000)
-            {
-                if (periodLengthsHead == 0)
-                    errors.add(Errors::noZeroCrossings);
-                else if (lError == notStable)
-                    errors.add(Errors::highJitterTimeOut);
-                else
-                    errors.add(Errors::stableTimeout);
-                stopMeasurement = true;
-                switchState(stopped);
-                break;
-            }
-            cycleCounter++;
-        } break;
-        default:
-            state = stopped;
-            break;
-    }
-}
-
-void VCOTuner::startContinuousMeasurement(int pitch)
-{
-    continuousFrequencyMeasurementPitch = pitch;
-    if (state != stopped && state != finished)
-        switchState(stopped);
-    state = prepareContinuousFrequencyMeasurement;
-}
-
-void VCOTuner::trySendMidiNoteOn(int pitch)
-{
-    MidiOutput* midiOut = deviceManager->getDefaultMidiOutput();
-    if (midiOut == nullptr)
-    {
-        errors.add(Errors::noMidiDeviceAvailable);
-        switchState(stopped);
-        return;
-    }
-    
-    if (currentlyPlayingMidiNote != -1)
-        trySendMidiNoteOff(currentlyPlayingMidiNote);
-    
-    midiOut->sendMessageNow(MidiMessage::noteOn(midiChannel, pitch, (uint8_t) 100));
-    currentlyPlayingMidiNote = pitch;
-}
-
-void VCOTuner::trySendMidiNoteOff(int pitch)
-{
-    MidiOutput* midiOut = deviceManager->getDefaultMidiOutput();
-    if (midiOut == nullptr)
-    {
-        errors.add(Errors::noMidiDeviceAvailable);
-        switchState(stopped);
-        return;
-    }
-    
-    midiOut->sendMessageNow(MidiMessage::noteOff(midiChannel, pitch));
-    currentlyPlayingMidiNote = -1;
-}
-
-/** inherited from AudioIODeviceCallback */
-void VCOTuner::audioDeviceIOCallback (const float** inputChannelData,
-                                    int numInputChannels,
-                                    float** outputChannelData,
-                                    int numOutputChannels,
-                                    int numSamples)
-{
-    if (inputChannelData == nullptr)
-        return;
-    const AudioBuffer<const float> inputBuffer(inputChannelData, numInputChannels, numSamples);
-
-    if (stopMeasurement)
-    {
-        startMeasurement = false;
-        stopMeasurement = false;
-        initialized = false;
-    }
-    
-    if (startMeasurement)
-    {
-        // check if measurement was initialized
-        if (!initialized)
-        {
-            lError = noError;
-            sampleCounter = 0;
-            lastZeroCrossing = -1;
-            indexOfFirstValidPeriodLength = -1;
-            periodLengthsHead = 0;
-            initialized = true;
-        }
-        
-        // try to find a zero crossing (- => +)
-        for (int i = 0; i < numSamples; i++)
-        {
-            float currentSample = inputBuffer.getSample(0, i);
-            if (lastSample < 0 && currentSample >= 0)
-            {
-                if (periodLengthsHead >= maxNumPeriodLengths)
-                    break;
-                
-                // interpolate line between the sample before and after the crossing
-                // y = mx + n
-                double m = (lastSample - currentSample);
-                double n = lastSample - m*(sampleCounter);
-                
-                // zero crossing of interpolated line: y = 0 => x0 = -n/m
-                double zeroCrossingPos = -n / m;
-                
-                periodLengths[periodLengthsHead++] = zeroCrossingPos - lastZeroCrossing;
-                lastZeroCrossing = zeroCrossingPos;                
-            }
-            lastSample = currentSample;
-            sampleCounter++;
-        }
-        
-        // see if the period length is stable
-        if (periodLengthsHead > 5 && indexOfFirstValidPeriodLength < 0)
-        {
-            double sum = 0;
-            for (int i = periodLengthsHead - 5; i < periodLengthsHead; i++)
-            {
-                sum += periodLengths[i];
-            }
-            double average = sum / 5.0;
-            
-            bool okay = true;
-            double boundary = average * 0.1; // max 10% error allowed
-            for (int i = periodLengthsHead - 5; i < periodLengthsHead; i++)
-            {
-                if (std::abs(periodLengths[i] - average) >= boundary)
-                    okay = false;
-            }
-            
-            if (okay)
-            {
-                indexOfFirstValidPeriodLength = periodLengthsHead;
-            }
-        }
-        
-        // finish measurement when the required number of valid measurements are made
-        int numMeasurements = periodLengthsHead - indexOfFirstValidPeriodLength;
-        if ((indexOfFirstValidPeriodLength > 0) && (numMeasurements > numPeriodSamples))
-        {
-            lError = noError;
-            initialized = false;
-            startMeasurement = false;
-        }
-        // the pitch hasn't stabilized yet.
-        // assign the notStable error prematurely, just in case the top level statemachine runs into
-        // a timeout and wants to know whats going on.
-        else if (indexOfFirstValidPeriodLength < 0)
-        {
-            lError = notStable;
-            
-            // ran out of recording space => period length too jittery or does change constantly - stop here.
-            if ((periodLengthsHead >= maxNumPeriodLengths))
-            {
-                initialized = false;
-                startMeasurement = false;
-            }
-        }
-    }
-
-    if (outputChannelData != nullptr)
-    { 
-    	AudioBuffer<float> outputBuffer(outputChannelData, numOutputChannels, numSamples);
-    	outputBuffer.clear();
-    }
-}
-
-void VCOTuner::switchState(VCOTuner::State newState)
-{
-    cycleCounter = 0;
-    state = newState;
-    if (state == stopped)
-    {
-        if (currentlyPlayingMidiNote >= 0 && currentlyPlayingMidiNote < 128)
-            trySendMidiNoteOff(currentlyPlayingMidiNote);
-        stopMeasurement = true;
-        listeners.call(&Listener::tunerStopped);
-    }
-    else if (newState == prepRefMeasurement)
-        listeners.call(&Listener::tunerStarted);
-    else if (newState == finished)
-        listeners.call(&Listener::tunerFinished);
-    
-    listeners.call(&Listener::tunerStatusChanged, getStatusString());
-}
-
-/** inherited from AudioIODeviceCallback */
-void VCOTuner::audioDeviceAboutToStart (AudioIODevice* device)
-{
-    sampleRate = device->getCurrentSampleRate();
-}
-
-/** inherited from AudioIODeviceCallback */
-void VCOTuner::audioDeviceStopped()
-{
-	if (isRunning())
-        errors.add(Errors::audioDeviceStoppedDuringMeasurement);
-
-    switchState(stopped);
-}
-
-void VCOTuner::changeListenerCallback (ChangeBroadcaster* source)
-{
-    if (source == deviceManager)
-    {
-        switchState(stopped);
-    }
-}
-
-String VCOTuner::getStatusString() const 
-{
-    switch(state)
-    {
-        case stopped:
-            return "Stopped.";
-            break; // these breaks are only here to prevent IDE warnings...
-        case prepRefMeasurement:
-        case refMeasurement:
-            return "Measuring reference frequency ...";
-            break;
-        case prepMeasurement:
-        case measurement:
-            return "Measuring frequency for MIDI note " + String(currentPitch) + " ...";
-            break;
-        case finished:
-            return "Finished.";
-            break;
-        case prepareContinuousFrequencyMeasurement:
-        case continuousFrequencyMeasurement:
-            return "Continuously measuring frequency...";
-            break;
-        case prepareSingleMeasurement:
-        case singleMeasurement:
-            return "Measuring frequency for MIDI note " + String(singleMeasurementPitch) + " ...";
-        default:
-            return "";
-            break;
-    }
-}
-
-const String VCOTuner::Errors::highJitter = "There are zero crossings in the incoming signal but they don't seem to be coming in at a constant rate. Are you sure you're recording on the correct channel? Please use only primitive waveforms (saw, square, triangle, sine, ...) without any other processing such as delays, reverbs, etc. This error typically appears when you are accidentally recording the signal from a microphone or another sound source. Or when you have dropouts (aka clicks and pops) in your audio.";
-
-const String VCOTuner::Errors::noZeroCrossings = "The incoming audio signal does not seem to contain any zero-crossings. Are you sure the oscillator signal is getting through to us? Check your audio device settings.";
-
-const String VCOTuner::Errors::highJitterTimeOut = "Timeout. " + highJitter;
-
-const String VCOTuner::Errors::stableTimeout = "There are some zero crossings in the incoming signal and they seem to come in at a constant rate - but they are coming in much slower than they should be. Are you recording from the right oscillator?";
-
-const String VCOTuner::Errors::noFrequencyChangeBetweenMeasurements = "Apparently the frequency of the oscillator is not changing between measurements. Please check if your MIDI-to-CV interface is set to the correct MIDI channel and make sure that it is selected as the default midi output device in the audio and midi settings.";
-
-const String VCOTuner::Errors::noMidiDeviceAvailable = "You don't have a MIDI output device selected or the selected device is not available.";
-
-const String VCOTuner::Errors::audioDeviceStoppedDuringMeasurement = "The audio device was stopped while the measurement was still running. Please check that the device is still powered, all cables are connected and the driver is working correctly.";
+/*
+  ==============================================================================
+
+    VCOTuner.cpp
+    Created: 17 May 2016 8:21:15pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "VCOTuner.h"
+
+namespace
+{
+    /** calibration attempts closer together than this (in semitones) only show the noise,
+     not the gain of the correction */
+    const double minimumSecantStep = 0.002;
+    /** gains outside of this range mean that something else has changed the pitch */
+    const double minimumCorrectionGain = 0.1;
+    const double maximumCorrectionGain = 10.0;
+    /** the correction values have 14 bits, this one is no correction */
+    const int neutralCorrectionValue = 8192;
+    /** notes closer to the reference than this (in semitones) might as well be the
+     reference itself, if the MIDI output doesn't work */
+    const int minimumCheckedInterval = 3;
+    /** the periods before this part of the predicted settle time are ignored */
+    const double predictedSettleWaitFraction = 0.5;
+    /** a note may take this many times its predicted settle time before it is given up */
+    const double predictedSettleTimeoutFactor = 3.0;
+    /** the wake ups of the audio thread are picked up this often */
+    const int wakeUpPollIntervalMs = 1;
+}
+
+VCOTuner::Lane::Lane()
+: sampleFifo(1), blockFifo(1), overflowedMeasurement(0)
+{
+    recordingOverflowed = false;
+    recordedInputChannel = 0;
+    active = true;
+    measuring = false;
+    estimatorType = FrequencyEstimator::zeroCrossings;
+    estimator = FrequencyEstimator::create(estimatorType);
+    numPeriods = 0;
+    stableTime = 0;
+    stablePosition = 0;
+    noteOnTime = 0;
+    firstPeriodTime = 0;
+    numUnsettledPeriods = 0;
+    previousPitch = -1;
+    previousPeriodLength = 0;
+    hasJump = false;
+    jump = 0;
+    predictedSettleTimeMs = 0;
+    pitchChangeChecked = false;
+    lError = noError;
+    currentlyPlayingMidiNote = -1;
+    referenceFrequency = 0;
+    continuousFreqMeasurementResult = 0;
+    continuousFreqMeasurementDeviation = 0;
+    singleMeasurementResult = -1;
+    singleMeasurementDeviation = 0;
+    correction = 0;
+    correctionSent = false;
+    previousCorrection = 0;
+    previousError = 0;
+    correctionGain = 1.0;
+    bestCorrection = 0;
+    bestError = 0;
+    numAttempts = 0;
+    calibrated = false;
+    numSeeds = 0;
+}
+
+void VCOTuner::Lane::setFifosAllocated(bool shouldBeAllocated)
+{
+    // a fifo of one can't take anything, so an unused lane would only overflow
+    const int numSamples = shouldBeAllocated ? sampleFifoSize : 1;
+    const int numBlocks = shouldBeAllocated ? blockFifoSize : 1;
+    if (sampleFifo.getTotalSize() == numSamples)
+        return;
+    
+    sampleFifo.setTotalSize(numSamples);
+    blockFifo.setTotalSize(numBlocks);
+    if (shouldBeAllocated)
+    {
+        sampleFifoBuffer.allocate((size_t) numSamples, false);
+        blockFifoBuffer.allocate((size_t) numBlocks, false);
+    }
+    else
+    {
+        sampleFifoBuffer.free();
+        blockFifoBuffer.free();
+    }
+}
+
+VCOTuner::VCOTuner(AudioDeviceManager* d)
+: analysisPool(nullptr), analysisPending(false), wakeUpPoller(*this), wakeUpPending(false),
+  numLanes(1), requestedMeasurement(0)
+{
+    state = stopped;
+    numPeriodSamples = 10;
+    targetConfidenceInterval = 0;
+    estimatorType = FrequencyEstimator::zeroCrossings;
+    conditioning = SignalConditioner::off;
+    lowestPitch = 30;
+    highestPitch = 120;
+    pitchIncrement = 12;
+    sweepOrder = SweepPlanner::monotonic;
+    currentPitch = 0;
+    currentIndex = 0;
+    deviceManager = d;
+    midiSink = nullptr;
+    virtualClock = false;
+    virtualTime = 0;
+    stateStartTime = 0;
+    sampleRate = 44100.0;
+    measurementId = 0;
+    recordedMeasurement = 0;
+    numRecordedLanes = 0;
+    inputLatencySamples = 0;
+    calibrating = false;
+    correctionMessage = pitchBend;
+    pitchBendRange = 2.0;
+    calibrationTolerance = 0.5;
+    referenceInterval = 0;
+    lastReferenceTime = 0;
+    
+    for (int i = 0; i < maxNumLanes; i++)
+        lanes.add(new Lane());
+    lanes[0]->setFifosAllocated(true);
+    
+    currentStatus = {};
+    currentStatus.midiPitch = -1;
+    publishStatus();
+    
+    d->addChangeListener(this);
+    d->addAudioCallback(this);
+}
+
+VCOTuner::~VCOTuner()
+{
+    removeAnalysisJobs();
+    wakeUpPoller.stopTimer();
+    stopTimer();
+    cancelPendingUpdate();
+    
+    sendNoteOffs();
+    
+    deviceManager->removeAudioCallback(this);
+}
+
+
+void VCOTuner::setNumMeasurementRange(int lPitch, int pitchInc, int hPitch)
+{
+    lowestPitch = lPitch;
+    pitchIncrement = pitchInc;
+    highestPitch = hPitch;
+}
+
+void VCOTuner::setLanes(const Array<LaneSetup>& newLanes)
+{
+    jassert(newLanes.size() > 0 && newLanes.size() <= maxNumLanes);
+    const ScopedLock sl(analysisLock);
+    
+    // nothing may be recorded while the lanes change
+    if (isRunning() || state == prepareContinuousFrequencyMeasurement || state == continuousFrequencyMeasurement)
+        switchState(stopped);
+    stopMeasuring();
+    
+    // the audio thread copies the setup when it starts to record, and writes into the fifos
+    const ScopedLock audioLock(deviceManager->getAudioCallbackLock());
+    const int newNumLanes = jlimit(1, (int) maxNumLanes, newLanes.size());
+    for (int i = 0; i < maxNumLanes; i++)
+    {
+        lanes[i]->setFifosAllocated(i < newNumLanes);
+        if (i < newNumLanes)
+        {
+            lanes[i]->setup = newLanes[i];
+            lanes[i]->previousPeriodLength = 0;
+            lanes[i]->settleModel.reset();
+        }
+    }
+    numLanes = newNumLanes;
+}
+
+void VCOTuner::setCorrectionMessage(CorrectionMessage message, double newPitchBendRange)
+{
+    const ScopedLock sl(analysisLock);
+    
+    // the corrections of a running calibration would be off
+    if (isRunning() && calibrating)
+        switchState(stopped);
+    
+    correctionMessage = message;
+    pitchBendRange = jmax(0.01, newPitchBendRange);
+}
+
+void VCOTuner::setEstimator(FrequencyEstimator::Type type)
+{
+    const ScopedLock sl(analysisLock);
+    
+    // the lanes switch over when the next measurement starts
+    estimatorType = type;
+}
+
+void VCOTuner::setConditioning(SignalConditioner::Mode mode)
+{
+    const ScopedLock sl(analysisLock);
+    
+    conditioning = mode;
+}
+
+void VCOTuner::addListener(Listener* l)
+{
+    listeners.add(l);
+}
+
+void VCOTuner::removeListener(Listener* l)
+{
+    listeners.remove(l);
+}
+
+void VCOTuner::addResultQueue(ResultQueue* queue)
+{
+    const ScopedLock sl(analysisLock);
+    resultQueues.addIfNotAlreadyThere(queue);
+}
+
+void VCOTuner::removeResultQueue(ResultQueue* queue)
+{
+    const ScopedLock sl(analysisLock);
+    resultQueues.removeFirstMatchingValue(queue);
+}
+
+//==============================================================================
+VCOTuner::ResultQueue::ResultQueue(int capacity)
+: fifo(capacity + 1), buffer((size_t) capacity + 1), numDropped(0)
+{
+}
+
+void VCOTuner::ResultQueue::push(const measurement_t& m)
+{
+    if (fifo.getFreeSpace() < 1)
+    {
+        numDropped++;
+        return;
+    }
+    
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    buffer[start1] = m;
+    fifo.finishedWrite(1);
+}
+
+bool VCOTuner::ResultQueue::pop(measurement_t& m)
+{
+    if (fifo.getNumReady() < 1)
+        return false;
+    
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+    m = buffer[start1];
+    fifo.finishedRead(1);
+    return true;
+}
+
+//==============================================================================
+
+void VCOTuner::toggleState()
+{
+    const ScopedLock sl(analysisLock);
+    
+    if (!isRunning())
+    {
+        calibrating = false;
+        switchState(prepRefMeasurement);
+    }
+    else
+    {
+        switchState(stopped);
+    }
+    scheduleUpdate();
+}
+
+void VCOTuner::start()
+{
+    const ScopedLock sl(analysisLock);
+    
+    if (!isRunning())
+    {
+        calibrating = false;
+        switchState(prepRefMeasurement);
+    }
+    scheduleUpdate();
+}
+
+void VCOTuner::startCalibration()
+{
+    const ScopedLock sl(analysisLock);
+    
+    if (isRunning())
+        switchState(stopped);
+    calibrating = true;
+    switchState(prepRefMeasurement);
+    scheduleUpdate();
+}
+
+void VCOTuner::stop()
+{
+    const ScopedLock sl(analysisLock);
+    
+    if (isRunning())
+        switchState(stopped);
+    scheduleUpdate();
+}
+
+void VCOTuner::startSingleMeasurement(int pitch)
+{
+    const ScopedLock sl(analysisLock);
+    
+    if (state != stopped && state != finished)
+        switchState(stopped);
+    
+    singleMeasurementPitch = pitch;
+    for (int i = 0; i < numLanes; i++)
+        lanes[i]->singleMeasurementResult = -1;
+    
+    switchState(prepareSingleMeasurement);
+    scheduleUpdate();
+}
+
+void VCOTuner::setUsesVirtualClock(bool shouldUseVirtualClock)
+{
+    // the state machine must not be running while the clock is switched
+    jassert(!isRunning());
+    
+    virtualClock = shouldUseVirtualClock;
+    virtualTime = 0;
+    stateStartTime = getCurrentTimeMs();
+    
+    wakeUpPoller.stopTimer();
+    stopTimer();
+    cancelPendingUpdate();
+}
+
+void VCOTuner::advanceClock(double elapsedMilliseconds)
+{
+    jassert(virtualClock);
+    
+    virtualTime += elapsedMilliseconds;
+    runStateMachine();
+}
+
+double VCOTuner::getCurrentTimeMs() const
+{
+    if (virtualClock)
+        return virtualTime;
+    return Time::getMillisecondCounterHiRes();
+}
+
+void VCOTuner::scheduleUpdate()
+{
+    // with a virtual clock, the next advanceClock() does the update
+    if (!virtualClock)
+        triggerAsyncUpdate();
+}
+
+void VCOTuner::setAnalysisPool(ThreadPool* pool)
+{
+    removeAnalysisJobs();
+    analysisPool = pool;
+}
+
+void VCOTuner::removeAnalysisJobs()
+{
+    if (analysisPool == nullptr)
+        return;
+    
+    // only the jobs of this tuner, the pool may be shared
+    struct Selector: public ThreadPool::JobSelector
+    {
+        Selector(VCOTuner& t) : tuner(t) {}
+        bool isJobSuitable(ThreadPoolJob* job) override
+        {
+            AnalysisJob* analysisJob = dynamic_cast<AnalysisJob*>(job);
+            return analysisJob != nullptr && &analysisJob->tuner == &tuner;
+        }
+        VCOTuner& tuner;
+    };
+    Selector selector(*this);
+    analysisPool->removeAllJobs(true, 10000, &selector);
+    analysisPending = false;
+}
+
+TunerTelemetry::Snapshot VCOTuner::getTelemetry() const
+{
+    const ScopedLock sl(analysisLock);
+    return telemetry.getSnapshot(getCurrentTimeMs(), getDeviceXRunCount());
+}
+
+void VCOTuner::resetTelemetry()
+{
+    const ScopedLock sl(analysisLock);
+    telemetry.reset(getCurrentTimeMs(), getDeviceXRunCount());
+}
+
+int VCOTuner::getDeviceXRunCount() const
+{
+    if (AudioIODevice* device = deviceManager->getCurrentAudioDevice())
+        return device->getXRunCount();
+    return -1;
+}
+
+ThreadPoolJob::JobStatus VCOTuner::AnalysisJob::runJob()
+{
+    {
+        const ScopedLock sl(tuner.analysisLock);
+        tuner.processRecordedSamples();
+    }
+    
+    // clear the flag first, so that new samples that come in now start another job
+    tuner.analysisPending = false;
+    tuner.triggerAsyncUpdate();
+    return jobHasFinished;
+}
+
+void VCOTuner::handleAsyncUpdate()
+{
+    runStateMachine();
+}
+
+void VCOTuner::WakeUpPoller::hiResTimerCallback()
+{
+    if (!tuner.wakeUpPending.exchange(false))
+        return;
+    
+    // the update is only posted if there isn't one pending already
+    const int64 start = Time::getHighResolutionTicks();
+    tuner.triggerAsyncUpdate();
+    tuner.telemetry.wakeUpPosted(Time::getHighResolutionTicks() - start);
+}
+
+void VCOTuner::timerCallback()
+{
+    // the deadline of the current state has passed
+    stopTimer();
+    runStateMachine();
+}
+
+void VCOTuner::runStateMachine()
+{
+    const ScopedTryLock sl(analysisLock);
+    if (!sl.isLocked())
+        return; // the analysis job wakes us up again when it is done
+    
+    telemetry.stateMachineWokeUp();
+    
+    if (analysisPool != nullptr && !virtualClock)
+    {
+        // the results are picked up the next time the state machine runs
+        if (hasNewSamples() && !analysisPending.exchange(true))
+            analysisPool->addJob(new AnalysisJob(*this), true);
+    }
+    else
+        processRecordedSamples();
+    
+    // run all states that follow each other immediately, e.g. from the end of a measurement
+    // straight to the note on of the next one
+    State previousState;
+    do
+    {
+        previousState = state;
+        processState();
+    }
+    while (state != previousState);
+    
+    // wake up again when the current state times out
+    const double deadline = getStateDeadline();
+    if (virtualClock || deadline < 0)
+        stopTimer();
+    else
+        startTimer(jmax(1, (int) std::ceil(deadline - getCurrentTimeMs())));
+}
+
+double VCOTuner::getStateDeadline() const
+{
+    if (state != refMeasurement && state != measurement && state != singleMeasurement && state != calibration
+        && state != refRemeasurement)
+        return -1; // no timeout
+    
+    // wait for the slowest lane
+    double deadline = -1;
+    for (int i = 0; i < numLanes; i++)
+    {
+        const Lane& lane = *lanes[i];
+        if (!lane.active || !lane.measuring)
+            continue;
+        
+        double minimumMs = 10000;
+        if (state == measurement || state == calibration)
+        {
+            float expectedFrequency = lane.referenceFrequency * powf(2,((float) currentPitch - (float) referencePitch)/12.0f);
+            float expectedTime = 1.0f / (float) expectedFrequency * numPeriodSamples;
+            expectedTime *= 2;
+            minimumMs = expectedTime * 1000;
+        }
+        deadline = jmax(deadline, getMeasurementDeadline(lane, minimumMs));
+    }
+    return deadline;
+}
+
+double VCOTuner::getProgress() const
+{
+    switch (state)
+    {
+        case prepMeasurement:
+        case measurement:
+        case prepCalibration:
+        case calibration:
+        case prepRefRemeasurement:
+        case refRemeasurement:
+        {
+            // the reference measurement counts as one more note
+            return jmin(1.0, (currentIndex + 1) / (double) (plannedPitches.size() + 1));
+        }
+        case finished:
+            return 1.0;
+        default:
+            return 0.0;
+    }
+}
+
+bool VCOTuner::isPastDeadline() const
+{
+    const double deadline = getStateDeadline();
+    return deadline >= 0 && getCurrentTimeMs() >= deadline;
+}
+
+StringArray VCOTuner::getLastErrors()
+{
+    StringArray tmp = errors;
+    errors.clear();
+    return tmp;
+}
+
+void VCOTuner::processState()
+{
+    switch (state)
+    {
+        case stopped:
+            break;
+        case prepRefMeasurement:
+            // send reference midi note and start measuring right away,
+            // the measurement waits for the oscillator to settle
+            referencePitch = (highestPitch + lowestPitch) / 2;
+            currentPitch = referencePitch;
+            if (startNote(currentPitch))
+                switchState(refMeasurement);
+            break;
+        case refMeasurement:
+        {
+            failTimedOutLanes();
+            if (stopIfNoLaneIsLeft())
+                break;
+            
+            // wait until all lanes are done
+            if (isAnyLaneMeasuring())
+                break;
+            
+            // send note off
+            sendNoteOffs();
+            
+            for (int i = 0; i < numLanes; i++)
+            {
+                Lane& lane = *lanes[i];
+                if (!lane.active)
+                    continue;
+                
+                if (lane.lError == notStable)
+                {
+                    laneFailed(i, Errors::highJitter);
+                    continue;
+                }
+                lane.referenceFrequency = float(getMeasuredFrequency(lane));
+                lane.referencePoints.add({ getMeasurementTime(lane), getMeasuredFrequency(lane) });
+            }
+            if (stopIfNoLaneIsLeft())
+                break;
+            lastReferenceTime = getCurrentTimeMs();
+            
+            // prepare next measurement
+            planSweep();
+            currentIndex = 0;
+            if (plannedPitches.isEmpty())
+            {
+                switchState(finished);
+                break;
+            }
+            currentPitch = plannedPitches.getFirst();
+            if (calibrating)
+            {
+                // the reference pitch is in tune by definition, it's the first seed
+                for (int i = 0; i < numLanes; i++)
+                {
+                    lanes[i]->seedPitches[0] = referencePitch;
+                    lanes[i]->seedCorrections[0] = 0;
+                    lanes[i]->numSeeds = 1;
+                    lanes[i]->correctionGain = 1.0;
+                }
+                switchState(prepCalibration);
+            }
+            else
+                switchState(prepMeasurement);
+            break;
+        }
+        case prepMeasurement:
+            // send midi note and start measuring right away
+            if (startNote(currentPitch))
+                switchState(measurement);
+            break;
+        case measurement:
+        {
+            failTimedOutLanes();
+            if (stopIfNoLaneIsLeft())
+                break;
+            
+            // wait until all lanes are done
+            if (isAnyLaneMeasuring())
+                break;
+            
+            // send note off
+            sendNoteOffs();
+            
+            for (int i = 0; i < numLanes; i++)
+            {
+                Lane& lane = *lanes[i];
+                if (!lane.active)
+                    continue;
+                
+                if (lane.lError == notStable)
+                {
+                    laneFailed(i, Errors::highJitter);
+                    continue;
+                }
+                
+                double frequency = getMeasuredFrequency(lane);
+                double pitch = 12.0 * log(frequency / lane.referenceFrequency) / log(2.0) + referencePitch;
+                
+                // check if the frequency has changed compared to the reference frequency
+                // if not, it is likely that the MIDI output is not working
+                if (!checkPitchChange(lane, frequency))
+                {
+                    laneFailed(i, Errors::noFrequencyChangeBetweenMeasurements);
+                    continue;
+                }
+                
+                reportMeasurement(createMeasurement(i, frequency, pitch));
+            }
+            if (stopIfNoLaneIsLeft())
+                break;
+            
+            // prepare next measurement
+            currentIndex++;
+            if (currentIndex < plannedPitches.size())
+                currentPitch = plannedPitches[currentIndex];
+            
+            if (isReferenceDue())
+                switchState(prepRefRemeasurement);
+            else if (currentIndex < plannedPitches.size())
+                switchState(prepMeasurement);
+            else
+                switchState(finished);
+            break;
+        }
+        case prepRefRemeasurement:
+            if (startNote(referencePitch))
+                switchState(refRemeasurement);
+            break;
+        case refRemeasurement:
+        {
+            failTimedOutLanes();
+            if (stopIfNoLaneIsLeft())
+                break;
+            
+            // wait until all lanes are done
+            if (isAnyLaneMeasuring())
+                break;
+            
+            sendNoteOffs();
+            
+            // the drift up to now is known, so are the results since the last time
+            for (int i = 0; i < numLanes; i++)
+            {
+                Lane& lane = *lanes[i];
+                if (!lane.active)
+                    continue;
+                
+                if (lane.lError == notStable)
+                {
+                    laneFailed(i, Errors::highJitter);
+                    continue;
+                }
+                lane.referencePoints.add({ getMeasurementTime(lane), getMeasuredFrequency(lane) });
+                reportPendingMeasurements(i);
+            }
+            if (stopIfNoLaneIsLeft())
+                break;
+            lastReferenceTime = getCurrentTimeMs();
+            
+            if (currentIndex < plannedPitches.size())
+                switchState(prepMeasurement);
+            else
+                switchState(finished);
+            break;
+        }
+        case finished:
+            break;
+        case prepCalibration:
+            // the correction goes out with the note on
+            for (int i = 0; i < numLanes; i++)
+            {
+                if (lanes[i]->active)
+                    startCalibratingNote(*lanes[i]);
+            }
+            if (startNote(currentPitch))
+                switchState(calibration);
+            break;
+        case calibration:
+        {
+            failTimedOutLanes();
+            if (stopIfNoLaneIsLeft())
+                break;
+            
+            // wait until all lanes are done
+            if (isAnyLaneMeasuring())
+                break;
+            
+            bool isAnyLaneLeft = false;
+            for (int i = 0; i < numLanes; i++)
+            {
+                Lane& lane = *lanes[i];
+                if (!lane.active || lane.calibrated)
+                    continue;
+                
+                if (lane.lError == notStable)
+                {
+                    laneFailed(i, Errors::highJitter);
+                    continue;
+                }
+                
+                double frequency = getMeasuredFrequency(lane);
+                double pitch = 12.0 * log(frequency / lane.referenceFrequency) / log(2.0) + referencePitch;
+                
+                // as for a sweep, the MIDI output must have changed the pitch
+                if (lane.numAttempts == 0 && !checkPitchChange(lane, frequency))
+                {
+                    laneFailed(i, Errors::noFrequencyChangeBetweenMeasurements);
+                    continue;
+                }
+                
+                lane.numAttempts++;
+                if (updateCorrection(lane, createMeasurement(i, frequency, pitch)))
+                {
+                    isAnyLaneLeft = true;
+                    continue;
+                }
+                
+                lane.calibrated = true;
+                lane.seedPitches[1] = lane.seedPitches[0];
+                lane.seedCorrections[1] = lane.seedCorrections[0];
+                lane.seedPitches[0] = currentPitch;
+                lane.seedCorrections[0] = lane.correction;
+                lane.numSeeds = jmin(2, lane.numSeeds + 1);
+                
+                // the correction may have gone back to an earlier attempt
+                reportMeasurement(lane.bestMeasurement);
+                calibration_t c;
+                c.lane = i;
+                c.midiPitch = currentPitch;
+                c.correction = lane.correction;
+                c.residual = lane.bestError;
+                c.numAttempts = lane.numAttempts;
+                c.converged = std::abs(lane.bestError) * 100.0 <= calibrationTolerance;
+                listeners.call(&Listener::newCalibrationReady, c);
+            }
+            if (stopIfNoLaneIsLeft())
+                break;
+            
+            if (isAnyLaneLeft)
+            {
+                // only the corrections change, the notes keep playing
+                for (int i = 0; i < numLanes && state == calibration; i++)
+                {
+                    if (lanes[i]->active && !lanes[i]->calibrated)
+                        trySendCorrection(*lanes[i]);
+                }
+                if (state != calibration)
+                    break; // sending failed and the tuner was stopped
+                
+                // every attempt gets the full time
+                stateStartTime = getCurrentTimeMs();
+                startMeasuring(currentPitch);
+                break;
+            }
+            
+            sendNoteOffs();
+            
+            // prepare next note
+            currentIndex++;
+            if (currentIndex < plannedPitches.size())
+            {
+                currentPitch = plannedPitches[currentIndex];
+                switchState(prepCalibration);
+            }
+            else
+                switchState(finished);
+            break;
+        }
+        case prepareContinuousFrequencyMeasurement:
+        {
+            // send midi note and start measuring
+            if (startNote(continuousFrequencyMeasurementPitch))
+                switchState(continuousFrequencyMeasurement);
+        } break;
+        case continuousFrequencyMeasurement:
+        {
+            // if the measurement is done on all lanes
+            if (!isAnyLaneMeasuring())
+            {
+                for (int i = 0; i < numLanes; i++)
+                {
+                    Lane& lane = *lanes[i];
+                    if (lane.periodStatistics.getNumValues() > 0)
+                    {
+                        lane.continuousFreqMeasurementResult = getMeasuredFrequency(lane);
+                        lane.continuousFreqMeasurementDeviation = getMeasuredFrequencyDeviation(lane);
+                    }
+                }
+                
+                // restart measurement
+                startMeasuring(continuousFrequencyMeasurementPitch);
+            }
+        } break;
+        case prepareSingleMeasurement:
+        {
+            // send midi note and start measuring right away
+            if (startNote(singleMeasurementPitch))
+                switchState(singleMeasurement);
+        } break;
+        case singleMeasurement:
+        {
+            // timeout handling
+            failTimedOutLanes();
+            if (stopIfNoLaneIsLeft())
+                break;
+            
+            // wait until all lanes are done
+            if (isAnyLaneMeasuring())
+                break;
+            
+            // send note off
+            sendNoteOffs();
+            
+            for (int i = 0; i < numLanes; i++)
+            {
+                Lane& lane = *lanes[i];
+                if (!lane.active)
+                    continue;
+                
+                if (lane.lError == notStable)
+                {
+                    laneFailed(i, Errors::highJitter);
+                    continue;
+                }
+                lane.singleMeasurementResult = getMeasuredFrequency(lane);
+                lane.singleMeasurementDeviation = getMeasuredFrequencyDeviation(lane);
+            }
+            if (stopIfNoLaneIsLeft())
+                break;
+            
+            switchState(finished);
+        } break;
+        default:
+            state = stopped;
+            break;
+    }
+}
+
+void VCOTuner::failTimedOutLanes()
+{
+    if (!isPastDeadline())
+        return;
+    
+    for (int i = 0; i < numLanes; i++)
+    {
+        Lane& lane = *lanes[i];
+        if (!lane.active || !lane.measuring)
+            continue;
+        
+        if (lane.numPeriods == 0)
+            laneFailed(i, Errors::noZeroCrossings);
+        else if (lane.lError == notStable)
+            laneFailed(i, Errors::highJitterTimeOut);
+        else
+            laneFailed(i, Errors::stableTimeout);
+    }
+}
+
+void VCOTuner::laneFailed(int laneIndex, const String& error)
+{
+    Lane& lane = *lanes[laneIndex];
+    
+    // tell the user which oscillator is affected
+    if (numLanes > 1)
+        addError("Input " + String(lane.setup.inputChannel + 1) + ": " + error);
+    else
+        addError(error);
+    
+    lane.active = false;
+    finishLane(lane, TunerTelemetry::failed);
+    // what was measured before stays valid, with the drift that is known so far
+    reportPendingMeasurements(laneIndex);
+    if (!isAnyLaneMeasuring())
+        stopMeasuring();
+}
+
+bool VCOTuner::stopIfNoLaneIsLeft()
+{
+    for (int i = 0; i < numLanes; i++)
+    {
+        if (lanes[i]->active)
+            return false;
+    }
+    
+    switchState(stopped);
+    return true;
+}
+
+bool VCOTuner::isAnyLaneMeasuring() const
+{
+    for (int i = 0; i < numLanes; i++)
+    {
+        if (lanes[i]->active && lanes[i]->measuring)
+            return true;
+    }
+    return false;
+}
+
+void VCOTuner::startContinuousMeasurement(int pitch)
+{
+    const ScopedLock sl(analysisLock);
+    
+    continuousFrequencyMeasurementPitch = pitch;
+    if (state != stopped && state != finished)
+        switchState(stopped);
+    switchState(prepareContinuousFrequencyMeasurement);
+    scheduleUpdate();
+}
+
+bool VCOTuner::startNote(int pitch)
+{
+    const State startState = state;
+    for (int i = 0; i < numLanes && state == startState; i++)
+    {
+        if (lanes[i]->active)
+            trySendMidiNoteOn(i, pitch);
+    }
+    
+    // sending failed and the tuner was stopped
+    if (state != startState)
+        return false;
+    if (stopIfNoLaneIsLeft())
+        return false;
+    
+    startMeasuring(pitch);
+    return true;
+}
+
+void VCOTuner::sendNoteOffs()
+{
+    for (int i = 0; i < numLanes; i++)
+    {
+        if (lanes[i]->currentlyPlayingMidiNote >= 0)
+            trySendMidiNoteOff(*lanes[i]);
+    }
+}
+
+void VCOTuner::trySendMidiNoteOn(int laneIndex, int pitch)
+{
+    Lane& lane = *lanes[laneIndex];
+    if (lane.currentlyPlayingMidiNote != -1)
+    {
+        if (!trySendMidiNoteOff(lane))
+            return;
+    }
+    
+    const int note = pitch + lane.setup.noteOffset;
+    if (note < 0 || note > 127)
+    {
+        laneFailed(laneIndex, Errors::noteOutOfRange);
+        return;
+    }
+    
+    // the correction must be in place when the note arrives
+    if (calibrating && !trySendCorrection(lane))
+        return;
+    
+    if (trySendMidiMessage(MidiMessage::noteOn(lane.setup.midiChannel, note, (uint8_t) 100)))
+        lane.currentlyPlayingMidiNote = note;
+}
+
+bool VCOTuner::trySendMidiNoteOff(Lane& lane)
+{
+    // reset first - a failing note off stops the tuner which would otherwise try again
+    const int note = lane.currentlyPlayingMidiNote;
+    lane.currentlyPlayingMidiNote = -1;
+    return trySendMidiMessage(MidiMessage::noteOff(lane.setup.midiChannel, note));
+}
+
+bool VCOTuner::trySendMidiMessage(const MidiMessage& message)
+{
+    if (midiSink != nullptr)
+    {
+        midiSink->sendMessageNow(message);
+        return true;
+    }
+    
+    MidiOutput* midiOut = deviceManager->getDefaultMidiOutput();
+    if (midiOut == nullptr)
+    {
+        addError(Errors::noMidiDeviceAvailable);
+        switchState(stopped);
+        return false;
+    }
+    
+    midiOut->sendMessageNow(message);
+    return true;
+}
+
+VCOTuner::measurement_t VCOTuner::createMeasurement(int laneIndex, double frequency, double pitch) const
+{
+    const Lane& lane = *lanes[laneIndex];
+    
+    measurement_t m;
+    m.timestamp = Time::getCurrentTime();
+    m.lane = laneIndex;
+    m.frequency = frequency;
+    m.rawFrequency = frequency;
+    m.pitch = pitch;
+    m.midiPitch = currentPitch;
+    m.pitchOffset = pitch - currentPitch;
+    m.rawPitchOffset = m.pitchOffset;
+    m.freqDeviation = getMeasuredFrequencyDeviation(lane);
+    m.pitchDeviation = getMeasuredPitchDeviation(lane);
+    m.pitchConfidenceInterval = getMeasuredPitchConfidenceInterval(lane);
+    m.numMeasurements = lane.periodStatistics.getNumValues();
+    m.settleTime = lane.settleDetector.getSettleTimeMs();
+    m.settleWaitTime = lane.settleDetector.getDetectionTimeMs();
+    return m;
+}
+
+void VCOTuner::reportMeasurement(const measurement_t& m)
+{
+    Lane& lane = *lanes[m.lane];
+    if (referenceInterval > 0 && !calibrating)
+        lane.pendingMeasurements.add({ m, getMeasurementTime(lane) });
+    else
+        deliverMeasurement(m);
+}
+
+void VCOTuner::reportPendingMeasurements(int laneIndex)
+{
+    Lane& lane = *lanes[laneIndex];
+    
+    // a listener may stop the tuner, which reports the rest
+    const Array<PendingMeasurement> pending(lane.pendingMeasurements);
+    lane.pendingMeasurements.clear();
+    for (const PendingMeasurement& p : pending)
+    {
+        measurement_t m = p.m;
+        const double drift = getReferenceDriftAt(lane, p.time);
+        m.pitch -= drift;
+        m.pitchOffset -= drift;
+        m.frequency = m.rawFrequency * pow(2.0, -drift / 12.0);
+        deliverMeasurement(m);
+    }
+}
+
+void VCOTuner::deliverMeasurement(const measurement_t& m)
+{
+    // the queues first, a listener may stop the tuner
+    for (ResultQueue* queue : resultQueues)
+        queue->push(m);
+    
+    currentStatus.numResults++;
+    currentStatus.lastResult = m;
+    publishStatus();
+    
+    listeners.call(&Listener::newMeasurementReady, m);
+}
+
+double VCOTuner::getMeasurementTime(const Lane& lane) const
+{
+    const double now = getCurrentTimeMs();
+    return lane.settleDetector.isSettled() ? (lane.stableTime + now) / 2 : now;
+}
+
+double VCOTuner::getReferenceDriftAt(const Lane& lane, double time) const
+{
+    const Array<ReferencePoint>& points = lane.referencePoints;
+    if (points.size() < 2 || time <= points.getReference(0).time)
+        return 0;
+    
+    auto getDrift = [&points] (int i)
+    {
+        return 12.0 * log(points.getReference(i).frequency / points.getReference(0).frequency) / log(2.0);
+    };
+    for (int i = 1; i < points.size(); i++)
+    {
+        const ReferencePoint& next = points.getReference(i);
+        if (time <= next.time)
+        {
+            const ReferencePoint& previous = points.getReference(i - 1);
+            const double alpha = next.time > previous.time ? (time - previous.time) / (next.time - previous.time) : 1.0;
+            return getDrift(i - 1) + alpha * (getDrift(i) - getDrift(i - 1));
+        }
+    }
+    return getDrift(points.size() - 1);
+}
+
+double VCOTuner::getReferenceDrift(int laneIndex) const
+{
+    const Lane& lane = *lanes[laneIndex];
+    if (lane.referencePoints.size() < 2)
+        return 0;
+    return getReferenceDriftAt(lane, lane.referencePoints.getLast().time);
+}
+
+double VCOTuner::getMaxReferenceStep(int laneIndex) const
+{
+    const Array<ReferencePoint>& points = lanes[laneIndex]->referencePoints;
+    double maxStep = 0;
+    for (int i = 1; i < points.size(); i++)
+        maxStep = jmax(maxStep, std::abs(12.0 * log(points.getReference(i).frequency / points.getReference(i - 1).frequency) / log(2.0)));
+    return maxStep;
+}
+
+bool VCOTuner::isReferenceDue() const
+{
+    if (referenceInterval <= 0 || calibrating)
+        return false;
+    
+    // the last results need a reference after them as well
+    return currentIndex >= plannedPitches.size() || getCurrentTimeMs() - lastReferenceTime >= referenceInterval * 1000.0;
+}
+
+bool VCOTuner::checkPitchChange(Lane& lane, double frequency)
+{
+    if (lane.pitchChangeChecked || std::abs(currentPitch - referencePitch) < minimumCheckedInterval)
+        return true;
+    
+    lane.pitchChangeChecked = true;
+    return std::abs(frequency - lane.referenceFrequency) / lane.referenceFrequency >= 0.1;
+}
+
+void VCOTuner::planSweep()
+{
+    // the notes wait for the slowest oscillator
+    Array<const SweepPlanner::SettleModel*> models;
+    for (int i = 0; i < numLanes; i++)
+    {
+        if (lanes[i]->active)
+            models.add(&lanes[i]->settleModel);
+    }
+    plannedPitches = SweepPlanner::plan(sweepOrder, lowestPitch, pitchIncrement, highestPitch,
+                                        referencePitch, models, plannerRandom);
+}
+
+//==============================================================================
+void VCOTuner::startCalibratingNote(Lane& lane)
+{
+    // along the line through the last two notes that are done. The errors of neighbouring
+    // notes are similar, so most notes are close after the first attempt.
+    double correction = lane.numSeeds > 0 ? lane.seedCorrections[0] : 0.0;
+    if (lane.numSeeds > 1 && lane.seedPitches[0] != lane.seedPitches[1])
+    {
+        const double slope = (lane.seedCorrections[0] - lane.seedCorrections[1]) / (lane.seedPitches[0] - lane.seedPitches[1]);
+        correction += slope * (currentPitch - lane.seedPitches[0]);
+    }
+    
+    lane.correction = quantiseCorrection(correction);
+    lane.previousCorrection = lane.correction;
+    lane.previousError = 0;
+    lane.numAttempts = 0;
+    lane.calibrated = false;
+}
+
+bool VCOTuner::updateCorrection(Lane& lane, const measurement_t& m)
+{
+    const double error = m.pitchOffset;
+    
+    // the gain is kept from note to note. It is only 1 if the pitch bend range is right.
+    if (lane.numAttempts > 1)
+    {
+        const double step = lane.correction - lane.previousCorrection;
+        if (std::abs(step) >= minimumSecantStep)
+        {
+            const double gain = (error - lane.previousError) / step;
+            if (gain >= minimumCorrectionGain && gain <= maximumCorrectionGain)
+                lane.correctionGain = gain;
+            else if (gain < minimumCorrectionGain) // the step was lost in the steps of the DAC, take a bigger one
+                lane.correctionGain = jmax(minimumCorrectionGain, lane.correctionGain * 0.5);
+        }
+    }
+    lane.previousCorrection = lane.correction;
+    lane.previousError = error;
+    if (lane.numAttempts == 1 || std::abs(error) < std::abs(lane.bestError))
+    {
+        lane.bestCorrection = lane.correction;
+        lane.bestError = error;
+        lane.bestMeasurement = m;
+    }
+    
+    if (std::abs(error) * 100.0 <= calibrationTolerance)
+        return false;
+    
+    // at the end of the range or below the resolution of the interface, there's nothing
+    // left to try. Noise or a coarse DAC can make the last attempt worse than an earlier one.
+    const double next = quantiseCorrection(lane.correction - error / lane.correctionGain);
+    if (next == lane.correction || lane.numAttempts >= maxNumCalibrationAttempts)
+    {
+        lane.correction = lane.bestCorrection;
+        return false;
+    }
+    
+    lane.correction = next;
+    return true;
+}
+
+int VCOTuner::getCorrectionValue(double semitones) const
+{
+    // fine tuning always spans +/- 1 semitone
+    const double range = correctionMessage == pitchBend ? pitchBendRange : 1.0;
+    return jlimit(0, 16383, neutralCorrectionValue + roundToInt(semitones / range * neutralCorrectionValue));
+}
+
+double VCOTuner::quantiseCorrection(double semitones) const
+{
+    const double range = correctionMessage == pitchBend ? pitchBendRange : 1.0;
+    return (getCorrectionValue(semitones) - neutralCorrectionValue) * range / neutralCorrectionValue;
+}
+
+bool VCOTuner::trySendCorrection(Lane& lane)
+{
+    const int value = getCorrectionValue(lane.correction);
+    const int channel = lane.setup.midiChannel;
+    
+    // set first - a failing message stops the tuner, which would otherwise try again
+    lane.correctionSent = value != neutralCorrectionValue;
+    
+    if (correctionMessage == pitchBend)
+        return trySendMidiMessage(MidiMessage::pitchWheel(channel, value));
+    
+    // RPN 1 is the channel fine tuning. The null RPN at the end keeps any further
+    // data entry messages from changing it.
+    return trySendMidiMessage(MidiMessage::controllerEvent(channel, 101, 0))
+        && trySendMidiMessage(MidiMessage::controllerEvent(channel, 100, 1))
+        && trySendMidiMessage(MidiMessage::controllerEvent(channel, 6, value >> 7))
+        && trySendMidiMessage(MidiMessage::controllerEvent(channel, 38, value & 0x7f))
+        && trySendMidiMessage(MidiMessage::controllerEvent(channel, 101, 127))
+        && trySendMidiMessage(MidiMessage::controllerEvent(channel, 100, 127));
+}
+
+void VCOTuner::resetCorrections()
+{
+    for (int i = 0; i < maxNumLanes; i++)
+    {
+        Lane& lane = *lanes[i];
+        lane.correction = 0;
+        if (lane.correctionSent)
+            trySendCorrection(lane);
+    }
+}
+
+/** inherited from AudioIODeviceCallback */
+void VCOTuner::audioDeviceIOCallback (const float** inputChannelData,
+                                    int numInputChannels,
+                                    float** outputChannelData,
+                                    int numOutputChannels,
+                                    int numSamples)
+{
+    if (inputChannelData == nullptr)
+        return;
+    const int64 callbackStart = Time::getHighResolutionTicks();
+    const AudioBuffer<const float> inputBuffer(inputChannelData, numInputChannels, numSamples);
+
+    // see if the message thread wants us to start or stop recording
+    const int requested = requestedMeasurement.load();
+    if (requested != recordedMeasurement)
+    {
+        recordedMeasurement = requested;
+        numRecordedLanes = numLanes.load();
+        for (int i = 0; i < maxNumLanes; i++)
+        {
+            lanes[i]->recordingOverflowed = false;
+            lanes[i]->recordedInputChannel = lanes[i]->setup.inputChannel;
+        }
+        if (requested != 0)
+            telemetry.recordingStarted();
+    }
+    
+    if (recordedMeasurement != 0)
+    {
+        bool hasNews = false;
+        for (int i = 0; i < numRecordedLanes; i++)
+        {
+            Lane& lane = *lanes[i];
+            if (lane.recordedInputChannel < numInputChannels)
+                hasNews = recordLane(lane, inputBuffer.getReadPointer(lane.recordedInputChannel), numSamples) || hasNews;
+        }
+        
+        // wake up the state machine, see WakeUpPoller
+        if (hasNews && !virtualClock)
+        {
+            telemetry.wakeUpRequested();
+            wakeUpPending.store(true);
+        }
+    }
+
+    if (outputChannelData != nullptr)
+    { 
+    	AudioBuffer<float> outputBuffer(outputChannelData, numOutputChannels, numSamples);
+    	outputBuffer.clear();
+    }
+    
+    telemetry.audioCallbackFinished(Time::getHighResolutionTicks() - callbackStart, numSamples, sampleRate);
+}
+
+bool VCOTuner::recordLane(Lane& lane, const float* samples, int numSamples)
+{
+    if (lane.recordingOverflowed)
+        return false;
+    
+    // the message thread didn't keep up - don't pass on an incomplete measurement
+    if (numSamples > lane.sampleFifo.getFreeSpace() || lane.blockFifo.getFreeSpace() < 1)
+    {
+        lane.recordingOverflowed = true;
+        lane.overflowedMeasurement.store(recordedMeasurement);
+        return true;
+    }
+    
+    int start1, size1, start2, size2;
+    lane.sampleFifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    FloatVectorOperations::copy(lane.sampleFifoBuffer + start1, samples, size1);
+    FloatVectorOperations::copy(lane.sampleFifoBuffer + start2, samples + size1, size2);
+    lane.sampleFifo.finishedWrite(size1 + size2);
+    
+    lane.blockFifo.prepareToWrite(1, start1, size1, start2, size2);
+    lane.blockFifoBuffer[start1] = { recordedMeasurement, numSamples };
+    lane.blockFifo.finishedWrite(1);
+    return numSamples > 0;
+}
+
+void VCOTuner::startMeasuring(int pitch)
+{
+    for (int i = 0; i < numLanes; i++)
+    {
+        Lane& lane = *lanes[i];
+        finishLane(lane, TunerTelemetry::abandoned);
+        lane.lError = noError;
+        lane.numPeriods = 0;
+        lane.stableTime = 0;
+        lane.stablePosition = 0;
+        lane.noteOnTime = getCurrentTimeMs();
+        lane.firstPeriodTime = 0;
+        lane.numUnsettledPeriods = 0;
+        lane.periodStatistics.reset();
+        lane.frequencyStatistics.reset();
+        lane.logFrequencyStatistics.reset();
+        
+        // if we know where the oscillator comes from, wait until it has left there.
+        // Otherwise at least wait until the note on can have had an effect on the input.
+        // The small steps of a calibration can't be told apart from the jitter, so they
+        // always get that time as well.
+        const double playedPitch = pitch + lane.correction;
+        const double minimumSettleTimeMs = inputLatencySamples * 1000.0 / sampleRate + minimumSettleMarginMs;
+        double expectedPeriodLength = 0;
+        lane.hasJump = lane.previousPeriodLength > 0;
+        lane.jump = lane.hasJump ? playedPitch - lane.previousPitch : 0;
+        lane.predictedSettleTimeMs = 0;
+        if (lane.hasJump)
+        {
+            // jumps like this one have settled after some time before. Looking at the periods
+            // only after half of it keeps e.g. the thermal tail of a big jump from being taken
+            // for a settled note.
+            double settleWaitMs = calibrating ? minimumSettleTimeMs : 0;
+            if (lane.settleModel.canPredict(lane.jump))
+            {
+                lane.predictedSettleTimeMs = lane.settleModel.getSettleTimeMs(lane.jump);
+                settleWaitMs = jmax(settleWaitMs, predictedSettleWaitFraction * lane.predictedSettleTimeMs);
+            }
+            
+            const double departure = std::abs(lane.jump) / 12.0 / 4.0;
+            lane.settleDetector.reset(sampleRate, lane.previousPeriodLength, departure, settleWaitMs);
+            expectedPeriodLength = lane.previousPeriodLength * pow(2.0, (lane.previousPitch - playedPitch) / 12.0);
+        }
+        else
+        {
+            lane.settleDetector.reset(sampleRate, 0, 0, minimumSettleTimeMs);
+        }
+        
+        if (lane.estimatorType != estimatorType)
+        {
+            lane.estimator = FrequencyEstimator::create(estimatorType);
+            lane.estimatorType = estimatorType;
+        }
+        lane.estimator->setConditioning(conditioning);
+        lane.estimator->reset(sampleRate, expectedPeriodLength);
+        // the lanes that are done with a note of a calibration wait for the others
+        lane.measuring = lane.active && !(state == calibration && lane.calibrated);
+    }
+    measuredPitch = pitch;
+    
+    measurementId = (measurementId < std::numeric_limits<int>::max()) ? measurementId + 1 : 1;
+    telemetry.measurementRequested();
+    requestedMeasurement.store(measurementId);
+    
+    // it keeps running from note to note until the tuner stops
+    if (!virtualClock && !wakeUpPoller.isTimerRunning())
+        wakeUpPoller.startTimer(wakeUpPollIntervalMs);
+}
+
+void VCOTuner::stopMeasuring()
+{
+    for (int i = 0; i < maxNumLanes; i++)
+        finishLane(*lanes[i], TunerTelemetry::abandoned);
+    requestedMeasurement.store(0);
+}
+
+void VCOTuner::finishLane(Lane& lane, TunerTelemetry::Outcome outcome)
+{
+    if (!lane.measuring)
+        return;
+    lane.measuring = false;
+    
+    // the phases end when the first period was found and when the oscillator had settled
+    const double now = getCurrentTimeMs();
+    const bool settled = lane.settleDetector.isSettled();
+    const double firstPeriodTime = lane.numPeriods > 0 ? lane.firstPeriodTime : now;
+    const double stableTime = settled ? lane.stableTime : now;
+    
+    TunerTelemetry::NoteTiming note;
+    note.lane = lanes.indexOf(&lane);
+    note.midiPitch = measuredPitch;
+    note.lockMs = firstPeriodTime - lane.noteOnTime;
+    note.settleMs = stableTime - firstPeriodTime;
+    note.collectMs = now - stableTime;
+    note.numDiscardedPeriods = settled ? lane.numUnsettledPeriods : lane.numPeriods;
+    note.numValidPeriods = lane.periodStatistics.getNumValues();
+    note.outcome = outcome;
+    telemetry.addNote(note);
+}
+
+bool VCOTuner::hasNewSamples() const
+{
+    for (int i = 0; i < maxNumLanes; i++)
+    {
+        const Lane& lane = *lanes[i];
+        if (lane.blockFifo.getNumReady() > 0)
+            return true;
+        if (lane.measuring && lane.overflowedMeasurement.load() == measurementId)
+            return true;
+    }
+    return false;
+}
+
+void VCOTuner::processRecordedSamples()
+{
+    const int64 analysisStart = Time::getHighResolutionTicks();
+    bool overflowed = false;
+    for (int l = 0; l < maxNumLanes; l++)
+    {
+        Lane& lane = *lanes[l];
+        
+        const int numBlocks = lane.blockFifo.getNumReady();
+        for (int b = 0; b < numBlocks; b++)
+        {
+            int start1, size1, start2, size2;
+            lane.blockFifo.prepareToRead(1, start1, size1, start2, size2);
+            const RecordedBlock block = lane.blockFifoBuffer[start1];
+            lane.blockFifo.finishedRead(1);
+            
+            lane.sampleFifo.prepareToRead(block.numSamples, start1, size1, start2, size2);
+            if (block.measurementId == measurementId && lane.measuring)
+            {
+                const float* parts[2] = { lane.sampleFifoBuffer + start1, lane.sampleFifoBuffer + start2 };
+                const int partSizes[2] = { size1, size2 };
+                for (int p = 0; p < 2; p++)
+                {
+                    for (int chunkStart = 0; chunkStart < partSizes[p] && lane.measuring; chunkStart += maxNumSamplesPerChunk)
+                    {
+                        const int chunkLength = jmin((int) maxNumSamplesPerChunk, partSizes[p] - chunkStart);
+                        const int numPeriods = lane.estimator->process(parts[p] + chunkStart, chunkLength,
+                                                                       estimatedPeriods, maxNumSamplesPerChunk / 2);
+                        for (int i = 0; i < numPeriods; i++)
+                            addPeriod(lane, estimatedPeriods[i]);
+                    }
+                }
+            }
+            lane.sampleFifo.finishedRead(size1 + size2);
+        }
+        
+        overflowed = overflowed || (lane.measuring && lane.overflowedMeasurement.load() == measurementId);
+    }
+    
+    telemetry.addAnalysisTime(Time::getHighResolutionTicks() - analysisStart);
+    
+    // some samples got lost, the periods can't be trusted - start over. The lanes
+    // share the note, so all of them are measured again.
+    if (overflowed)
+    {
+        telemetry.measurementOverflowed();
+        startMeasuring(measuredPitch);
+    }
+}
+
+void VCOTuner::addPeriod(Lane& lane, const FrequencyEstimator::Period& period)
+{
+    if (!lane.measuring)
+        return;
+    
+    const double position = period.endPosition;
+    const double periodLength = period.length;
+    lane.numPeriods++;
+    if (lane.numPeriods == 1)
+        lane.firstPeriodTime = getCurrentTimeMs();
+    
+    if (lane.settleDetector.isSettled())
+    {
+        const double frequency = sampleRate / periodLength;
+        lane.periodStatistics.add(periodLength);
+        lane.frequencyStatistics.add(frequency);
+        lane.logFrequencyStatistics.add(log2(frequency));
+        
+        // finish measurement when the required number of valid measurements are made
+        if (hasEnoughPeriods(lane, position))
+        {
+            // only the notes of a sweep. The small steps of a calibration have to wait for the
+            // input latency, and a continuous measurement doesn't jump at all.
+            if (lane.hasJump && (state == measurement || state == refRemeasurement))
+                lane.settleModel.addSettleTime(lane.jump, lane.settleDetector.getSettleTimeMs());
+            
+            lane.lError = noError;
+            lane.previousPitch = measuredPitch + lane.correction;
+            lane.previousPeriodLength = lane.periodStatistics.getMean();
+            finishLane(lane, TunerTelemetry::completed);
+            if (!isAnyLaneMeasuring())
+                stopMeasuring();
+        }
+        return;
+    }
+    
+    // see if the oscillator has settled at the new pitch
+    if (lane.settleDetector.addPeriod(position, periodLength))
+    {
+        lane.stableTime = getCurrentTimeMs();
+        lane.stablePosition = position;
+        lane.numUnsettledPeriods = lane.numPeriods;
+        return;
+    }
+    
+    // the pitch hasn't stabilized yet.
+    // assign the notStable error prematurely, just in case the top level statemachine runs into
+    // a timeout and wants to know whats going on.
+    lane.lError = notStable;
+    
+    // period length too jittery or does change constantly - stop here.
+    const double maxSettleTime = getSettleTimeoutMs(lane) * sampleRate / 1000.0;
+    if (lane.numPeriods >= maxNumUnstablePeriods && position >= maxSettleTime)
+    {
+        finishLane(lane, TunerTelemetry::failed);
+        if (!isAnyLaneMeasuring())
+            stopMeasuring();
+    }
+}
+
+double VCOTuner::getMeasuredFrequency(const Lane& lane) const
+{
+    return sampleRate / lane.periodStatistics.getMean();
+}
+
+double VCOTuner::getMeasuredFrequencyDeviation(const Lane& lane) const
+{
+    return sqrt(lane.frequencyStatistics.getVarianceAround(getMeasuredFrequency(lane)));
+}
+
+double VCOTuner::getMeasuredPitchDeviation(const Lane& lane) const
+{
+    return 12.0 * sqrt(lane.logFrequencyStatistics.getVarianceAround(log2(getMeasuredFrequency(lane))));
+}
+
+double VCOTuner::getMeasuredPitchConfidenceInterval(const Lane& lane) const
+{
+    // relative error of the mean period, converted to semitones
+    const double relativeError = lane.periodStatistics.getStandardErrorOfMean() / lane.periodStatistics.getMean();
+    return 1.96 * 12.0 * log2(1.0 + relativeError);
+}
+
+bool VCOTuner::hasEnoughPeriods(const Lane& lane, double position) const
+{
+    // the estimators don't necessarily report every single period, so count how many
+    // periods fit into the signal since the oscillator has settled
+    const double numPeriodsMeasured = (position - lane.stablePosition) / lane.periodStatistics.getMean();
+    if (numPeriodsMeasured > numPeriodSamples + 0.5)
+        return true;
+    
+    const int numValues = lane.periodStatistics.getNumValues();
+    if (targetConfidenceInterval <= 0 || numValues < minNumConfidencePeriods)
+        return false;
+    return getMeasuredPitchConfidenceInterval(lane) * 100.0 <= targetConfidenceInterval;
+}
+
+double VCOTuner::getMeasurementDeadline(const Lane& lane, double minimumMs) const
+{
+    if (!lane.settleDetector.isSettled())
+        return stateStartTime + minimumMs + getSettleTimeoutMs(lane);
+    
+    const double expectedTime = 2.0 * lane.settleDetector.getSettledPeriodLength() / sampleRate * (numPeriodSamples + 1);
+    return jmax(stateStartTime + minimumMs, lane.stableTime + expectedTime * 1000);
+}
+
+double VCOTuner::getSettleTimeoutMs(const Lane& lane) const
+{
+    return jmax(2.0 * SettleDetector::maxDepartureTimeMs, predictedSettleTimeoutFactor * lane.predictedSettleTimeMs);
+}
+
+void VCOTuner::switchState(VCOTuner::State newState)
+{
+    // the results that are still waiting for the next reference get the drift so far
+    if (newState == stopped)
+    {
+        for (int i = 0; i < maxNumLanes; i++)
+            reportPendingMeasurements(i);
+    }
+    
+    stateStartTime = getCurrentTimeMs();
+    state = newState;
+    if (state == stopped || state == finished)
+        wakeUpPoller.stopTimer();
+    if (state == stopped)
+    {
+        sendNoteOffs();
+        resetCorrections();
+        stopMeasuring();
+    }
+    else if (newState == prepRefMeasurement)
+    {
+        // the oscillators may have been changed since the last run
+        for (int i = 0; i < numLanes; i++)
+        {
+            lanes[i]->active = true;
+            lanes[i]->previousPeriodLength = 0;
+            lanes[i]->referencePoints.clearQuick();
+            lanes[i]->pendingMeasurements.clearQuick();
+            lanes[i]->pitchChangeChecked = false;
+        }
+        currentStatus.numResults = 0;
+        telemetry.reset(stateStartTime, getDeviceXRunCount());
+    }
+    else if (newState == prepareSingleMeasurement || newState == prepareContinuousFrequencyMeasurement)
+    {
+        for (int i = 0; i < numLanes; i++)
+            lanes[i]->active = true;
+    }
+    else if (newState == finished)
+        resetCorrections();
+    
+    // the status is published before anyone hears about the change
+    publishStatus();
+    if (newState == stopped)
+        listeners.call(&Listener::tunerStopped);
+    else if (newState == prepRefMeasurement)
+        listeners.call(&Listener::tunerStarted);
+    else if (newState == finished)
+        listeners.call(&Listener::tunerFinished);
+    listeners.call(&Listener::tunerStatusChanged);
+}
+
+void VCOTuner::publishStatus()
+{
+    switch (state)
+    {
+        case prepRefMeasurement:
+            // the reference is picked when the note is sent
+            currentStatus.activity = Status::measuringReference;
+            currentStatus.midiPitch = -1;
+            break;
+        case refMeasurement:
+            currentStatus.activity = Status::measuringReference;
+            currentStatus.midiPitch = referencePitch;
+            break;
+        case prepRefRemeasurement:
+        case refRemeasurement:
+            currentStatus.activity = Status::measuringDrift;
+            currentStatus.midiPitch = referencePitch;
+            break;
+        case prepMeasurement:
+        case measurement:
+            currentStatus.activity = Status::measuringNote;
+            currentStatus.midiPitch = currentPitch;
+            break;
+        case prepCalibration:
+        case calibration:
+            currentStatus.activity = Status::calibratingNote;
+            currentStatus.midiPitch = currentPitch;
+            break;
+        case prepareContinuousFrequencyMeasurement:
+        case continuousFrequencyMeasurement:
+            currentStatus.activity = Status::measuringContinuously;
+            currentStatus.midiPitch = continuousFrequencyMeasurementPitch;
+            break;
+        case prepareSingleMeasurement:
+        case singleMeasurement:
+            currentStatus.activity = Status::measuringSingleNote;
+            currentStatus.midiPitch = singleMeasurementPitch;
+            break;
+        case finished:
+            currentStatus.activity = Status::done;
+            currentStatus.midiPitch = -1;
+            break;
+        case stopped:
+        default:
+            currentStatus.activity = Status::idle;
+            currentStatus.midiPitch = -1;
+            break;
+    }
+    currentStatus.calibrating = calibrating;
+    currentStatus.progress = getProgress();
+    status.write(currentStatus);
+}
+
+void VCOTuner::addError(const String& error)
+{
+    errors.add(error);
+    currentStatus.numErrors++;
+    currentStatus.lastErrorCode = Errors::getCode(error);
+    publishStatus();
+}
+
+/** inherited from AudioIODeviceCallback */
+void VCOTuner::audioDeviceAboutToStart (AudioIODevice* device)
+{
+    inputLatencySamples = device->getInputLatencyInSamples();
+    prepareToPlay(device->getCurrentSampleRate());
+}
+
+void VCOTuner::prepareToPlay(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+}
+
+/** inherited from AudioIODeviceCallback */
+void VCOTuner::audioDeviceStopped()
+{
+    const ScopedLock sl(analysisLock);
+    
+	if (isRunning())
+        addError(Errors::audioDeviceStoppedDuringMeasurement);
+
+    switchState(stopped);
+}
+
+void VCOTuner::changeListenerCallback (ChangeBroadcaster* source)
+{
+    if (source == deviceManager)
+    {
+        const ScopedLock sl(analysisLock);
+        switchState(stopped);
+    }
+}
+
+String VCOTuner::getStatusString() const
+{
+    return describe(getStatus());
+}
+
+String VCOTuner::describe(const Status& s)
+{
+    switch (s.activity)
+    {
+        case Status::idle:
+            return "Stopped.";
+        case Status::measuringReference:
+            return "Measuring reference frequency ...";
+        case Status::measuringDrift:
+            return "Measuring the drift of the reference frequency ...";
+        case Status::measuringNote:
+        case Status::measuringSingleNote:
+            return "Measuring frequency for MIDI note " + String(s.midiPitch) + " ...";
+        case Status::calibratingNote:
+            return "Calibrating MIDI note " + String(s.midiPitch) + " ...";
+        case Status::measuringContinuously:
+            return "Continuously measuring frequency...";
+        case Status::done:
+            return "Finished.";
+        default:
+            return "";
+    }
+}
+
+const String VCOTuner::Errors::highJitter = "There are zero crossings in the incoming signal but they don't seem to be coming in at a constant rate. Are you sure you're recording on the correct channel? Please use only primitive waveforms (saw, square, triangle, sine, ...) without any other processing such as delays, reverbs, etc. This error typically appears when you are accidentally recording the signal from a microphone or another sound source. Or when you have dropouts (aka clicks and pops) in your audio.";
+
+const String VCOTuner::Errors::noZeroCrossings = "The incoming audio signal does not seem to contain any zero-crossings. Are you sure the oscillator signal is getting through to us? Check your audio device settings.";
+
+const String VCOTuner::Errors::highJitterTimeOut = "Timeout. " + highJitter;
+
+const String VCOTuner::Errors::stableTimeout = "There are some zero crossings in the incoming signal and they seem to come in at a constant rate - but they are coming in much slower than they should be. Are you recording from the right oscillator?";
+
+const String VCOTuner::Errors::noFrequencyChangeBetweenMeasurements = "Apparently the frequency of the oscillator is not changing between measurements. Please check if your MIDI-to-CV interface is set to the correct MIDI channel and make sure that it is selected as the default midi output device in the audio and midi settings.";
+
+const String VCOTuner::Errors::noMidiDeviceAvailable = "You don't have a MIDI output device selected or the selected device is not available.";
+
+const String VCOTuner::Errors::noteOutOfRange = "The MIDI note for this oscillator is outside of the MIDI range. Please check the note offset of its input.";
+
+const String VCOTuner::Errors::audioDeviceStoppedDuringMeasurement = "The audio device was stopped while the measurement was still running. Please check that the device is still powered, all cables are connected and the driver is working correctly.";
+
+int VCOTuner::Errors::getCode(const String& message)
+{
+    const String* messages[] = { &highJitter, &noZeroCrossings, &highJitterTimeOut, &stableTimeout,
+                                 &noFrequencyChangeBetweenMeasurements, &noMidiDeviceAvailable,
+                                 &noteOutOfRange, &audioDeviceStoppedDuringMeasurement };
+    
+    // with several inputs, the message starts with the affected one
+    for (int i = 0; i < numElementsInArray(messages); i++)
+    {
+        if (message == *messages[i] || message.endsWith(": " + *messages[i]))
+            return i + 1;
+    }
+    return 0;
+}
@@ -1,200 +1,686 @@
-/*
-  ==============================================================================
-
-    VCOTuner.h
-    Created: 17 May 2016 8:21:15pm
-    Author:  Johannes Neumann
-
-  ==============================================================================
-*/
-
-#ifndef VCOTUNER_H_INCLUDED
-#define VCOTUNER_H_INCLUDED
-
-#include "../JuceLibraryCode/JuceHeader.h"
-
-class VCOTuner: public ChangeListener,
-                private Timer,
-                public AudioIODeviceCallback
-{
-public:
-    VCOTuner(AudioDeviceManager* deviceManager);
-    ~VCOTuner();
-    
-    void toggleState();
-    void start();
-    void stop();
-    bool isRunning() const { return state != stopped && state != finished; }
-    
-    void setNumMeasurementRange(int lowestPitch, int pitchIncrement, int highestPitch);
-    int getLowestPitch() const { return lowestPitch; }
-    int getPitchIncrement() const { return pitchIncrement; }
-    int getHighestPitch() const { return highestPitch; }
-    
-    void setMidiChannel(int channel) { midiChannel = channel; }
-    int  getMidiChannel() const { return midiChannel; }
-    
-    void setResolution(int numCyclesPerNote) { numPeriodSamples = numCyclesPerNote; }
-    int getResolution() { return numPeriodSamples; }
-    
-    double getCurrentSampleRate() { return sampleRate; }
-    double getReferenceFrequency() { return referenceFrequency; }
-    int getReferencePitch() const { return referencePitch; }
-    
-    String getStatusString()const;
-    
-    void startContinuousMeasurement(int pitch);
-    double getContinuousMesurementResult() const { return continuousFreqMeasurementResult; }
-    
-    void startSingleMeasurement(int pitch);
-    double getSingleMeasurementResult() const { return singleMeasurementResult; }
-    
-    /** holds all properties of a single measurements */
-    typedef struct
-    {
-        int midiPitch;
-        double frequency;
-        double pitch; // according to the measured reference pitch
-        double pitchOffset; // pitch - midiPitch
-        double freqDeviation;
-        double pitchDeviation;
-        int numMeasurements;
-        Time timestamp;
-    } measurement_t;
-    
-    /** returns all error messages and removes them from the internal list */
-    StringArray getLastErrors();
-    
-    /** inherited from AudioIODeviceCallback */
-    virtual void audioDeviceIOCallback (const float** inputChannelData,
-                                        int numInputChannels,
-                                        float** outputChannelData,
-                                        int numOutputChannels,
-                                        int numSamples);
-    
-    /** inherited from AudioIODeviceCallback */
-    virtual void audioDeviceAboutToStart (AudioIODevice* device);
-    
-    /** inherited from AudioIODeviceCallback */
-    virtual void audioDeviceStopped();
-    
-    /** inherited from ChangeListener */
-    virtual void changeListenerCallback (ChangeBroadcaster* source);
-    
-    class Listener
-    {
-    public:
-        virtual ~Listener() {}
-        
-        virtual void newMeasurementReady(const measurement_t& /*m*/) {}
-        virtual void tunerStarted() {}
-        virtual void tunerStopped() {}
-        virtual void tunerFinished() {}
-        virtual void tunerStatusChanged(String /* statusString */) {}
-    };
-    
-    void addListener(Listener* l);
-    void removeListener(Listener* l);
-    
-private:
-    // states for the state machine
-    enum State
-    {
-        stopped,
-        prepRefMeasurement,
-        refMeasurement,
-        prepMeasurement,
-        measurement,
-        finished,
-        prepareContinuousFrequencyMeasurement,
-        continuousFrequencyMeasurement,
-        prepareSingleMeasurement,
-        singleMeasurement
-    };
-    
-    ListenerList<Listener> listeners;
-    
-    // processes the state machine
-    virtual void timerCallback();
-    void switchState(State newState);
-    void trySendMidiNoteOn(int pitch);
-    void trySendMidiNoteOff(int pitch);
-    int currentlyPlayingMidiNote;
-    
-    // counts cycles since the last state transition
-    int cycleCounter;
-
-    
-    /** error message from the audio thread */
-    enum LowLevelError
-    {
-        noError = 0,
-        notStable // frequency not stable (= too much jitter)
-    };
-    
-    /** lowest pitch to be measured */
-    int lowestPitch;
-    /** pitch increment */
-    int pitchIncrement;
-    /** highest pitch to be measured */
-    int highestPitch;
-    
-    int currentPitch;
-    int currentIndex;
-    
-    /** midi note for which the reference measurement was done. */
-    int referencePitch;
-    /** frequency returned during the reference measurement */
-    float referenceFrequency;
-    
-    /** a list with recent error messages */
-    StringArray errors;
-    
-    AudioDeviceManager* deviceManager;
-    int midiChannel;
-    
-    /** state of the state machine */
-    State state;
-    
-    
-    /** the following must only be accessed from the message thread, when startMeasurement == false and
-     be accessed from the audio thread, when startMeasurement == true */
-    bool startMeasurement; // set by message thread, reset by audio thread.
-    bool stopMeasurement;  // set by message thread, reset by audio thread.
-    static const int maxNumPeriodLengths = 600;
-    double periodLengths[maxNumPeriodLengths]; // all measured period lengths of this measurement
-    int numPeriodSamples; // number of periods to measure before averaging
-    int indexOfFirstValidPeriodLength; // the index in periodLengths[] at which the system has reached a stable frequency
-                                       // this is also the first valid period length measurement that is included in the result
-    int periodLengthsHead;
-    LowLevelError lError; // holds error message from the audio thread
-    
-    /** the following are only to be accessed from the audio thread */
-    int sampleCounter; // counts samples since the start of a measurement
-    double lastZeroCrossing; // holds the sample counters value of the last zero corssing (- => +)
-    float lastSample;
-    double sampleRate;
-    bool initialized;
-    
-    int continuousFrequencyMeasurementPitch;
-    double continuousFreqMeasurementResult;
-    double continuousFreqMeasurementDeviation;
-    
-    int singleMeasurementPitch;
-    double singleMeasurementResult;
-    double singleMeasurementDeviation;
-    
-    struct Errors
-    {
-        static const String highJitter;
-        static const String noZeroCrossings;
-        static const String highJitterTimeOut;
-        static const String stableTimeout;
-        static const String noFrequencyChangeBetweenMeasurements;
-        static const String noMidiDeviceAvailable;
-        static const String audioDeviceStoppedDuringMeasurement;
-    };
-};
-
-
-#endif  // VCOTUNER_H_INCLUDED
+/*
+  ==============================================================================
+
+    VCOTuner.h
+    Created: 17 May 2016 8:21:15pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef VCOTUNER_H_INCLUDED
+#define VCOTUNER_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "RunningStatistics.h"
+#include "FrequencyEstimator.h"
+#include "SettleDetector.h"
+#include "SweepPlanner.h"
+#include "SeqLock.h"
+#include "TunerTelemetry.h"
+
+class VCOTuner: public ChangeListener,
+                private Timer,
+                private AsyncUpdater,
+                public AudioIODeviceCallback
+{
+public:
+    VCOTuner(AudioDeviceManager* deviceManager);
+    ~VCOTuner();
+    
+    void toggleState();
+    void start();
+    void stop();
+    
+    /** starts a calibration instead of a sweep. Every note of the range is measured and
+     corrected through the MIDI output until it's in tune, see calibration_t. */
+    void startCalibration();
+    /** true if the running (or the last) run is a calibration */
+    bool isCalibrating() const { return calibrating; }
+    bool isRunning() const { return state != stopped && state != finished; }
+    bool hasFinished() const { return state == finished; }
+    
+    /** how much of the current run is done, from 0 to 1 */
+    double getProgress() const;
+    
+    void setNumMeasurementRange(int lowestPitch, int pitchIncrement, int highestPitch);
+    int getLowestPitch() const { return lowestPitch; }
+    int getPitchIncrement() const { return pitchIncrement; }
+    int getHighestPitch() const { return highestPitch; }
+    
+    /** the order in which the notes of a sweep or calibration are played. It is planned
+     when the reference has been measured. Takes effect with the next run. */
+    void setSweepOrder(SweepPlanner::Strategy strategy) { sweepOrder = strategy; }
+    SweepPlanner::Strategy getSweepOrder() const { return sweepOrder; }
+    
+    /** Every lane measures one oscillator on its own input channel. All lanes are
+     measured in parallel, each one is played on its own MIDI channel. */
+    struct LaneSetup
+    {
+        /** index into the active input channels of the audio device */
+        int inputChannel = 0;
+        int midiChannel = 1;
+        /** added to every note that is sent to this lane, e.g. for interfaces that
+         split the keyboard between their outputs */
+        int noteOffset = 0;
+    };
+    static const int maxNumLanes = 16;
+    
+    /** replaces all lanes. The tuner is stopped if it was running. */
+    void setLanes(const Array<LaneSetup>& newLanes);
+    int getNumLanes() const { return numLanes.load(); }
+    const LaneSetup& getLaneSetup(int lane) const { return lanes[lane]->setup; }
+    
+    /** sets the MIDI channel of the first lane */
+    void setMidiChannel(int channel) { lanes[0]->setup.midiChannel = channel; }
+    int  getMidiChannel() const { return lanes[0]->setup.midiChannel; }
+    
+    void setResolution(int numCyclesPerNote) { numPeriodSamples = numCyclesPerNote; }
+    int getResolution() { return numPeriodSamples; }
+    
+    /** stops measuring a note as soon as the 95% confidence interval of its pitch is
+     within +/- the given number of cents. The resolution is then only the maximum
+     number of periods. 0 always measures the full number of periods. */
+    void setTargetConfidenceInterval(double cents) { targetConfidenceInterval = cents; }
+    double getTargetConfidenceInterval() const { return targetConfidenceInterval; }
+    
+    /** selects how the frequency is estimated from the recorded signal. Takes effect
+     with the next note that is measured. */
+    void setEstimator(FrequencyEstimator::Type type);
+    FrequencyEstimator::Type getEstimator() const { return estimatorType; }
+    
+    /** selects how the signal is filtered before its zero crossings are timed. The other
+     estimators don't use it. Takes effect with the next note that is measured. */
+    void setConditioning(SignalConditioner::Mode mode);
+    SignalConditioner::Mode getConditioning() const { return conditioning; }
+    
+    /** how a calibration corrects the pitch of the MIDI-CV interface */
+    enum CorrectionMessage
+    {
+        pitchBend = 0,
+        fineTuning // RPN 1, the channel fine tuning of +/- 1 semitone
+    };
+    
+    /** the pitch bend range must match the one of the interface, in semitones */
+    void setCorrectionMessage(CorrectionMessage message, double pitchBendRange = 2.0);
+    CorrectionMessage getCorrectionMessage() const { return correctionMessage; }
+    double getPitchBendRange() const { return pitchBendRange; }
+    
+    /** a calibration stops correcting a note as soon as it's within +/- this many cents */
+    void setCalibrationTolerance(double cents) { calibrationTolerance = cents; }
+    double getCalibrationTolerance() const { return calibrationTolerance; }
+    /** a note that isn't within the tolerance after this many measurements keeps the
+     correction of the best one */
+    static const int maxNumCalibrationAttempts = 6;
+    
+    /** measures the reference note again during a sweep whenever this many seconds have
+     passed since the last time, and once more at the end. The drift of the reference is
+     interpolated linearly between those measurements and taken out of every pitch, see
+     measurement_t. The measurements are then reported after the next reference measurement
+     (or when the tuner is stopped). 0 only measures the reference at the start. Calibrations
+     always do that, they need every result right away. */
+    void setReferenceInterval(double seconds) { referenceInterval = jmax(0.0, seconds); }
+    double getReferenceInterval() const { return referenceInterval; }
+    
+    double getCurrentSampleRate() { return sampleRate; }
+    /** of the first reference measurement, all raw pitches are relative to it */
+    double getReferenceFrequency(int lane = 0) { return lanes[lane]->referenceFrequency; }
+    int getReferencePitch() const { return referencePitch; }
+    /** how often the reference was measured during the current (or the last) sweep */
+    int getNumReferenceMeasurements(int lane = 0) const { return lanes[lane]->referencePoints.size(); }
+    /** how far the reference had drifted at its last measurement, in semitones */
+    double getReferenceDrift(int lane = 0) const;
+    /** the largest change of the reference between two of its measurements, in semitones.
+     The interpolation can only take out drift that is steady over such a step. */
+    double getMaxReferenceStep(int lane = 0) const;
+    AudioDeviceManager* getDeviceManager() const { return deviceManager; }
+    
+    String getStatusString()const;
+    
+    void startContinuousMeasurement(int pitch);
+    double getContinuousMesurementResult(int lane = 0) const { return lanes[lane]->continuousFreqMeasurementResult; }
+    
+    void startSingleMeasurement(int pitch);
+    double getSingleMeasurementResult(int lane = 0) const { return lanes[lane]->singleMeasurementResult; }
+    
+    /** holds all properties of a single measurements */
+    typedef struct
+    {
+        int lane;
+        int midiPitch;
+        double frequency; // without the drift of the reference, like the pitch
+        double pitch; // according to the measured reference pitch, without its drift
+        double pitchOffset; // pitch - midiPitch
+        double rawPitchOffset; // against the first reference measurement, without the drift correction
+        double rawFrequency; // as measured, without the drift correction
+        double freqDeviation;
+        double pitchDeviation;
+        double pitchConfidenceInterval; // half width of the 95% confidence interval of the pitch, in semitones
+        int numMeasurements;
+        double settleTime; // time from the note on until the frequency was stable, in ms
+        double settleWaitTime; // time from the note on until the settling was detected, what the sweep waited, in ms
+        Time timestamp;
+    } measurement_t;
+    
+    /** the result of calibrating a note */
+    typedef struct
+    {
+        int lane;
+        int midiPitch;
+        double correction; // what has to be added to the note to play it in tune, in semitones
+        double residual; // pitch offset that was measured with the correction, in semitones
+        int numAttempts; // measurements it took
+        bool converged; // the residual is within the tolerance
+    } calibration_t;
+    
+    /** returns all error messages and removes them from the internal list */
+    StringArray getLastErrors();
+    
+    /** the messages of all errors that stop a measurement */
+    struct Errors
+    {
+        static const String highJitter;
+        static const String noZeroCrossings;
+        static const String highJitterTimeOut;
+        static const String stableTimeout;
+        static const String noFrequencyChangeBetweenMeasurements;
+        static const String noMidiDeviceAvailable;
+        static const String noteOutOfRange;
+        static const String audioDeviceStoppedDuringMeasurement;
+        
+        /** returns a number for the error of a message from getLastErrors(), counted from 1
+         in the order above, e.g. for exit codes. 0 if it isn't one of them. */
+        static int getCode(const String& message);
+    };
+    
+    /** what the tuner is doing, see getStatus() */
+    struct Status
+    {
+        enum Activity
+        {
+            idle = 0,
+            measuringReference,
+            measuringDrift, // of the reference, during a sweep
+            measuringNote,
+            calibratingNote,
+            measuringContinuously,
+            measuringSingleNote,
+            done
+        };
+        
+        Activity activity;
+        bool calibrating; // the run is a calibration
+        int midiPitch; // the note that is measured, -1 if none
+        double progress; // of the run, from 0 to 1
+        int numResults; // reported since the run was started
+        measurement_t lastResult; // the latest of them, only valid if numResults > 0
+        int numErrors; // since the tuner was created
+        int lastErrorCode; // of the latest error, see Errors::getCode()
+    };
+    
+    /** returns what the tuner is doing right now. Can be called from any thread at any rate,
+     it never blocks and doesn't allocate. The state machine is never held up by it, so
+     displays and loggers should poll this instead of listening to every change. */
+    Status getStatus() const { return status.read(); }
+    /** changes whenever the status has changed */
+    uint32 getStatusVersion() const { return status.getVersion(); }
+    /** the text for a status, e.g. "Measuring frequency for MIDI note 60 ..." */
+    static String describe(const Status& s);
+    
+    /** Receives every result of the tuner, in the order they are reported, so that a
+     consumer can pick them up at its own rate. The tuner only copies a result into the
+     queue and never waits for it. When the queue is full, the new results are dropped
+     and counted. One thread may take the results out. */
+    class ResultQueue
+    {
+    public:
+        ResultQueue(int capacity = 4096);
+        
+        /** takes out the oldest result, returns false if there is none */
+        bool pop(measurement_t& m);
+        /** results that didn't fit into the queue */
+        int getNumDropped() const { return numDropped.load(); }
+    
+    private:
+        friend class VCOTuner;
+        void push(const measurement_t& m);
+        
+        AbstractFifo fifo;
+        HeapBlock<measurement_t> buffer;
+        std::atomic<int> numDropped;
+        
+        JUCE_DECLARE_NON_COPYABLE(ResultQueue)
+    };
+    
+    /** the queue receives all results from now on, until it is removed. Must be removed
+     before it is deleted. */
+    void addResultQueue(ResultQueue* queue);
+    void removeResultQueue(ResultQueue* queue);
+    
+    /** inherited from AudioIODeviceCallback */
+    virtual void audioDeviceIOCallback (const float** inputChannelData,
+                                        int numInputChannels,
+                                        float** outputChannelData,
+                                        int numOutputChannels,
+                                        int numSamples);
+    
+    /** inherited from AudioIODeviceCallback */
+    virtual void audioDeviceAboutToStart (AudioIODevice* device);
+    
+    /** inherited from AudioIODeviceCallback */
+    virtual void audioDeviceStopped();
+    
+    /** inherited from ChangeListener */
+    virtual void changeListenerCallback (ChangeBroadcaster* source);
+    
+    class Listener
+    {
+    public:
+        virtual ~Listener() {}
+        
+        virtual void newMeasurementReady(const measurement_t& /*m*/) {}
+        /** during a calibration, this comes after the measurement that was taken with the
+         final correction */
+        virtual void newCalibrationReady(const calibration_t& /*c*/) {}
+        virtual void tunerStarted() {}
+        virtual void tunerStopped() {}
+        virtual void tunerFinished() {}
+        /** the new status can be read with getStatus() or getStatusString() */
+        virtual void tunerStatusChanged() {}
+    };
+    
+    void addListener(Listener* l);
+    void removeListener(Listener* l);
+    
+    /** receives the MIDI messages of the tuner instead of the default MIDI output
+     of the device manager. Used to drive simulated or recorded oscillators. */
+    class MidiSink
+    {
+    public:
+        virtual ~MidiSink() {}
+        
+        virtual void sendMessageNow(const MidiMessage& message) = 0;
+    };
+    
+    /** routes all MIDI messages to the given sink. Pass nullptr to use the default
+     MIDI output of the device manager again. */
+    void setMidiSink(MidiSink* sink) { midiSink = sink; }
+    
+    /** the state machine usually runs on the message thread whenever the audio thread has
+     recorded new samples and when the current state times out. With a virtual clock, it only
+     runs when advanceClock() is called. This lets a simulation run the tuner in lockstep
+     with its audio, faster than real time. Must not be changed while the tuner is running. */
+    void setUsesVirtualClock(bool shouldUseVirtualClock);
+    bool usesVirtualClock() const { return virtualClock; }
+    
+    /** advances the virtual clock by the given time and processes the new samples
+     and all timeouts that have passed. */
+    void advanceClock(double elapsedMilliseconds);
+    
+    /** prepares the audio side for a sample rate. Called from audioDeviceAboutToStart(),
+     but can also be used to feed audioDeviceIOCallback() without an audio device. */
+    void prepareToPlay(double newSampleRate);
+    
+    /** analyses the recorded samples on a thread pool instead of the message thread. Several
+     tuners can share one pool, so that their analysis runs in parallel. The state machine and
+     all listener callbacks stay on the message thread. Pass nullptr to analyse on the message
+     thread again. Not used with a virtual clock. */
+    void setAnalysisPool(ThreadPool* pool);
+    
+    /** returns the performance counters since the current run was started (or since
+     resetTelemetry() was called): the timing of the audio callbacks and where the time
+     of each note went. */
+    TunerTelemetry::Snapshot getTelemetry() const;
+    void resetTelemetry();
+    
+private:
+    // states for the state machine
+    enum State
+    {
+        stopped,
+        prepRefMeasurement,
+        refMeasurement,
+        prepMeasurement,
+        measurement,
+        finished,
+        prepareContinuousFrequencyMeasurement,
+        continuousFrequencyMeasurement,
+        prepareSingleMeasurement,
+        singleMeasurement,
+        prepCalibration,
+        calibration,
+        prepRefRemeasurement,
+        refRemeasurement
+    };
+    
+    ListenerList<Listener> listeners;
+    Array<ResultQueue*> resultQueues; // only accessed under the analysisLock
+    
+    SeqLock<Status> status;
+    Status currentStatus; // the status as it is published next
+    /** publishes the current state, pitch and progress to getStatus() */
+    void publishStatus();
+    /** passes a final result on to the queues and the listeners */
+    void deliverMeasurement(const measurement_t& m);
+    void addError(const String& error);
+    
+    // processes the state machine
+    void runStateMachine();
+    void processState();
+    void switchState(State newState);
+    /** makes sure the state machine runs soon, e.g. after it was started */
+    void scheduleUpdate();
+    
+    /** drains the sample fifos on the analysis pool and wakes up the state machine when done */
+    class AnalysisJob: public ThreadPoolJob
+    {
+    public:
+        AnalysisJob(VCOTuner& t) : ThreadPoolJob("VCOTuner analysis"), tuner(t) {}
+        JobStatus runJob() override;
+        
+        VCOTuner& tuner;
+    };
+    ThreadPool* analysisPool;
+    std::atomic<bool> analysisPending; // an analysis job was added but hasn't finished yet
+    void removeAnalysisJobs();
+    
+    /** held while the recorded samples are analysed and while the state machine runs. The
+     message thread never waits for it in runStateMachine(), the analysis job wakes it up
+     again when it is done. */
+    CriticalSection analysisLock;
+    
+    TunerTelemetry telemetry;
+    /** the xruns reported by the current audio device, -1 if it can't tell */
+    int getDeviceXRunCount() const;
+    
+    /** the timer only fires when the current state times out */
+    void timerCallback() override;
+    /** triggered by the wake up poller when there are new samples */
+    void handleAsyncUpdate() override;
+    
+    /** posting a message can take a lock or allocate, so the audio thread only sets a flag.
+     This timer runs on a thread of its own while the tuner measures, and passes the flag
+     on to the message thread. */
+    class WakeUpPoller: public HighResolutionTimer
+    {
+    public:
+        WakeUpPoller(VCOTuner& t) : tuner(t) {}
+        void hiResTimerCallback() override;
+        
+        VCOTuner& tuner;
+    };
+    WakeUpPoller wakeUpPoller;
+    std::atomic<bool> wakeUpPending; // set by the audio thread when there are new samples
+    
+    /** the time at which the current state times out, or -1 if it never does */
+    double getStateDeadline() const;
+    bool isPastDeadline() const;
+    /** current time in ms, either real or virtual */
+    double getCurrentTimeMs() const;
+    
+    // time of the last state transition
+    double stateStartTime;
+    
+    std::atomic<bool> virtualClock;
+    double virtualTime;
+
+    
+    /** error message from the audio thread */
+    enum LowLevelError
+    {
+        noError = 0,
+        notStable // frequency not stable (= too much jitter)
+    };
+    
+    /** lowest pitch to be measured */
+    int lowestPitch;
+    /** pitch increment */
+    int pitchIncrement;
+    /** highest pitch to be measured */
+    int highestPitch;
+    
+    int currentPitch;
+    int currentIndex; // into plannedPitches
+    
+    SweepPlanner::Strategy sweepOrder;
+    /** the notes of the current run in the order they are played */
+    Array<int> plannedPitches;
+    Random plannerRandom;
+    /** plans the notes of the run, starting at the reference */
+    void planSweep();
+    
+    /** midi note for which the reference measurement was done. */
+    int referencePitch;
+    
+    /** a list with recent error messages */
+    StringArray errors;
+    
+    AudioDeviceManager* deviceManager;
+    MidiSink* midiSink;
+    
+    /** state of the state machine */
+    State state;
+    
+    
+    /** the audio thread only copies the samples of each lane into a lock free fifo.
+     The frequency estimators analyse them on the message thread (or the analysis pool).
+     Every measurement gets a new id. The message thread requests a measurement by publishing
+     its id, the audio thread tags each block of samples with the id it is currently recording.
+     Blocks that are still in the fifo from an older measurement are simply skipped. */
+    struct RecordedBlock
+    {
+        int measurementId;
+        int numSamples;
+    };
+    static const int sampleFifoSize = 1 << 17;
+    static const int blockFifoSize = 2048;
+    
+    /** a measurement of the reference note during a sweep */
+    struct ReferencePoint
+    {
+        double time; // in ms, see getMeasurementTime()
+        double frequency;
+    };
+    
+    /** a result that waits for the next reference measurement to correct its drift */
+    struct PendingMeasurement
+    {
+        measurement_t m;
+        double time;
+    };
+    
+    /** everything that is measured separately for each oscillator */
+    struct Lane
+    {
+        Lane();
+        
+        /** sizes the fifos of a lane that is used, or frees them. Nothing may be recorded meanwhile. */
+        void setFifosAllocated(bool shouldBeAllocated);
+        
+        LaneSetup setup; // only changed while holding the audio callback lock, see setLanes()
+        
+        /** the following are passed from the audio thread to the message thread. The samples
+         of a block are written before the block itself. */
+        AbstractFifo sampleFifo;
+        HeapBlock<float> sampleFifoBuffer;
+        AbstractFifo blockFifo;
+        HeapBlock<RecordedBlock> blockFifoBuffer;
+        std::atomic<int> overflowedMeasurement; // set by the audio thread when the fifo was full
+        
+        /** the following are only to be accessed from the audio thread */
+        bool recordingOverflowed;
+        int recordedInputChannel; // copied from the setup when a measurement is started
+        
+        /** the following must only be accessed from the message thread */
+        bool active; // false when the lane failed during the current run
+        bool measuring; // true until the running measurement is complete or was stopped
+        std::unique_ptr<FrequencyEstimator> estimator; // positions are counted from the start of a measurement
+        FrequencyEstimator::Type estimatorType;
+        int numPeriods; // all periods of this measurement, including those before the frequency was stable
+        SettleDetector settleDetector; // only periods after the oscillator has settled are included in the result
+        double stableTime; // time when the frequency got stable
+        double stablePosition; // end of the period that completed the settling, in samples
+        double noteOnTime; // when the measurement was started
+        double firstPeriodTime; // when the first period was found
+        int numUnsettledPeriods; // periods before the oscillator had settled
+        double previousPitch; // the pitch of the last complete measurement, including its correction
+        double previousPeriodLength; // and its period length, 0 if unknown
+        bool hasJump; // the previous pitch is known
+        double jump; // from the previous pitch to this note, in semitones
+        SweepPlanner::SettleModel settleModel; // learned from the notes of the sweeps
+        double predictedSettleTimeMs; // of this note, 0 if unknown
+        bool pitchChangeChecked; // the MIDI output has been seen to change the pitch in this run
+        LowLevelError lError;
+        int currentlyPlayingMidiNote;
+        
+        /** statistics of the valid periods of the running measurement */
+        RunningStatistics periodStatistics;
+        RunningStatistics frequencyStatistics;
+        RunningStatistics logFrequencyStatistics; // log2 of the frequency, for the pitch deviation
+        
+        /** frequency returned during the reference measurement */
+        float referenceFrequency;
+        /** all reference measurements of the current sweep, oldest first */
+        Array<ReferencePoint> referencePoints;
+        Array<PendingMeasurement> pendingMeasurements;
+        double continuousFreqMeasurementResult;
+        double continuousFreqMeasurementDeviation;
+        double singleMeasurementResult;
+        double singleMeasurementDeviation;
+        
+        /** the following are only used during a calibration, all pitches are in semitones */
+        double correction; // sent with the current note, 0 at all other times
+        bool correctionSent; // the interface may still have a correction other than 0
+        double previousCorrection; // of the previous attempt at the current note
+        double previousError; // the pitch offset that was measured with it
+        double correctionGain; // pitch change per correction, from the attempts so far
+        double bestCorrection; // of all attempts at the current note, the one closest to the note
+        double bestError;
+        measurement_t bestMeasurement; // and its result
+        int numAttempts; // at the current note
+        bool calibrated; // the current note is done
+        int seedPitches[2]; // the last two notes that are done, most recent first
+        double seedCorrections[2]; // and their corrections
+        int numSeeds;
+        
+        JUCE_DECLARE_NON_COPYABLE(Lane)
+    };
+    OwnedArray<Lane> lanes; // always holds maxNumLanes, only the first numLanes are used and have fifos
+    std::atomic<int> numLanes; // only changed while nothing is recorded
+    
+    std::atomic<int> requestedMeasurement; // set by the message thread, 0 = don't record anything
+    
+    /** starts a new measurement on the audio thread for all active lanes. Must be called
+     right after the note on for the pitch was sent. */
+    void startMeasuring(int pitch);
+    /** stops recording on the audio thread, samples still in the fifos are ignored */
+    void stopMeasuring();
+    /** reads all new samples from the fifos and analyses them */
+    void processRecordedSamples();
+    bool hasNewSamples() const;
+    void addPeriod(Lane& lane, const FrequencyEstimator::Period& period);
+    /** true while at least one active lane hasn't finished its measurement */
+    bool isAnyLaneMeasuring() const;
+    
+    /** sends the note on to all active lanes and starts measuring. Returns false if the
+     note couldn't be sent and the tuner was stopped. */
+    bool startNote(int pitch);
+    void sendNoteOffs();
+    void trySendMidiNoteOn(int laneIndex, int pitch);
+    bool trySendMidiNoteOff(Lane& lane);
+    bool trySendMidiMessage(const MidiMessage& message);
+    
+    /** the result of the lane's last measurement */
+    measurement_t createMeasurement(int laneIndex, double frequency, double pitch) const;
+    /** reports a result to the listeners, or keeps it until the drift of the reference is known */
+    void reportMeasurement(const measurement_t& m);
+    /** corrects the drift of the kept results and reports them */
+    void reportPendingMeasurements(int laneIndex);
+    
+    /** the middle of the part of the lane's last measurement that went into its result, in ms */
+    double getMeasurementTime(const Lane& lane) const;
+    /** the drift of the reference at a time, in semitones. Between two reference measurements
+     it is interpolated linearly, after the last one it stays where it was. */
+    double getReferenceDriftAt(const Lane& lane, double time) const;
+    /** true if the reference should be measured again before the next note of the sweep */
+    bool isReferenceDue() const;
+    
+    /** checks on the first note that is far enough from the reference that the MIDI output has
+     changed the pitch at all. Returns false if it hasn't. */
+    bool checkPitchChange(Lane& lane, double frequency);
+    
+    double referenceInterval; // in seconds, 0 = only at the start
+    double lastReferenceTime; // when the reference was last measured, in ms
+    
+    /** predicts the correction of the current note from the notes before and sends it
+     with the note on */
+    void startCalibratingNote(Lane& lane);
+    /** updates the correction of a lane after a measurement with a Newton step, using the
+     gain of the secant through the last two attempts. Returns false if the note is done. */
+    bool updateCorrection(Lane& lane, const measurement_t& m);
+    /** the 14 bit value that is sent for a correction, 8192 is none */
+    int getCorrectionValue(double semitones) const;
+    /** a correction as it arrives at the interface, i.e. limited to the range and rounded */
+    double quantiseCorrection(double semitones) const;
+    bool trySendCorrection(Lane& lane);
+    /** takes back all corrections that might still be active on the interface */
+    void resetCorrections();
+    
+    bool calibrating;
+    CorrectionMessage correctionMessage;
+    double pitchBendRange; // in semitones
+    double calibrationTolerance; // in cents
+    
+    /** stops measuring on a lane and records where the time of the note went */
+    void finishLane(Lane& lane, TunerTelemetry::Outcome outcome);
+    
+    /** takes a lane out of the current run and reports the error for it */
+    void laneFailed(int laneIndex, const String& error);
+    /** fails all lanes that are still measuring when the current state has timed out */
+    void failTimedOutLanes();
+    /** stops the tuner if all lanes have failed. Returns true if it was stopped. */
+    bool stopIfNoLaneIsLeft();
+    
+    /** the following must only be accessed from the message thread */
+    int measurementId; // id of the running measurement
+    int numPeriodSamples; // number of periods to measure before averaging
+    double targetConfidenceInterval; // in cents, 0 = always measure numPeriodSamples periods
+    FrequencyEstimator::Type estimatorType;
+    SignalConditioner::Mode conditioning;
+    static const int maxNumSamplesPerChunk = 1024; // samples are passed to the estimators in chunks of this size
+    FrequencyEstimator::Period estimatedPeriods[maxNumSamplesPerChunk / 2]; // periods found in the current chunk
+    static const int minNumConfidencePeriods = 20; // the correlation estimate needs a few periods before it can be trusted
+    int measuredPitch; // the MIDI note of the running measurement
+    static const int maxNumUnstablePeriods = 600; // give up if the frequency doesn't get stable within this many periods
+    int inputLatencySamples;
+    static const int minimumSettleMarginMs = 10; // added to the input latency when the previous pitch is unknown
+    
+    /** results of the last measurement */
+    double getMeasuredFrequency(const Lane& lane) const;
+    double getMeasuredFrequencyDeviation(const Lane& lane) const;
+    double getMeasuredPitchDeviation(const Lane& lane) const; // in semitones
+    double getMeasuredPitchConfidenceInterval(const Lane& lane) const; // in semitones
+    /** true if enough periods were measured to finish the measurement of this lane.
+     The position is the end of the last period. */
+    bool hasEnoughPeriods(const Lane& lane, double position) const;
+    
+    /** allows for the oscillator to settle. After that, twice the time the measurement should take */
+    double getMeasurementDeadline(const Lane& lane, double minimumMs) const;
+    /** how long a lane may take to settle before it is given up, longer for jumps that are
+     known to settle slowly */
+    double getSettleTimeoutMs(const Lane& lane) const;
+    
+    /** the following are only to be accessed from the audio thread */
+    int recordedMeasurement; // id of the measurement that is currently recorded, 0 = none
+    int numRecordedLanes; // copied from numLanes when a measurement is started
+    double sampleRate;
+    /** passes the samples of one lane on. Returns true if the message thread needs to be
+     woken up. */
+    bool recordLane(Lane& lane, const float* samples, int numSamples);
+    
+    int continuousFrequencyMeasurementPitch;
+    int singleMeasurementPitch;
+};
+
+
+#endif  // VCOTUNER_H_INCLUDED
@@ -1,249 +1,687 @@
-/*
-  ==============================================================================
-
-    Visualizer.cpp
-    Created: 22 May 2016 2:45:34pm
-    Author:  Johannes Neumann
-
-  ==============================================================================
-*/
-
-#include "../JuceLibraryCode/JuceHeader.h"
-#include "Visualizer.h"
-
-
-Visualizer::Visualizer(VCOTuner* t)
-{
-    tuner = t;
-}
-
-Visualizer::~Visualizer()
-{
-    
-}
-
-
-void Visualizer::paint(juce::Graphics &g, int width, int height)
-{
-    if (measurements.size() == 0)
-    {
-        g.drawText("No Data", 0, 0, width, height, juce::Justification::centred);
-        return;
-    }
-    
-    // calculate display range
-    double max = 0;
-    double min = 0;
-    for (int i = 0; i < measurements.size(); i++)
-    {
-        double value = measurements[i].pitchOffset;
-        double deviation = measurements[i].pitchDeviation;
-        if (value - deviation < min)
-            min = value - deviation;
-        if (value + deviation > max)
-            max = value + deviation;
-    }
-    double expandAmount = (max - min) * 0.2;
-    min -= expandAmount;
-    max += expandAmount;
-    
-    paintWithFixedScaling(g, width, height, min, max);
-}
-
-void Visualizer::paintWithFixedScaling(Graphics& g, int width, int height, double min, double max)
-{
-    if (measurements.size() == 0)
-    {
-        g.drawText("No Data", 0, 0, width, height, juce::Justification::centred);
-        return;
-    }
-    
-    const int bottomBarHeight = 20;
-    
-    int imageHeight = height - bottomBarHeight;
-    
-    // prepare coordinate transformation (flipping the y axis)
-    heightForFlipping = (float) imageHeight;
-    
-    const float sidebarWidth = 75;
-    double columnWidth = (double) (width - sidebarWidth) / (double) measurements.size();
-    const double allowedPitchOffset = 0.02; // 5 cents allowed
-    
-    if (min > -allowedPitchOffset)
-        min = -allowedPitchOffset;
-    if (max < allowedPitchOffset)
-        max = allowedPitchOffset;
-    if (max < min)
-        return;
-    
-    double vertScaling = (double) imageHeight / (max - min);
-    
-    // draw maximum "in-tune" pitch offset and center line
-    g.setColour(Colours::grey);
-    const float dashLengths[] = {4, 4};
-    double position = (allowedPitchOffset - min) * vertScaling;
-    g.drawDashedLine(Line<float>(sidebarWidth, yFlip((float) position), (float) width, yFlip((float) position)), dashLengths, 2);
-    position = (-allowedPitchOffset - min) * vertScaling;
-    g.drawDashedLine(Line<float>(sidebarWidth, yFlip((float) position), (float) width, yFlip((float) position)), dashLengths, 2);
-    position = (- min) * vertScaling;
-    g.drawLine(sidebarWidth, yFlip((float) position), (float) width, yFlip((float) position));
-    
-    // draw scales
-    g.setColour(Colours::grey);
-    const int numIntervals = 13;
-    const double allowedIntervals[numIntervals] = {0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1, 2, 5, 10, 20, 50 };
-    double lineInterval = allowedIntervals[0];
-    int currentIntervalIndex = 0;
-    
-    int numLinesAllowed = imageHeight / 30;
-    while (((max - min) / lineInterval) > numLinesAllowed)
-    {
-        lineInterval = allowedIntervals[++currentIntervalIndex];
-        if (currentIntervalIndex >= numIntervals)
-            break;
-    }
-    bool useSemitoneTexts = lineInterval >= 1.0;
-    
-    int numPosLines = (int) trunc(max/lineInterval);
-    int numNegLines = (int) trunc(-min/lineInterval);
-    for (double y = numPosLines; y > -numNegLines; y--)
-    {
-        double linePos = (y*lineInterval - min) * vertScaling;
-        double left = sidebarWidth - 2;
-        double number = y*lineInterval*((useSemitoneTexts)?1.0:100.0);
-        String numberString = (std::abs(number - round(number)) > 0.1)?String(number, 1):String((int)round(number));
-        String lineText = numberString;
-        if (!useSemitoneTexts)
-            lineText += " cents";
-        g.drawText(lineText, juce::Rectangle<float>(0.0f, yFlip(float(linePos) + g.getCurrentFont().getHeight()/2.0f), float(left) - 4, g.getCurrentFont().getHeight()), Justification::centredRight);
-        
-        // don't overwrite maximum "in-tune" lines
-        if (y*lineInterval == allowedPitchOffset || y*lineInterval == -allowedPitchOffset)
-            continue;
-        
-        const float lineDashLengths[] = {4, 20};
-        g.drawDashedLine(Line<float>((float) left, yFlip((float) linePos), (float) width, yFlip((float) linePos)), lineDashLengths, 2);
-        
-    }
-    
-    // draw pitch measurement points
-    for (int i = 0; i < measurements.size(); i++)
-    {
-        float left = sidebarWidth + i*(float)columnWidth;
-        
-        // draw deviation
-        float maxPosition = (float) ((measurements[i].pitchOffset + measurements[i].pitchDeviation - min) * vertScaling);
-        float minPosition = (float) ((measurements[i].pitchOffset - measurements[i].pitchDeviation - min) * vertScaling);
-        
-        g.setColour(Colours::springgreen.withAlpha(0.4f));
-        g.fillRect(left, yFlip(maxPosition), (float) columnWidth, maxPosition - minPosition);
-        
-        // draw average value
-        float pointPosition = (float) ((measurements[i].pitchOffset - min) * vertScaling);
-        g.setColour(Colours::green);
-        g.drawLine(left, yFlip(pointPosition), left + (float) columnWidth, yFlip(pointPosition));
-    }
-    
-    // draw the X-Axis label
-    g.setColour(Colours::black);
-    g.drawText("MIDI note", 0, imageHeight, juce::roundToInt(sidebarWidth) - 10, bottomBarHeight, Justification::centredRight);
-    
-    // draw the corresponding note values to the X axis
-    const int numPitchTextIntervals = 5;
-    const int pitchTextIntervals[numPitchTextIntervals] = {1, 2, 5, 10, 20};
-    int currentPitchTextIntervalIndex = 0;
-    while (g.getCurrentFont().getStringWidth("123.") > pitchTextIntervals[currentPitchTextIntervalIndex] * columnWidth)
-    {
-        currentPitchTextIntervalIndex++;
-        if (currentPitchTextIntervalIndex >= numPitchTextIntervals)
-            break;
-    }
-    int pitchTextInterval = pitchTextIntervals[currentPitchTextIntervalIndex];
-    int startLine = 0;
-    int endLine = measurements.size() - 1;
-    while (measurements[startLine].midiPitch % pitchTextInterval != 0)
-    {
-        startLine++;
-        if (startLine >= measurements.size())
-            return;
-    }
-    while (measurements[endLine].midiPitch % pitchTextInterval != 0)
-    {
-        endLine--;
-        if (endLine < 0 || endLine < startLine)
-            return;
-    }
-    
-    for (int i = startLine; i <= endLine; i += pitchTextInterval)
-    {
-        g.setColour(Colours::black);
-        float textWidth = g.getCurrentFont().getStringWidth(String(measurements[i].midiPitch));
-        float left = sidebarWidth + i * float(columnWidth);
-        float x = left + float(columnWidth)/2.0f - textWidth/2.0f;
-        float y = imageHeight;
-        g.drawText(String(measurements[i].midiPitch), juce::Rectangle<float>(x, y, textWidth, bottomBarHeight), Justification::centred);
-        
-        // the line for the reference pitch will be drawn later
-        if (measurements[i].midiPitch == tuner->getReferencePitch())
-            continue;
-        
-        // also draw dim vertical lines for the larger devisions or if the columns get very narrow
-        if (pitchTextInterval >= 2)
-        {
-            g.setColour(Colours::blue.withAlpha(0.05f));
-            g.fillRect(Rectangle<float>(left, 0, float(columnWidth), imageHeight));
-        }
-        if (pitchTextInterval == 1 && columnWidth < g.getCurrentFont().getStringWidth("123."))
-        {
-            if (i % 2 == 0)
-            {
-                g.setColour(Colours::blue.withAlpha(0.05f));
-                g.fillRect(Rectangle<float>(left, 0, float(columnWidth), imageHeight));
-            }
-        }
-    }
-    
-    // draw a blue indicator for the reference pitch (if included in the measurements)
-    if (measurements[0].midiPitch < tuner->getReferencePitch()
-        && measurements.getLast().midiPitch > tuner->getReferencePitch())
-    {
-        for (int i = 0; i < measurements.size(); i++)
-        {
-            if (measurements[i].midiPitch == tuner->getReferencePitch())
-            {
-                float left = sidebarWidth + i * float(columnWidth);
-                g.setColour(Colours::blue.withAlpha(0.15f));
-                g.fillRect(Rectangle<float>(left, 0, float(columnWidth), imageHeight));
-            }
-        }
-    }
-}
-
-void Visualizer::paint(Graphics& g)
-{
-    paint(g, getWidth(), getHeight());
-}
-
-float Visualizer::yFlip(float y)
-{
-    return heightForFlipping - y;
-}
-
-void Visualizer::newMeasurementReady(const VCOTuner::measurement_t& m)
-{
-    bool found = false;
-    for (int i = 0; i < measurements.size(); i++)
-    {
-        if (measurements[i].midiPitch == m.midiPitch)
-        {
-            measurements.set(i, m);
-            found = true;
-            repaint();
-        }
-    }
-    
-    if (!found)
-        measurements.add(m);
-    
-    repaint();
-}
+/*
+  ==============================================================================
+
+    Visualizer.cpp
+    Created: 22 May 2016 2:45:34pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "Visualizer.h"
+
+namespace
+{
+    const int bottomBarHeight = 20;
+    const float sidebarWidth = 75;
+    const double allowedPitchOffset = 0.02; // 2 cents allowed
+
+    /** repaints are collected and done at this rate at most */
+    const int refreshRateHz = 60;
+    
+    const int defaultMaxNumPreviousSweeps = 32;
+    const float previousSweepAlpha = 0.35f;
+    /** narrower lanes than this are connected to a line through the previous results */
+    const float minLaneWidthForTicks = 4.0f;
+    /** the line through the previous results gets at most two points per this many pixels */
+    const float pixelsPerLinePoint = 2.0f;
+}
+
+//==============================================================================
+Visualizer::Sweep::Sweep()
+{
+    numLanes = 0;
+}
+
+const VCOTuner::measurement_t* Visualizer::Sweep::get(int lane, int note) const
+{
+    if (lane < 0 || lane >= numLanes || note < 0 || note >= numNotes)
+        return nullptr;
+    
+    const VCOTuner::measurement_t& m = results.getReference(lane * numNotes + note);
+    return m.midiPitch >= 0 ? &m : nullptr;
+}
+
+bool Visualizer::Sweep::set(const VCOTuner::measurement_t& m)
+{
+    jassert(m.lane >= 0 && m.midiPitch >= 0 && m.midiPitch < numNotes);
+    
+    if (m.lane >= numLanes)
+    {
+        VCOTuner::measurement_t empty = {};
+        empty.midiPitch = -1;
+        results.insertMultiple(-1, empty, (m.lane + 1 - numLanes) * numNotes);
+        numLanes = m.lane + 1;
+    }
+    
+    VCOTuner::measurement_t& entry = results.getReference(m.lane * numNotes + m.midiPitch);
+    const bool replaced = entry.midiPitch >= 0;
+    entry = m;
+    return replaced;
+}
+
+//==============================================================================
+Visualizer::Layout::Layout(int w, int h, double minimum, double maximum, int numColumns, int lanes)
+: width(w), height(h)
+{
+    imageHeight = (float) (height - bottomBarHeight);
+    min = jmin(minimum, -allowedPitchOffset);
+    max = jmax(maximum, allowedPitchOffset);
+    isValid = max > min && numColumns > 0 && imageHeight > 0;
+    
+    vertScaling = isValid ? imageHeight / (max - min) : 0;
+    columnWidth = numColumns > 0 ? (width - sidebarWidth) / (float) numColumns : 0;
+    numLanes = jmax(1, lanes);
+    laneWidth = columnWidth / (float) numLanes;
+}
+
+float Visualizer::Layout::getY(double pitchOffset) const
+{
+    // flipped, the larger offsets are on top
+    return imageHeight - (float) ((pitchOffset - min) * vertScaling);
+}
+
+float Visualizer::Layout::getColumnX(int column) const
+{
+    return sidebarWidth + column * columnWidth;
+}
+
+bool Visualizer::Layout::operator== (const Layout& other) const
+{
+    return width == other.width && height == other.height
+        && min == other.min && max == other.max
+        && columnWidth == other.columnWidth && laneWidth == other.laneWidth && numLanes == other.numLanes;
+}
+
+//==============================================================================
+Visualizer::Visualizer(VCOTuner* t)
+: backgroundLayout(0, 0, 0, 0, 0, 1)
+{
+    tuner = t;
+    maxNumPreviousSweeps = defaultMaxNumPreviousSweeps;
+    backgroundScale = 1.0f;
+    backgroundReferencePitch = -1;
+    fullRepaintPending = false;
+    
+    clearCache();
+}
+
+Visualizer::~Visualizer()
+{
+    stopTimer();
+}
+
+void Visualizer::clearCache()
+{
+    currentSweep = Sweep();
+    hasNewResults = false;
+    previousSweeps.clear();
+
+    pitches.clear();
+    for (int i = 0; i < numNotes; i++)
+        columnOfNote[i] = -1;
+    numLanes = 1;
+    
+    minPreviousResult = 0;
+    maxPreviousResult = 0;
+    minResult = 0;
+    maxResult = 0;
+    
+    invalidateBackground();
+    fullRepaintPending = true;
+    scheduleRepaint();
+}
+
+Array<VCOTuner::measurement_t> Visualizer::getResults() const
+{
+    Array<VCOTuner::measurement_t> results;
+    for (int lane = 0; lane < numLanes; lane++)
+    {
+        for (int i = 0; i < pitches.size(); i++)
+        {
+            if (const VCOTuner::measurement_t* m = currentSweep.get(lane, pitches[i]))
+                results.add(*m);
+        }
+    }
+    return results;
+}
+
+void Visualizer::setMaxNumPreviousSweeps(int numSweeps)
+{
+    maxNumPreviousSweeps = jmax(0, numSweeps);
+    if (previousSweeps.size() <= maxNumPreviousSweeps)
+        return;
+    
+    previousSweeps.removeRange(0, previousSweeps.size() - maxNumPreviousSweeps);
+    updatePreviousRange();
+    invalidateBackground();
+    fullRepaintPending = true;
+    scheduleRepaint();
+}
+
+void Visualizer::updateRange()
+{
+    // the axis always includes zero
+    minResult = minPreviousResult;
+    maxResult = maxPreviousResult;
+    for (int lane = 0; lane < numLanes; lane++)
+    {
+        for (int i = 0; i < pitches.size(); i++)
+        {
+            if (const VCOTuner::measurement_t* m = currentSweep.get(lane, pitches[i]))
+            {
+                minResult = jmin(minResult, m->pitchOffset - m->pitchDeviation);
+                maxResult = jmax(maxResult, m->pitchOffset + m->pitchDeviation);
+            }
+        }
+    }
+}
+
+void Visualizer::updatePreviousRange()
+{
+    minPreviousResult = 0;
+    maxPreviousResult = 0;
+    for (int s = 0; s < previousSweeps.size(); s++)
+    {
+        const Sweep& sweep = *previousSweeps[s];
+        for (int lane = 0; lane < sweep.getNumLanes(); lane++)
+        {
+            for (int i = 0; i < pitches.size(); i++)
+            {
+                if (const VCOTuner::measurement_t* m = sweep.get(lane, pitches[i]))
+                {
+                    minPreviousResult = jmin(minPreviousResult, m->pitchOffset);
+                    maxPreviousResult = jmax(maxPreviousResult, m->pitchOffset);
+                }
+            }
+        }
+    }
+    updateRange();
+}
+
+Visualizer::Layout Visualizer::getAutoScaledLayout(int width, int height) const
+{
+    const double expandAmount = (maxResult - minResult) * 0.2;
+    return Layout(width, height, minResult - expandAmount, maxResult + expandAmount, pitches.size(), numLanes);
+}
+
+//==============================================================================
+void Visualizer::paint(Graphics& g, int width, int height)
+{
+    if (pitches.isEmpty())
+    {
+        g.drawText("No Data", 0, 0, width, height, juce::Justification::centred);
+        return;
+    }
+    
+    const Layout layout = getAutoScaledLayout(width, height);
+    paintWithFixedScaling(g, width, height, layout.min, layout.max);
+}
+
+void Visualizer::paintWithFixedScaling(Graphics& g, int width, int height, double min, double max)
+{
+    if (pitches.isEmpty())
+    {
+        g.drawText("No Data", 0, 0, width, height, juce::Justification::centred);
+        return;
+    }
+    
+    const Layout layout(width, height, min, max, pitches.size(), numLanes);
+    if (!layout.isValid)
+        return;
+    
+    paintBackground(g, layout, pitches, tuner->getReferencePitch());
+    paintColumns(g, layout, currentSweep, pitches, 0, pitches.size() - 1);
+    paintLegend(g, layout);
+}
+
+void Visualizer::paintResults(Graphics& g, const Array<VCOTuner::measurement_t>& results, int referencePitch,
+                              int width, int height, double min, double max)
+{
+    Sweep sweep;
+    Array<int> pitches;
+    for (const VCOTuner::measurement_t& m : results)
+    {
+        if (m.midiPitch < 0 || m.midiPitch >= numNotes || m.lane < 0)
+            continue;
+        
+        sweep.set(m);
+        if (!pitches.contains(m.midiPitch))
+            pitches.addUsingDefaultSort(m.midiPitch);
+    }
+    
+    if (pitches.isEmpty())
+    {
+        g.drawText("No Data", 0, 0, width, height, juce::Justification::centred);
+        return;
+    }
+    
+    const Layout layout(width, height, min, max, pitches.size(), sweep.getNumLanes());
+    if (!layout.isValid)
+        return;
+    
+    paintBackground(g, layout, pitches, referencePitch);
+    paintColumns(g, layout, sweep, pitches, 0, pitches.size() - 1);
+    paintLegend(g, layout);
+}
+
+void Visualizer::paint(Graphics& g)
+{
+    if (pitches.isEmpty())
+    {
+        g.drawText("No Data", 0, 0, getWidth(), getHeight(), juce::Justification::centred);
+        return;
+    }
+    
+    const Layout layout = getAutoScaledLayout(getWidth(), getHeight());
+    if (!layout.isValid)
+        return;
+    
+    // the cached images have the resolution of the screen
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const int imageWidth = jmax(1, roundToInt(layout.width * scale));
+    const int imageHeight = jmax(1, roundToInt(layout.height * scale));
+    if (!backgroundValid || !(layout == backgroundLayout) || scale != backgroundScale
+        || tuner->getReferencePitch() != backgroundReferencePitch)
+    {
+        background = Image(Image::ARGB, imageWidth, imageHeight, true);
+        Graphics backgroundGraphics(background);
+        backgroundGraphics.addTransform(AffineTransform::scale(scale));
+        paintBackground(backgroundGraphics, layout, pitches, tuner->getReferencePitch());
+        
+        previousSweepsImage = Image(Image::ARGB, imageWidth, imageHeight, true);
+        numPreviousSweepsDrawn = 0;
+        
+        backgroundLayout = layout;
+        backgroundScale = scale;
+        backgroundReferencePitch = tuner->getReferencePitch();
+        backgroundValid = true;
+    }
+    
+    // only the sweeps that were added since the last time are drawn
+    if (numPreviousSweepsDrawn < 0)
+    {
+        previousSweepsImage.clear(previousSweepsImage.getBounds());
+        numPreviousSweepsDrawn = 0;
+    }
+    if (numPreviousSweepsDrawn < previousSweeps.size())
+    {
+        Graphics sweepsGraphics(previousSweepsImage);
+        sweepsGraphics.addTransform(AffineTransform::scale(scale));
+        paintPreviousSweeps(sweepsGraphics, layout, numPreviousSweepsDrawn);
+        numPreviousSweepsDrawn = previousSweeps.size();
+    }
+    
+    const Rectangle<float> area(0.0f, 0.0f, (float) getWidth(), (float) getHeight());
+    g.drawImage(background, area);
+    if (!previousSweeps.isEmpty())
+        g.drawImage(previousSweepsImage, area);
+    
+    // only the columns that need to be repainted
+    const Rectangle<int> clip = g.getClipBounds();
+    const int firstColumn = jmax(0, (int) std::floor((clip.getX() - sidebarWidth) / layout.columnWidth));
+    const int lastColumn = jmin(pitches.size() - 1, (int) std::floor((clip.getRight() - sidebarWidth) / layout.columnWidth));
+    paintColumns(g, layout, currentSweep, pitches, firstColumn, lastColumn);
+    paintLegend(g, layout);
+}
+
+void Visualizer::resized()
+{
+    // the background is redrawn for the new size with the next paint
+    fullRepaintPending = true;
+    scheduleRepaint();
+}
+
+void Visualizer::paintBackground(Graphics& g, const Layout& layout, const Array<int>& pitches, int referencePitch)
+{
+    const float width = (float) layout.width;
+    const float imageHeight = layout.imageHeight;
+    const double min = layout.min;
+    const double max = layout.max;
+    const float columnWidth = layout.columnWidth;
+    
+    // draw maximum "in-tune" pitch offset and center line
+    g.setColour(Colours::grey);
+    const float dashLengths[] = {4, 4};
+    g.drawDashedLine(Line<float>(sidebarWidth, layout.getY(allowedPitchOffset), width, layout.getY(allowedPitchOffset)), dashLengths, 2);
+    g.drawDashedLine(Line<float>(sidebarWidth, layout.getY(-allowedPitchOffset), width, layout.getY(-allowedPitchOffset)), dashLengths, 2);
+    g.drawLine(sidebarWidth, layout.getY(0), width, layout.getY(0));
+    
+    // draw scales
+    g.setColour(Colours::grey);
+    const int numIntervals = 13;
+    const double allowedIntervals[numIntervals] = {0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1, 2, 5, 10, 20, 50 };
+    double lineInterval = allowedIntervals[0];
+    int currentIntervalIndex = 0;
+    
+    int numLinesAllowed = (int) imageHeight / 30;
+    while (((max - min) / lineInterval) > numLinesAllowed)
+    {
+        if (++currentIntervalIndex >= numIntervals)
+            break;
+        lineInterval = allowedIntervals[currentIntervalIndex];
+    }
+    bool useSemitoneTexts = lineInterval >= 1.0;
+    
+    const float fontHeight = g.getCurrentFont().getHeight();
+    int numPosLines = (int) trunc(max/lineInterval);
+    int numNegLines = (int) trunc(-min/lineInterval);
+    for (double y = numPosLines; y > -numNegLines; y--)
+    {
+        const float linePos = layout.getY(y*lineInterval);
+        double left = sidebarWidth - 2;
+        double number = y*lineInterval*((useSemitoneTexts)?1.0:100.0);
+        String numberString = (std::abs(number - round(number)) > 0.1)?String(number, 1):String((int)round(number));
+        String lineText = numberString;
+        if (!useSemitoneTexts)
+            lineText += " cents";
+        g.drawText(lineText, juce::Rectangle<float>(0.0f, linePos - fontHeight/2.0f, float(left) - 4, fontHeight), Justification::centredRight);
+        
+        // don't overwrite maximum "in-tune" lines
+        if (y*lineInterval == allowedPitchOffset || y*lineInterval == -allowedPitchOffset)
+            continue;
+        
+        const float lineDashLengths[] = {4, 20};
+        g.drawDashedLine(Line<float>((float) left, linePos, width, linePos), lineDashLengths, 2);
+    }
+    
+    // draw a blue indicator for the reference pitch (if included in the measurements)
+    const int referenceColumn = pitches.indexOf(referencePitch);
+    if (pitches[0] < referencePitch && pitches.getLast() > referencePitch && referenceColumn >= 0)
+    {
+        g.setColour(Colours::blue.withAlpha(0.15f));
+        g.fillRect(Rectangle<float>(layout.getColumnX(referenceColumn), 0, columnWidth, imageHeight));
+    }
+    
+    // draw the X-Axis label
+    g.setColour(Colours::black);
+    g.drawText("MIDI note", 0, (int) imageHeight, juce::roundToInt(sidebarWidth) - 10, bottomBarHeight, Justification::centredRight);
+    
+    // draw the corresponding note values to the X axis
+    const int numPitchTextIntervals = 5;
+    const int pitchTextIntervals[numPitchTextIntervals] = {1, 2, 5, 10, 20};
+    int currentPitchTextIntervalIndex = 0;
+    const float noteTextWidth = g.getCurrentFont().getStringWidthFloat("123.");
+    while (noteTextWidth > pitchTextIntervals[currentPitchTextIntervalIndex] * columnWidth)
+    {
+        if (currentPitchTextIntervalIndex + 1 >= numPitchTextIntervals)
+            break;
+        currentPitchTextIntervalIndex++;
+    }
+    int pitchTextInterval = pitchTextIntervals[currentPitchTextIntervalIndex];
+    int startLine = 0;
+    int endLine = pitches.size() - 1;
+    while (pitches[startLine] % pitchTextInterval != 0)
+    {
+        startLine++;
+        if (startLine >= pitches.size())
+            return;
+    }
+    while (pitches[endLine] % pitchTextInterval != 0)
+    {
+        endLine--;
+        if (endLine < 0 || endLine < startLine)
+            return;
+    }
+    
+    for (int i = startLine; i <= endLine; i += pitchTextInterval)
+    {
+        g.setColour(Colours::black);
+        float textWidth = g.getCurrentFont().getStringWidthFloat(String(pitches[i]));
+        float left = layout.getColumnX(i);
+        float x = left + columnWidth/2.0f - textWidth/2.0f;
+        g.drawText(String(pitches[i]), juce::Rectangle<float>(x, imageHeight, textWidth, bottomBarHeight), Justification::centred);
+        
+        // the reference pitch has its own indicator
+        if (pitches[i] == referencePitch)
+            continue;
+        
+        // also draw dim vertical lines for the larger devisions or if the columns get very narrow
+        if (pitchTextInterval >= 2 || (columnWidth < noteTextWidth && i % 2 == 0))
+        {
+            g.setColour(Colours::blue.withAlpha(0.05f));
+            g.fillRect(Rectangle<float>(left, 0, columnWidth, imageHeight));
+        }
+    }
+}
+
+void Visualizer::paintColumns(Graphics& g, const Layout& layout, const Sweep& sweep, const Array<int>& pitches,
+                              int firstColumn, int lastColumn)
+{
+    for (int column = firstColumn; column <= lastColumn; column++)
+    {
+        for (int lane = 0; lane < layout.numLanes; lane++)
+        {
+            const VCOTuner::measurement_t* m = sweep.get(lane, pitches[column]);
+            if (m == nullptr)
+                continue;
+            
+            const float left = layout.getColumnX(column) + lane * layout.laneWidth;
+            
+            // draw deviation
+            const float top = layout.getY(m->pitchOffset + m->pitchDeviation);
+            const float bottom = layout.getY(m->pitchOffset - m->pitchDeviation);
+            g.setColour(getLaneColour(lane).withAlpha(0.4f));
+            g.fillRect(left, top, layout.laneWidth, bottom - top);
+            
+            // draw average value
+            const float y = layout.getY(m->pitchOffset);
+            if (lane == 0)
+                g.setColour(Colours::green);
+            else
+                g.setColour(getLaneColour(lane).darker());
+            g.drawLine(left, y, left + layout.laneWidth, y);
+        }
+    }
+}
+
+void Visualizer::paintPreviousSweeps(Graphics& g, const Layout& layout, int firstSweep)
+{
+    // wide lanes get a tick at each result, like the average of the current sweep. Narrow ones
+    // get a line through all results of a sweep, with only the lowest and the highest result
+    // of the notes that fall onto the same few pixels.
+    const bool drawTicks = layout.laneWidth >= minLaneWidthForTicks;
+    
+    for (int s = firstSweep; s < previousSweeps.size(); s++)
+    {
+        const Sweep& sweep = *previousSweeps[s];
+        for (int lane = 0; lane < jmin(numLanes, sweep.getNumLanes()); lane++)
+        {
+            Path path;
+            bool startNewLine = true;
+            int bucket = -1;
+            float bucketX = 0, bucketMin = 0, bucketMax = 0;
+            
+            auto addBucket = [&] ()
+            {
+                if (bucket < 0)
+                    return;
+                if (startNewLine)
+                    path.startNewSubPath(bucketX, bucketMin);
+                else
+                    path.lineTo(bucketX, bucketMin);
+                if (bucketMax != bucketMin)
+                    path.lineTo(bucketX, bucketMax);
+                startNewLine = false;
+                bucket = -1;
+            };
+            
+            for (int column = 0; column < pitches.size(); column++)
+            {
+                const VCOTuner::measurement_t* m = sweep.get(lane, pitches[column]);
+                if (m == nullptr)
+                {
+                    // don't connect the results across a note that wasn't measured
+                    addBucket();
+                    startNewLine = true;
+                    continue;
+                }
+                
+                const float left = layout.getColumnX(column) + lane * layout.laneWidth;
+                const float y = layout.getY(m->pitchOffset);
+                if (drawTicks)
+                {
+                    path.startNewSubPath(left, y);
+                    path.lineTo(left + layout.laneWidth, y);
+                    continue;
+                }
+                
+                const float x = left + layout.laneWidth / 2.0f;
+                const int newBucket = (int) (x / pixelsPerLinePoint);
+                if (newBucket != bucket)
+                {
+                    addBucket();
+                    bucket = newBucket;
+                    bucketX = x;
+                    bucketMin = y;
+                    bucketMax = y;
+                }
+                else
+                {
+                    bucketMin = jmin(bucketMin, y);
+                    bucketMax = jmax(bucketMax, y);
+                }
+            }
+            addBucket();
+            
+            g.setColour(getLaneColour(lane).darker().withAlpha(previousSweepAlpha));
+            g.strokePath(path, PathStrokeType(1.0f));
+        }
+    }
+}
+
+void Visualizer::paintLegend(Graphics& g, const Layout& layout)
+{
+    // tell the lanes apart
+    if (layout.numLanes <= 1)
+        return;
+    
+    const float legendWidth = 60;
+    const float legendHeight = g.getCurrentFont().getHeight();
+    for (int lane = 0; lane < layout.numLanes; lane++)
+    {
+        Rectangle<float> legend((float) layout.width - legendWidth, lane * legendHeight, legendWidth, legendHeight);
+        g.setColour(getLaneColour(lane).withAlpha(0.4f));
+        g.fillRect(legend);
+        g.setColour(Colours::black);
+        g.drawText("Input " + String(lane + 1), legend, Justification::centred);
+    }
+}
+
+//==============================================================================
+void Visualizer::invalidateBackground()
+{
+    backgroundValid = false;
+    numPreviousSweepsDrawn = -1;
+}
+
+void Visualizer::scheduleRepaint()
+{
+    if (!isTimerRunning())
+        startTimerHz(refreshRateHz);
+}
+
+void Visualizer::timerCallback()
+{
+    stopTimer();
+    
+    if (fullRepaintPending)
+    {
+        repaint();
+    }
+    else if (!dirtyColumns.isZero())
+    {
+        const Layout layout = getAutoScaledLayout(getWidth(), getHeight());
+        for (int column = dirtyColumns.findNextSetBit(0); column >= 0; column = dirtyColumns.findNextSetBit(column + 1))
+        {
+            const int left = (int) std::floor(layout.getColumnX(column));
+            repaint(left, 0, (int) std::ceil(layout.columnWidth) + 2, getHeight());
+        }
+    }
+    
+    fullRepaintPending = false;
+    dirtyColumns.clear();
+}
+
+void Visualizer::newMeasurementReady(const VCOTuner::measurement_t& m)
+{
+    if (m.midiPitch < 0 || m.midiPitch >= numNotes || m.lane < 0)
+        return;
+    
+    const bool replaced = currentSweep.set(m);
+    hasNewResults = true;
+    
+    // a new note or lane changes the width of all columns
+    bool layoutChanged = false;
+    if (columnOfNote[m.midiPitch] < 0)
+    {
+        pitches.addUsingDefaultSort(m.midiPitch);
+        for (int i = 0; i < pitches.size(); i++)
+            columnOfNote[pitches[i]] = i;
+        layoutChanged = true;
+    }
+    if (m.lane >= numLanes)
+    {
+        numLanes = m.lane + 1;
+        layoutChanged = true;
+    }
+    
+    // a replaced result may have been the one that determined the range
+    const double oldMin = minResult;
+    const double oldMax = maxResult;
+    if (replaced)
+    {
+        updateRange();
+    }
+    else
+    {
+        minResult = jmin(minResult, m.pitchOffset - m.pitchDeviation);
+        maxResult = jmax(maxResult, m.pitchOffset + m.pitchDeviation);
+    }
+    if (minResult != oldMin || maxResult != oldMax)
+        layoutChanged = true;
+    
+    if (layoutChanged)
+    {
+        invalidateBackground();
+        fullRepaintPending = true;
+    }
+    else
+    {
+        dirtyColumns.setBit(columnOfNote[m.midiPitch]);
+    }
+    scheduleRepaint();
+}
+
+void Visualizer::tunerFinished()
+{
+    // e.g. a single measurement doesn't produce any results
+    if (!hasNewResults || maxNumPreviousSweeps <= 0)
+        return;
+    hasNewResults = false;
+    
+    previousSweeps.add(new Sweep(currentSweep));
+    if (previousSweeps.size() > maxNumPreviousSweeps)
+    {
+        previousSweeps.removeRange(0, previousSweeps.size() - maxNumPreviousSweeps);
+        numPreviousSweepsDrawn = -1;
+    }
+    
+    const double oldMin = minResult;
+    const double oldMax = maxResult;
+    updatePreviousRange();
+    if (minResult != oldMin || maxResult != oldMax)
+        invalidateBackground();
+    
+    fullRepaintPending = true;
+    scheduleRepaint();
+}
+
+Colour Visualizer::getLaneColour(int lane)
+{
+    const Colour colours[] = { Colours::springgreen, Colours::orange, Colours::deepskyblue,
+                               Colours::hotpink, Colours::gold, Colours::mediumpurple };
+    const int numColours = sizeof(colours) / sizeof(colours[0]);
+    return colours[lane % numColours];
+}
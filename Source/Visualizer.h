@@ -1,41 +1,142 @@
-/*
-  ==============================================================================
-
-    Visualizer.h
-    Created: 22 May 2016 2:45:34pm
-    Author:  Johannes Neumann
-
-  ==============================================================================
-*/
-
-#ifndef VISUALIZER_H_INCLUDED
-#define VISUALIZER_H_INCLUDED
-
-#include "VCOTuner.h"
-
-class Visualizer: public Component,
-                  public VCOTuner::Listener
-{
-public:
-    Visualizer(VCOTuner* t);
-    ~Visualizer();
-    
-    void paintWithFixedScaling(Graphics& g, int width, int height, double min, double max);
-    void paint(Graphics& g, int width, int height);
-    virtual void paint(Graphics& g);
-    
-    virtual void newMeasurementReady(const VCOTuner::measurement_t& m);
-    
-    void clearCache() { measurements.clear(); }
-private:
-    /** holds the list of completed measurements */
-    Array<VCOTuner::measurement_t> measurements;
-    
-    float heightForFlipping;
-    float yFlip(float y);
-    
-    VCOTuner* tuner;
-};
-
-
-#endif  // VISUALIZER_H_INCLUDED
+/*
+  ==============================================================================
+
+    Visualizer.h
+    Created: 22 May 2016 2:45:34pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef VISUALIZER_H_INCLUDED
+#define VISUALIZER_H_INCLUDED
+
+#include "VCOTuner.h"
+
+/** Shows the pitch offset and deviation of every measured note, one column per note.
+
+    On screen, the grid and all labels are drawn into a cached image that is only redrawn
+    when the size, the range or the measured notes change. A new result only repaints its
+    own column, and all repaints are collected until the next frame. The results of the
+    previous sweeps (e.g. in cycle mode) are drawn as thin lines behind the current one.
+ */
+class Visualizer: public Component,
+                  public VCOTuner::Listener,
+                  private Timer
+{
+public:
+    Visualizer(VCOTuner* t);
+    ~Visualizer();
+    
+    /** paints the current results without any caching and without the previous sweeps,
+     e.g. into the image of a report */
+    void paintWithFixedScaling(Graphics& g, int width, int height, double min, double max);
+    /** the same for results that aren't in a Visualizer. Doesn't touch any component, so
+     it can be used on any thread, e.g. to render reports in the background. */
+    static void paintResults(Graphics& g, const Array<VCOTuner::measurement_t>& results, int referencePitch,
+                             int width, int height, double min, double max);
+    void paint(Graphics& g, int width, int height);
+    virtual void paint(Graphics& g);
+    virtual void resized();
+    
+    virtual void newMeasurementReady(const VCOTuner::measurement_t& m);
+    /** keeps the results of the sweep, so that they are shown behind the next one */
+    virtual void tunerFinished();
+    
+    /** removes the current results and those of all previous sweeps */
+    void clearCache();
+    
+    /** the results that are shown, i.e. the latest of each note and lane, sorted by lane and note */
+    Array<VCOTuner::measurement_t> getResults() const;
+    
+    /** how many previous sweeps are shown behind the current one, 0 shows none */
+    void setMaxNumPreviousSweeps(int numSweeps);
+    int getNumPreviousSweeps() const { return previousSweeps.size(); }
+    
+private:
+    static const int numNotes = 128;
+    
+    /** the results of one sweep, directly indexed by lane and MIDI note */
+    class Sweep
+    {
+    public:
+        Sweep();
+        /** returns nullptr if the note wasn't measured on that lane */
+        const VCOTuner::measurement_t* get(int lane, int note) const;
+        /** returns true if there already was a result for the note and lane */
+        bool set(const VCOTuner::measurement_t& m);
+        int getNumLanes() const { return numLanes; }
+    
+    private:
+        int numLanes;
+        Array<VCOTuner::measurement_t> results; // numNotes per lane, midiPitch is -1 where there is none
+    };
+    Sweep currentSweep;
+    bool hasNewResults; // since the last sweep was finished
+    OwnedArray<Sweep> previousSweeps; // oldest first
+    int maxNumPreviousSweeps;
+    
+    /** the measured MIDI notes in ascending order, one column per note */
+    Array<int> pitches;
+    int columnOfNote[numNotes]; // -1 for notes that weren't measured
+    /** each column is divided between the lanes */
+    int numLanes;
+    
+    /** the range of the results. The offsets of the previous sweeps are included, but
+     not their deviations. */
+    double minResult, maxResult;
+    double minPreviousResult, maxPreviousResult;
+    void updateRange();
+    void updatePreviousRange();
+    
+    /** where everything goes for a given size and pitch range */
+    struct Layout
+    {
+        Layout(int width, int height, double min, double max, int numColumns, int numLanes);
+        
+        float getY(double pitchOffset) const;
+        float getColumnX(int column) const;
+        bool operator== (const Layout& other) const;
+        
+        int width, height;
+        float imageHeight; // without the bar with the MIDI notes at the bottom
+        double min, max;
+        double vertScaling;
+        float columnWidth, laneWidth;
+        int numLanes;
+        bool isValid;
+    };
+    /** the layout that fits all results into the component */
+    Layout getAutoScaledLayout(int width, int height) const;
+    
+    /** these only draw what they are given, so that paintResults() can use them as well */
+    static void paintBackground(Graphics& g, const Layout& layout, const Array<int>& pitches, int referencePitch);
+    static void paintColumns(Graphics& g, const Layout& layout, const Sweep& sweep, const Array<int>& pitches,
+                             int firstColumn, int lastColumn);
+    static void paintLegend(Graphics& g, const Layout& layout);
+    void paintPreviousSweeps(Graphics& g, const Layout& layout, int firstSweep);
+    
+    /** the grid and the labels, and the previous sweeps on top of them */
+    Image background;
+    Image previousSweepsImage;
+    Layout backgroundLayout;
+    float backgroundScale;
+    int backgroundReferencePitch;
+    bool backgroundValid;
+    int numPreviousSweepsDrawn; // new sweeps are added to the image, 0 redraws it completely
+    void invalidateBackground();
+    
+    /** repaints are collected and done with the next frame */
+    BigInteger dirtyColumns;
+    bool fullRepaintPending;
+    void timerCallback() override;
+    void scheduleRepaint();
+    
+    /** colour of the deviation bar of a lane. The average line is drawn a bit darker. */
+    static Colour getLaneColour(int lane);
+    
+    VCOTuner* tuner;
+};
+
+
+#endif  // VISUALIZER_H_INCLUDED
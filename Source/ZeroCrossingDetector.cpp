@@ -0,0 +1,356 @@
+/*
+  ==============================================================================
+
+    ZeroCrossingDetector.cpp
+    Created: 17 Oct 2026 1:40:03pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ZeroCrossingDetector.h"
+
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#elif JUCE_ARM && defined (__aarch64__)
+ #include <arm_neon.h>
+#endif
+
+namespace
+{
+    /** the samples on each side of the crossing for the windowed sinc */
+    const int sincHalfWidth = 16;
+    /** shape of the Kaiser window: flat up to 0.4 * sample rate with this width */
+    const double kaiserBeta = 6.0;
+    /** the number of intervals between two samples in the oversampled sinc table */
+    const int numSincPhases = 64;
+    /** the iterations stop when the position changes by less than this (in samples) */
+    const double rootTolerance = 1e-9;
+    const int maxRootIterations = 20;
+    
+    int getHalfWidth(ZeroCrossingDetector::Interpolation interpolation)
+    {
+        switch (interpolation)
+        {
+            case ZeroCrossingDetector::cubic:
+                return 2;
+            case ZeroCrossingDetector::sinc:
+            case ZeroCrossingDetector::oversampledSinc:
+                return sincHalfWidth;
+            case ZeroCrossingDetector::linear:
+            default:
+                return 1;
+        }
+    }
+    
+    /** finds the root of f in [0, 1] with regula falsi (Illinois variant), f(0) < 0 <= f(1) */
+    template <typename Function>
+    double findRoot(Function f, double fLow, double fHigh)
+    {
+        double low = 0.0;
+        double high = 1.0;
+        double t = 0.0;
+        int side = 0;
+        for (int i = 0; i < maxRootIterations; i++)
+        {
+            const double lastT = t;
+            t = (low * fHigh - high * fLow) / (fHigh - fLow);
+            const double ft = f(t);
+            if (ft < 0)
+            {
+                low = t;
+                fLow = ft;
+                if (side == -1)
+                    fHigh *= 0.5;
+                side = -1;
+            }
+            else
+            {
+                high = t;
+                fHigh = ft;
+                if (side == 1)
+                    fLow *= 0.5;
+                side = 1;
+            }
+            if (ft == 0 || std::abs(t - lastT) < rootTolerance)
+                break;
+        }
+        return t;
+    }
+    
+    /** modified Bessel function of the first kind, order 0 */
+    double bessel0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; term > 1e-12 * sum; k++)
+        {
+            const double factor = x / (2.0 * k);
+            term *= factor * factor;
+            sum += term;
+        }
+        return sum;
+    }
+    
+    /** Kaiser windowed sinc, zero outside of +/- sincHalfWidth */
+    double windowedSinc(double x)
+    {
+        if (x == 0)
+            return 1.0;
+        if (std::abs(x) >= sincHalfWidth)
+            return 0.0;
+        
+        const double px = MathConstants<double>::pi * x;
+        const double r = x / sincHalfWidth;
+        const double window = bessel0(kaiserBeta * sqrt(1.0 - r * r)) / bessel0(kaiserBeta);
+        return sin(px) / px * window;
+    }
+    
+    /** the signal at t (0 = s[-1], 1 = s[0]), reconstructed from s[-sincHalfWidth] ... s[sincHalfWidth - 1] */
+    double evaluateSinc(const float* s, double t)
+    {
+        double sum = 0;
+        for (int k = -sincHalfWidth; k < sincHalfWidth; k++)
+            sum += s[k] * windowedSinc(t - 1.0 - k);
+        return sum;
+    }
+    
+    /** the windowed sinc at t = phase / numSincPhases for every sample around the crossing */
+    struct SincTable
+    {
+        SincTable()
+        {
+            for (int phase = 0; phase <= numSincPhases; phase++)
+            {
+                const double t = phase / (double) numSincPhases;
+                for (int k = -sincHalfWidth; k < sincHalfWidth; k++)
+                    coefficients[phase][k + sincHalfWidth] = windowedSinc(t - 1.0 - k);
+            }
+        }
+        
+        double evaluate(const float* s, int phase) const
+        {
+            const double* c = coefficients[phase];
+            double sum = 0;
+            for (int k = 0; k < 2 * sincHalfWidth; k++)
+                sum += s[k - sincHalfWidth] * c[k];
+            return sum;
+        }
+        
+        double coefficients[numSincPhases + 1][2 * sincHalfWidth];
+    };
+    
+    const SincTable& getSincTable()
+    {
+        static const SincTable table;
+        return table;
+    }
+}
+
+ZeroCrossingDetector::ZeroCrossingDetector(Interpolation i)
+    : interpolation(i),
+      vectorised(true),
+      halfWidth(getHalfWidth(i))
+{
+    for (int n = 0; n < maxHistoryLength; n++)
+        history[n] = 0;
+    sampleCounter = 0;
+    
+    hysteresis = 0;
+    armed = false;
+    checkedPosition = -maxHistoryLength;
+    
+    if (interpolation == oversampledSinc)
+        getSincTable();
+}
+
+int ZeroCrossingDetector::process(const float* samples, int numSamples, double* crossingPositions, int maxNumCrossings)
+{
+    const int historyLength = 2 * halfWidth - 1;
+    
+    // the crossings at the start of the block need the samples of the previous one
+    float edge[2 * maxHistoryLength];
+    const int numEdgeSamples = jmin(numSamples, historyLength);
+    for (int n = 0; n < historyLength; n++)
+        edge[n] = history[n];
+    for (int n = 0; n < numEdgeSamples; n++)
+        edge[historyLength + n] = samples[n];
+    
+    const int edgeEnd = jmin(historyLength + halfWidth, historyLength + numEdgeSamples - halfWidth + 1);
+    int numCrossings = findAndInterpolate(edge, halfWidth, edgeEnd, sampleCounter - historyLength,
+                                          crossingPositions, maxNumCrossings);
+    
+    // the rest of the block, as far as there are enough samples after the crossing
+    numCrossings += findAndInterpolate(samples, halfWidth, numSamples - halfWidth + 1, sampleCounter,
+                                       crossingPositions + numCrossings, maxNumCrossings - numCrossings);
+    
+    // keep the last samples for the next block
+    const int numOldSamples = historyLength - numEdgeSamples;
+    for (int n = 0; n < numOldSamples; n++)
+        history[n] = history[n + numEdgeSamples];
+    for (int n = numOldSamples; n < historyLength; n++)
+        history[n] = samples[numSamples - historyLength + n];
+    
+    sampleCounter += numSamples;
+    return numCrossings;
+}
+
+int ZeroCrossingDetector::findAndInterpolate(const float* samples, int begin, int end, int offset,
+                                             double* crossingPositions, int maxNumCrossings)
+{
+    int numCrossings = 0;
+    while (begin < end && numCrossings < maxNumCrossings)
+    {
+        const int maxNumFound = jmin((int) maxNumIndices, maxNumCrossings - numCrossings);
+        const int numFound = vectorised ? findCrossingsVectorised(samples, begin, end, crossingIndices, maxNumFound)
+                                        : findCrossingsScalar(samples, begin, end, crossingIndices, maxNumFound);
+        
+        for (int i = 0; i < numFound; i++)
+        {
+            const int index = crossingIndices[i];
+            if (hysteresis > 0)
+            {
+                if (!isArmed(samples, index, offset))
+                    continue;
+                armed = false;
+            }
+            crossingPositions[numCrossings++] = offset + index - 1 + interpolate(samples + index);
+        }
+        
+        if (numFound < maxNumFound)
+            break;
+        begin = crossingIndices[numFound - 1] + 1;
+    }
+    
+    // the samples after the last crossing may arm the next one, which is in the next range
+    if (hysteresis > 0)
+        isArmed(samples, end, offset);
+    return numCrossings;
+}
+
+bool ZeroCrossingDetector::isArmed(const float* samples, int index, int offset)
+{
+    // only the samples that weren't looked at before, the ranges overlap by a sample
+    const int from = jmax(0, checkedPosition - offset);
+    if (!armed && index > from)
+        armed = FloatVectorOperations::findMinimum(samples + from, index - from) < -hysteresis;
+    checkedPosition = jmax(checkedPosition, offset + index);
+    return armed;
+}
+
+double ZeroCrossingDetector::interpolate(const float* s) const
+{
+    const double before = s[-1];
+    const double after = s[0];
+    if (after == 0)
+        return 1.0;
+    
+    switch (interpolation)
+    {
+        case cubic:
+        {
+            // Hermite spline between s[-1] and s[0], with the slopes of the cubic through
+            // all four samples. (The usual Catmull-Rom slopes put the crossing of a sine
+            // exactly where the straight line does.)
+            const double c1 = -s[-2] / 3.0 - 0.5 * before + after - s[1] / 6.0;
+            const double c2 = 0.5 * (s[-2] + after) - before;
+            const double c3 = (s[1] - s[-2]) / 6.0 + 0.5 * (before - after);
+            return findRoot([&] (double t) { return before + t * (c1 + t * (c2 + t * c3)); }, before, after);
+        }
+        
+        case sinc:
+            return findRoot([s] (double t) { return evaluateSinc(s, t); }, before, after);
+        
+        case oversampledSinc:
+        {
+            // bisect the table phases, then a straight line between the two around the crossing
+            const SincTable& table = getSincTable();
+            int low = 0;
+            int high = numSincPhases;
+            double lowValue = before;
+            double highValue = after;
+            while (high - low > 1)
+            {
+                const int middle = (low + high) / 2;
+                const double value = table.evaluate(s, middle);
+                if (value < 0)
+                {
+                    low = middle;
+                    lowValue = value;
+                }
+                else
+                {
+                    high = middle;
+                    highValue = value;
+                }
+            }
+            return (low + lowValue / (lowValue - highValue)) / numSincPhases;
+        }
+        
+        case linear:
+        default:
+            // straight line from (0, before) to (1, after)
+            return before / (before - after);
+    }
+}
+
+int ZeroCrossingDetector::findCrossingsScalar(const float* samples, int begin, int end, int* indices, int maxNumIndices)
+{
+    int numFound = 0;
+    for (int i = begin; i < end && numFound < maxNumIndices; i++)
+    {
+        if (samples[i - 1] < 0 && samples[i] >= 0)
+            indices[numFound++] = i;
+    }
+    return numFound;
+}
+
+int ZeroCrossingDetector::findCrossingsVectorised(const float* samples, int begin, int end, int* indices, int maxNumIndices)
+{
+#if JUCE_INTEL || (JUCE_ARM && defined (__aarch64__))
+    const int vectorSize = 4;
+    int numFound = 0;
+    
+    // find sign changes between samples[i-1] and samples[i], four at a time
+    int i = begin;
+    for (; i + vectorSize <= end; i += vectorSize)
+    {
+       #if JUCE_INTEL
+        const __m128 zero = _mm_setzero_ps();
+        __m128 previous = _mm_loadu_ps(samples + i - 1);
+        __m128 current = _mm_loadu_ps(samples + i);
+        int mask = _mm_movemask_ps(_mm_and_ps(_mm_cmplt_ps(previous, zero), _mm_cmpge_ps(current, zero)));
+       #else
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        float32x4_t previous = vld1q_f32(samples + i - 1);
+        float32x4_t current = vld1q_f32(samples + i);
+        uint32x4_t lanes = vandq_u32(vcltq_f32(previous, zero), vcgeq_f32(current, zero));
+        int mask = 0;
+        if (vmaxvq_u32(lanes) != 0)
+        {
+            static const uint32_t laneBits[4] = { 1, 2, 4, 8 };
+            mask = (int) vaddvq_u32(vandq_u32(lanes, vld1q_u32(laneBits)));
+        }
+       #endif
+        
+        // crossings are rare - most of the time there is nothing to do here
+        while (mask != 0)
+        {
+            int lane = 0;
+            while ((mask & (1 << lane)) == 0)
+                lane++;
+            mask &= ~(1 << lane);
+            
+            if (numFound >= maxNumIndices)
+                return numFound;
+            indices[numFound++] = i + lane;
+        }
+    }
+    
+    // the remaining samples that don't fill up a whole vector
+    return numFound + findCrossingsScalar(samples, i, end, indices + numFound, maxNumIndices - numFound);
+#else
+    return findCrossingsScalar(samples, begin, end, indices, maxNumIndices);
+#endif
+}
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    ZeroCrossingDetector.h
+    Created: 17 Oct 2026 1:40:03pm
+    Author:  Johannes Neumann
+
+  ==============================================================================
+*/
+
+#ifndef ZEROCROSSINGDETECTOR_H_INCLUDED
+#define ZEROCROSSINGDETECTOR_H_INCLUDED
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+/** Finds rising zero crossings (- => +) in a stream of audio blocks and
+    interpolates their position between the two samples around the crossing.
+    
+    The blocks are scanned with SSE2 (or NEON) for sign changes, only the few
+    samples around a crossing are looked at individually. The crossings found
+    are exactly the same as those found by the sample-by-sample reference
+    implementation, which the "equivalence" suite of VCOTunerBenchmark checks.
+    
+    The position between the two samples is found with a straight line or with
+    a curve through more samples around the crossing. The last few samples of a
+    block are kept, so that the crossings at the block boundaries see the same
+    samples as all others. The crossings that need samples after them are
+    reported with the block that contains these samples.
+    
+    With a hysteresis, only the crossings after the signal was far enough below
+    zero are reported. The samples in between are checked with FloatVectorOperations.
+ */
+class ZeroCrossingDetector
+{
+public:
+    enum Interpolation
+    {
+        linear = 0,     // straight line through the 2 samples around the crossing
+        cubic,          // cubic Hermite spline through 4 samples
+        sinc,           // windowed sinc through 32 samples, solved at the exact position
+        oversampledSinc // the same windowed sinc from a table at 64 phases between two samples
+    };
+    
+    ZeroCrossingDetector(Interpolation interpolation = linear);
+    
+    Interpolation getInterpolation() const { return interpolation; }
+    
+    /** the number of samples a crossing is reported late, because the interpolation needs them */
+    int getLatency() const { return halfWidth - 1; }
+    
+    /** restarts counting the crossing positions at zero with the next block.
+     The last samples of the previous block are still used to detect and
+     interpolate the crossings at the start of the next block. */
+    void resetPosition()
+    {
+        checkedPosition -= sampleCounter;
+        sampleCounter = 0;
+    }
+    
+    /** a rising crossing only counts if the signal was below -level since the
+     previous one, so that noise around zero can't add crossings. 0 (the default)
+     counts all crossings. */
+    void setHysteresis(float level) { hysteresis = level; }
+    
+    /** false scans the blocks sample by sample with the reference implementation instead
+     of the vector instructions, so that both can be checked against each other */
+    void setVectorised(bool shouldUseVectorInstructions) { vectorised = shouldUseVectorInstructions; }
+    
+    /** scans a block of samples. Stores the positions of the crossings (in samples
+     since the last resetPosition()) and returns how many were found. Crossings that
+     don't fit into the array anymore are skipped, the positions of the following
+     blocks are still right. */
+    int process(const float* samples, int numSamples, double* crossingPositions, int maxNumCrossings);
+    
+    /** sample by sample reference implementation. Stores the indices i of the crossings
+     between samples[i-1] and samples[i] for begin <= i < end, at most maxNumIndices. */
+    static int findCrossingsScalar(const float* samples, int begin, int end, int* indices, int maxNumIndices);
+    /** the same with SSE2 or NEON, the results must be exactly the same */
+    static int findCrossingsVectorised(const float* samples, int begin, int end, int* indices, int maxNumIndices);
+    
+private:
+    /** finds the crossings between samples[i-1] and samples[i] for begin <= i < end, interpolates
+     them and stores their positions (offset + i - 1 + fraction). Returns the number of crossings. */
+    int findAndInterpolate(const float* samples, int begin, int end, int offset,
+                           double* crossingPositions, int maxNumCrossings);
+    
+    /** true if samples[index-1] or one of the samples before it, back to the previous
+     crossing, was below -hysteresis */
+    bool isArmed(const float* samples, int index, int offset);
+    
+    /** the position of the crossing between s[-1] and s[0] as a fraction of the sample
+     interval. s[-halfWidth] ... s[halfWidth - 1] are valid. */
+    double interpolate(const float* s) const;
+    
+    Interpolation interpolation;
+    bool vectorised;
+    int halfWidth; // samples needed on each side of the crossing
+    
+    static const int maxHalfWidth = 16;
+    static const int maxHistoryLength = 2 * maxHalfWidth - 1;
+    float history[maxHistoryLength]; // the last 2 * halfWidth - 1 samples
+    int sampleCounter; // position of the next sample
+    
+    float hysteresis;
+    bool armed; // the signal was below -hysteresis since the last crossing
+    int checkedPosition; // the samples before this position were looked at for arming
+    
+    static const int maxNumIndices = 256;
+    int crossingIndices[maxNumIndices];
+};
+
+
+#endif  // ZEROCROSSINGDETECTOR_H_INCLUDED